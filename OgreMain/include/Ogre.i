@@ -963,6 +963,7 @@ public:
 }
 #endif
 %include "OgreRoot.h"
+%include "OgreFrameCounters.h"
 // dont wrap: not useful in high level languages
 // %include "OgreTimer.h"
 // %include "OgreString.h"
@@ -502,6 +502,13 @@ namespace Ogre {
         
         /// Internal method to adjust keyframes relative to a base keyframe (see @ref setUseBaseKeyFrame)
         void _applyBaseKeyFrame();
+
+        /** Internal method to build the data of the node tracks that is otherwise computed on first use
+
+            Applies the base keyframe and builds the keyframe time list and the interpolation splines, so
+            the node tracks can be evaluated from several threads afterwards.
+        */
+        void _prepareNodeTracks();
         
         void _notifyContainer(AnimationContainer* c);
         /** Retrieve the container of this animation. */
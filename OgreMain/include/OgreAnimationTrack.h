@@ -39,6 +39,7 @@ namespace Ogre
 {
     class VertexPoseKeyFrame;
     class KeyFrame;
+    struct CompressedTransformTrack;
 
     /** \addtogroup Core
     *  @{
@@ -239,13 +240,12 @@ namespace Ogre
         /** Returns the parent Animation object for this track. */
         Animation *getParent() const { return mParent; }
     private:
-        /// Map used to translate global keyframe time lower bound index to local lower bound index
-        typedef std::vector<ushort> KeyFrameIndexMap;
-        KeyFrameIndexMap mKeyFrameIndexMap;
-
         /// Create a keyframe implementation - must be overridden
         virtual KeyFrame* createKeyFrameImpl(Real time) = 0;
     protected:
+        /// Map used to translate global keyframe time lower bound index to local lower bound index
+        typedef std::vector<ushort> KeyFrameIndexMap;
+        KeyFrameIndexMap mKeyFrameIndexMap;
         typedef std::vector<KeyFrame*> KeyFrameList;
         KeyFrameList mKeyFrames;
         Animation* mParent;
@@ -339,6 +339,46 @@ namespace Ogre
         /** Gets the method of rotation calculation */
         virtual bool getUseShortestRotationPath() const;
 
+        /** Compresses the keyframes of this track to reduce its memory usage.
+
+            Translation, rotation and scale are compressed separately. A channel that stays within the
+            tolerance of its first keyframe is stored as a single value. Otherwise keyframes are removed
+            as long as the interpolation between the remaining ones stays within the tolerance, and
+            the remaining ones are quantised: rotations to 48 bits using their smallest three components,
+            translations and scales to 16 bits per component and times to 16 bits over the track length.
+            The tolerance includes the quantisation error, which is about 1/65536 of the value range. If
+            it cannot be met, or two keyframes end up at the same time, the keyframes are kept as they are.
+        @par
+            The keyframes are released afterwards, so getNumKeyFrames returns 0 until decompress is
+            called. getInterpolatedKeyFrame decodes the compressed keys directly. A base keyframe set
+            on the animation is applied before compressing.
+        @param translateTolerance The maximum error of each translation component
+        @param rotateTolerance The maximum angle between an original and the interpolated rotation
+        @param scaleTolerance The maximum error of each scale component
+        @return Whether the track was compressed
+        */
+        bool compress(Real translateTolerance = 1e-3f, const Radian& rotateTolerance = Radian(1e-3f),
+                      Real scaleTolerance = 1e-3f);
+
+        /// Recreates the keyframes from the compressed keys, see compress
+        void decompress(void);
+
+        /// Whether the keys are stored compressed, see compress
+        bool isCompressed(void) const { return mCompressed != NULL; }
+
+        /// Internal accessor for the compressed keys, NULL if the track is not compressed
+        const CompressedTransformTrack* _getCompressedKeys(void) const { return mCompressed.get(); }
+
+        /** Internal method to decode the compressed keys to keyframes, without decompressing the track
+
+            For code that copies or writes the keyframes of a track that may be compressed. keys is
+            cleared if the track is not compressed.
+        */
+        void _decodeCompressedKeys(std::vector<TransformKeyFrame>& keys) const;
+
+        /// Internal method to set compressed keys, e.g. when loading. The track must not have keyframes.
+        void _setCompressedKeys(const std::shared_ptr<const CompressedTransformTrack>& keys);
+
         /// @copydoc AnimationTrack::getInterpolatedKeyFrame
         void getInterpolatedKeyFrame(const TimeIndex& timeIndex, KeyFrame* kf) const override;
 
@@ -365,6 +405,13 @@ namespace Ogre
         NodeAnimationTrack* _clone(Animation* newParent) const;
         
         void _applyBaseKeyFrame(const KeyFrame* base) override;
+
+        void _collectKeyFrameTimes(std::vector<Real>& keyFrameTimes) override;
+
+        void _buildKeyFrameIndexMap(const std::vector<Real>& keyFrameTimes) override;
+
+        /// Internal method to build the interpolation splines now instead of on first use, if they are needed
+        void _prepareInterpolationSplines(void) const;
         
     private:
         /// Specialised keyframe creation
@@ -386,6 +433,11 @@ namespace Ogre
         Node* mTargetNode;
         // Prebuilt splines, must be mutable since lazy-update in const method
         mutable Splines* mSplines;
+        /// Compressed keys replacing mKeyFrames, shared by clones
+        std::shared_ptr<const CompressedTransformTrack> mCompressed;
+
+        /// getInterpolatedKeyFrame from the compressed keys
+        void getCompressedKeyFrame(const TimeIndex& timeIndex, TransformKeyFrame* kf) const;
     };
 
     /** Type of vertex animation.
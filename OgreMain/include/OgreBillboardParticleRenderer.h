@@ -31,6 +31,7 @@ THE SOFTWARE.
 #include "OgrePrerequisites.h"
 #include "OgreParticleSystemRenderer.h"
 #include "OgreBillboardSet.h"
+#include "OgreBillboard.h"
 #include "OgreHeaderPrefix.h"
 
 namespace Ogre {
@@ -54,6 +55,11 @@ namespace Ogre {
         /// The billboard set that's doing the rendering
         BillboardSet* mBillboardSet;
         Vector2 mStacksSlices;
+        /// The particles converted for BillboardSet::injectBillboards, kept to avoid allocations
+        std::vector<Billboard> mBillboards;
+
+        /// Append the particles to mBillboards
+        void addBillboards(const std::vector<Particle*>& particles);
     public:
         BillboardParticleRenderer();
         ~BillboardParticleRenderer();
@@ -107,6 +113,9 @@ namespace Ogre {
         /// @copydoc ParticleSystemRenderer::_updateRenderQueue
         void _updateRenderQueue(RenderQueue* queue, 
             std::vector<Particle*>& currentParticles, bool cullIndividually) override;
+        /// @copydoc ParticleSystemRenderer::_updateRenderQueueFromStreams
+        bool _updateRenderQueueFromStreams(RenderQueue* queue, ParticleStreams& streams,
+                                           std::vector<Particle*>& currentParticles, bool cullIndividually) override;
         /// @copydoc ParticleSystemRenderer::visitRenderables
         void visitRenderables(Renderable::Visitor* visitor, bool debugRenderables = false) override
         {
@@ -254,6 +254,21 @@ namespace Ogre {
             Real width, Real height,
             const Vector3& x, const Vector3& y, Vector3* pDestVec);
 
+        /** Internal method generating the vertices of many billboards for injectBillboards.
+
+            Same results as injectBillboard, but the billboard type and rotation options are template
+            parameters, so there is no branching on them per billboard. Only reads the set, so it can run
+            on several threads for separate ranges of pDest.
+        */
+        template <BillboardType type, BillboardRotationType rotationType, bool accurateFacing>
+        void genQuadVerticesBulk(const Billboard* billboards, size_t count, float* pDest) const;
+        /// Selects the genQuadVerticesBulk instance for the current options
+        template <BillboardType type>
+        void genQuadVerticesBulk(const Billboard* billboards, size_t count, float* pDest) const;
+        /// genBillboardAxes without changing mCamDir, for genQuadVerticesBulk
+        template <BillboardType type, bool accurateFacing>
+        void genBillboardAxesBulk(const Billboard& bb, Vector3& x, Vector3& y) const;
+
 
         /** Sort by direction functor */
         struct SortByDirectionFunctor
@@ -517,6 +532,12 @@ namespace Ogre {
         void beginBillboards(size_t numBillboards = 0);
         /** Define a billboard. */
         void injectBillboard(const Billboard& bb);
+        /** Define many billboards at once.
+
+            Same as calling injectBillboard for each of them, but the vertices are written in parallel
+            chunks on the WorkQueue. Unless culling individually, which has to be done one by one.
+        */
+        void injectBillboards(const Billboard* billboards, size_t count);
         /** Finish defining billboards. */
         void endBillboards(void);
         /** Set the bounds of the BillboardSet.
@@ -116,6 +116,15 @@ namespace Ogre
         */
         void _getOffsetTransform(Affine3& m) const;
 
+        /** Sets the local and derived transforms at once, without notifying the parent or children.
+
+            Internal use only, by Skeleton::_evaluateBoneMatrices, which computes the derived
+            transforms itself. No Node::Listener is called.
+        */
+        void _setTransforms(const Vector3& position, const Quaternion& orientation, const Vector3& scale,
+                            const Vector3& derivedPosition, const Quaternion& derivedOrientation,
+                            const Vector3& derivedScale);
+
         /** Gets the inverted binding pose scale. */
         const Vector3& _getBindingPoseInverseScale(void) const { return mBindDerivedInverseScale; }
         /** Gets the inverted binding pose position. */
@@ -580,6 +580,15 @@ namespace Ogre {
         /** Returns the custom culling frustum in use. */
         Frustum* getCullingFrustum(void) const { return mCullFrustum; }
 
+        /** Brings the planes tested by isVisible up to date
+
+            These are the planes of the culling frustum, if set. See Frustum::updateFrustumPlanes.
+        */
+        void updateCullingPlanes(void) const
+        {
+            (mCullFrustum ? mCullFrustum : static_cast<const Frustum*>(this))->updateFrustumPlanes();
+        }
+
         /** Forward projects frustum rays to find forward intersection with plane.
 
             Forward projection may lead to intersections at infinity.
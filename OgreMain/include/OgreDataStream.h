@@ -535,6 +535,32 @@ namespace Ogre {
         void close(void) override;
 
     };
+
+    /** Read-only stream on a memory mapped file
+
+        The file is mapped with POSIX mmap, so its bytes can be used through getPtr() without reading them
+        into a buffer first. Pages are loaded by the OS on first access and are shared with the file cache.
+        Not available on Windows, where the constructor throws.
+    */
+    class _OgreExport MmapDataStream : public MemoryDataStream
+    {
+    private:
+        void* mMapping;
+        size_t mMappingSize;
+
+        MmapDataStream(const String& name, const std::pair<void*, size_t>& mapping);
+    public:
+        /** Map a file
+        @param name The name to give the stream
+        @param path The path of the file
+        */
+        MmapDataStream(const String& name, const String& path);
+        ~MmapDataStream();
+
+        /** @copydoc DataStream::close
+        */
+        void close(void) override;
+    };
     /** @} */
     /** @} */
 }
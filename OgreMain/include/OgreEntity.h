@@ -221,9 +221,14 @@ namespace Ogre {
         Affine3 *mBoneMatrices;
         /// Records the last frame in which animation was updated.
         unsigned long mFrameAnimationLastUpdated;
+        /// Records the last frame in which the entity was added to a render queue.
+        unsigned long mFrameLastQueued;
 
         /// Perform all the updates required for an animated entity.
         void updateAnimation(void);
+        /// Software skinning, queued on the SceneManager when it performs it in parallel.
+        void softwareVertexBlend(const VertexData* sourceVertexData, const VertexData* targetVertexData,
+                                 const Affine3* const* blendMatrices, size_t numMatrices, bool blendNormals);
 
         /// Records the last frame in which the bones was updated.
         /// It's a pointer because it can be shared between different entities with
@@ -724,6 +729,27 @@ namespace Ogre {
         */
         void _updateAnimation(void);
 
+        /** Prepares the evaluation of the skeleton by _evaluateSkeleton, see
+            SceneManager::setParallelSkeletonAnimation.
+
+            Internal use only. Marks the bone matrices as updated for this frame, so entities sharing the
+            skeleton and the following _updateAnimation do not evaluate it again.
+        @return
+            True if the skeleton animation is dirty, in which case _evaluateSkeleton must be called. False
+            as well if a bone has a Node::Listener, which _evaluateSkeleton would not call, so the skeleton
+            is left to _updateAnimation.
+        */
+        bool _prepareSkeletonEvaluation(void);
+
+        /// Gets the last frame in which the entity was added to a render queue (internal use)
+        unsigned long _getFrameLastQueued(void) const { return mFrameLastQueued; }
+
+        /** Evaluates the skeleton animation into the bone matrices, see _prepareSkeletonEvaluation.
+
+            Internal use only. Entities with different skeleton instances may be evaluated in parallel.
+        */
+        void _evaluateSkeleton(void);
+
         /** Tests if any animation applied to this entity.
 
             An entity is animated if any animation state is enabled, or any manual bone
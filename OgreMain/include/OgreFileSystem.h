@@ -70,6 +70,18 @@ namespace Ogre {
 
         /// Get whether hidden files are ignored during filesystem enumeration.
         static bool getIgnoreHidden();
+
+        /** Set whether files opened for reading are memory mapped
+
+            The returned streams are then MmapDataStream instances, so loaders can use the file contents
+            in place instead of copying them into a MemoryDataStream first. Only supported on POSIX
+            platforms, enabling it elsewhere throws. The default is false. This also applies to the files
+            of Zip archives.
+        */
+        static void setUseMmap(bool mmap);
+
+        /// Get whether files opened for reading are memory mapped
+        static bool getUseMmap();
     };
 
     class APKFileSystemArchiveFactory : public ArchiveFactory
@@ -0,0 +1,123 @@
+// This file is part of the OGRE project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at https://www.ogre3d.org/licensing.
+// SPDX-License-Identifier: MIT
+#ifndef __FrameCounters_H__
+#define __FrameCounters_H__
+
+#include "OgrePrerequisites.h"
+#include "OgreException.h"
+#include "OgreHeaderPrefix.h"
+
+#include <atomic>
+
+namespace Ogre
+{
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup General
+    *  @{
+    */
+    /** Counts of the work done each frame, by subsystem
+
+        Complements RenderTarget::FrameStats, which only has the frame times and what was rendered.
+        The built-in counters are incremented by the engine, applications may add their own with
+        registerCounter. Incrementing is a relaxed atomic add, so counting from worker threads is fine.
+
+        Root::renderOneFrame starts a frame by calling _frameStarted, which makes the counts so far
+        the ones of the last frame. Between frames, e.g. when loading, the counts add up in the
+        current frame.
+    */
+    class _OgreExport FrameCounters
+    {
+    public:
+        /// The built-in counters
+        enum Counter
+        {
+            /// SceneNodes whose derived transform was updated from their parent
+            NODES_UPDATED,
+            /// SceneNodes whose bounds were outside of the camera, so their objects were not visited
+            NODES_CULLED,
+            /// MovableObjects that were added to the render queue
+            OBJECTS_VISIBLE,
+            /// MovableObjects that were visited but not added, as they are hidden or not needed for shadows
+            OBJECTS_CULLED,
+            /// Renderables added to a RenderQueue
+            RENDERABLES_QUEUED,
+            /// Calls to SceneManager::_setPass
+            PASS_CHANGES,
+            /// GPU programs bound by the SceneManager
+            GPU_PROGRAM_BINDS,
+            /// GPU program parameters and fixed function parameters passed to the RenderSystem
+            GPU_PARAMETER_UPLOADS,
+            /// Locks of hardware buffers, once per lock call, even with a shadow buffer or a delegate
+            BUFFER_LOCKS,
+            /// Bytes of hardware buffers that were locked
+            BUFFER_BYTES_LOCKED,
+            /// Resources that finished loading
+            RESOURCES_LOADED,
+            BUILTIN_COUNT
+        };
+
+        /// The built-in counters and the registered ones
+        static const uint32 MAX_COUNTERS = 64;
+
+        /// Adds to a counter of the current frame
+        static void add(uint32 counter, uint64 n = 1)
+        {
+            OgreAssertDbg(counter < MAX_COUNTERS, "unknown frame counter");
+            sCounters[counter].current.fetch_add(n, std::memory_order_relaxed);
+        }
+
+        /** Adds a counter, or gets the one with that name
+
+            The names of the built-in counters are the CamelCase of the enum values, like "NodesUpdated".
+        */
+        static uint32 registerCounter(const String& name);
+
+        /// The number of built-in and registered counters
+        static uint32 getCount();
+
+        static const String& getName(uint32 counter);
+
+        /// The value of a counter in the last frame
+        static uint64 getValue(uint32 counter) { return sCounters[counter].last.load(std::memory_order_relaxed); }
+
+        /// The value of a counter in the current frame so far
+        static uint64 getCurrentValue(uint32 counter)
+        {
+            return sCounters[counter].current.load(std::memory_order_relaxed);
+        }
+
+        /// The number of frames that were started
+        static uint64 getFrameCount();
+
+        /// A line with "Frame" and the names of the counters, separated by commas
+        static String getCsvHeader();
+
+        /// A line with the frame count and the values of the last frame, matching getCsvHeader
+        static String getCsvRow();
+
+        /// Sets all values and the frame count to 0
+        static void reset();
+
+        /// Starts a frame, which makes the current values the ones of the last frame
+        static void _frameStarted();
+
+    private:
+        // a cache line each, as they are incremented by different threads
+        struct alignas(64) Slot
+        {
+            std::atomic<uint64> current;
+            std::atomic<uint64> last;
+        };
+        static Slot sCounters[MAX_COUNTERS];
+    };
+    /** @} */
+    /** @} */
+}
+
+#include "OgreHeaderSuffix.h"
+
+#endif
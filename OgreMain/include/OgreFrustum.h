@@ -126,7 +126,6 @@ namespace Ogre
         virtual void updateFrustumImpl(void) const;
         /// Implementation of updateView (called if out of date)
         virtual void updateViewImpl(void) const;
-        void updateFrustumPlanes(void) const;
         /// Implementation of updateFrustumPlanes (called if out of date)
         virtual void updateFrustumPlanesImpl(void) const;
         void updateWorldSpaceCorners(void) const;
@@ -372,6 +371,12 @@ namespace Ogre
         */
         virtual const Plane* getFrustumPlanes(void) const;
 
+        /** Brings the clipping planes up to date
+
+            The queries such as isVisible do this lazily. Call it before querying from several threads at once.
+        */
+        void updateFrustumPlanes(void) const;
+
         /** Retrieves a specified plane of the frustum (world space).
 
             Gets a reference to one of the planes which make up the frustum frustum, e.g. for clipping purposes.
@@ -31,6 +31,7 @@ THE SOFTWARE.
 // Precompiler options
 #include "OgrePrerequisites.h"
 #include "OgreException.h"
+#include "OgreFrameCounters.h"
 
 namespace Ogre {
 
@@ -227,6 +228,12 @@ namespace Ogre {
                     mIsLocked = true;
                     // Lock the real buffer if there is no shadow buffer 
                     ret = lockImpl(offset, length, options);
+                    // a delegate counts the lock itself
+                    if (!mDelegate)
+                    {
+                        FrameCounters::add(FrameCounters::BUFFER_LOCKS);
+                        FrameCounters::add(FrameCounters::BUFFER_BYTES_LOCKED, length);
+                    }
                 }
                 mLockStart = offset;
                 mLockSize = length;
@@ -278,6 +278,17 @@ namespace Ogre
         */
         virtual void _boundsDirty(void);
 
+        /** Collects the batches InstancedEntity(s) moved on this thread would call _boundsDirty on
+
+            Used while the scene graph is updated in parallel, see SceneManager::setParallelUpdateDepth.
+            The caller then calls _boundsDirty on the collected batches from a single thread.
+            @param batches where to add the batches, NULL to call _boundsDirty directly again
+        */
+        static void _setDeferredBoundsDirty(std::vector<InstanceBatch*>* batches);
+
+        /// Calls _boundsDirty, or adds this batch to the list given to _setDeferredBoundsDirty on this thread
+        void _notifyBoundsDirty(void);
+
         /** Tells this batch to stop updating animations, positions, rotations, and display
             all it's active instances. Currently only InstanceBatchHW & InstanceBatchHW_VTF support it.
             This option makes the batch behave pretty much like Static Geometry, but with the GPU RAM
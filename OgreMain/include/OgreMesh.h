@@ -90,6 +90,7 @@ namespace Ogre {
     {
         friend class SubMesh;
         friend class MeshSerializerImpl;
+        friend class MeshSerializerImpl_v1_10;
         friend class MeshSerializerImpl_v1_8;
         friend class MeshSerializerImpl_v1_4;
         friend class MeshSerializerImpl_v1_3;
@@ -149,14 +150,24 @@ namespace Ogre {
         /// Flag indicating that bone assignments need to be recompiled.
         bool mBoneAssignmentsOutOfDate;
 
+        /// The bone assignments as read from a .mesh file, valid until the assignments are changed
+        PackedBoneAssignments mPackedBoneAssignments;
+
         /** Build the index map between bone index and blend index. */
-        void buildIndexMap(const VertexBoneAssignmentList& boneAssignments,
+        static void buildIndexMap(const VertexBoneAssignmentList& boneAssignments,
             IndexMap& boneIndexToBlendIndexMap, IndexMap& blendIndexToBoneIndexMap);
+        /** Pack rationalised bone assignments, see PackedBoneAssignments */
+        static void packBoneAssignments(const VertexBoneAssignmentList& boneAssignments,
+            unsigned short numBlendWeightsPerVertex, const IndexMap& boneIndexToBlendIndexMap,
+            size_t vertexCount, uchar* pDest);
         /** Compile bone assignments into blend index and weight buffers. */
         void compileBoneAssignments(const VertexBoneAssignmentList& boneAssignments,
             unsigned short numBlendWeightsPerVertex, 
             IndexMap& blendIndexToBoneIndexMap,
             VertexData* targetVertexData);
+        /** Compile packed bone assignments into blend index and weight buffers. */
+        void compileBoneAssignments(const PackedBoneAssignments& packed, IndexMap& blendIndexToBoneIndexMap,
+            VertexData* targetVertexData);
 #if !OGRE_NO_MESHLOD
         const LodStrategy *mLodStrategy;
         bool mHasManualLodLevel;
@@ -607,7 +618,7 @@ namespace Ogre {
         @return
             The maximum number of bone assignments per vertex found, clamped to [1-4]
         */
-        unsigned short _rationaliseBoneAssignments(size_t vertexCount, VertexBoneAssignmentList& assignments);
+        unsigned short _rationaliseBoneAssignments(size_t vertexCount, VertexBoneAssignmentList& assignments) const;
 
         /** Internal method, be called once to compile bone assignments into geometry buffer. 
 
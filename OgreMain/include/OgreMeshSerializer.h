@@ -44,6 +44,8 @@ namespace Ogre {
         /// Latest version available
         MESH_VERSION_LATEST,
         
+        /// OGRE version v14.4+, bone weights stored like the blend buffers
+        MESH_VERSION_14_4,
         /// OGRE version v1.10+
         MESH_VERSION_1_10,
         /// OGRE version v1.8+
@@ -34,6 +34,8 @@ THE SOFTWARE.
 #include "OgreUserObjectBindings.h"
 #include "OgreHeaderPrefix.h"
 
+#include <functional>
+
 namespace Ogre {
     template <typename T> class VectorIterator;
     template <typename T> class ConstVectorIterator;
@@ -564,6 +566,18 @@ namespace Ogre {
         /** Gets the current listener for this Node.
         */
         Listener* getListener(void) const { return mListener; }
+
+        /** Collects the listener calls made on this thread instead of making them
+
+            Used while the scene graph is updated in parallel, see SceneManager::setParallelUpdateDepth,
+            as listeners need not be thread safe. The caller then makes the collected calls from a single
+            thread. This covers Listener::nodeUpdated and MovableObject::Listener::objectMoved.
+            @param calls where to add the calls, NULL to make them directly again
+        */
+        static void _setDeferredListenerCalls(std::vector<std::function<void()> >* calls);
+
+        /// The list given to _setDeferredListenerCalls on this thread, NULL if calls are made directly
+        static std::vector<std::function<void()> >* _getDeferredListenerCalls(void);
         
 
         /** Sets the current transform of this node to be the 'initial state' ie that
@@ -72,6 +72,21 @@ namespace Ogre {
         */
         static OptimisedUtil* getImplementation(void) { return msImplementation; }
 
+        /// The implementations getImplementation chooses from
+        enum ImplementationType
+        {
+            IMPL_GENERAL,
+            /// SSE, or NEON on ARM
+            IMPL_SSE,
+            /// AVX2 and FMA
+            IMPL_AVX2
+        };
+
+        /** Gets a specific implementation, for testing and comparing them.
+        @return NULL if the implementation is not compiled in or the CPU does not support it
+        */
+        static OptimisedUtil* getImplementation(ImplementationType type);
+
         /** Performs software vertex skinning.
         @param srcPosPtr Pointer to source position buffer.
         @param destPosPtr Pointer to destination position buffer.
@@ -204,6 +219,64 @@ namespace Ogre {
             const float* srcPositions,
             float* destPositions,
             size_t numVertices) = 0;
+
+        /** Test axis aligned boxes against a set of planes, as used for frustum culling.
+
+            A box is culled if it lies completely on the negative side of any of the planes,
+            the same as Plane::getSide returning Plane::NEGATIVE_SIDE.
+        @param planes The planes, packed as (normal.x, normal.y, normal.z, d).
+        @param numPlanes Number of planes.
+        @param centres Box centres, packed in (x, y, z) format. No alignment requirement.
+        @param halfSizes Box half sizes, packed in (x, y, z) format. No alignment requirement.
+        @param numBoxes Number of boxes to test. Only finite boxes are supported.
+        @param visibleMask Array of (numBoxes + 31) / 32 words receiving the results. Bit
+            (i % 32) of word (i / 32) is set if box i is not culled.
+        */
+        virtual void cullBoxes(
+            const Vector4* planes,
+            size_t numPlanes,
+            const float* centres,
+            const float* halfSizes,
+            size_t numBoxes,
+            uint32* visibleMask) = 0;
+
+        /** Test spheres against a set of planes, as used for frustum culling.
+
+            A sphere is culled if its centre is farther than its radius on the negative
+            side of any of the planes.
+        @param planes The planes, packed as (normal.x, normal.y, normal.z, d).
+        @param numPlanes Number of planes.
+        @param spheres The spheres, packed as (centre.x, centre.y, centre.z, radius).
+        @param numSpheres Number of spheres to test.
+        @param visibleMask Array of (numSpheres + 31) / 32 words receiving the results, see cullBoxes.
+        */
+        virtual void cullSpheres(
+            const Vector4* planes,
+            size_t numPlanes,
+            const Vector4* spheres,
+            size_t numSpheres,
+            uint32* visibleMask) = 0;
+
+        /** Intersect a ray with axis aligned boxes.
+        @param origin The origin of the ray.
+        @param direction The direction of the ray.
+        @param mins Box minimum corners, packed in (x, y, z) format. No alignment requirement.
+        @param maxs Box maximum corners, packed in (x, y, z) format. No alignment requirement.
+        @param numBoxes Number of boxes to test. Only finite boxes are supported.
+        @param hitMask Array of (numBoxes + 31) / 32 words receiving the results. Bit (i % 32)
+            of word (i / 32) is set if the ray hits box i.
+        @param distances If not NULL, receives the distance along the ray, in multiples of
+            the direction, at which it enters each box that is hit. This is 0 if the origin
+            is inside the box. The values for boxes that are not hit are undefined.
+        */
+        virtual void intersectRayBoxes(
+            const Vector3& origin,
+            const Vector3& direction,
+            const float* mins,
+            const float* maxs,
+            size_t numBoxes,
+            uint32* hitMask,
+            float* distances) = 0;
     };
 
     /** Returns raw offsetted of the given pointer.
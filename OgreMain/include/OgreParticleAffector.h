@@ -84,6 +84,14 @@ namespace Ogre {
         /** Virtual destructor essential. */
         virtual ~ParticleAffector();
 
+        /** Method called before each update of the particle system.
+
+            Unlike the other methods, this is always called on the thread updating the scene, even with
+            ParticleSystemManager::setParallelUpdate. Load the resources the affector needs here, rather
+            than on first use.
+        */
+        virtual void _prepare(void) {}
+
         /** Method called to allow the affector to initialize all newly created particles in the system.
 
             This is where the affector gets the chance to initialize it's effects to the particles of a system.
@@ -110,6 +118,25 @@ namespace Ogre {
         */
         virtual void _affectParticles(ParticleSystem* pSystem, Real timeElapsed) = 0;
 
+        /** Returns whether this affector implements _affectParticleStreams.
+
+            Otherwise a ParticleSystem using stream storage passes temporary Particle copies of its stream
+            particles to _affectParticles.
+        */
+        virtual bool _supportsParticleStreams(void) const { return false; }
+
+        /** Method called to apply the affector to the particles of a system using stream storage.
+
+            Only called if _supportsParticleStreams returns true. _affectParticles is still called for
+            the emitted emitters, which are not part of the streams.
+        @see ParticleSystem::setStreamStorage
+        @param
+            streams The visual particles of the system.
+        @param
+            timeElapsed The number of seconds which have elapsed since the last call.
+        */
+        virtual void _affectParticleStreams(ParticleStreams& streams, Real timeElapsed) {}
+
         /** Returns the name of the type of affector. 
 
             This property is useful for determining the type of affector procedurally so another
@@ -0,0 +1,104 @@
+// This file is part of the OGRE project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at https://www.ogre3d.org/licensing.
+// SPDX-License-Identifier: MIT
+#ifndef __ParticleStreams_H__
+#define __ParticleStreams_H__
+
+#include "OgrePrerequisites.h"
+#include "OgreColourValue.h"
+#include "OgreVector.h"
+#include "OgreHeaderPrefix.h"
+
+namespace Ogre
+{
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup Effects
+    *  @{
+    */
+    /** Particles stored as a structure of arrays
+
+        Holds the same values as Particle, but each member is kept in a separate contiguous stream with one
+        entry per particle. This is used by ParticleSystem::setStreamStorage, so affectors and renderers can
+        process all particles with tight loops instead of following a pointer per particle.
+
+        The bulk operations below implement the common affectors, four particles at a time where SIMD is
+        available. Their results match the ones of the equivalent operations on Particle objects.
+    */
+    class _OgreExport ParticleStreams : public FXAlloc
+    {
+    public:
+        struct Vector3Array
+        {
+            std::vector<Real> x, y, z;
+        };
+
+        // Note the intentional public access, like in Particle
+        /// World position
+        Vector3Array mPosition;
+        /// Direction (and speed)
+        Vector3Array mDirection;
+        /// Current colour
+        std::vector<RGBA> mColour;
+        /// Time to live, number of seconds left of particles natural life
+        std::vector<float> mTimeToLive;
+        /// Total Time to live, number of seconds of particles natural life
+        std::vector<float> mTotalTimeToLive;
+        /// Particle width
+        std::vector<float> mWidth;
+        /// Particle height
+        std::vector<float> mHeight;
+        /// Current rotation value in radians
+        std::vector<Real> mRotation;
+        /// Speed of rotation in radians/sec
+        std::vector<Real> mRotationSpeed;
+        /// Index into the array of texture coordinates @see BillboardSet::setTextureStacksAndSlices()
+        std::vector<uint8> mTexcoordIndex;
+        std::vector<uint8> mRandomTexcoordOffset;
+
+        size_t size() const { return mTimeToLive.size(); }
+        bool empty() const { return mTimeToLive.empty(); }
+        size_t capacity() const { return mTimeToLive.capacity(); }
+        void reserve(size_t count);
+        void clear();
+
+        /// append a particle, its type is ignored
+        void push_back(const Particle& p);
+        /// copy the values of a particle to p
+        void get(size_t index, Particle& p) const;
+        /// set the values of a particle from p
+        void set(size_t index, const Particle& p);
+        /// remove a particle by moving the last one into its place
+        void removeSwapLast(size_t index);
+        /// reorder the particles, so the new particle i is the old particle order[i]
+        void reorder(const std::vector<uint32>& order);
+
+        /// position += direction * timeElapsed
+        void applyMotion(Real timeElapsed);
+        /// direction += v
+        void addDirection(const Vector3& v);
+        /// direction = (direction + v) / 2
+        void averageDirection(const Vector3& v);
+        /// add to each colour channel and saturate, like ColourValue::saturate
+        void adjustColour(const ColourValue& delta);
+        /// add to width and height, which are clamped at 0
+        void adjustDimensions(float delta);
+        /// rotation += rotationSpeed * timeElapsed
+        void applyRotationSpeed(Real timeElapsed);
+        /** Bounce particles off a plane, if they would cross it within timeElapsed
+
+            Particles in front of the plane, where planeNormal.dotProduct(position) + planeDistance > 0, that
+            would end up behind it are moved to the bounce position and their direction is reflected, both
+            scaled by bounce.
+        */
+        void deflect(const Vector3& planeNormal, Real planeDistance, Real bounce, Real timeElapsed);
+    };
+    /** @} */
+    /** @} */
+}
+
+#include "OgreHeaderSuffix.h"
+
+#endif
@@ -36,6 +36,8 @@ THE SOFTWARE.
 #include "OgreResourceGroupManager.h"
 #include "OgreHeaderPrefix.h"
 
+#include <random>
+
 
 namespace Ogre {
 
@@ -197,6 +199,8 @@ namespace Ogre {
             particle manually (say, if you've used setSpeedFactor(0) to make particles live forever)
             you should use getParticle() and modify it's timeToLive to zero, meaning that it will
             get cleaned up in the next update.
+        @note
+            Returns NULL with stream storage, see setStreamStorage.
         */
         Particle* createParticle(void);
 
@@ -216,6 +220,8 @@ namespace Ogre {
             Normally you use an affector to alter particles in flight, but
             for small manually controlled particle systems you might want to use
             this method.
+        @note
+            Not available with stream storage, use _getParticleStreams instead.
         */
         Particle* getParticle(size_t index);
 
@@ -271,9 +277,32 @@ namespace Ogre {
             This method is designed to be used by people providing new ParticleAffector subclasses,
             this is the easiest way to step through all the particles in a system and apply the
             changes the affector wants to make.
+        @note
+            With stream storage this only contains the emitted emitters, unless it is called from
+            ParticleAffector::_affectParticles of an affector that does not support streams. Those get
+            temporary copies of the stream particles appended, which are written back afterwards.
         */
         const std::vector<Particle*>& _getActiveParticles() { return mActiveParticles; }
 
+        /** Sets whether visual particles are stored in ParticleStreams instead of Particle objects.
+
+            With stream storage the particle members are kept in contiguous arrays, so affectors that
+            implement ParticleAffector::_affectParticleStreams and renderers that implement
+            ParticleSystemRenderer::_updateRenderQueueFromStreams process them with tight loops, instead of
+            following one pointer per particle. Others transparently work on temporary Particle copies,
+            which costs a copy in each direction.
+        @par
+            Emitted emitters are still Particle objects in _getActiveParticles. Particle pointers passed to
+            the renderer notifications of stream particles are only valid during the call.
+            Changing this clears the system.
+        */
+        void setStreamStorage(bool enabled);
+        /// Gets whether visual particles are stored in ParticleStreams
+        bool getStreamStorage(void) const { return mStreams != NULL; }
+
+        /// The visual particles, if stream storage is enabled. NULL otherwise.
+        ParticleStreams* _getParticleStreams() { return mStreams.get(); }
+
         /** Sets the name of the material to be used for this billboard set.
         */
         virtual void setMaterialName( const String& name, const String& groupName = ResourceGroupManager::AUTODETECT_RESOURCE_GROUP_NAME );
@@ -531,7 +560,30 @@ namespace Ogre {
 
         /// Override to return specific type flag
         uint32 getTypeFlags(void) const override;
+
+        /** Random numbers for the emitters and affectors of this system.
+
+            Each system has its own generator, so the results do not depend on the order in which the
+            systems are updated, which is arbitrary with ParticleSystemManager::setParallelUpdate.
+        */
+        float _unitRandom(void)
+        {
+            return float(mRandom() - mRandom.min()) / float(mRandom.max() - mRandom.min());
+        }
+        /// @copydoc _unitRandom
+        float _rangeRandom(float low, float high) { return (high - low) * _unitRandom() + low; }
+        /// @copydoc _unitRandom
+        float _symmetricRandom(void) { return 2.0f * _unitRandom() - 1.0f; }
+
+        /** Seeds the random number generator of this system.
+
+            By default it is seeded from a hash of the name that does not depend on the platform, so systems
+            created in the same order get the same results everywhere.
+        */
+        void setRandomSeed(uint32 seed) { mRandom.seed(seed); }
     private:
+        friend class ParticleSystemManager;
+
         AxisAlignedBox mAABB;
         Real mBoundingRadius;
         bool mBoundsAutoUpdate;
@@ -623,6 +675,12 @@ namespace Ogre {
         */
         ParticlePool mParticlePool;
 
+        /// Visual particles when stream storage is enabled
+        std::unique_ptr<ParticleStreams> mStreams;
+
+        /// Copies of the stream particles for affectors and renderers that do not support streams
+        std::vector<Particle> mStreamParticles;
+
         typedef std::list<ParticleEmitter*> FreeEmittedEmitterList;
         typedef std::list<ParticleEmitter*> ActiveEmittedEmitterList;
         typedef std::vector<ParticleEmitter*> EmittedEmitterList;
@@ -683,6 +741,28 @@ namespace Ogre {
         /// Default nonvisible update timeout
         static Real msDefaultNonvisibleTimeout;
 
+        /// Random number generator for the emitters and affectors
+        std::minstd_rand mRandom;
+
+        /// Requested emissions of the emitters and the active emitted emitters, kept to avoid allocations
+        std::vector<unsigned> mRequested;
+        std::vector<unsigned> mEmittedRequested;
+
+        /** Prepares _update on the calling thread.
+
+            Sets up the renderer and emitted emitters and caches the node transform, so _simulate only
+            touches this system.
+        @param timeElapsed scaled by the speed factor on return
+        @return false if the system does not need an update
+        */
+        bool _beginUpdate(Real& timeElapsed);
+
+        /** The expire, affect, move and emit part of _update, which may run on a worker thread */
+        void _simulate(Real timeElapsed);
+
+        /** Finishes _update on the calling thread by updating the bounds */
+        void _endUpdate(Real timeElapsed);
+
         /** Internal method used to expire dead particles. */
         void _expire(Real timeElapsed);
 
@@ -702,6 +782,14 @@ namespace Ogre {
         /** Sort the particles in the system **/
         void _sortParticles(Camera* cam);
 
+        /** Appends copies of the stream particles to mActiveParticles.
+            @return the previous size of mActiveParticles
+        */
+        size_t gatherStreamParticles(void);
+
+        /** Removes the copies added by gatherStreamParticles, optionally writing them back to the streams */
+        void releaseStreamParticles(size_t numActive, bool writeBack);
+
         /** Resize the internal pool of particles. */
         void increasePool(size_t size);
 
@@ -96,6 +96,15 @@ namespace Ogre {
         // Factory instance
         ParticleSystemFactory* mFactory;
 
+        struct QueuedUpdate
+        {
+            ParticleSystem* system;
+            Real timeElapsed;
+        };
+        /// Updates waiting for _updateQueuedSystems
+        std::vector<QueuedUpdate> mQueuedUpdates;
+        bool mParallelUpdate;
+
         /// Internal implementation of createSystem
         ParticleSystem* createSystemImpl(const String& name, size_t quota, 
             const String& resourceGroup);
@@ -313,6 +322,29 @@ namespace Ogre {
                 mSystemTemplates.begin(), mSystemTemplates.end());
         } 
 
+        /** Update the particle systems concurrently on the WorkQueue
+
+            When enabled, the controllers of the particle systems only queue their update, which is performed
+            for all systems at once by _updateQueuedSystems. This is called by SceneManager::_renderScene
+            after updating the controllers, and by Root when a frame starts, for updates queued elsewhere,
+            like by updating the controllers without rendering. The expiry, affectors, motion and emission of each system then run
+            on the worker threads, while everything touching the scene graph, like the bounds, stays on the
+            calling thread.
+
+            Custom emitters and affectors must only modify their own state and use the random numbers of
+            their ParticleSystem to be used with this. Disabled by default.
+        */
+        void setParallelUpdate(bool enabled) { mParallelUpdate = enabled; }
+        /// @copydoc setParallelUpdate
+        bool getParallelUpdate(void) const { return mParallelUpdate; }
+
+        /// Queue an update of a particle system for _updateQueuedSystems (internal use)
+        void _queueUpdate(ParticleSystem* system, Real timeElapsed);
+        /// Remove the queued updates of a particle system (internal use)
+        void _cancelUpdate(ParticleSystem* system);
+        /// Perform the queued particle system updates, see setParallelUpdate
+        void _updateQueuedSystems(void);
+
         /** Get an instance of ParticleSystemFactory (internal use). */
         ParticleSystemFactory* _getFactory(void) { return mFactory; }
         
@@ -65,6 +65,19 @@ namespace Ogre {
         virtual void _updateRenderQueue(RenderQueue* queue, 
             std::vector<Particle*>& currentParticles, bool cullIndividually) = 0;
 
+        /** Delegated to by ParticleSystem::_updateRenderQueue when using stream storage
+
+            Renderers that can read ParticleStreams directly should override this and return true.
+            Otherwise _updateRenderQueue is called with temporary copies of the stream particles.
+        @param streams The visual particles
+        @param currentParticles The emitted emitters
+        */
+        virtual bool _updateRenderQueueFromStreams(RenderQueue* queue, ParticleStreams& streams,
+                                                   std::vector<Particle*>& currentParticles, bool cullIndividually)
+        {
+            return false;
+        }
+
         /** Sets the material this renderer must use; called by ParticleSystem. */
         virtual void _setMaterial(MaterialPtr& mat) = 0;
         /** Delegated to by ParticleSystem::_notifyCurrentCamera */
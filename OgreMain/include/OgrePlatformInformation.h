@@ -62,6 +62,15 @@ namespace Ogre {
 #   define __OGRE_HAVE_SSE  0
 #endif
 
+/* Define whether or not Ogre compiled with the AVX2/FMA routines. These are enabled per function
+   and only used if the CPU supports them, so no compiler flags are required.
+ */
+#if __OGRE_HAVE_SSE && OGRE_PLATFORM != OGRE_PLATFORM_EMSCRIPTEN
+#   define __OGRE_HAVE_AVX2  1
+#else
+#   define __OGRE_HAVE_AVX2  0
+#endif
+
 #ifndef __OGRE_HAVE_VFP
 #   define __OGRE_HAVE_VFP  0
 #endif
@@ -118,6 +127,8 @@ namespace Ogre {
             CPU_FEATURE_FPU             = 1 << 12,
             CPU_FEATURE_PRO             = 1 << 13,
             CPU_FEATURE_HTT             = 1 << 14,
+            CPU_FEATURE_AVX2            = 1 << 18,
+            CPU_FEATURE_FMA             = 1 << 19,
 #elif OGRE_CPU == OGRE_CPU_ARM          
             CPU_FEATURE_VFP             = 1 << 15,
             CPU_FEATURE_NEON            = 1 << 16,
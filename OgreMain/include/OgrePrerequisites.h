@@ -181,6 +181,7 @@ namespace Ogre {
     class ParticleAffectorFactory;
     class ParticleEmitter;
     class ParticleEmitterFactory;
+    class ParticleStreams;
     class ParticleSystem;
     class ParticleSystemManager;
     class ParticleSystemRenderer;
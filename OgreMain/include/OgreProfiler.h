@@ -43,13 +43,19 @@ Ogre-dependent is in the visualization/logging routines and the use of the Timer
 
 #include "OgrePrerequisites.h"
 #include "OgreSingleton.h"
+#include "Threading/OgreThreadHeaders.h"
 #include "OgreHeaderPrefix.h"
 
+#include <atomic>
+#include <thread>
+
 #if OGRE_PROFILING == 1
-#   define OgreProfile( a ) Ogre::Profile _OgreProfileInstance( (a) )
+#   define OgreProfile( a ) OgreProfileGroup( (a), Ogre::OGREPROF_USER_DEFAULT )
 #   define OgreProfileBegin( a ) Ogre::Profiler::getSingleton().beginProfile( (a) )
 #   define OgreProfileEnd( a ) Ogre::Profiler::getSingleton().endProfile( (a) )
-#   define OgreProfileGroup( a, g ) Ogre::Profile OGRE_TOKEN_PASTE(_OgreProfileInstance, __LINE__) ( (a), (g) )
+#   define OgreProfileGroup( a, g ) \
+        Ogre::Profile OGRE_TOKEN_PASTE(_OgreProfileInstance, __LINE__) ( \
+            []() -> Ogre::ProfileName& { static Ogre::ProfileName name; return name; }(), (a), (g) )
 #   define OgreProfileBeginGroup( a, g ) Ogre::Profiler::getSingleton().beginProfile( (a), (g) )
 #   define OgreProfileEndGroup( a, g ) Ogre::Profiler::getSingleton().endProfile( (a), (g) )
 #   define OgreProfileBeginGPUEvent( g ) Ogre::Root::getSingleton().getRenderSystem()->beginProfileEvent(g)
@@ -219,6 +225,34 @@ namespace Ogre {
         virtual void displayResults(const ProfileInstance& instance, ulong maxTotalFrameTime) {};
     };
 
+    /** Caches the id of a profile name at a call site, see the OgreProfile macro
+    */
+    class ProfileName
+    {
+    public:
+        constexpr ProfileName() : mID(0) {}
+
+        /** The id of the name
+
+            Only the id of a string literal, or another constant array, is cached, as it is the same on
+            each call. Other names, like char buffers or String::c_str(), are looked up each time.
+        */
+        template <typename T> uint32 getID(T&& profileName)
+        {
+            typedef typename std::remove_reference<T>::type Name;
+            typedef std::integral_constant<bool, std::is_array<Name>::value &&
+                                                     std::is_const<typename std::remove_extent<Name>::type>::value>
+                IsConstant;
+            return getID(profileName, IsConstant());
+        }
+
+    private:
+        uint32 getID(const char* profileName, std::true_type);
+        uint32 getID(const String& profileName, std::false_type);
+
+        std::atomic<uint32> mID;
+    };
+
     /** The profiler allows you to measure the performance of your code
 
         Do not create profiles directly from this unless you want a profile to last
@@ -226,6 +260,17 @@ namespace Ogre {
         OgreProfile(name) and braces to limit the scope. You must enable the Profile
         before you can used it with setEnabled(true). If you want to disable profiling
         in Ogre, simply set the macro OGRE_PROFILING to 0.
+
+        Profiles may be used on any thread. Each thread records begin and end events with
+        the id of the name, see getNameID, into a buffer of its own. The events are only
+        gathered into the ProfileInstance hierarchy when the outermost profile of the thread
+        that created the Profiler ends, which is the end of the frame. The top level profiles
+        of the other threads show up next to the ones of that thread then. While enabled, the
+        events can also be captured for exportChromeTrace.
+
+        OgreProfile caches the id of the name at the call site only for string literals and other
+        constant char arrays. Other names, like char buffers, String::c_str() or the name of a camera,
+        are looked up on each call, see ProfileName::getID.
         @author Amit Mathew (amitmathew (at) yahoo (dot) com)
         @todo resolve artificial cap on number of profiles displayed
         @todo fix display ordering of profiles not called every frame
@@ -275,6 +320,26 @@ namespace Ogre {
             */
             void endProfile(const String& profileName, uint32 groupID = (uint32)OGREPROF_USER_DEFAULT);
 
+            /// @overload
+            void beginProfile(uint32 nameID, uint32 groupID);
+
+            /** @overload
+
+                An id of 0 only handles a change of the enabled state, which is what Profile
+                does for a profile that was not begun as the profiler was disabled.
+            */
+            void endProfile(uint32 nameID, uint32 groupID);
+
+            /** Gets the id of a profile name, registering it on first use
+
+                Ids are shared by all profilers and stay valid until the application ends. 0 is
+                reserved for the empty name of the root.
+            */
+            static uint32 getNameID(const String& profileName);
+
+            /// Gets the name of an id returned by getNameID
+            static String getName(uint32 nameID);
+
             /** Sets whether this profiler is enabled. Only takes effect after the
                 the frame has ended.
                 @remarks When this is called the first time with the parameter true,
@@ -283,7 +348,7 @@ namespace Ogre {
             void setEnabled(bool enabled);
 
             /** Gets whether this profiler is enabled */
-            bool getEnabled() const;
+            bool getEnabled() const { return mEnabled.load(std::memory_order_relaxed); }
 
             /** Enables a previously disabled profile 
             @remarks Can be safely called in the middle of the profile.
@@ -331,6 +396,31 @@ namespace Ogre {
             /** Outputs current profile statistics to the log */
             void logResults();
 
+            /** Starts recording the profiles of all threads for exportChromeTrace
+
+                Discards any previous capture. Only profiles that begin while the profiler is
+                enabled are captured.
+            */
+            void startCapture();
+
+            /** Stops recording, keeping the events captured so far
+
+                Call this from the thread that created the Profiler, as it gathers the
+                events that the threads recorded since the frame started.
+            */
+            void stopCapture();
+
+            /** Whether profiles are being captured */
+            bool isCapturing() const { return mCapturing; }
+
+            /** Writes the captured profiles in the Chrome trace event format
+
+                The result can be opened with chrome://tracing or the Perfetto UI. The thread
+                that created the Profiler is named "Main", the others by the order they first
+                recorded a profile.
+            */
+            void exportChromeTrace(std::ostream& stream) const;
+
             /** Clears the profiler statistics */
             void reset();
 
@@ -363,6 +453,7 @@ namespace Ogre {
 
         private:
             friend class ProfileInstance;
+            friend class Profile;
 
             typedef std::vector<ProfileSessionListener*> TProfileSessionListener;
             TProfileSessionListener mListeners;
@@ -380,14 +471,47 @@ namespace Ogre {
             /** Handles a change of the profiler's enabled state*/
             void changeEnableState();
 
+            /// A profile beginning or ending on a thread
+            struct Event
+            {
+                uint64 time;
+                uint32 nameID;
+                uint32 groupID;
+                /// index of the thread in mThreadEvents
+                uint32 thread;
+                bool begin;
+            };
+            struct ThreadEvents;
+
+            /// the events of the calling thread, which are created on first use
+            ThreadEvents* getThreadEvents();
+            /// moves the events recorded by the threads into the hierarchy and the capture
+            void processEvents();
+            /// drops the recorded events and the open profiles of all threads
+            void discardEvents();
+
             // lol. Uses typedef; put's original container type in name.
             typedef std::set<String> DisabledProfileMap;
             typedef ProfileInstance::ProfileChildren ProfileChildren;
 
-            ProfileInstance* mCurrent;
-            ProfileInstance* mLast;
             ProfileInstance mRoot;
 
+            /// The events of each thread that recorded a profile
+            std::vector<ThreadEvents*> mThreadEvents;
+            OGRE_WQ_MUTEX(mThreadEventsMutex);
+            /// Tells the threads to drop their open profiles, when it differs from theirs
+            std::atomic<uint32> mGeneration;
+            /// Tells the threads whether their events belong to this profiler
+            uint32 mSerial;
+            std::thread::id mMainThread;
+
+            /// Whether the last events were from profiles that began before the profiler was enabled
+            bool mDiscardFrame;
+
+            /// The captured events, in the order they were gathered per thread
+            std::vector<Event> mCapture;
+            bool mCapturing;
+
             /// Holds the names of disabled profiles
             DisabledProfileMap mDisabledProfiles;
 
@@ -408,14 +532,14 @@ namespace Ogre {
             ulong mTotalFrameTime;
 
             /// Whether this profiler is enabled
-            bool mEnabled;
+            std::atomic<bool> mEnabled;
 
             /// Keeps track of the new enabled/disabled state that the user has requested
             /// which will be applied after the frame ends
-            bool mNewEnableState;
+            std::atomic<bool> mNewEnableState;
 
             /// Mask to decide whether a type of profile is enabled or not
-            uint32 mProfileMask;
+            std::atomic<uint32> mProfileMask;
 
             /// The max frame time recorded
             ulong mMaxTotalFrameTime;
@@ -442,18 +566,54 @@ namespace Ogre {
 
     public:
         Profile(const String& profileName, uint32 groupID = (uint32)OGREPROF_USER_DEFAULT)
-            : mName(profileName), mGroupID(groupID)
+            : mProfiler(Profiler::getSingleton()), mNameID(0), mGroupID(groupID)
+        {
+            if (mProfiler.getEnabled())
+            {
+                mNameID = Profiler::getNameID(profileName);
+                mProfiler.beginProfile(mNameID, groupID);
+            }
+        }
+        /// the name is only looked up while the profiler is enabled, using the cache of the call site
+        template <typename T>
+        Profile(ProfileName& cache, T&& profileName, uint32 groupID)
+            : mProfiler(Profiler::getSingleton()), mNameID(0), mGroupID(groupID)
+        {
+            if (mProfiler.getEnabled())
+            {
+                mNameID = cache.getID(std::forward<T>(profileName));
+                mProfiler.beginProfile(mNameID, groupID);
+            }
+        }
+        ~Profile()
         {
-            Profiler::getSingleton().beginProfile(profileName, groupID);
+            // ending a profile is also where a requested change of the enabled state applies
+            if (mNameID || mProfiler.mNewEnableState.load(std::memory_order_relaxed) != mProfiler.getEnabled())
+                mProfiler.endProfile(mNameID, mGroupID);
         }
-        ~Profile() { Profiler::getSingleton().endProfile(mName, mGroupID); }
 
     private:
-        /// The name of this profile
-        String mName;
+        Profiler& mProfiler;
+        /// The id of the name of this profile, 0 if it was not begun
+        uint32 mNameID;
         /// The group ID
         uint32 mGroupID;
     };
+    inline uint32 ProfileName::getID(const char* profileName, std::true_type)
+    {
+        uint32 id = mID.load(std::memory_order_relaxed);
+        if (!id)
+        {
+            id = Profiler::getNameID(profileName);
+            mID.store(id, std::memory_order_relaxed);
+        }
+        return id;
+    }
+    inline uint32 ProfileName::getID(const String& profileName, std::false_type)
+    {
+        return Profiler::getNameID(profileName);
+    }
+
     /** @} */
     /** @} */
 
@@ -140,8 +140,12 @@ namespace Ogre {
         bool mSplitPassesByLightingType;
         bool mSplitNoShadowPasses;
         bool mShadowCastersCannotBeReceivers;
+        bool mSortSolidsFrontToBack;
 
         RenderableListener* mRenderableListener;
+
+        /// apply the default organisation mode to a group
+        void defaultOrganisationMode(uint8 qid);
     public:
         RenderQueue();
         virtual ~RenderQueue();
@@ -275,6 +279,27 @@ namespace Ogre {
         */
         bool getShadowCastersCannotBeReceivers(void) const;
 
+        /** Sets whether solid objects are rendered sorted front to back instead of grouped by pass
+
+            Drawing the closest opaque geometry first lets the depth test reject occluded fragments
+            early, which pays off on fill rate bound render systems and scenes with a lot of overdraw.
+            This comes at the cost of more render state changes.
+
+            Only affects the groups between #RENDER_QUEUE_SKIES_EARLY and #RENDER_QUEUE_SKIES_LATE,
+            as background, sky and overlay rendering relies on submission order.
+        */
+        void setSortSolidsFrontToBack(bool sort);
+
+        /// @copydoc setSortSolidsFrontToBack
+        bool getSortSolidsFrontToBack(void) const { return mSortSolidsFrontToBack; }
+
+        /** Reset the organisation mode of all groups to the default
+
+            This is grouping by pass, or sorting front to back where requested by setSortSolidsFrontToBack.
+            Settings made directly on the groups are discarded.
+        */
+        void defaultOrganisationMode(void);
+
         /** Set a renderable listener on the queue.
 
             There can only be a single renderable listener on the queue, since
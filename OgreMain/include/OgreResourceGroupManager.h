@@ -281,7 +281,7 @@ namespace Ogre {
         ResourceLoadingListener *mLoadingListener;
 
         /// Resource index entry, resourcename->location 
-        typedef std::map<String, Archive*> ResourceLocationIndex;
+        typedef std::unordered_map<String, Archive*> ResourceLocationIndex;
 
         /// List of resources which can be loaded / unloaded
         typedef std::list<ResourcePtr> LoadUnloadResourceList;
@@ -332,6 +332,30 @@ namespace Ogre {
         typedef std::map<String, ResourceGroup*> ResourceGroupMap;
         ResourceGroupMap mResourceGroupMap;
 
+        /// Resource index entry across all groups
+        struct GlobalResourceLocation
+        {
+            Archive* archive;
+            ResourceGroup* group;
+            /// position of the group in mResourceGroupMap
+            size_t groupOrder;
+        };
+        typedef std::unordered_map<String, GlobalResourceLocation> GlobalResourceLocationIndex;
+        /** Index of the resources of all groups, rebuilt on lookup after mIndexGeneration changed
+
+            Where several groups contain a resource, the first group in mResourceGroupMap order wins.
+            Within a group, the group index already resolved the location order. A lookup compares the
+            group order of the case sensitive and insensitive hits, so the group order still comes first.
+        */
+        mutable GlobalResourceLocationIndex mGlobalIndexCaseSensitive;
+#if !OGRE_RESOURCEMANAGER_STRICT
+        mutable GlobalResourceLocationIndex mGlobalIndexCaseInsensitive;
+#endif
+        /// Incremented whenever a group or a group index changes
+        std::atomic<uint32> mIndexGeneration;
+        /// Value of mIndexGeneration the global index was built from
+        mutable uint32 mGlobalIndexGeneration;
+
         /// Group name for world resources
         String mWorldGroupName;
 
@@ -357,6 +381,8 @@ namespace Ogre {
         /// Internal find method for auto groups
         std::pair<Archive*, ResourceGroup*>
         resourceExistsInAnyGroupImpl(const String& filename) const;
+        /// Rebuild the global index if a group changed since it was built, assumes the mutex is locked
+        void updateGlobalIndex() const;
         /// Internal event firing method
         void fireResourceGroupScriptingStarted(const String& groupName, size_t scriptCount) const;
         /// Internal event firing method
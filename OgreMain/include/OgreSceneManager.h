@@ -93,6 +93,8 @@ namespace Ogre {
     struct EntityMeshLodChangedEvent;
     struct EntityMaterialLodChangedEvent;
     class ShadowCasterSceneQueryListener;
+    class SoftwareVertexBlendQueue;
+    class TransformStore;
 
     /** Structure collecting together information about the visible objects
     that have been discovered in a scene.
@@ -759,6 +761,9 @@ namespace Ogre {
         /** Updates all instance managaers with dirty instance batches. @see _addDirtyInstanceManager */
         void updateDirtyInstanceManagers(void);
 
+        /// Evaluates the skeletons of all animated entities in parallel, see setParallelSkeletonAnimation
+        void evaluateSkeletons(void);
+
         void _destroySceneNode(SceneNodeList::iterator it);
 
         struct _OgreExport ShadowRenderer
@@ -981,6 +986,40 @@ namespace Ogre {
         uint32 mVisibilityMask;
         bool mFindVisibleObjects;
 
+        /// depth at which the scene graph update is split into parallel tasks, 0 if disabled
+        uint16 mParallelUpdateDepth;
+        /// scratch lists of the parallel scene graph update
+        std::vector<SceneNode*> mUpdatedTopLevelNodes;
+        std::vector<std::pair<SceneNode*, bool> > mUpdateSubtrees;
+        /// instance batches whose bounds got dirty while updating each of mUpdateSubtrees
+        std::vector<std::vector<InstanceBatch*> > mDirtyBatchesOfSubtrees;
+        /// node and object listener calls made while updating each of mUpdateSubtrees
+        std::vector<std::vector<std::function<void()> > > mListenerCallsOfSubtrees;
+        /// depth at which the culling in _findVisibleObjects is split into parallel tasks, 0 if disabled
+        uint16 mParallelCullingDepth;
+        /// scratch lists of the parallel culling
+        std::vector<SceneNode*> mVisibleTopLevelNodes;
+        std::vector<SceneNode*> mCullSubtrees;
+        /// visible nodes of each of mCullSubtrees, in the order of the recursive traversal
+        std::vector<std::vector<SceneNode*> > mVisibleSubtreeNodes;
+        /// backs the transforms of the nodes in the scene graph, if enabled
+        std::unique_ptr<TransformStore> mTransformStore;
+        /// whether the layout of mTransformStore no longer matches the scene graph
+        bool mTransformStoreDirty;
+        /// whether the derived transforms in mTransformStore are current, only during _updateSceneGraph
+        bool mTransformStoreUpdated;
+        /// assign store entries to the nodes of the scene graph, parents first
+        void rebuildTransformStore();
+        /// whether software skinning is collected while finding the visible objects
+        bool mParallelSoftwareAnimation;
+        /// blends collected by the visible entities, only set while finding the visible objects
+        std::unique_ptr<SoftwareVertexBlendQueue> mSoftwareVertexBlendQueue;
+        bool mCollectSoftwareVertexBlends;
+        /// whether the skeletons are evaluated in parallel once per frame
+        bool mParallelSkeletonAnimation;
+        /// scratch list of the parallel skeleton evaluation
+        std::vector<Entity*> mEvaluatedEntities;
+
         /// The active renderable visitor class - subclasses could override this
         SceneMgrQueuedRenderableVisitor* mActiveQueuedRenderableVisitor;
         /// Storage for default renderable visitor
@@ -1775,6 +1814,14 @@ namespace Ogre {
         */
         virtual void _findVisibleObjects(Camera* cam, VisibleObjectsBoundsInfo* visibleBounds, bool onlyShadowCasters);
 
+        /** Internal method calling _findVisibleObjects, as done by _renderScene
+
+            With setParallelSoftwareAnimation, the visible entities queue their software skinning meanwhile,
+            which is performed once all objects are found.
+        */
+        void _findVisibleObjectsAndBlend(Camera* cam, VisibleObjectsBoundsInfo* visibleBounds,
+                                         bool onlyShadowCasters);
+
         /** Internal method for issuing the render operation.*/
         void _issueRenderOp(Renderable* rend, const Pass* pass);
 
@@ -3219,6 +3266,122 @@ namespace Ogre {
         */
         bool getFindVisibleObjects(void) { return mFindVisibleObjects; }
 
+        /** Sets the depth below the root node at which the scene graph update is split into parallel tasks
+
+            The levels above are processed on the calling thread. The subtrees starting at this depth are then
+            distributed over the WorkQueue workers, and finally the results are merged in a fixed order, so
+            they are identical to the serial traversal.
+
+            Listeners of nodes and movable objects inside the subtrees are called on the calling thread
+            once all subtrees are updated, in the order of the serial traversal, so they need not be thread
+            safe. Only scene managers that return true from supportsParallelUpdate accept a depth other
+            than 0, others log a warning and keep the serial traversal.
+
+            Choose a depth that yields many independent subtrees of similar size.
+            @param depth 0 processes the whole graph on the calling thread, which is the default
+            @see setParallelCullingDepth
+        */
+        void setParallelUpdateDepth(uint16 depth);
+
+        /// @copydoc setParallelUpdateDepth
+        uint16 getParallelUpdateDepth(void) const { return mParallelUpdateDepth; }
+
+        /** Sets the depth below the root node at which the culling in _findVisibleObjects is split into parallel tasks
+
+            The levels above are tested on the calling thread. Within the subtrees starting at this depth,
+            the workers test the node bounds. Like the serial traversal, all objects attached to a visible
+            node are then added to the RenderQueue, including their camera and LOD notifications. This
+            happens on the calling thread in the order of the serial traversal, so the results are identical.
+
+            Like setParallelUpdateDepth, this is only accepted by scene managers that return true from
+            supportsParallelUpdate.
+            @param depth 0 culls the whole graph on the calling thread, which is the default
+        */
+        void setParallelCullingDepth(uint16 depth);
+
+        /// @copydoc setParallelCullingDepth
+        uint16 getParallelCullingDepth(void) const { return mParallelCullingDepth; }
+
+        /** Whether the scene graph update and culling may be split into parallel tasks
+
+            Subclasses opt in when their scene nodes only modify their own state in _update and
+            _updateBounds, apart from the instance batches marked dirty by moved InstancedEntity(s),
+            which are collected per subtree and passed on after the update. The octree and portal scene
+            managers do not, as their nodes move between shared octants and zones while updating.
+        */
+        virtual bool supportsParallelUpdate() const { return false; }
+
+        /** Sets whether the nodes of the scene graph are backed by a TransformStore
+
+            Each SceneNode attached to the root then refers to an entry of a TransformStore owned by this
+            SceneManager, which receives its local transform whenever it changes. _updateSceneGraph computes
+            the derived transforms of all entries in one linear sweep, so the traversal only copies them
+            to the nodes before updating their bounds. The SceneNode API is unchanged.
+
+            Nodes outside the scene graph, and nodes queried outside of _updateSceneGraph, compute their
+            derived transforms as usual. The entries are reassigned in breadth first order whenever the
+            hierarchy changes, and the traversal still visits every changed node, so measure the benefit
+            for a given scene before enabling this.
+
+            Not available if OGRE_NODE_INHERIT_TRANSFORM is enabled.
+        */
+        void setUseTransformStore(bool enabled);
+
+        /// @copydoc setUseTransformStore
+        bool getUseTransformStore(void) const { return mTransformStore != nullptr; }
+
+        /// Internal method to write the local transform of a node to its TransformStore entry
+        void _notifyLocalTransformChanged(const SceneNode* node);
+
+        /// Internal method to notify the SceneManager that a node was attached or detached
+        void _notifySceneGraphChanged(void);
+
+        /// Internal method returning the TransformStore, if it holds the current derived transforms
+        const TransformStore* _getUpdatedTransformStore(void) const
+        {
+            return mTransformStoreUpdated ? mTransformStore.get() : NULL;
+        }
+
+        /** Sets whether software skinning of the visible entities is performed in parallel
+
+            While finding the visible objects, animated entities only prepare their software skinning. The
+            blends are then performed on the WorkQueue workers once all objects are found, before the
+            post find visible objects listeners are called. Morph and pose animation are still applied
+            immediately, as skinning may depend on them.
+
+            Objects must therefore not read the software skinned vertex data of entities in
+            _updateRenderQueue.
+        */
+        void setParallelSoftwareAnimation(bool enabled) { mParallelSoftwareAnimation = enabled; }
+
+        /// @copydoc setParallelSoftwareAnimation
+        bool getParallelSoftwareAnimation(void) const { return mParallelSoftwareAnimation; }
+
+        /** Sets whether the skeletons of animated entities are evaluated in parallel
+
+            Once per frame, before the scene graph is updated, the skeletons of the entities with dirty
+            animation that were rendered in the previous frame are evaluated on the WorkQueue workers. This
+            blends the animations and computes the bone matrices without the Node update of each bone, see
+            Skeleton::_evaluateBoneMatrices. The matrices are then used as they are for hardware or
+            software skinning.
+
+            As this happens before culling, entities that were not rendered in the previous frame, like
+            the ones coming into view, are animated serially once they are rendered. Skeletons with a
+            Node::Listener on any bone are animated serially as well, so the listener gets its callbacks.
+            Animations must not be modified by AnimationTrack::Listener callbacks, which are called from the
+            worker threads.
+        */
+        void setParallelSkeletonAnimation(bool enabled) { mParallelSkeletonAnimation = enabled; }
+
+        /// @copydoc setParallelSkeletonAnimation
+        bool getParallelSkeletonAnimation(void) const { return mParallelSkeletonAnimation; }
+
+        /// Gets the queue collecting software vertex blends, NULL if they are to be performed immediately
+        SoftwareVertexBlendQueue* _getSoftwareVertexBlendQueue(void) const
+        {
+            return mCollectSoftwareVertexBlends ? mSoftwareVertexBlendQueue.get() : NULL;
+        }
+
         /** Set whether to automatically flip the culling mode on objects whenever they
             are negatively scaled.
 
@@ -81,6 +81,9 @@ namespace Ogre {
         */
         size_t mGlobalIndex;
 
+        /// Index in the TransformStore of our creator, if it backs this node, see SceneManager::setUseTransformStore
+        uint32 mTransformStoreIndex;
+
         /// World-Axis aligned bounding box, updated only through _update
         AxisAlignedBox mWorldAABB;
 
@@ -194,6 +197,34 @@ namespace Ogre {
         */
         void _update(bool updateChildren, bool parentHasChanged) override;
 
+        /** See Node, also updates the TransformStore entry backing this node */
+        void needUpdate(bool forceParentUpdate = false) override;
+
+        /// subtree roots with their parentHasChanged flag, as collected by _updateTopLevels
+        typedef std::vector<std::pair<SceneNode*, bool> > SubtreeList;
+
+        /** Internal method to update only the upper levels of the tree
+
+            Updates the transforms of this node and of the relevant children down to @c depth levels
+            below it, like _update would. The relevant children below that are not updated, but added
+            to @c subtrees, so they can be updated independently by calling _update on each.
+            @param depth number of levels to update below this node
+            @param parentHasChanged see _update
+            @param updated receives the updated nodes in top down order. Once the subtrees are done,
+                _updateBounds must be called on these in reverse order.
+            @param subtrees receives the roots of the subtrees that still need an update
+        */
+        void _updateTopLevels(uint16 depth, bool parentHasChanged, std::vector<SceneNode*>& updated,
+                              SubtreeList& subtrees);
+
+        /** Counts the nodes updated on this thread instead of adding each to FrameCounters::NODES_UPDATED
+
+            Used while the scene graph is updated in parallel, so the workers do not contend for the
+            counter. The caller then adds the count once.
+            @param count where to count, NULL to add to the FrameCounters directly again
+        */
+        static void _setDeferredUpdateCount(uint64* count);
+
         /** Tells the SceneNode to update the world bound info it stores.
         */
         virtual void _updateBounds(void);
@@ -221,6 +252,19 @@ namespace Ogre {
             VisibleObjectsBoundsInfo* visibleBounds, 
             bool includeChildren = true, bool displayNodes = false, bool onlyShadowCasters = false);
 
+        /** Internal method to collect the nodes whose bounds are visible to the camera
+
+            Only tests the node bounds, in the order _findVisibleObjects would visit them. Does not modify
+            any state, so disjoint subtrees can be processed concurrently.
+            @param cam the camera. Its frustum must be up to date.
+            @param depth children this many levels below this node are appended to @c visible and
+                @c subtrees without being tested. 0 visits the whole tree.
+            @param visible receives the visible nodes
+            @param subtrees receives the untested subtree roots
+        */
+        void _findVisibleNodes(const Camera* cam, uint16 depth, std::vector<SceneNode*>& visible,
+                               std::vector<SceneNode*>& subtrees);
+
         /** Gets the axis-aligned bounding box of this node (and hence all subnodes).
 
             Recommended only if you are extending a SceneManager, because the bounding box returned
@@ -53,6 +53,8 @@ namespace Ogre {
     };
     
     struct LinkedSkeletonAnimationSource;
+    class AnimationEvaluationCache;
+    struct AnimationPose;
 
     /** A collection of Bone objects used to animate a skinned mesh.
 
@@ -274,6 +276,25 @@ namespace Ogre {
         */
         virtual void _getBoneMatrices(Affine3* pMatrices);
 
+        /** Applies the animations and populates the bone matrices in one pass.
+
+            Same result as setAnimationState followed by _getBoneMatrices, but the local transforms
+            are blended into contiguous arrays and the derived ones are computed by a TransformStore,
+            instead of going through Node::translate, Node::rotate and Node::_update for each bone. The
+            bones are updated afterwards, so their derived transforms can still be queried.
+
+            Internal use only. Several skeletons may be evaluated in parallel once
+            _prepareAnimations was called on the calling thread, but Node::Listener callbacks of the
+            bones are not made.
+        */
+        void _evaluateBoneMatrices(const AnimationStateSet& animSet, Affine3* pMatrices);
+
+        /** Builds the data of the enabled animations that is otherwise computed on first use.
+
+            Internal use only. Must be called before _evaluateBoneMatrices runs on a worker thread.
+        */
+        void _prepareAnimations(const AnimationStateSet& animSet);
+
         unsigned short getNumAnimations(void) const override;
 
         /** Gets a single animation by index. 
@@ -289,6 +310,25 @@ namespace Ogre {
         /** Sets the animation blending mode this skeleton will use. */
         virtual void setBlendMode(SkeletonAnimationBlendMode state);
 
+        /** Share the evaluated animations between the instances of this skeleton.
+
+            When many instances play the same animation at the same time, the keyframes of each track
+            are looked up and interpolated only once per frame and the result is reused by all of them.
+            Only the weighting and blending is done per instance. Track listeners are then called once
+            per shared evaluation, so their result must not depend on the instance.
+        @param enabled Whether to use the cache
+        @param timeQuantum The time positions are rounded to a multiple of this before evaluating,
+            so instances at nearby times share the pose as well. 0 only shares identical times.
+        */
+        virtual void setAnimationCache(bool enabled, Real timeQuantum = 0);
+        /// Whether the evaluated animations are shared, see setAnimationCache
+        bool getAnimationCacheEnabled(void) const { return _getAnimationCache() != NULL; }
+        /// The time quantum of the animation cache, see setAnimationCache
+        Real getAnimationCacheQuantum(void) const;
+
+        /// Internal accessor for the animation cache, which is shared with the instances
+        virtual AnimationEvaluationCache* _getAnimationCache(void) const { return mAnimationCache.get(); }
+
         /// Updates all the derived transforms in the skeleton
         virtual void _updateTransforms(void);
 
@@ -299,6 +339,12 @@ namespace Ogre {
         */
         virtual void optimiseAllAnimations(bool preservingIdentityNodeTracks = false);
 
+        /** Compress the node tracks of all of this skeleton's animations.
+        @see NodeAnimationTrack::compress
+        */
+        void compressAllAnimations(Real translateTolerance = 1e-3f, const Radian& rotateTolerance = Radian(1e-3f),
+                                   Real scaleTolerance = 1e-3f);
+
         /** Allows you to use the animations from another Skeleton object to animate
             this skeleton.
 
@@ -439,6 +485,22 @@ namespace Ogre {
         bool mManualBonesDirty;
         /// Storage of bones, indexed by bone handle
         BoneList mBoneList;
+        /// Evaluated animations shared by the instances, see setAnimationCache
+        std::unique_ptr<AnimationEvaluationCache> mAnimationCache;
+
+        /// Scratch arrays of _evaluateBoneMatrices
+        struct PoseEvaluation;
+        std::unique_ptr<PoseEvaluation> mPoseEvaluation;
+
+        /// Like Animation::apply, using the evaluated tracks of pose
+        void applyAnimationPose(const AnimationPose& pose, Real weight,
+                                const AnimationState::BoneBlendMask* blendMask, Real scale);
+        /// Like applyAnimationPose, on the local transform arrays of eval
+        void applyAnimationPose(const AnimationPose& pose, Real weight,
+                                const AnimationState::BoneBlendMask* blendMask, Real scale,
+                                PoseEvaluation& eval) const;
+        /// The factor applied to all weights, for ANIMBLEND_AVERAGE
+        Real getAnimationWeightFactor(const AnimationStateSet& animSet) const;
 
         /** Internal method which parses the bones to derive the root bone. 
 
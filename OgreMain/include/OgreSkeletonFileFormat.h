@@ -101,6 +101,20 @@ namespace Ogre {
                     // Quaternion rotate            : Rotation to apply at this keyframe
                     // Vector3 translate            : Translation to apply at this keyframe
                     // Vector3 scale                : Scale to apply at this keyframe
+                SKELETON_ANIMATION_TRACK_COMPRESSED = 0x4120,
+                // [Optional] The keys in compressed form, instead of the keyframes
+                // see NodeAnimationTrack::compress, only written for SKELETON_VERSION_1_9 and later
+                    // float timeScale              : key time units per second
+                    // unsigned short animated      : channels with keys, 1 translate, 2 rotate, 4 scale
+                    //                                8 if rotations are blended in encoded form
+                    // unsigned int numKeys
+                    // Vector3 translateBase        : constant value or minimum
+                    // Vector3 translateStep        : translation per quantisation step
+                    // Quaternion rotation          : constant rotation
+                    // Vector3 scaleBase
+                    // Vector3 scaleStep
+                    // unsigned short times[numKeys]
+                    // unsigned short values[numKeys * 3 * number of animated channels]
         SKELETON_ANIMATION_LINK         = 0x5000
         // Link to another skeleton, to re-use its animations
 
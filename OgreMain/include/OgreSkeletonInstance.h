@@ -105,6 +105,10 @@ namespace Ogre {
         OGRE_DEPRECATED LinkedSkeletonAnimSourceIterator
             getLinkedSkeletonAnimationSourceIterator(void) const override;
 
+        /// @copydoc Skeleton::setAnimationCache
+        void setAnimationCache(bool enabled, Real timeQuantum = 0) override;
+        AnimationEvaluationCache* _getAnimationCache(void) const override;
+
         /// @copydoc Skeleton::_initAnimationState
         void _initAnimationState(AnimationStateSet* animSet) override;
 
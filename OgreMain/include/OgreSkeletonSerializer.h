@@ -35,6 +35,7 @@ THE SOFTWARE.
 namespace Ogre {
 
     struct LinkedSkeletonAnimationSource;
+    struct CompressedTransformTrack;
 
     /// Skeleton compatibility versions
     enum SkeletonVersion 
@@ -43,6 +44,8 @@ namespace Ogre {
         SKELETON_VERSION_1_0,
         /// OGRE version v1.8+
         SKELETON_VERSION_1_8,
+        /// OGRE version v1.9+, compressed animation tracks
+        SKELETON_VERSION_1_9,
         
         /// Latest version available
         SKELETON_VERSION_LATEST = 100
@@ -115,7 +118,8 @@ namespace Ogre {
         void writeBone(const Skeleton* pSkel, const Bone* pBone);
         void writeBoneParent(const Skeleton* pSkel, unsigned short boneId, unsigned short parentId);
         void writeAnimation(const Skeleton* pSkel, const Animation* anim, SkeletonVersion ver);
-        void writeAnimationTrack(const Skeleton* pSkel, const NodeAnimationTrack* track);
+        void writeAnimationTrack(const Skeleton* pSkel, const NodeAnimationTrack* track, SkeletonVersion ver);
+        void writeCompressedKeys(const CompressedTransformTrack* keys);
         void writeKeyFrame(const Skeleton* pSkel, const TransformKeyFrame* key);
         void writeSkeletonAnimationLink(const Skeleton* pSkel, 
             const LinkedSkeletonAnimationSource& link);
@@ -127,13 +131,15 @@ namespace Ogre {
         void readAnimation(DataStreamPtr& stream, Skeleton* pSkel);
         void readAnimationTrack(DataStreamPtr& stream, Animation* anim, Skeleton* pSkel);
         void readKeyFrame(DataStreamPtr& stream, NodeAnimationTrack* track, Skeleton* pSkel);
+        void readCompressedKeys(DataStreamPtr& stream, NodeAnimationTrack* track);
         void readSkeletonAnimationLink(DataStreamPtr& stream, Skeleton* pSkel);
 
         size_t calcBoneSize(const Skeleton* pSkel, const Bone* pBone);
         size_t calcBoneSizeWithoutScale(const Skeleton* pSkel, const Bone* pBone);
         size_t calcBoneParentSize(const Skeleton* pSkel);
         size_t calcAnimationSize(const Skeleton* pSkel, const Animation* pAnim, SkeletonVersion ver);
-        size_t calcAnimationTrackSize(const Skeleton* pSkel, const NodeAnimationTrack* pTrack);
+        size_t calcAnimationTrackSize(const Skeleton* pSkel, const NodeAnimationTrack* pTrack, SkeletonVersion ver);
+        size_t calcCompressedKeysSize(const CompressedTransformTrack* keys);
         size_t calcKeyFrameSize(const Skeleton* pSkel, const TransformKeyFrame* pKey);
         size_t calcKeyFrameSizeWithoutScale(const Skeleton* pSkel, const TransformKeyFrame* pKey);
         size_t calcSkeletonAnimationLinkSize(const Skeleton* pSkel, 
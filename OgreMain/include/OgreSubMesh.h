@@ -61,6 +61,7 @@ namespace Ogre {
     {
         friend class Mesh;
         friend class MeshSerializerImpl;
+        friend class MeshSerializerImpl_v1_10;
         friend class MeshSerializerImpl_v1_2;
         friend class MeshSerializerImpl_v1_1;
     public:
@@ -242,6 +243,9 @@ namespace Ogre {
 
         VertexBoneAssignmentList mBoneAssignments;
 
+        /// The bone assignments as read from a .mesh file, valid until the assignments are changed
+        PackedBoneAssignments mPackedBoneAssignments;
+
         /// Internal method for removing LOD data
         void removeLodLevels(void);
 
@@ -0,0 +1,141 @@
+// This file is part of the OGRE project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at https://www.ogre3d.org/licensing.
+// SPDX-License-Identifier: MIT
+#ifndef __TransformStore_H__
+#define __TransformStore_H__
+
+#include "OgrePrerequisites.h"
+#include "OgreQuaternion.h"
+#include "OgreVector.h"
+#include "OgreMatrix4.h"
+#include "OgreHeaderPrefix.h"
+
+namespace Ogre
+{
+    /** \addtogroup Core
+    *  @{
+    */
+    /** \addtogroup Scene
+    *  @{
+    */
+    /** Contiguous storage of node transforms for large hierarchies
+
+        Stores the local and derived position, orientation and scale of each entry in separate arrays, together
+        with the index of its parent. Entries are referenced by their index and a parent must be added before
+        its children, so the derived transforms of all entries are computed by a single linear sweep, four
+        entries at a time where SIMD is available.
+
+        The results match those of a Node hierarchy with the same local transforms and inheritance settings,
+        unless OGRE_NODE_INHERIT_TRANSFORM is enabled.
+        Unlike Node, there are no listeners, attached objects or partial updates, which makes this suitable
+        for many animated transforms that are consumed in bulk, e.g. by instancing.
+        SceneManager::setUseTransformStore backs the scene nodes of a SceneManager by such a store.
+    */
+    class _OgreExport TransformStore : public NodeAlloc
+    {
+    public:
+        /// parent index of root entries
+        static const uint32 NO_PARENT = 0xFFFFFFFF;
+
+        TransformStore();
+
+        /** add a new entry
+            @param parent index of an existing entry or NO_PARENT
+            @return index of the new entry
+        */
+        uint32 add(uint32 parent, const Vector3& position = Vector3::ZERO,
+                   const Quaternion& orientation = Quaternion::IDENTITY, const Vector3& scale = Vector3::UNIT_SCALE,
+                   bool inheritOrientation = true, bool inheritScale = true);
+
+        /// reserve storage for the given number of entries
+        void reserve(size_t count);
+        /// remove all entries
+        void clear();
+        size_t size() const { return mParents.size(); }
+
+        uint32 getParent(uint32 index) const { return mParents[index]; }
+
+        void setPosition(uint32 index, const Vector3& pos) { set(mPosition, index, pos); }
+        Vector3 getPosition(uint32 index) const { return get(mPosition, index); }
+        void setOrientation(uint32 index, const Quaternion& q)
+        {
+            OgreAssertDbg(!q.isNaN(), "Invalid orientation supplied as parameter");
+            set(mOrientation, index, q);
+        }
+        Quaternion getOrientation(uint32 index) const { return get(mOrientation, index); }
+        void setScale(uint32 index, const Vector3& scale) { set(mScale, index, scale); }
+        Vector3 getScale(uint32 index) const { return get(mScale, index); }
+        /// set whether the entry inherits the orientation and scale of its parent
+        void setInheritance(uint32 index, bool inheritOrientation, bool inheritScale);
+
+        /// recompute the derived transforms of all entries
+        void update();
+
+        /// derived values as of the last update()
+        Vector3 getDerivedPosition(uint32 index) const { return get(mDerivedPosition, index); }
+        /// @copydoc getDerivedPosition
+        Quaternion getDerivedOrientation(uint32 index) const { return get(mDerivedOrientation, index); }
+        /// @copydoc getDerivedPosition
+        Vector3 getDerivedScale(uint32 index) const { return get(mDerivedScale, index); }
+        /// full derived transform as of the last update()
+        Affine3 getTransform(uint32 index) const;
+        /// write the full derived transforms of all entries to dst, which must hold size() matrices
+        void getTransforms(Affine3* dst) const;
+
+    private:
+        struct Vector3Array
+        {
+            std::vector<Real> x, y, z;
+        };
+        struct QuaternionArray
+        {
+            std::vector<Real> w, x, y, z;
+        };
+
+        static void set(Vector3Array& dst, uint32 i, const Vector3& v)
+        {
+            dst.x[i] = v.x;
+            dst.y[i] = v.y;
+            dst.z[i] = v.z;
+        }
+        static void set(QuaternionArray& dst, uint32 i, const Quaternion& q)
+        {
+            dst.w[i] = q.w;
+            dst.x[i] = q.x;
+            dst.y[i] = q.y;
+            dst.z[i] = q.z;
+        }
+        static Vector3 get(const Vector3Array& src, uint32 i) { return Vector3(src.x[i], src.y[i], src.z[i]); }
+        static Quaternion get(const QuaternionArray& src, uint32 i)
+        {
+            return Quaternion(src.w[i], src.x[i], src.y[i], src.z[i]);
+        }
+
+        /// update a single entry, its parent must be up to date
+        void updateEntry(size_t i);
+        /// update four independent entries starting at i
+        void updateGroup(size_t i);
+
+        std::vector<uint32> mParents;
+        /// bit 0: inherit orientation, bit 1: inherit scale
+        std::vector<uint8> mFlags;
+
+        Vector3Array mPosition;
+        QuaternionArray mOrientation;
+        Vector3Array mScale;
+
+        Vector3Array mDerivedPosition;
+        QuaternionArray mDerivedOrientation;
+        Vector3Array mDerivedScale;
+
+        /// per group of four entries, whether all parents lie before the group, so its lanes are independent
+        std::vector<bool> mIndependentGroups;
+    };
+    /** @} */
+    /** @} */
+}
+
+#include "OgreHeaderSuffix.h"
+
+#endif
@@ -54,6 +54,21 @@ namespace Ogre
         float weight;
     };
 
+    /** Bone assignments of a vertex buffer, packed like the blend indices and weights buffer
+
+        Per vertex, there are 4 blend indices as bytes, then weightsPerVertex weights as floats.
+        Vertices without assignments use blend index 0 with weight 1. This is how the .mesh format
+        stores them, so they can be compiled without being rationalised again.
+    */
+    struct PackedBoneAssignments
+    {
+        std::vector<uchar> data;
+        /// Maps the blend indices to the bone indices
+        std::vector<unsigned short> blendIndexToBoneIndexMap;
+        unsigned short weightsPerVertex;
+        PackedBoneAssignments() : weightsPerVertex(0) {}
+    };
+
     /** @} */
     /** @} */
 
@@ -35,6 +35,7 @@ THE SOFTWARE.
 #include "Threading/OgreThreadHeaders.h"
 #include "OgreHeaderPrefix.h"
 
+#include <atomic>
 #include <deque>
 #include <functional>
 
@@ -136,6 +137,23 @@ namespace Ogre
             /// Return the response data (user defined, only valid on success)
             const Any& getData() const { return mData; }
         };
+        /** A set of tasks that can be waited for, see @ref waitForTasks
+
+            Tasks may add further tasks to their group while running, so a parent task can split up its
+            work into children and wait for them (fork-join). The group must outlive its tasks.
+        */
+        class TaskGroup
+        {
+        public:
+            TaskGroup() : mPending(0) {}
+            /// Whether all tasks added to the group have finished
+            bool isDone() const { return mPending.load(std::memory_order_acquire) == 0; }
+            /// @internal called when adding or finishing a task of the group
+            void _addPending(ptrdiff_t n) { mPending.fetch_add(n, std::memory_order_acq_rel); }
+        private:
+            std::atomic<ptrdiff_t> mPending;
+        };
+
         WorkQueue() {}
         virtual ~WorkQueue() {}
 
@@ -159,6 +177,74 @@ namespace Ogre
 
         /** Add a new task to the queue */
         virtual void addTask(std::function<void()> task) = 0;
+
+        /** Add a new task to the queue, that is part of group
+            @see waitForTasks
+        */
+        virtual void addTask(std::function<void()> task, TaskGroup& group);
+
+        /** Wait until all tasks of the group have finished
+
+            Implementations may process other tasks while waiting, so this can be called from within a task.
+        */
+        virtual void waitForTasks(const TaskGroup& group);
+
+        /** Run func(begin, end) over the range [0, count) split into chunks of at least grainSize elements
+
+            The chunks are processed by the workers and the calling thread, which only returns once all of
+            them are done. Chunks are handed out dynamically, so uneven workloads balance themselves.
+            Without thread support or workers everything runs on the calling thread.
+        */
+        template <typename Func> void parallelFor(size_t count, size_t grainSize, const Func& func)
+        {
+            parallelFor(this, count, grainSize, func);
+        }
+
+        /** As parallelFor, but runs everything on the calling thread if queue is NULL
+
+            For code that can also be used without a Root, e.g. by tools, which passes
+            `Root::getSingletonPtr() ? Root::getSingleton().getWorkQueue() : NULL`.
+        */
+        template <typename Func>
+        static void parallelFor(WorkQueue* queue, size_t count, size_t grainSize, const Func& func)
+        {
+            size_t workers = OGRE_THREAD_SUPPORT && queue ? queue->getWorkerThreadCount() : 0;
+            // a few chunks per thread to balance uneven workloads
+            size_t chunks = std::min(count / std::max<size_t>(grainSize, 1), (workers + 1) * 4);
+
+            if (chunks < 2)
+            {
+                if (count)
+                    func(size_t(0), count);
+                return;
+            }
+
+            struct State
+            {
+                std::atomic<size_t> next;
+                size_t chunks;
+                size_t count;
+                const Func* func;
+            } state;
+            state.next = 0;
+            state.chunks = chunks;
+            state.count = count;
+            state.func = &func;
+
+            // only captures a pointer, which fits into the small object buffer of std::function
+            auto work = [&state]() {
+                size_t chunk;
+                while ((chunk = state.next++) < state.chunks)
+                    (*state.func)(chunk * state.count / state.chunks, (chunk + 1) * state.count / state.chunks);
+            };
+
+            TaskGroup group;
+            for (size_t i = 0; i < std::min(workers, chunks - 1); i++)
+                queue->addTask(work, group);
+
+            work();
+            queue->waitForTasks(group);
+        }
         
         /** Set whether to pause further processing of any requests. 
         If true, any further requests will simply be queued and not processed until
@@ -216,6 +302,47 @@ namespace Ogre
         virtual void shutdown() = 0;
     };
 
+    /** Tasks with dependencies between them, run on a WorkQueue
+
+        A task starts once all the tasks it depends on have finished, so independent ones run in parallel.
+        The graph is kept after running, so it can be run again e.g. each frame.
+    */
+    class _OgreExport TaskGraph : public UtilityAlloc
+    {
+    public:
+        typedef size_t TaskID;
+
+        /** Add a task
+        @param task the work to do
+        @param dependencies tasks that have to finish before this one starts, they must be added before
+        */
+        TaskID addTask(std::function<void()> task, const std::vector<TaskID>& dependencies = {});
+
+        /** Run all tasks on the queue and wait for them to finish
+
+            Without thread support or a queue the tasks run in the order they were added.
+        */
+        void run(WorkQueue* queue);
+
+        size_t getTaskCount() const { return mTasks.size(); }
+
+        /// Remove all tasks
+        void clear() { mTasks.clear(); }
+
+    private:
+        struct Task
+        {
+            std::function<void()> func;
+            std::vector<TaskID> successors;
+            uint32 numDependencies;
+        };
+        struct RunState;
+
+        static void startTask(RunState* state, TaskID id);
+
+        std::vector<Task> mTasks;
+    };
+
     /** Base for a general purpose task-based background work queue.
     */
     class _OgreExport DefaultWorkQueueBase : public WorkQueue
@@ -287,26 +414,75 @@ namespace Ogre
         size_t getWorkerThreadCount() const override { return mWorkerThreadCount; }
         void setWorkerThreadCount(size_t c) override { mWorkerThreadCount = c; }
         void addMainThreadTask(std::function<void()> task) override;
+        /** @copydoc WorkQueue::addTask
+
+            Tasks added by a worker thread go to its own deque, where it takes the newest one first while
+            idle workers steal the oldest ones. Tasks from other threads go to a shared queue.
+        */
         void addTask(std::function<void()> task) override;
+        /** @copydoc WorkQueue::addTask(std::function<void()>, TaskGroup&)
+
+            Unlike other tasks, these run right away on the calling thread if requests are not accepted, as
+            someone is waiting for them.
+        */
+        void addTask(std::function<void()> task, TaskGroup& group) override;
+        /** @copydoc WorkQueue::waitForTasks
+
+            Only tasks of the group are processed meanwhile, so the wait does not stall behind unrelated
+            long running tasks.
+        */
+        void waitForTasks(const TaskGroup& group) override;
     protected:
+        struct Task;
+        class TaskDeque;
+
         String mName;
         size_t mWorkerThreadCount;
         bool mWorkerRenderSystemAccess;
         bool mIsRunning;
         unsigned long mResposeTimeLimitMS;
 
-        std::deque<std::function<void()>> mTasks;
+        /// tasks added by threads other than the workers, guarded by mRequestMutex
+        std::deque<Task*> mTasks;
         std::deque<std::function<void()>> mMainThreadTasks;
+        /// one per worker thread, created by createTaskDeques
+        std::vector<TaskDeque*> mTaskDeques;
+        std::atomic<size_t> mNextTaskDeque;
+        /// tasks in mTasks and mTaskDeques
+        std::atomic<size_t> mNumPendingTasks;
+        /// workers waiting for a task, see notifyWorkers
+        std::atomic<size_t> mNumSleepingWorkers;
 
         bool mPaused;
-        bool mAcceptRequests;
-        bool mShuttingDown;
+        /// read without the lock by addTask
+        std::atomic<bool> mAcceptRequests;
+        std::atomic<bool> mShuttingDown;
 
         OGRE_WQ_MUTEX(mRequestMutex);
         OGRE_WQ_MUTEX(mResponseMutex);
 
         /// Notify workers about a new request. 
         virtual void notifyWorkers() = 0;
+
+        /// Create a task deque for each worker thread, before starting them
+        void createTaskDeques();
+        /// Move tasks left in the deques to mTasks and destroy them, after the worker threads stopped
+        void destroyTaskDeques();
+        /// Assign a task deque to the calling worker thread
+        void registerWorkerThread();
+        /// Run the next task, if there is one
+        bool processNextTask();
+    private:
+        /// the deque of the calling thread, if it is a worker
+        static TaskDeque*& currentTaskDeque();
+        /// the deque of the calling thread, if it is a worker of this queue
+        TaskDeque* getWorkerTaskDeque() const;
+        void pushTask(Task* task);
+        Task* takeTask();
+        /// Take a task of the group, for a thread waiting for it
+        Task* takeGroupTask(const TaskGroup& group);
+        Task* createTask(std::function<void()>& func, TaskGroup* group);
+        void runTask(Task* task);
     };
 
 
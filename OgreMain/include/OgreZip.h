@@ -52,6 +52,9 @@ namespace Ogre {
 
         This archive format supports all archives compressed in the standard
         zip format, including iD pk3 files.
+
+        The central directory is read once on load. Entries are then inflated straight from the
+        archive contents, so they can be opened concurrently from several threads.
     */
     class _OgreExport ZipArchiveFactory : public ArchiveFactory
     {
@@ -65,6 +68,17 @@ namespace Ogre {
         //! @endcond
 
         Archive *createInstance( const String& name, bool readOnly ) override;
+
+        /** Set the uncompressed size from which deflated entries are inflated lazily
+
+            Such entries are opened as DeflateStream, which inflates on read instead of decompressing
+            the whole entry up front. These streams can only seek back to the start or within the
+            recently read data. 0 disables lazy inflation, which is the default.
+        */
+        static void setLazyInflateThreshold(size_t bytes);
+
+        /// Get the uncompressed size from which deflated entries are inflated lazily
+        static size_t getLazyInflateThreshold();
     };
 
     /** Specialisation of ZipArchiveFactory for embedded Zip files. */
@@ -616,6 +616,19 @@ namespace Ogre {
         return TimeIndex(timePos, static_cast<uint>(std::distance(mKeyFrameTimes.begin(), it)));
     }
     //-----------------------------------------------------------------------
+    void Animation::_prepareNodeTracks()
+    {
+        _applyBaseKeyFrame();
+
+        if (mKeyFrameTimesDirty)
+            buildKeyFrameTimeList();
+
+        for (auto& i : mNodeTrackList)
+        {
+            i.second->_prepareInterpolationSplines();
+        }
+    }
+    //-----------------------------------------------------------------------
     void Animation::buildKeyFrameTimeList(void) const
     {
         // Clear old keyframe times
@@ -0,0 +1,79 @@
+// This file is part of the OGRE project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at https://www.ogre3d.org/licensing.
+// SPDX-License-Identifier: MIT
+#ifndef __AnimationEvaluationCache_H__
+#define __AnimationEvaluationCache_H__
+
+#include "OgrePrerequisites.h"
+#include "OgreAnimation.h"
+
+#include <future>
+#include <memory>
+#include <unordered_map>
+
+namespace Ogre
+{
+    /** The node tracks of an Animation evaluated at one time, with one entry per track in each array */
+    struct AnimationPose
+    {
+        std::vector<unsigned short> handle;
+        std::vector<Vector3> translate;
+        std::vector<Quaternion> rotate;
+        std::vector<Vector3> scale;
+        std::vector<uint8> useShortestRotationPath;
+        Animation::RotationInterpolationMode rotationInterpolation;
+    };
+
+    /** Shares evaluated animations between the instances of a Skeleton, see Skeleton::setAnimationCache
+
+        The poses are dropped when the frame number changes, so changed keyframes show up the next frame.
+        Thread safe, so the instances may be animated in parallel. Poses are evaluated outside of the lock,
+        threads asking for a pose that is being evaluated wait for it instead of evaluating it again.
+    */
+    class AnimationEvaluationCache
+    {
+    public:
+        explicit AnimationEvaluationCache(Real timeQuantum) : mTimeQuantum(timeQuantum), mFrame(0) {}
+
+        /// Gets the pose of the animation at timePos, rounded to the time quantum
+        std::shared_ptr<const AnimationPose> getPose(Animation* anim, Real timePos);
+
+        Real getTimeQuantum() const { return mTimeQuantum; }
+
+        /// Evaluates the node tracks of the animation at timePos into pose, without caching
+        static void evaluate(Animation* anim, Real timePos, AnimationPose& pose);
+
+    private:
+        struct Key
+        {
+            Animation* animation;
+            Real timePos;
+            Animation::InterpolationMode interpolation;
+            Animation::RotationInterpolationMode rotationInterpolation;
+
+            bool operator==(const Key& o) const
+            {
+                return animation == o.animation && timePos == o.timePos && interpolation == o.interpolation &&
+                       rotationInterpolation == o.rotationInterpolation;
+            }
+        };
+        struct KeyHash
+        {
+            size_t operator()(const Key& k) const
+            {
+                size_t h = std::hash<Animation*>()(k.animation);
+                h ^= std::hash<Real>()(k.timePos) + 0x9e3779b9 + (h << 6) + (h >> 2);
+                return h ^ (size_t(k.interpolation) << 1) ^ (size_t(k.rotationInterpolation) << 2);
+            }
+        };
+
+        typedef std::shared_future<std::shared_ptr<const AnimationPose> > PoseFuture;
+        std::unordered_map<Key, PoseFuture, KeyHash> mPoses;
+        Real mTimeQuantum;
+        unsigned long mFrame;
+        OGRE_WQ_MUTEX(mMutex);
+    };
+}
+
+#endif
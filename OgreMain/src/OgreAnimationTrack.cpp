@@ -29,6 +29,7 @@ THE SOFTWARE.
 #include "OgreAnimationTrack.h"
 #include "OgreAnimation.h"
 #include "OgreKeyFrame.h"
+#include "OgreCompressedTransformTrack.h"
 
 namespace Ogre {
 
@@ -42,6 +43,13 @@ namespace Ogre {
             }
         };
     }
+
+    /// the linear blend of two quantised vectors
+    static Vector3 blendKeys(const uint16* a, const uint16* b, Real t)
+    {
+        return Vector3(a[0] + (Real(b[0]) - a[0]) * t, a[1] + (Real(b[1]) - a[1]) * t,
+                       a[2] + (Real(b[2]) - a[2]) * t);
+    }
     //---------------------------------------------------------------------
     //---------------------------------------------------------------------
     AnimationTrack::AnimationTrack(Animation* parent, unsigned short handle) :
@@ -189,12 +197,12 @@ namespace Ogre {
     //---------------------------------------------------------------------
     void AnimationTrack::_buildKeyFrameIndexMap(const std::vector<Real>& keyFrameTimes)
     {
-        // Pre-allocate memory
-        mKeyFrameIndexMap.resize(keyFrameTimes.size());
+        // Pre-allocate memory, tracks without keyframes need no map
+        mKeyFrameIndexMap.resize(mKeyFrames.empty() ? 0 : keyFrameTimes.size());
 
         size_t i = 0, j = 0;
 
-        while (j < keyFrameTimes.size())
+        while (j < mKeyFrameIndexMap.size())
         {
             mKeyFrameIndexMap[j] = static_cast<ushort>(i);
             while (i < (mKeyFrames.size() - 1) && mKeyFrames[i]->getTime() <= keyFrameTimes[j])
@@ -380,6 +388,12 @@ namespace Ogre {
 
         TransformKeyFrame* kret = static_cast<TransformKeyFrame*>(kf);
 
+        if (mCompressed)
+        {
+            getCompressedKeyFrame(timeIndex, kret);
+            return;
+        }
+
         // Keyframe pointers
         KeyFrame *kBase1, *kBase2;
         TransformKeyFrame *k1, *k2;
@@ -474,7 +488,7 @@ namespace Ogre {
         Real scl)
     {
         // Nothing to do if no keyframes or zero weight or no node
-        if (mKeyFrames.empty() || !weight || !node)
+        if ((mKeyFrames.empty() && !mCompressed) || !weight || !node)
             return;
 
         TransformKeyFrame kf(0, timeIndex.getTimePos());
@@ -512,6 +526,12 @@ namespace Ogre {
 
     }
     //---------------------------------------------------------------------
+    void NodeAnimationTrack::_prepareInterpolationSplines(void) const
+    {
+        if (mSplineBuildNeeded && mParent->getInterpolationMode() == Animation::IM_SPLINE)
+            buildInterpolationSplines();
+    }
+    //---------------------------------------------------------------------
     void NodeAnimationTrack::buildInterpolationSplines(void) const
     {
         // Allocate splines if not exists
@@ -532,6 +552,29 @@ namespace Ogre {
         splines->rotationSpline.clear();
         splines->scaleSpline.clear();
 
+        if (mCompressed)
+        {
+            // splines of the animated channels only
+            const CompressedTransformTrack& c = *mCompressed;
+            size_t stride = c.getStride();
+            for (size_t k = 0; k < c.times.size(); k++)
+            {
+                const uint16* v = &c.values[k * stride];
+                if (c.animated & CompressedTransformTrack::TRANSLATE)
+                {
+                    splines->positionSpline.addPoint(c.translateBase + c.translateStep * blendKeys(v, v, 0));
+                    v += 3;
+                }
+                if (c.animated & CompressedTransformTrack::ROTATE)
+                {
+                    splines->rotationSpline.addPoint(CompressedTransformTrack::decodeRotation(v));
+                    v += 3;
+                }
+                if (c.animated & CompressedTransformTrack::SCALE)
+                    splines->scaleSpline.addPoint(c.scaleBase + c.scaleStep * blendKeys(v, v, 0));
+            }
+        }
+
         for (auto *f : mKeyFrames)
         {
             TransformKeyFrame* kf = static_cast<TransformKeyFrame*>(f);
@@ -565,26 +608,173 @@ namespace Ogre {
         mSplineBuildNeeded = true;
     }
     //---------------------------------------------------------------------
-    bool NodeAnimationTrack::hasNonZeroKeyFrames(void) const
+    void NodeAnimationTrack::getCompressedKeyFrame(const TimeIndex& timeIndex, TransformKeyFrame* kf) const
+    {
+        const CompressedTransformTrack& c = *mCompressed;
+        if (!c.animated)
+        {
+            kf->setTranslate(c.translateBase);
+            kf->setRotation(c.rotation);
+            kf->setScale(c.scaleBase);
+            return;
+        }
+
+        Real timePos = timeIndex.getTimePos();
+        if (!timeIndex.hasKeyIndex())
+        {
+            // Wrap time, like getKeyFramesAtTime
+            Real totalAnimationLength = mParent->getLength();
+            if (timePos > totalAnimationLength && totalAnimationLength > 0.0f)
+                timePos = std::fmod(timePos, totalAnimationLength);
+        }
+
+        bool spline = mParent->getInterpolationMode() == Animation::IM_SPLINE;
+        if (spline && mSplineBuildNeeded)
+            buildInterpolationSplines();
+
+        // the key index map gives the key at or before the global key time
+        size_t hint = timeIndex.hasKeyIndex() && !mKeyFrameIndexMap.empty()
+                          ? mKeyFrameIndexMap[timeIndex.getKeyIndex()]
+                          : size_t(-1);
+        size_t key;
+        Real t = c.findKey(timePos, hint, key);
+        size_t stride = c.getStride();
+        const uint16* v = &c.values[key * stride];
+        // blending with the same key if there is no next one
+        const uint16* next = t > 0 ? v + stride : v;
+        spline = spline && t > 0;
+        unsigned int splineIndex = static_cast<unsigned int>(key);
+
+        if (!(c.animated & CompressedTransformTrack::TRANSLATE))
+            kf->setTranslate(c.translateBase);
+        else
+        {
+            kf->setTranslate(spline ? mSplines->positionSpline.interpolate(splineIndex, t)
+                                    : c.translateBase + c.translateStep * blendKeys(v, next, t));
+            v += 3;
+            next += 3;
+        }
+
+        if (!(c.animated & CompressedTransformTrack::ROTATE))
+            kf->setRotation(c.rotation);
+        else
+        {
+            if (spline)
+                kf->setRotation(mSplines->rotationSpline.interpolate(splineIndex, t, mUseShortestRotationPath));
+            else if (t == 0)
+                kf->setRotation(CompressedTransformTrack::decodeRotation(v));
+            else if (mParent->getRotationInterpolationMode() == Animation::RIM_LINEAR)
+                kf->setRotation(c.nlerpRotation(t, v, next, mUseShortestRotationPath));
+            else
+                kf->setRotation(Quaternion::Slerp(t, CompressedTransformTrack::decodeRotation(v),
+                                                  CompressedTransformTrack::decodeRotation(next),
+                                                  mUseShortestRotationPath));
+            v += 3;
+            next += 3;
+        }
+
+        if (!(c.animated & CompressedTransformTrack::SCALE))
+            kf->setScale(c.scaleBase);
+        else
+            kf->setScale(spline ? mSplines->scaleSpline.interpolate(splineIndex, t)
+                                : c.scaleBase + c.scaleStep * blendKeys(v, next, t));
+    }
+    //---------------------------------------------------------------------
+    bool NodeAnimationTrack::compress(Real translateTolerance, const Radian& rotateTolerance, Real scaleTolerance)
     {
+        if (mKeyFrames.empty())
+            return false;
+
+        // the keyframes cannot be re-based once compressed
+        mParent->_applyBaseKeyFrame();
+
+        std::vector<TransformKeyFrame*> keys;
         for (auto *k : mKeyFrames)
+            keys.push_back(static_cast<TransformKeyFrame*>(k));
+
+        auto compressed = std::make_shared<CompressedTransformTrack>();
+        if (!compressed->compress(keys, mParent->getLength(), translateTolerance, rotateTolerance, scaleTolerance,
+                                  mParent->getRotationInterpolationMode(), mUseShortestRotationPath))
+            return false;
+
+        removeAllKeyFrames();
+        KeyFrameList().swap(mKeyFrames);
+        _setCompressedKeys(compressed);
+        return true;
+    }
+    //---------------------------------------------------------------------
+    void NodeAnimationTrack::decompress(void)
+    {
+        if (!mCompressed)
+            return;
+
+        std::vector<TransformKeyFrame> keys;
+        _decodeCompressedKeys(keys);
+
+        mCompressed.reset();
+        for (const auto& k : keys)
         {
+            TransformKeyFrame* kf = createNodeKeyFrame(k.getTime());
+            kf->setTranslate(k.getTranslate());
+            kf->setRotation(k.getRotation());
+            kf->setScale(k.getScale());
+        }
+    }
+    //---------------------------------------------------------------------
+    void NodeAnimationTrack::_decodeCompressedKeys(std::vector<TransformKeyFrame>& keys) const
+    {
+        keys.clear();
+        if (!mCompressed)
+            return;
+
+        for (Real time : mCompressed->getKeyTimes())
+        {
+            keys.emplace_back(nullptr, time);
+            getCompressedKeyFrame(TimeIndex(time), &keys.back());
+        }
+    }
+    //---------------------------------------------------------------------
+    void NodeAnimationTrack::_setCompressedKeys(const std::shared_ptr<const CompressedTransformTrack>& keys)
+    {
+        OgreAssert(mKeyFrames.empty(), "the track already has keyframes");
+        mCompressed = keys;
+        _keyFrameDataChanged();
+        mParent->_keyFrameListChanged();
+    }
+    //---------------------------------------------------------------------
+    bool NodeAnimationTrack::hasNonZeroKeyFrames(void) const
+    {
+        auto isNonZero = [](const TransformKeyFrame* kf) {
             // look for keyframes which have any component which is non-zero
             // Since exporters can be a little inaccurate sometimes we use a
             // tolerance value rather than looking for nothing
-            TransformKeyFrame* kf = static_cast<TransformKeyFrame*>(k);
             Vector3 trans = kf->getTranslate();
             Vector3 scale = kf->getScale();
             Vector3 axis;
             Radian angle;
             kf->getRotation().ToAngleAxis(angle, axis);
             Real tolerance = 1e-3f;
-            if (!trans.positionEquals(Vector3::ZERO, tolerance) ||
-                !scale.positionEquals(Vector3::UNIT_SCALE, tolerance) ||
-                !Math::RealEqual(angle.valueRadians(), 0.0f, tolerance))
+            return !trans.positionEquals(Vector3::ZERO, tolerance) ||
+                   !scale.positionEquals(Vector3::UNIT_SCALE, tolerance) ||
+                   !Math::RealEqual(angle.valueRadians(), 0.0f, tolerance);
+        };
+
+        if (mCompressed)
+        {
+            for (Real time : mCompressed->getKeyTimes())
             {
-                return true;
+                TransformKeyFrame kf(0, time);
+                getCompressedKeyFrame(TimeIndex(time), &kf);
+                if (isNonZero(&kf))
+                    return true;
             }
+            return false;
+        }
+
+        for (auto *k : mKeyFrames)
+        {
+            if (isNonZero(static_cast<TransformKeyFrame*>(k)))
+                return true;
         }
 
         return false;
@@ -646,6 +836,7 @@ namespace Ogre {
     //--------------------------------------------------------------------------
     KeyFrame* NodeAnimationTrack::createKeyFrameImpl(Real time)
     {
+        OgreAssert(!mCompressed, "decompress the track before adding keyframes");
         return OGRE_NEW TransformKeyFrame(this, time);
     }
     //--------------------------------------------------------------------------
@@ -665,12 +856,58 @@ namespace Ogre {
             newParent->createNodeTrack(mHandle, mTargetNode);
         newTrack->mUseShortestRotationPath = mUseShortestRotationPath;
         populateClone(newTrack);
+        if (mCompressed)
+            newTrack->_setCompressedKeys(mCompressed);
         return newTrack;
     }
     //--------------------------------------------------------------------------
+    void NodeAnimationTrack::_collectKeyFrameTimes(std::vector<Real>& keyFrameTimes)
+    {
+        if (!mCompressed)
+        {
+            AnimationTrack::_collectKeyFrameTimes(keyFrameTimes);
+            return;
+        }
+
+        for (uint16 t : mCompressed->times)
+        {
+            Real timePos = t / mCompressed->timeScale;
+
+            std::vector<Real>::iterator it =
+                std::lower_bound(keyFrameTimes.begin(), keyFrameTimes.end(), timePos);
+            if (it == keyFrameTimes.end() || *it != timePos)
+            {
+                keyFrameTimes.insert(it, timePos);
+            }
+        }
+    }
+    //--------------------------------------------------------------------------
+    void NodeAnimationTrack::_buildKeyFrameIndexMap(const std::vector<Real>& keyFrameTimes)
+    {
+        if (!mCompressed)
+        {
+            AnimationTrack::_buildKeyFrameIndexMap(keyFrameTimes);
+            return;
+        }
+
+        // the last key at or before each global key time
+        const std::vector<uint16>& times = mCompressed->times;
+        mKeyFrameIndexMap.resize(times.empty() ? 0 : keyFrameTimes.size());
+        size_t i = 0;
+        for (size_t j = 0; j < mKeyFrameIndexMap.size(); j++)
+        {
+            while (i + 1 < times.size() && times[i + 1] / mCompressed->timeScale <= keyFrameTimes[j])
+                ++i;
+            mKeyFrameIndexMap[j] = static_cast<ushort>(i);
+        }
+    }
+    //--------------------------------------------------------------------------
     void NodeAnimationTrack::_applyBaseKeyFrame(const KeyFrame* b)
     {
         const TransformKeyFrame* base = static_cast<const TransformKeyFrame*>(b);
+
+        // the base keyframe was set after compressing
+        decompress();
         
         for (auto& k : mKeyFrames)
         {
@@ -29,6 +29,7 @@ THE SOFTWARE.
 
 #include "OgreBillboardParticleRenderer.h"
 #include "OgreParticle.h"
+#include "OgreParticleStreams.h"
 #include "OgreBillboard.h"
 
 namespace Ogre {
@@ -197,16 +198,78 @@ namespace Ogre {
         OgreProfile("BillboardParticleRenderer");
         mBillboardSet->setCullIndividually(cullIndividually);
 
+        mBillboards.clear();
+        addBillboards(currentParticles);
+
+        // Update billboard set geometry
+        mBillboardSet->beginBillboards(mBillboards.size());
+        mBillboardSet->injectBillboards(mBillboards.data(), mBillboards.size());
+        mBillboardSet->endBillboards();
+
+        // Update the queue
+        mBillboardSet->_updateRenderQueue(queue);
+    }
+
+    bool BillboardParticleRenderer::_updateRenderQueueFromStreams(RenderQueue* queue, ParticleStreams& streams,
+                                                                  std::vector<Particle*>& currentParticles,
+                                                                  bool cullIndividually)
+    {
+        OgreProfile("BillboardParticleRenderer");
+        mBillboardSet->setCullIndividually(cullIndividually);
+
+        bool selfOriented = mBillboardSet->getBillboardType() == BBT_ORIENTED_SELF ||
+                            mBillboardSet->getBillboardType() == BBT_PERPENDICULAR_SELF;
+        float defaultWidth = mBillboardSet->getDefaultWidth();
+        float defaultHeight = mBillboardSet->getDefaultHeight();
+
+        mBillboards.resize(streams.size());
+        for (size_t i = 0; i < streams.size(); i++)
+        {
+            Billboard& bb = mBillboards[i];
+            bb.mPosition = Vector3(streams.mPosition.x[i], streams.mPosition.y[i], streams.mPosition.z[i]);
+
+            if (selfOriented)
+            {
+                // Normalise direction vector
+                bb.mDirection = Vector3(streams.mDirection.x[i], streams.mDirection.y[i], streams.mDirection.z[i]);
+                bb.mDirection.normalise();
+            }
+            bb.mColour = streams.mColour[i];
+            bb.mRotation = Radian(streams.mRotation[i]);
+            bb.mTexcoordIndex = streams.mTexcoordIndex[i];
+            bb.mOwnDimensions = streams.mWidth[i] != defaultWidth || streams.mHeight[i] != defaultHeight;
+            if (bb.mOwnDimensions)
+            {
+                bb.mWidth = streams.mWidth[i];
+                bb.mHeight = streams.mHeight[i];
+            }
+        }
+        addBillboards(currentParticles);
+
         // Update billboard set geometry
-        mBillboardSet->beginBillboards(currentParticles.size());
-        Billboard bb;
+        mBillboardSet->beginBillboards(mBillboards.size());
+        mBillboardSet->injectBillboards(mBillboards.data(), mBillboards.size());
+        mBillboardSet->endBillboards();
+
+        // Update the queue
+        mBillboardSet->_updateRenderQueue(queue);
+        return true;
+    }
 
-        for (Particle* p : currentParticles)
+    void BillboardParticleRenderer::addBillboards(const std::vector<Particle*>& particles)
+    {
+        size_t first = mBillboards.size();
+        mBillboards.resize(first + particles.size());
+
+        bool selfOriented = mBillboardSet->getBillboardType() == BBT_ORIENTED_SELF ||
+                            mBillboardSet->getBillboardType() == BBT_PERPENDICULAR_SELF;
+        for (size_t i = 0; i < particles.size(); i++)
         {
+            const Particle* p = particles[i];
+            Billboard& bb = mBillboards[first + i];
             bb.mPosition = p->mPosition;
 
-            if (mBillboardSet->getBillboardType() == BBT_ORIENTED_SELF ||
-                mBillboardSet->getBillboardType() == BBT_PERPENDICULAR_SELF)
+            if (selfOriented)
             {
                 // Normalise direction vector
                 bb.mDirection = p->mDirection;
@@ -222,13 +285,7 @@ namespace Ogre {
                 bb.mWidth = p->mWidth;
                 bb.mHeight = p->mHeight;
             }
-            mBillboardSet->injectBillboard(bb);
         }
-
-        mBillboardSet->endBillboards();
-
-        // Update the queue
-        mBillboardSet->_updateRenderQueue(queue);
     }
 
     void BillboardParticleRenderer::_notifyBoundingBox(const AxisAlignedBox& aabb)
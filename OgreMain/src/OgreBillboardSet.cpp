@@ -30,9 +30,17 @@ THE SOFTWARE.
 #include "OgreBillboardSet.h"
 #include "OgreBillboard.h"
 
+#include "OgreSIMDHelper.h"
+
 #include <algorithm>
 #include <memory>
 
+#if (__OGRE_HAVE_SSE || __OGRE_HAVE_NEON) && OGRE_DOUBLE_PRECISION == 0
+#define OGRE_BILLBOARDSET_SIMD 1
+#else
+#define OGRE_BILLBOARDSET_SIMD 0
+#endif
+
 namespace Ogre {
     //-----------------------------------------------------------------------
     BillboardSet::BillboardSet() :
@@ -384,6 +392,52 @@ namespace Ogre {
         }
     }
     //-----------------------------------------------------------------------
+    void BillboardSet::injectBillboards(const Billboard* billboards, size_t count)
+    {
+        if (mCullIndividual || mPointRendering)
+        {
+            // culling decides the position of the following billboards, points are trivial anyway
+            for (size_t i = 0; i < count; i++)
+                injectBillboard(billboards[i]);
+            return;
+        }
+
+        // Don't accept injections beyond pool size
+        count = std::min(count, mPoolSize - mNumVisibleBillboards);
+
+        // 4 vertices of position, colour and texture coords
+        const size_t floatsPerBillboard = 4 * 6;
+        assert(mMainBuf->getVertexSize() == 6 * sizeof(float));
+
+        float* pDest = mLockPtr;
+        mLockPtr += count * floatsPerBillboard;
+        mNumVisibleBillboards += count;
+
+        WorkQueue* workQueue = Root::getSingletonPtr() ? Root::getSingleton().getWorkQueue() : NULL;
+        WorkQueue::parallelFor(workQueue, count, 256, [this, billboards, pDest](size_t begin, size_t end) {
+            const Billboard* first = billboards + begin;
+            float* pChunk = pDest + begin * floatsPerBillboard;
+            switch (mBillboardType)
+            {
+            case BBT_POINT:
+                genQuadVerticesBulk<BBT_POINT>(first, end - begin, pChunk);
+                break;
+            case BBT_ORIENTED_COMMON:
+                genQuadVerticesBulk<BBT_ORIENTED_COMMON>(first, end - begin, pChunk);
+                break;
+            case BBT_ORIENTED_SELF:
+                genQuadVerticesBulk<BBT_ORIENTED_SELF>(first, end - begin, pChunk);
+                break;
+            case BBT_PERPENDICULAR_COMMON:
+                genQuadVerticesBulk<BBT_PERPENDICULAR_COMMON>(first, end - begin, pChunk);
+                break;
+            case BBT_PERPENDICULAR_SELF:
+                genQuadVerticesBulk<BBT_PERPENDICULAR_SELF>(first, end - begin, pChunk);
+                break;
+            }
+        });
+    }
+    //-----------------------------------------------------------------------
     void BillboardSet::endBillboards(void)
     {
         mMainBuf->unlock();
@@ -1042,6 +1096,185 @@ namespace Ogre {
 
     }
     //-----------------------------------------------------------------------
+    template <BillboardType type, bool accurateFacing>
+    void BillboardSet::genBillboardAxesBulk(const Billboard& bb, Vector3& x, Vector3& y) const
+    {
+        // same as genBillboardAxes, the branches on the type are resolved at compile time
+        Vector3 camDir = mCamDir;
+        if (accurateFacing && (type == BBT_POINT || type == BBT_ORIENTED_COMMON || type == BBT_ORIENTED_SELF))
+        {
+            // cam -> bb direction
+            camDir = bb.mPosition - mCamPos;
+            camDir.normalise();
+        }
+
+        switch (type)
+        {
+        case BBT_POINT:
+            // only called with accurate facing, otherwise the axes are common
+            y = mCamQ * Vector3::UNIT_Y;
+            x = camDir.crossProduct(y);
+            x.normalise();
+            y = x.crossProduct(camDir);
+            break;
+        case BBT_ORIENTED_COMMON:
+            y = mCommonDirection;
+            x = camDir.crossProduct(y);
+            x.normalise();
+            break;
+        case BBT_ORIENTED_SELF:
+            y = bb.mDirection;
+            x = camDir.crossProduct(y);
+            x.normalise();
+            break;
+        case BBT_PERPENDICULAR_COMMON:
+            x = mCommonUpVector.crossProduct(mCommonDirection);
+            y = mCommonDirection.crossProduct(x);
+            break;
+        case BBT_PERPENDICULAR_SELF:
+            x = mCommonUpVector.crossProduct(bb.mDirection);
+            x.normalise();
+            y = bb.mDirection.crossProduct(x);
+            break;
+        }
+    }
+    //-----------------------------------------------------------------------
+    /// write the 4 vertices of a quad, with the texture coords of each corner in uv
+    static inline void writeQuad(float* pDest, const Vector3& position, const Vector3* offsets, RGBA colour,
+                                 const float* uv)
+    {
+        for (int i = 0; i < 4; i++)
+        {
+            *pDest++ = offsets[i].x + position.x;
+            *pDest++ = offsets[i].y + position.y;
+            *pDest++ = offsets[i].z + position.z;
+            memcpy(pDest++, &colour, sizeof(RGBA));
+            *pDest++ = uv[i * 2];
+            *pDest++ = uv[i * 2 + 1];
+        }
+    }
+#if OGRE_BILLBOARDSET_SIMD
+    static inline void writeQuad(float* pDest, __m128 position, const __m128* offsets, RGBA colour, const float* uv)
+    {
+        for (int i = 0; i < 4; i++)
+        {
+            // the 4th lane lands on the colour, which is written afterwards
+            _mm_storeu_ps(pDest, _mm_add_ps(offsets[i], position));
+            memcpy(pDest + 3, &colour, sizeof(RGBA));
+            pDest[4] = uv[i * 2];
+            pDest[5] = uv[i * 2 + 1];
+            pDest += 6;
+        }
+    }
+#endif
+    //-----------------------------------------------------------------------
+    template <BillboardType type>
+    void BillboardSet::genQuadVerticesBulk(const Billboard* billboards, size_t count, float* pDest) const
+    {
+        // point billboards only need their own axes with accurate facing
+        const bool accurateFacing = mAccurateFacing && type != BBT_PERPENDICULAR_COMMON &&
+                                    type != BBT_PERPENDICULAR_SELF;
+        if (mRotationType == BBR_VERTEX)
+        {
+            if (accurateFacing)
+                genQuadVerticesBulk<type, BBR_VERTEX, true>(billboards, count, pDest);
+            else
+                genQuadVerticesBulk<type, BBR_VERTEX, false>(billboards, count, pDest);
+        }
+        else
+        {
+            if (accurateFacing)
+                genQuadVerticesBulk<type, BBR_TEXCOORD, true>(billboards, count, pDest);
+            else
+                genQuadVerticesBulk<type, BBR_TEXCOORD, false>(billboards, count, pDest);
+        }
+    }
+    //-----------------------------------------------------------------------
+    template <BillboardType type, BillboardRotationType rotationType, bool accurateFacing>
+    void BillboardSet::genQuadVerticesBulk(const Billboard* billboards, size_t count, float* pDest) const
+    {
+        // otherwise the axes were generated by beginBillboards
+        const bool ownAxes = type == BBT_ORIENTED_SELF || type == BBT_PERPENDICULAR_SELF ||
+                             (accurateFacing && type != BBT_PERPENDICULAR_COMMON);
+        Vector3 x = mCamX, y = mCamY;
+        float uv[8];
+
+        for (size_t i = 0; i < count; i++, pDest += 4 * 6)
+        {
+            const Billboard& bb = billboards[i];
+            if (ownAxes)
+                genBillboardAxesBulk<type, accurateFacing>(bb, x, y);
+
+            Real width = bb.mOwnDimensions ? bb.mWidth : mDefaultWidth;
+            Real height = bb.mOwnDimensions ? bb.mHeight : mDefaultHeight;
+
+            // Texcoords
+            assert(bb.mUseTexcoordRect || bb.mTexcoordIndex < mTextureCoords.size());
+            const FloatRect& r = bb.mUseTexcoordRect ? bb.mTexcoordRect : mTextureCoords[bb.mTexcoordIndex];
+            bool rotated = bb.mRotation != Radian(0);
+
+            if (rotationType == BBR_TEXCOORD && rotated)
+            {
+                const Real cos_rot(Math::Cos(bb.mRotation));
+                const Real sin_rot(Math::Sin(bb.mRotation));
+
+                float uvWidth = (r.right - r.left) / 2;
+                float uvHeight = (r.bottom - r.top) / 2;
+                float mid_u = r.left + uvWidth;
+                float mid_v = r.top + uvHeight;
+
+                float cos_rot_w = cos_rot * uvWidth;
+                float cos_rot_h = cos_rot * uvHeight;
+                float sin_rot_w = sin_rot * uvWidth;
+                float sin_rot_h = sin_rot * uvHeight;
+
+                float rotatedUV[8] = {mid_u - cos_rot_w + sin_rot_h, mid_v - sin_rot_w - cos_rot_h,
+                                      mid_u + cos_rot_w + sin_rot_h, mid_v + sin_rot_w - cos_rot_h,
+                                      mid_u - cos_rot_w - sin_rot_h, mid_v - sin_rot_w + cos_rot_h,
+                                      mid_u + cos_rot_w - sin_rot_h, mid_v + sin_rot_w + cos_rot_h};
+                memcpy(uv, rotatedUV, sizeof(uv));
+            }
+            else
+            {
+                float cornerUV[8] = {r.left, r.top, r.right, r.top, r.left, r.bottom, r.right, r.bottom};
+                memcpy(uv, cornerUV, sizeof(uv));
+            }
+
+            if (rotationType == BBR_VERTEX && rotated)
+            {
+                Vector3 offsets[4];
+                genVertOffsets(mLeftOff, mRightOff, mTopOff, mBottomOff, width, height, x, y, offsets);
+
+                Vector3 axis = (offsets[3] - offsets[0]).crossProduct(offsets[2] - offsets[1]).normalisedCopy();
+                Matrix3 rotation;
+                rotation.FromAngleAxis(axis, bb.mRotation);
+                for (auto& offset : offsets)
+                    offset = rotation * offset;
+
+                writeQuad(pDest, bb.mPosition, offsets, bb.mColour, uv);
+                continue;
+            }
+
+#if OGRE_BILLBOARDSET_SIMD
+            // the corner offsets of genVertOffsets, one vector per register
+            __m128 vx = _mm_setr_ps(x.x, x.y, x.z, 0);
+            __m128 vy = _mm_setr_ps(y.x, y.y, y.z, 0);
+            __m128 leftOff = _mm_mul_ps(vx, _mm_set1_ps(mLeftOff * width));
+            __m128 rightOff = _mm_mul_ps(vx, _mm_set1_ps(mRightOff * width));
+            __m128 topOff = _mm_mul_ps(vy, _mm_set1_ps(mTopOff * height));
+            __m128 bottomOff = _mm_mul_ps(vy, _mm_set1_ps(mBottomOff * height));
+            __m128 offsets[4] = {_mm_add_ps(leftOff, topOff), _mm_add_ps(rightOff, topOff),
+                                 _mm_add_ps(leftOff, bottomOff), _mm_add_ps(rightOff, bottomOff)};
+            writeQuad(pDest, _mm_setr_ps(bb.mPosition.x, bb.mPosition.y, bb.mPosition.z, 0), offsets, bb.mColour,
+                      uv);
+#else
+            Vector3 offsets[4];
+            genVertOffsets(mLeftOff, mRightOff, mTopOff, mBottomOff, width, height, x, y, offsets);
+            writeQuad(pDest, bb.mPosition, offsets, bb.mColour, uv);
+#endif
+        }
+    }
+    //-----------------------------------------------------------------------
     const String& BillboardSet::getMovableType(void) const
     {
         return MOT_BILLBOARD_SET;
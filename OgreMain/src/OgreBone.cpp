@@ -108,6 +108,26 @@ namespace Ogre {
         m.makeTransform(locTranslate, locScale, locRotate);
     }
     //---------------------------------------------------------------------
+    void Bone::_setTransforms(const Vector3& position, const Quaternion& orientation, const Vector3& scale,
+                              const Vector3& derivedPosition, const Quaternion& derivedOrientation,
+                              const Vector3& derivedScale)
+    {
+        mPosition = position;
+        mOrientation = orientation;
+        mScale = scale;
+        mDerivedPosition = derivedPosition;
+        mDerivedOrientation = derivedOrientation;
+        mDerivedScale = derivedScale;
+
+        // same state as after _update(true, false)
+        mCachedTransformOutOfDate = true;
+        mNeedParentUpdate = false;
+        mParentNotified = false;
+        mNeedChildUpdate = false;
+        if (!mChildrenToUpdate.empty())
+            mChildrenToUpdate.clear();
+    }
+    //---------------------------------------------------------------------
     unsigned short Bone::getHandle(void) const
     {
         return mHandle;
@@ -0,0 +1,271 @@
+// This file is part of the OGRE project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at https://www.ogre3d.org/licensing.
+// SPDX-License-Identifier: MIT
+#include "OgreStableHeaders.h"
+#include "OgreCompressedTransformTrack.h"
+#include "OgreKeyFrame.h"
+
+namespace Ogre
+{
+    static uint16 quantiseComponent(Real v)
+    {
+        const Real range = CompressedTransformTrack::SMALLEST_THREE_RANGE;
+        v = Math::Clamp<Real>(v, -range, range);
+        return uint16(std::round((v + range) / CompressedTransformTrack::SMALLEST_THREE_STEP));
+    }
+
+    static void encodeRotation(Quaternion q, uint16* out)
+    {
+        q.normalise();
+        size_t largest = 0;
+        for (size_t i = 1; i < 4; i++)
+        {
+            if (std::abs(q[i]) > std::abs(q[largest]))
+                largest = i;
+        }
+        // q and -q are the same rotation, but the sign matters when not interpolating along the shortest path
+        bool negated = q[largest] < 0;
+        if (negated)
+            q = -q;
+
+        uint16 components[3];
+        for (size_t i = 0, j = 0; i < 4; i++)
+        {
+            if (i != largest)
+                components[j++] = quantiseComponent(q[i]);
+        }
+        out[0] = uint16(components[0] | (largest >> 1) << 15);
+        out[1] = uint16(components[1] | (largest & 1) << 15);
+        out[2] = uint16(components[2] | (negated ? 0x8000 : 0));
+    }
+    //-----------------------------------------------------------------------
+    std::vector<Real> CompressedTransformTrack::getKeyTimes() const
+    {
+        std::vector<Real> ret;
+        for (uint16 t : times)
+            ret.push_back(t / timeScale);
+        if (ret.empty())
+            ret.push_back(0);
+        return ret;
+    }
+    //-----------------------------------------------------------------------
+    size_t CompressedTransformTrack::calculateSize() const
+    {
+        return sizeof(*this) + (times.capacity() + values.capacity()) * sizeof(uint16);
+    }
+    //-----------------------------------------------------------------------
+    /** Greedily picks the keys to keep, so fits(first, last) holds between each pair of kept ones
+
+        fits(first, last) tests the keys in between against the interpolation of the two.
+    */
+    template <typename Fits> static std::vector<size_t> reduceKeys(size_t count, const Fits& fits)
+    {
+        std::vector<size_t> kept(1, 0);
+        size_t first = 0;
+        while (first + 1 < count)
+        {
+            size_t last = first + 1;
+            while (last + 1 < count && fits(first, last + 1))
+                last++;
+            kept.push_back(last);
+            first = last;
+        }
+        return kept;
+    }
+
+    /// the minimum and the quantisation step of the values
+    static void getVectorRange(const std::vector<Vector3>& values, Vector3& base, Vector3& step)
+    {
+        Vector3 maximum = base = values[0];
+        for (const Vector3& v : values)
+        {
+            base.makeFloor(v);
+            maximum.makeCeil(v);
+        }
+        step = (maximum - base) / 65535;
+    }
+
+    static void encodeVector(const Vector3& v, const Vector3& base, const Vector3& step, uint16* out)
+    {
+        for (int i = 0; i < 3; i++)
+            out[i] = step[i] > 0 ? uint16(std::round((v[i] - base[i]) / step[i])) : 0;
+    }
+
+    /// the values as decoded, or false if one of them is further than tolerance from the original
+    static bool quantiseVectors(const std::vector<Vector3>& values, const Vector3& base, const Vector3& step,
+                               Real tolerance, std::vector<Vector3>& quantised)
+    {
+        quantised.clear();
+        for (const Vector3& v : values)
+        {
+            uint16 encoded[3];
+            encodeVector(v, base, step, encoded);
+            quantised.push_back(base + step * Vector3(encoded[0], encoded[1], encoded[2]));
+            if (!quantised.back().positionEquals(v, tolerance))
+                return false;
+        }
+        return true;
+    }
+    //-----------------------------------------------------------------------
+    bool CompressedTransformTrack::compress(const std::vector<TransformKeyFrame*>& keys, Real length,
+                                            Real translateTolerance, Radian rotateTolerance, Real scaleTolerance,
+                                            Animation::RotationInterpolationMode rotationInterpolation,
+                                            bool useShortestRotationPath)
+    {
+        OgreAssert(!keys.empty(), "no keys to compress");
+        length = std::max(length, keys.back()->getTime());
+        timeScale = length > 0 ? 65535 / length : 1;
+
+        std::vector<Real> keyTimes;
+        // the key times in units of 1 / timeScale, as they are decoded
+        std::vector<uint16> keyUnits;
+        std::vector<Vector3> translates, scales;
+        std::vector<Quaternion> rotations;
+        for (auto k : keys)
+        {
+            keyTimes.push_back(k->getTime());
+            keyUnits.push_back(uint16(std::min<Real>(std::round(k->getTime() * timeScale), 65535)));
+            translates.push_back(k->getTranslate());
+            rotations.push_back(k->getRotation());
+            scales.push_back(k->getScale());
+        }
+
+        // channels that stay within the tolerance of the first key are constant
+        translateBase = translates[0];
+        rotation = rotations[0];
+        scaleBase = scales[0];
+        translateStep = scaleStep = Vector3::ZERO;
+        animated = 0;
+        for (size_t k = 0; k < keys.size(); k++)
+        {
+            if (!translates[k].positionEquals(translateBase, translateTolerance))
+                animated |= TRANSLATE;
+            if (!rotations[k].equals(rotation, rotateTolerance))
+                animated |= ROTATE;
+            if (!scales[k].positionEquals(scaleBase, scaleTolerance))
+                animated |= SCALE;
+        }
+
+        times.clear();
+        values.clear();
+        if (!animated)
+            return true;
+
+        // all values are checked as decoded, including the quantisation error. The range of all keys
+        // is used, as the kept ones are not known yet.
+        std::vector<Vector3> quantisedTranslates = translates, quantisedScales = scales;
+        if (animated & TRANSLATE)
+        {
+            getVectorRange(translates, translateBase, translateStep);
+            if (!quantiseVectors(translates, translateBase, translateStep, translateTolerance, quantisedTranslates))
+                return false;
+        }
+        if (animated & SCALE)
+        {
+            getVectorRange(scales, scaleBase, scaleStep);
+            if (!quantiseVectors(scales, scaleBase, scaleStep, scaleTolerance, quantisedScales))
+                return false;
+        }
+
+        std::vector<uint16> encoded(keys.size() * 3);
+        for (size_t k = 0; k < keys.size(); k++)
+        {
+            encodeRotation(rotations[k], &encoded[k * 3]);
+            if ((animated & ROTATE) && !decodeRotation(&encoded[k * 3]).equals(rotations[k], rotateTolerance))
+                return false;
+        }
+
+        // the blend value the decoder computes at time between the keys first and last
+        auto blendValue = [&](size_t first, size_t last, Real time) {
+            Real t1 = keyUnits[first], t2 = keyUnits[last];
+            return Math::saturate((time * timeScale - t1) / (t2 - t1));
+        };
+        auto interpolate = [&](const Quaternion& q1, const Quaternion& q2, Real t) {
+            return rotationInterpolation == Animation::RIM_LINEAR
+                       ? Quaternion::nlerp(t, q1, q2, useShortestRotationPath)
+                       : Quaternion::Slerp(t, q1, q2, useShortestRotationPath);
+        };
+        auto rotationFits = [&](size_t first, size_t last, Real t, const Quaternion& expected) {
+            const uint16* q1 = &encoded[first * 3];
+            const uint16* q2 = &encoded[last * 3];
+            Quaternion q = rotationInterpolation == Animation::RIM_LINEAR
+                               ? nlerpRotation(t, q1, q2, useShortestRotationPath)
+                               : interpolate(decodeRotation(q1), decodeRotation(q2), t);
+            return q.equals(expected, rotateTolerance);
+        };
+        // the interpolated path may bend away between the keys as well, so check the middle of each segment
+        auto pathFits = [&](size_t first, size_t last) {
+            for (size_t k = first; k < last; k++)
+            {
+                Real t = blendValue(first, last, (keyTimes[k] + keyTimes[k + 1]) / 2);
+                if (!rotationFits(first, last, t, interpolate(rotations[k], rotations[k + 1], 0.5f)))
+                    return false;
+            }
+            return true;
+        };
+        auto fits = [&](size_t first, size_t last) {
+            if (keyUnits[last] <= keyUnits[first])
+                return false;
+            for (size_t k = first + 1; k < last; k++)
+            {
+                Real t = blendValue(first, last, keyTimes[k]);
+                const Vector3& t1 = quantisedTranslates[first];
+                if ((animated & TRANSLATE) &&
+                    !(t1 + (quantisedTranslates[last] - t1) * t).positionEquals(translates[k], translateTolerance))
+                    return false;
+                const Vector3& s1 = quantisedScales[first];
+                if ((animated & SCALE) &&
+                    !(s1 + (quantisedScales[last] - s1) * t).positionEquals(scales[k], scaleTolerance))
+                    return false;
+                if ((animated & ROTATE) && !rotationFits(first, last, t, rotations[k]))
+                    return false;
+            }
+            return !(animated & ROTATE) || pathFits(first, last);
+        };
+
+        // blending encoded rotations is faster, unless it bends too far between keys that are always kept
+        if ((animated & ROTATE) && rotationInterpolation == Animation::RIM_LINEAR)
+            animated |= BLEND_ENCODED;
+        std::vector<size_t> kept = reduceKeys(keys.size(), fits);
+        for (size_t i = 1; (animated & BLEND_ENCODED) && i < kept.size(); i++)
+        {
+            if (!pathFits(kept[i - 1], kept[i]))
+            {
+                animated &= ~BLEND_ENCODED;
+                kept = reduceKeys(keys.size(), fits);
+            }
+        }
+
+        // neighbouring keys are always kept, even when they end up at the same time
+        for (size_t k : kept)
+        {
+            if (!times.empty() && times.back() >= keyUnits[k])
+            {
+                times.clear();
+                return false;
+            }
+            times.push_back(keyUnits[k]);
+        }
+
+        size_t stride = getStride();
+        values.resize(kept.size() * stride);
+        for (size_t i = 0; i < kept.size(); i++)
+        {
+            uint16* v = &values[i * stride];
+            if (animated & TRANSLATE)
+            {
+                encodeVector(translates[kept[i]], translateBase, translateStep, v);
+                v += 3;
+            }
+            if (animated & ROTATE)
+            {
+                std::copy_n(&encoded[kept[i] * 3], 3, v);
+                v += 3;
+            }
+            if (animated & SCALE)
+                encodeVector(scales[kept[i]], scaleBase, scaleStep, v);
+        }
+        return true;
+    }
+}
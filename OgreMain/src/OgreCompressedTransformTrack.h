@@ -0,0 +1,182 @@
+// This file is part of the OGRE project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at https://www.ogre3d.org/licensing.
+// SPDX-License-Identifier: MIT
+#ifndef __CompressedTransformTrack_H__
+#define __CompressedTransformTrack_H__
+
+#include "OgrePrerequisites.h"
+#include "OgreAnimation.h"
+#include "OgreQuaternion.h"
+#include "OgreVector.h"
+
+namespace Ogre
+{
+    /** The keys of a NodeAnimationTrack in compressed form, see NodeAnimationTrack::compress
+
+        Translation, rotation and scale are channels that are either animated or hold a constant value.
+        The animated ones share the key times, which are stored as 16 bit units of 1 / timeScale. Vectors
+        are stored with 16 bits per component over the range of the channel and rotations as the
+        smallest three components of the quaternion with 15 bits each.
+    */
+    struct CompressedTransformTrack
+    {
+        enum Channel
+        {
+            TRANSLATE = 1,
+            ROTATE = 2,
+            SCALE = 4,
+            /// not a channel, rotations with the same largest component are blended encoded, see nlerpRotation
+            BLEND_ENCODED = 8
+        };
+
+        /// units of the key times per second
+        Real timeScale;
+        /// the animated channels, the others hold a constant value, and the BLEND_ENCODED flag
+        uint16 animated;
+        /// sorted and unique, empty if no channel is animated
+        std::vector<uint16> times;
+        /** for each key three values per animated channel, in the order translate, rotate, scale
+
+            The rotation values are the smallest three components in their lower 15 bits. The top bits
+            of the first two give the index of the largest component, which is positive unless the top
+            bit of the third one is set.
+        */
+        std::vector<uint16> values;
+        /// the constant value, or the minimum of the keys
+        Vector3 translateBase;
+        /// the translation of one quantisation step
+        Vector3 translateStep;
+        /// the constant rotation
+        Quaternion rotation;
+        Vector3 scaleBase;
+        Vector3 scaleStep;
+
+        CompressedTransformTrack() : timeScale(1), animated(0) {}
+
+        /// number of values per key
+        size_t getStride() const
+        {
+            return 3 * ((animated & TRANSLATE) + ((animated & ROTATE) >> 1) + ((animated & SCALE) >> 2));
+        }
+
+        /** Gets the key at or before timePos and the blend value towards the next one
+
+            Keys are clamped at both ends, like AnimationTrack::getKeyFramesAtTime. There must be keys.
+            @param hint a key close to the result, e.g. from the key index of a TimeIndex, or -1 for none
+            @return 0 if there is no next key to blend to
+        */
+        Real findKey(Real timePos, size_t hint, size_t& key) const
+        {
+            const uint16* t = times.data();
+            size_t last = times.size() - 1;
+            Real pos = timePos * timeScale;
+            if (pos <= t[0] || last == 0)
+            {
+                key = 0;
+                return 0;
+            }
+            if (pos >= t[last])
+            {
+                key = last;
+                return 0;
+            }
+
+            // t[key] <= pos < t[key + 1], the times are integers so compare with the integer part
+            uint32 ipos = uint32(pos);
+            if (hint < last)
+            {
+                key = hint;
+                while (t[key] > ipos)
+                    key--;
+                while (t[key + 1] <= ipos)
+                    key++;
+            }
+            else
+            {
+                key = 0;
+                size_t len = last;
+                while (len > 1)
+                {
+                    size_t half = len / 2;
+                    key += (t[key + half] <= ipos) * half;
+                    len -= half;
+                }
+            }
+            return (pos - t[key]) / (t[key + 1] - t[key]);
+        }
+
+        /// range of the smallest three components of a unit quaternion
+        static constexpr Real SMALLEST_THREE_RANGE = Real(0.70710678118654752440);
+        static constexpr Real SMALLEST_THREE_STEP = 2 * SMALLEST_THREE_RANGE / 32767;
+
+        /// creates the quaternion from decoded components, with the largest one moved to its place in v
+        static Quaternion makeRotation(const Real* c, const uint16* v)
+        {
+            // where w, x, y and z are in the components, by the index of the largest one
+            static const uint8 order[4][4] = {{3, 0, 1, 2}, {0, 3, 1, 2}, {0, 1, 3, 2}, {0, 1, 2, 3}};
+            const uint8* o = order[(v[0] >> 15) << 1 | v[1] >> 15];
+            return Quaternion(c[o[0]], c[o[1]], c[o[2]], c[o[3]]);
+        }
+
+        /// decodes the smallest three components, blended between rotations with the same largest one, then the largest
+        static void decodeComponents(const uint16* v1, const uint16* v2, Real t, Real* c)
+        {
+            // arithmetic instead of a branch, as the sign is hard to predict
+            Real sign = 1 - 2 * Real(v1[2] >> 15);
+            for (int i = 0; i < 3; i++)
+            {
+                Real a = v1[i] & 0x7FFF;
+                a += ((v2[i] & 0x7FFF) - a) * t;
+                c[i] = sign * (a * SMALLEST_THREE_STEP - SMALLEST_THREE_RANGE);
+            }
+            c[3] = sign * std::sqrt(std::max<Real>(0, 1 - c[0] * c[0] - c[1] * c[1] - c[2] * c[2]));
+        }
+
+        /// decodes three rotation values
+        static Quaternion decodeRotation(const uint16* v)
+        {
+            Real c[4];
+            decodeComponents(v, v, 0, c);
+            return makeRotation(c, v);
+        }
+
+        /** Interpolates two encoded rotations, like Quaternion::nlerp
+
+            Keys usually have the same largest component and sign. With BLEND_ENCODED their smallest three
+            components are interpolated then, which saves decoding both. That path bends away from the one
+            of Quaternion::nlerp the larger the rotation between the keys, so compress only sets the flag
+            if it stays within the tolerance.
+        */
+        Quaternion nlerpRotation(Real t, const uint16* v1, const uint16* v2, bool shortestPath) const
+        {
+            if (!(animated & BLEND_ENCODED) || (((v1[0] ^ v2[0]) | (v1[1] ^ v2[1]) | (v1[2] ^ v2[2])) & 0x8000))
+                return Quaternion::nlerp(t, decodeRotation(v1), decodeRotation(v2), shortestPath);
+
+            Real c[4];
+            decodeComponents(v1, v2, t, c);
+            return makeRotation(c, v1);
+        }
+
+        /// Times in seconds of the keys, a single one at 0 if no channel is animated
+        std::vector<Real> getKeyTimes() const;
+
+        /// Memory used by the keys, in bytes
+        size_t calculateSize() const;
+
+        /** Compresses keys sorted by time
+
+            Keys whose values are within the tolerance of the linear interpolation between the kept keys
+            are removed. Rotations are interpolated like NodeAnimationTrack does for the given modes.
+            The key times are quantised over the length, so the tracks of an animation share them. The
+            tolerance is checked against the decoded values, including the quantisation error.
+            @return false if the keys cannot be compressed within the tolerance, e.g. when the range of
+            a channel is too large or two kept keys end up at the same time
+        */
+        bool compress(const std::vector<TransformKeyFrame*>& keys, Real length, Real translateTolerance,
+                      Radian rotateTolerance, Real scaleTolerance,
+                      Animation::RotationInterpolationMode rotationInterpolation, bool useShortestRotationPath);
+    };
+}
+
+#endif
@@ -27,6 +27,14 @@ THE SOFTWARE.
 */
 #include "OgreStableHeaders.h"
 
+#if OGRE_PLATFORM != OGRE_PLATFORM_WIN32 && OGRE_PLATFORM != OGRE_PLATFORM_WINRT
+#   include <fcntl.h>
+#   include <sys/mman.h>
+#   include <sys/stat.h>
+#   include <unistd.h>
+#   define OGRE_HAVE_MMAP
+#endif
+
 namespace Ogre {
 
     //-----------------------------------------------------------------------
@@ -761,4 +769,64 @@ namespace Ogre {
     }
     //-----------------------------------------------------------------------
 
+    //-----------------------------------------------------------------------
+    static std::pair<void*, size_t> mapFile(const String& path)
+    {
+#ifdef OGRE_HAVE_MMAP
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd == -1)
+            OGRE_EXCEPT(Exception::ERR_FILE_NOT_FOUND, "Cannot open file: " + path);
+
+        struct stat st;
+        void* addr = NULL;
+        size_t size = fstat(fd, &st) == 0 ? st.st_size : 0;
+        // mapping 0 bytes is an error, an empty file is not
+        if (size > 0)
+        {
+            addr = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (addr == MAP_FAILED)
+            {
+                ::close(fd);
+                OGRE_EXCEPT(Exception::ERR_INTERNAL_ERROR, "Cannot map file: " + path);
+            }
+            // the whole file is usually read, so start reading it ahead
+            madvise(addr, size, MADV_WILLNEED);
+        }
+        // the mapping stays valid after closing
+        ::close(fd);
+        return std::make_pair(addr, size);
+#else
+        OGRE_EXCEPT(Exception::ERR_NOT_IMPLEMENTED, "Memory mapped files are not supported on this platform");
+#endif
+    }
+    //-----------------------------------------------------------------------
+    MmapDataStream::MmapDataStream(const String& name, const String& path)
+        : MmapDataStream(name, mapFile(path))
+    {
+    }
+    //-----------------------------------------------------------------------
+    MmapDataStream::MmapDataStream(const String& name, const std::pair<void*, size_t>& mapping)
+        : MemoryDataStream(name, mapping.first, mapping.second, false, true), mMapping(mapping.first),
+          mMappingSize(mapping.second)
+    {
+    }
+    //-----------------------------------------------------------------------
+    MmapDataStream::~MmapDataStream()
+    {
+        close();
+    }
+    //-----------------------------------------------------------------------
+    void MmapDataStream::close(void)
+    {
+        MemoryDataStream::close();
+#ifdef OGRE_HAVE_MMAP
+        if (mMapping)
+        {
+            munmap(mMapping, mMappingSize);
+            mMapping = NULL;
+        }
+#endif
+    }
+    //-----------------------------------------------------------------------
+
 }
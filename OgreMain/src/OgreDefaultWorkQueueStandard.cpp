@@ -62,6 +62,7 @@ namespace Ogre
             Root::getSingleton().getRenderSystem()->preExtraThreadsStarted();
 
         mNumThreadsRegisteredWithRS = 0;
+        createTaskDeques();
         for (size_t i = 0; i < mWorkerThreadCount; ++i)
         {
             OGRE_THREAD_CREATE(t, [this]() { _threadMain(); });
@@ -107,8 +108,11 @@ namespace Ogre
         mShuttingDown = true;
 
 #if OGRE_THREAD_SUPPORT
-        // wake all threads (they should check shutting down as first thing after wait)
-        OGRE_THREAD_NOTIFY_ALL(mRequestCondition);
+        {
+            // wake all threads (they should check shutting down as first thing after wait)
+            OGRE_WQ_LOCK_MUTEX(mRequestMutex);
+            OGRE_THREAD_NOTIFY_ALL(mRequestCondition);
+        }
 
         // all our threads should have been woken now, so join
         for (WorkerThreadList::iterator i = mWorkers.begin(); i != mWorkers.end(); ++i)
@@ -117,6 +121,7 @@ namespace Ogre
             OGRE_THREAD_DESTROY(*i);
         }
         mWorkers.clear();
+        destroyTaskDeques();
 #endif
 
         mIsRunning = false;
@@ -132,13 +137,19 @@ namespace Ogre
     void DefaultWorkQueue::waitForNextRequest()
     {
 #if OGRE_THREAD_SUPPORT
+        if (mNumPendingTasks)
+            return;
+
         // Lock; note that OGRE_THREAD_WAIT will free the lock
             OGRE_WQ_LOCK_MUTEX_NAMED(mRequestMutex, queueLock);
-        if (mTasks.empty())
+        // counted before checking, so adding a task after the check notifies us
+        mNumSleepingWorkers++;
+        if (!mNumPendingTasks && !mShuttingDown)
         {
             // frees lock and suspends the thread
             OGRE_THREAD_WAIT(mRequestCondition, mRequestMutex, queueLock);
         }
+        mNumSleepingWorkers--;
         // When we get back here, it's because we've been notified 
         // and thus the thread has been woken up. Lock has also been
         // re-acquired, but we won't use it. It's safe to try processing and fail
@@ -155,6 +166,8 @@ namespace Ogre
             "DefaultWorkQueue('" << getName() << "')::WorkerFunc - thread " 
             << OGRE_THREAD_CURRENT_ID << " starting.";
 
+        registerWorkerThread();
+
         // Initialise the thread for RS if necessary
         if (mWorkerRenderSystemAccess)
         {
@@ -31,6 +31,7 @@ Copyright (c) 2000-2014 Torus Knot Software Ltd
 #include "OgreOptimisedUtil.h"
 #include "OgreLodStrategy.h"
 #include "OgreLodListener.h"
+#include "OgreSoftwareVertexBlend.h"
 
 
 namespace Ogre {
@@ -53,6 +54,7 @@ namespace Ogre {
           mBoneWorldMatrices(NULL),
           mBoneMatrices(NULL),
           mFrameAnimationLastUpdated(std::numeric_limits<unsigned long>::max()),
+          mFrameLastQueued(std::numeric_limits<unsigned long>::max()),
           mFrameBonesLastUpdated(NULL),
           mSharedSkeletonEntities(NULL),
         mSoftwareAnimationRequests(0),
@@ -573,6 +575,8 @@ namespace Ogre {
             _initialise(true);
         }
 
+        mFrameLastQueued = Root::getSingleton().getNextFrameNumber();
+
         Entity* displayEntity = this;
 #if !OGRE_NO_MESHLOD
         // Check we're not using a manual LOD
@@ -833,7 +837,7 @@ namespace Ogre {
                         Mesh::prepareMatricesForVertexBlend(blendMatrices,
                                                             mBoneMatrices, mMesh->sharedBlendIndexToBoneIndexMap);
                         // Blend, taking source from either mesh data or morph data
-                        Mesh::softwareVertexBlend(
+                        softwareVertexBlend(
                             (mMesh->getSharedVertexDataAnimationType() != VAT_NONE) ?
                             mSoftwareVertexAnimVertexData.get() : mMesh->sharedVertexData,
                             mSkelAnimVertexData.get(),
@@ -853,7 +857,7 @@ namespace Ogre {
                             Mesh::prepareMatricesForVertexBlend(blendMatrices,
                                                                 mBoneMatrices, se->mSubMesh->blendIndexToBoneIndexMap);
                             // Blend, taking source from either mesh data or morph data
-                            Mesh::softwareVertexBlend(
+                            softwareVertexBlend(
                                 (se->getSubMesh()->getVertexAnimationType() != VAT_NONE)?
                                 se->mSoftwareVertexAnimVertexData.get() : se->mSubMesh->vertexData,
                                 se->mSkelAnimVertexData.get(),
@@ -910,6 +914,16 @@ namespace Ogre {
         }
     }
     //-----------------------------------------------------------------------
+    void Entity::softwareVertexBlend(const VertexData* sourceVertexData, const VertexData* targetVertexData,
+                                     const Affine3* const* blendMatrices, size_t numMatrices, bool blendNormals)
+    {
+        // queue the blend, if the scene manager performs them in parallel
+        if (SoftwareVertexBlendQueue* queue = mManager ? mManager->_getSoftwareVertexBlendQueue() : NULL)
+            queue->add(sourceVertexData, targetVertexData, blendMatrices, numMatrices, blendNormals);
+        else
+            Mesh::softwareVertexBlend(sourceVertexData, targetVertexData, blendMatrices, numMatrices, blendNormals);
+    }
+    //-----------------------------------------------------------------------
     ushort Entity::initHardwareAnimationElements(VertexData* vdata,
                                                  ushort numberOfElements, bool animateNormals)
     {
@@ -1316,6 +1330,35 @@ namespace Ogre {
         return false;
     }
     //-----------------------------------------------------------------------
+    bool Entity::_prepareSkeletonEvaluation(void)
+    {
+        if (!mInitialised || !hasSkeleton() || mSkipAnimStateUpdates)
+            return false;
+
+        unsigned long currentFrameNumber = Root::getSingleton().getNextFrameNumber();
+        bool animationDirty = (mFrameAnimationLastUpdated != mAnimationState->getDirtyFrameNumber()) ||
+                              mSkeletonInstance->getManualBonesDirty();
+        // also skips entities sharing a skeleton that was already prepared
+        if (!animationDirty || *mFrameBonesLastUpdated == currentFrameNumber)
+            return false;
+
+        // updated without Node::_update, so listeners would miss the changes
+        for (auto b : mSkeletonInstance->getBones())
+        {
+            if (b->getListener())
+                return false;
+        }
+
+        mSkeletonInstance->_prepareAnimations(*mAnimationState);
+        *mFrameBonesLastUpdated = currentFrameNumber;
+        return true;
+    }
+    //-----------------------------------------------------------------------
+    void Entity::_evaluateSkeleton(void)
+    {
+        mSkeletonInstance->_evaluateBoneMatrices(*mAnimationState, mBoneMatrices);
+    }
+    //-----------------------------------------------------------------------
     void Entity::setDisplaySkeleton(bool display)
     {
         mDisplaySkeleton = display;
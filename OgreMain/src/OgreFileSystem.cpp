@@ -116,6 +116,7 @@ namespace {
     };
 
     bool gIgnoreHidden = true;
+    bool gUseMmap = false;
 }
 
     //-----------------------------------------------------------------------
@@ -339,7 +340,11 @@ namespace {
 
         if(!readOnly) mode |= std::ios::out;
 
-        return _openFileStream(concatenate_path(mName, filename), mode, filename);
+        String full_path = concatenate_path(mName, filename);
+        if (readOnly && gUseMmap)
+            return std::make_shared<MmapDataStream>(filename, full_path);
+
+        return _openFileStream(full_path, mode, filename);
     }
     DataStreamPtr _openFileStream(const String& full_path, std::ios::openmode mode, const String& name)
     {
@@ -569,4 +574,18 @@ namespace {
     {
         return gIgnoreHidden;
     }
+
+    void FileSystemArchiveFactory::setUseMmap(bool mmap)
+    {
+#if OGRE_PLATFORM == OGRE_PLATFORM_WIN32 || OGRE_PLATFORM == OGRE_PLATFORM_WINRT
+        // rejected here, rather than failing each read later on
+        OgreAssert(!mmap, "Memory mapped files are not supported on this platform");
+#endif
+        gUseMmap = mmap;
+    }
+
+    bool FileSystemArchiveFactory::getUseMmap()
+    {
+        return gUseMmap;
+    }
 }
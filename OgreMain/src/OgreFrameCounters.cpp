@@ -0,0 +1,101 @@
+// This file is part of the OGRE project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at https://www.ogre3d.org/licensing.
+// SPDX-License-Identifier: MIT
+#include "OgreStableHeaders.h"
+#include "OgreFrameCounters.h"
+
+namespace Ogre
+{
+    FrameCounters::Slot FrameCounters::sCounters[MAX_COUNTERS];
+
+    static std::atomic<uint64> sFrameCount(0);
+
+    struct FrameCounterNames
+    {
+        StringVector names;
+        OGRE_WQ_MUTEX(mutex);
+
+        FrameCounterNames()
+            : names({"NodesUpdated", "NodesCulled", "ObjectsVisible", "ObjectsCulled", "RenderablesQueued",
+                     "PassChanges", "GpuProgramBinds", "GpuParameterUploads", "BufferLocks", "BufferBytesLocked",
+                     "ResourcesLoaded"})
+        {
+            // getName returns references, so the names must not move
+            names.reserve(FrameCounters::MAX_COUNTERS);
+        }
+    };
+    static FrameCounterNames& getCounterNames()
+    {
+        static FrameCounterNames names;
+        return names;
+    }
+    //-----------------------------------------------------------------------
+    uint32 FrameCounters::registerCounter(const String& name)
+    {
+        FrameCounterNames& registry = getCounterNames();
+        OGRE_WQ_LOCK_MUTEX(registry.mutex);
+        auto it = std::find(registry.names.begin(), registry.names.end(), name);
+        if (it != registry.names.end())
+            return uint32(it - registry.names.begin());
+
+        OgreAssert(registry.names.size() < MAX_COUNTERS, "too many frame counters");
+        registry.names.push_back(name);
+        return uint32(registry.names.size() - 1);
+    }
+    //-----------------------------------------------------------------------
+    uint32 FrameCounters::getCount()
+    {
+        FrameCounterNames& registry = getCounterNames();
+        OGRE_WQ_LOCK_MUTEX(registry.mutex);
+        return uint32(registry.names.size());
+    }
+    //-----------------------------------------------------------------------
+    const String& FrameCounters::getName(uint32 counter)
+    {
+        FrameCounterNames& registry = getCounterNames();
+        OGRE_WQ_LOCK_MUTEX(registry.mutex);
+        OgreAssert(counter < registry.names.size(), "unknown frame counter");
+        return registry.names[counter];
+    }
+    //-----------------------------------------------------------------------
+    uint64 FrameCounters::getFrameCount()
+    {
+        return sFrameCount.load(std::memory_order_relaxed);
+    }
+    //-----------------------------------------------------------------------
+    String FrameCounters::getCsvHeader()
+    {
+        StringStream str;
+        str << "Frame";
+        for (uint32 i = 0, count = getCount(); i < count; i++)
+            str << "," << getName(i);
+        return str.str();
+    }
+    //-----------------------------------------------------------------------
+    String FrameCounters::getCsvRow()
+    {
+        StringStream str;
+        str << getFrameCount();
+        for (uint32 i = 0, count = getCount(); i < count; i++)
+            str << "," << getValue(i);
+        return str.str();
+    }
+    //-----------------------------------------------------------------------
+    void FrameCounters::reset()
+    {
+        for (auto& c : sCounters)
+        {
+            c.current.store(0, std::memory_order_relaxed);
+            c.last.store(0, std::memory_order_relaxed);
+        }
+        sFrameCount.store(0, std::memory_order_relaxed);
+    }
+    //-----------------------------------------------------------------------
+    void FrameCounters::_frameStarted()
+    {
+        for (auto& c : sCounters)
+            c.last.store(c.current.exchange(0, std::memory_order_relaxed), std::memory_order_relaxed);
+        sFrameCount.fetch_add(1, std::memory_order_relaxed);
+    }
+}
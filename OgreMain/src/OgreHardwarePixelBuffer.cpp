@@ -93,6 +93,9 @@ namespace Ogre
             // Lock the real buffer if there is no shadow buffer 
             mCurrentLock = lockImpl(lockBox, options);
             mIsLocked = true;
+            FrameCounters::add(FrameCounters::BUFFER_LOCKS);
+            FrameCounters::add(FrameCounters::BUFFER_BYTES_LOCKED, PixelUtil::getMemorySize(
+                lockBox.getWidth(), lockBox.getHeight(), lockBox.getDepth(), mFormat));
         }
 
         return mCurrentLock;
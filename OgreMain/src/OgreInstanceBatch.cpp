@@ -427,6 +427,25 @@ namespace Ogre
         mBoundsDirty = true;
     }
     //-----------------------------------------------------------------------
+    static std::vector<InstanceBatch*>*& deferredBoundsDirty()
+    {
+        static thread_local std::vector<InstanceBatch*>* batches = NULL;
+        return batches;
+    }
+    //-----------------------------------------------------------------------
+    void InstanceBatch::_setDeferredBoundsDirty(std::vector<InstanceBatch*>* batches)
+    {
+        deferredBoundsDirty() = batches;
+    }
+    //-----------------------------------------------------------------------
+    void InstanceBatch::_notifyBoundsDirty(void)
+    {
+        if (auto batches = deferredBoundsDirty())
+            batches->push_back(this);
+        else
+            _boundsDirty();
+    }
+    //-----------------------------------------------------------------------
     const String& InstanceBatch::getMovableType(void) const
     {
         return MOT_INSTANCE_BATCH;
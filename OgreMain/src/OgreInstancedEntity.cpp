@@ -429,7 +429,8 @@ namespace Ogre
     {
         mNeedTransformUpdate = true;
         mNeedAnimTransformUpdate = true; 
-        mBatchOwner->_boundsDirty();
+        // the batch and its manager are shared with entities updated on other threads
+        mBatchOwner->_notifyBoundsDirty();
     }
 
     //---------------------------------------------------------------------------
@@ -36,6 +36,7 @@ THE SOFTWARE.
 #include "OgreTangentSpaceCalc.h"
 #include "OgreLodStrategyManager.h"
 #include "OgrePixelCountLodStrategy.h"
+#include "OgreSoftwareVertexBlend.h"
 
 namespace Ogre {
     //-----------------------------------------------------------------------
@@ -209,8 +210,9 @@ namespace Ogre {
             ResourceGroupManager::getSingleton().openResource(
                 mName, mGroup, this);
  
-        // fully prebuffer into host RAM
-        mFreshFromDisk = DataStreamPtr(OGRE_NEW MemoryDataStream(mName,mFreshFromDisk));
+        // fully prebuffer into host RAM, unless it already is in memory or mapped
+        if (!dynamic_cast<MemoryDataStream*>(mFreshFromDisk.get()))
+            mFreshFromDisk = DataStreamPtr(OGRE_NEW MemoryDataStream(mName,mFreshFromDisk));
     }
     //-----------------------------------------------------------------------
     void Mesh::unprepareImpl()
@@ -268,6 +270,7 @@ namespace Ogre {
 
         // Clear bone assignments
         mBoneAssignments.clear();
+        mPackedBoneAssignments = PackedBoneAssignments();
         mBoneAssignmentsOutOfDate = false;
 
         // Removes reference to skeleton
@@ -327,6 +330,7 @@ namespace Ogre {
         newMesh->mSubMeshNameMap = mSubMeshNameMap ;
         // Copy any bone assignments
         newMesh->mBoneAssignments = mBoneAssignments;
+        newMesh->mPackedBoneAssignments = mPackedBoneAssignments;
         newMesh->mBoneAssignmentsOutOfDate = mBoneAssignmentsOutOfDate;
         // Copy bounds
         newMesh->mAABB = mAABB;
@@ -515,12 +519,14 @@ namespace Ogre {
     void Mesh::addBoneAssignment(const VertexBoneAssignment& vertBoneAssign)
     {
         mBoneAssignments.emplace(vertBoneAssign.vertexIndex, vertBoneAssign);
+        mPackedBoneAssignments = PackedBoneAssignments();
         mBoneAssignmentsOutOfDate = true;
     }
     //-----------------------------------------------------------------------
     void Mesh::clearBoneAssignments(void)
     {
         mBoneAssignments.clear();
+        mPackedBoneAssignments = PackedBoneAssignments();
         mBoneAssignmentsOutOfDate = true;
     }
     //-----------------------------------------------------------------------
@@ -596,7 +602,7 @@ namespace Ogre {
     }
     //-----------------------------------------------------------------------
     typedef std::multimap<Real, Mesh::VertexBoneAssignmentList::iterator> WeightIteratorMap;
-    unsigned short Mesh::_rationaliseBoneAssignments(size_t vertexCount, Mesh::VertexBoneAssignmentList& assignments)
+    unsigned short Mesh::_rationaliseBoneAssignments(size_t vertexCount, Mesh::VertexBoneAssignmentList& assignments) const
     {
         // Iterate through, finding the largest # bones per vertex
         unsigned short maxBones = 0;
@@ -693,7 +699,15 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     void  Mesh::_compileBoneAssignments(void)
     {
-        if (sharedVertexData)
+        const auto& packed = mPackedBoneAssignments;
+        if (sharedVertexData && packed.weightsPerVertex &&
+            packed.data.size() == sharedVertexData->vertexCount * (4 + sizeof(float) * packed.weightsPerVertex))
+        {
+            // as loaded, no need to rationalise them again
+            compileBoneAssignments(mPackedBoneAssignments, sharedBlendIndexToBoneIndexMap, sharedVertexData);
+            mPackedBoneAssignments = PackedBoneAssignments();
+        }
+        else if (sharedVertexData)
         {
             unsigned short maxBones = _rationaliseBoneAssignments(sharedVertexData->vertexCount, mBoneAssignments);
 
@@ -740,23 +754,71 @@ namespace Ogre {
         }
     }
     //---------------------------------------------------------------------
+    void Mesh::packBoneAssignments(const VertexBoneAssignmentList& boneAssignments,
+        unsigned short numBlendWeightsPerVertex, const IndexMap& boneIndexToBlendIndexMap,
+        size_t vertexCount, uchar* pDest)
+    {
+        OgreAssert(numBlendWeightsPerVertex <= 4, "at most 4 blend weights per vertex");
+        auto i = boneAssignments.begin();
+        auto iend = boneAssignments.end();
+        // Iterate by vertex
+        for (size_t v = 0; v < vertexCount; ++v)
+        {
+            // collect the indices/weights in these arrays
+            uchar indices[ 4 ] = { 0, 0, 0, 0 };
+            float weights[ 4 ] = { 1.0f, 0.0f, 0.0f, 0.0f };
+            for (unsigned short bone = 0; bone < numBlendWeightsPerVertex; ++bone)
+            {
+                // Do we still have data for this vertex?
+                if (i != iend && i->second.vertexIndex == v)
+                {
+                    // If so, grab weight and index
+                    weights[ bone ] = i->second.weight;
+                    indices[ bone ] = static_cast<uchar>( boneIndexToBlendIndexMap[ i->second.boneIndex ] );
+                    ++i;
+                }
+            }
+            memcpy(pDest, indices, sizeof(indices));
+            pDest += sizeof(indices);
+            memcpy(pDest, weights, sizeof(float) * numBlendWeightsPerVertex);
+            pDest += sizeof(float) * numBlendWeightsPerVertex;
+        }
+    }
+    //---------------------------------------------------------------------
     void Mesh::compileBoneAssignments(
         const VertexBoneAssignmentList& boneAssignments,
         unsigned short numBlendWeightsPerVertex,
         IndexMap& blendIndexToBoneIndexMap,
         VertexData* targetVertexData)
     {
+        // Build the index map brute-force. The .mesh format stores it along with the packed
+        // assignments, see MeshSerializerImpl::writeMeshBoneAssignments
+        IndexMap boneIndexToBlendIndexMap;
+        PackedBoneAssignments packed;
+        buildIndexMap(boneAssignments, boneIndexToBlendIndexMap, packed.blendIndexToBoneIndexMap);
+
+        packed.weightsPerVertex = numBlendWeightsPerVertex;
+        packed.data.resize(targetVertexData->vertexCount * (4 + sizeof(float) * numBlendWeightsPerVertex));
+        packBoneAssignments(boneAssignments, numBlendWeightsPerVertex, boneIndexToBlendIndexMap,
+                            targetVertexData->vertexCount, packed.data.data());
+
+        compileBoneAssignments(packed, blendIndexToBoneIndexMap, targetVertexData);
+    }
+    //---------------------------------------------------------------------
+    void Mesh::compileBoneAssignments(const PackedBoneAssignments& packed, IndexMap& blendIndexToBoneIndexMap,
+                                      VertexData* targetVertexData)
+    {
+        unsigned short numBlendWeightsPerVertex = packed.weightsPerVertex;
+        size_t packedVertexSize = 4 + sizeof(float) * numBlendWeightsPerVertex;
+        OgreAssert(packed.data.size() == targetVertexData->vertexCount * packedVertexSize,
+                   "packed bone assignments do not match the vertex count");
+        blendIndexToBoneIndexMap = packed.blendIndexToBoneIndexMap;
+
         // Create or reuse blend weight / indexes buffer
         // Indices are always a UBYTE4 no matter how many weights per vertex
         VertexDeclaration* decl = targetVertexData->vertexDeclaration;
         VertexBufferBinding* bind = targetVertexData->vertexBufferBinding;
         unsigned short bindIndex;
-
-        // Build the index map brute-force. It's possible to store the index map
-        // in .mesh, but maybe trivial.
-        IndexMap boneIndexToBlendIndexMap;
-        buildIndexMap(boneAssignments, boneIndexToBlendIndexMap, blendIndexToBoneIndexMap);
-
         const VertexElement* testElem =
             decl->findElementBySemantic(VES_BLEND_INDICES);
         if (testElem)
@@ -825,7 +887,9 @@ namespace Ogre {
             	OgreAssert(false, "Invalid BlendWeightsBaseElementType");
             	break;
             case VET_FLOAT1:
-                break;
+                // the packed layout matches a float weights buffer
+                vbuf->writeData(0, packed.data.size(), packed.data.data(), true);
+                return;
             case VET_UBYTE4_NORM:
                 maxIntWt = 0xff;
                 break;
@@ -837,97 +901,72 @@ namespace Ogre {
                 break;
         }
         // Assign data
-        size_t v;
-        VertexBoneAssignmentList::const_iterator i, iend;
-        i = boneAssignments.begin();
-        iend = boneAssignments.end();
+        const uchar* pSrc = packed.data.data();
         HardwareBufferLockGuard vertexLock(vbuf, HardwareBuffer::HBL_DISCARD);
         unsigned char *pBase = static_cast<unsigned char*>(vertexLock.pData);
         // Iterate by vertex
-        for (v = 0; v < targetVertexData->vertexCount; ++v)
-        {
-            // collect the indices/weights in these arrays
-            unsigned char indices[ 4 ] = { 0, 0, 0, 0 };
-            float weights[ 4 ] = { 1.0f, 0.0f, 0.0f, 0.0f };
-            for (unsigned short bone = 0; bone < numBlendWeightsPerVertex; ++bone)
+        for (size_t v = 0; v < targetVertexData->vertexCount; ++v)
+        {
+            unsigned char indices[ 4 ];
+            float weights[ 4 ] = { 0.0f, 0.0f, 0.0f, 0.0f };
+            memcpy(indices, pSrc, sizeof(indices));
+            memcpy(weights, pSrc + sizeof(indices), sizeof(float) * numBlendWeightsPerVertex);
+            pSrc += packedVertexSize;
+
+            // pack the float weights into shorts/bytes
+            unsigned int intWeights[ 4 ];
+            unsigned int sum = 0;
+            const unsigned int wtScale = maxIntWt;  // this value corresponds to a weight of 1.0
+            for ( int ii = 0; ii < 4; ++ii )
             {
-                // Do we still have data for this vertex?
-                if (i != iend && i->second.vertexIndex == v)
-                {
-                    // If so, grab weight and index
-                    weights[ bone ] = i->second.weight;
-                    indices[ bone ] = static_cast<unsigned char>( boneIndexToBlendIndexMap[ i->second.boneIndex ] );
-                    ++i;
-                }
+                unsigned int bw = static_cast<unsigned int>( weights[ ii ] * wtScale );
+                intWeights[ ii ] = bw;
+                sum += bw;
             }
-            // if weights are integers,
-            if ( weightsBaseType != VET_FLOAT1 )
+            // if the sum doesn't add up due to roundoff error, we need to adjust the intWeights so that the sum is wtScale
+            if ( sum != maxIntWt )
             {
-                // pack the float weights into shorts/bytes
-                unsigned int intWeights[ 4 ];
-                unsigned int sum = 0;
-                const unsigned int wtScale = maxIntWt;  // this value corresponds to a weight of 1.0
+                // find the largest weight (it isn't necessarily the first one...)
+                int iMaxWeight = 0;
+                unsigned int maxWeight = 0;
                 for ( int ii = 0; ii < 4; ++ii )
                 {
-                    unsigned int bw = static_cast<unsigned int>( weights[ ii ] * wtScale );
-                    intWeights[ ii ] = bw;
-                    sum += bw;
-                }
-                // if the sum doesn't add up due to roundoff error, we need to adjust the intWeights so that the sum is wtScale
-                if ( sum != maxIntWt )
-                {
-                    // find the largest weight (it isn't necessarily the first one...)
-                    int iMaxWeight = 0;
-                    unsigned int maxWeight = 0;
-                    for ( int ii = 0; ii < 4; ++ii )
+                    unsigned int bw = intWeights[ ii ];
+                    if ( bw > maxWeight )
                     {
-                        unsigned int bw = intWeights[ ii ];
-                        if ( bw > maxWeight )
-                        {
-                            iMaxWeight = ii;
-                            maxWeight = bw;
-                        }
+                        iMaxWeight = ii;
+                        maxWeight = bw;
                     }
-                    // Adjust the largest weight to make sure the sum is correct.
-                    // The idea is that changing the largest weight will have the smallest effect
-                    // on the ratio of weights.  This works best when there is one dominant weight,
-                    // and worst when 2 or more weights are similar in magnitude.
-                    // A better method could be used to reduce the quantization error, but this is
-                    // being done at run-time so it needs to be quick.
-                    intWeights[ iMaxWeight ] += maxIntWt - sum;
                 }
+                // Adjust the largest weight to make sure the sum is correct.
+                // The idea is that changing the largest weight will have the smallest effect
+                // on the ratio of weights.  This works best when there is one dominant weight,
+                // and worst when 2 or more weights are similar in magnitude.
+                // A better method could be used to reduce the quantization error, but this is
+                // being done at run-time so it needs to be quick.
+                intWeights[ iMaxWeight ] += maxIntWt - sum;
+            }
 
-                // now write the weights
-                if ( weightsBaseType == VET_UBYTE4_NORM )
-                {
-                    // write out the weights as bytes
-                    unsigned char* pWeight;
-                    pWeightElem->baseVertexPointerToElement( pBase, &pWeight );
-                    // NOTE: always writes out 4 regardless of numBlendWeightsPerVertex
-                    for (unsigned int intWeight : intWeights)
-                    {
-                        *pWeight++ = static_cast<unsigned char>( intWeight );
-                    }
-                }
-                else
+            // now write the weights
+            if ( weightsBaseType == VET_UBYTE4_NORM )
+            {
+                // write out the weights as bytes
+                unsigned char* pWeight;
+                pWeightElem->baseVertexPointerToElement( pBase, &pWeight );
+                // NOTE: always writes out 4 regardless of numBlendWeightsPerVertex
+                for (unsigned int intWeight : intWeights)
                 {
-                    // write out the weights as shorts
-                    unsigned short* pWeight;
-                    pWeightElem->baseVertexPointerToElement( pBase, &pWeight );
-                    for ( int ii = 0; ii < numBlendWeightsPerVertex; ++ii )
-                    {
-                        *pWeight++ = static_cast<unsigned short>( intWeights[ ii ] );
-                    }
+                    *pWeight++ = static_cast<unsigned char>( intWeight );
                 }
             }
             else
             {
-                // write out the weights as floats
-                float* pWeight;
+                // write out the weights as shorts
+                unsigned short* pWeight;
                 pWeightElem->baseVertexPointerToElement( pBase, &pWeight );
                 for ( int ii = 0; ii < numBlendWeightsPerVertex; ++ii )
                 {
-                    *pWeight++ = weights[ ii ];
+                    *pWeight++ = static_cast<unsigned short>( intWeights[ ii ] );
                 }
             }
             unsigned char* pIndex;
@@ -1798,15 +1837,16 @@ namespace Ogre {
         const Affine3* const* blendMatrices, size_t numMatrices,
         bool blendNormals)
     {
-        float *pSrcPos = 0;
-        float *pSrcNorm = 0;
-        float *pDestPos = 0;
-        float *pDestNorm = 0;
-        float *pBlendWeight = 0;
-        unsigned char* pBlendIdx = 0;
-        size_t srcNormStride = 0;
-        size_t destNormStride = 0;
-
+        SoftwareVertexBlendQueue queue;
+        queue.add(sourceVertexData, targetVertexData, blendMatrices, numMatrices, blendNormals);
+        queue.flush();
+    }
+    //---------------------------------------------------------------------
+    void SoftwareVertexBlendQueue::add(const VertexData* sourceVertexData,
+        const VertexData* targetVertexData,
+        const Affine3* const* blendMatrices, size_t numMatrices,
+        bool blendNormals)
+    {
         // Get elements for source
         auto srcElemPos = sourceVertexData->vertexDeclaration->findElementBySemantic(VES_POSITION);
         auto srcElemNorm = sourceVertexData->vertexDeclaration->findElementBySemantic(VES_NORMAL);
@@ -1818,86 +1858,152 @@ namespace Ogre {
         auto destElemPos = targetVertexData->vertexDeclaration->findElementBySemantic(VES_POSITION);
         auto destElemNorm = targetVertexData->vertexDeclaration->findElementBySemantic(VES_NORMAL);
 
-        // Get buffers for source
-        HardwareVertexBufferSharedPtr srcPosBuf = sourceVertexData->vertexBufferBinding->getBuffer(srcElemPos->getSource());
-        HardwareVertexBufferSharedPtr srcIdxBuf = sourceVertexData->vertexBufferBinding->getBuffer(srcElemBlendIndices->getSource());
-        HardwareVertexBufferSharedPtr srcWeightBuf = sourceVertexData->vertexBufferBinding->getBuffer(srcElemBlendWeights->getSource());
-        HardwareVertexBufferSharedPtr srcNormBuf;
-
-        // Get buffers for target
-        HardwareVertexBufferSharedPtr destPosBuf = targetVertexData->vertexBufferBinding->getBuffer(destElemPos->getSource());
+        // Indices must be 4 bytes
+        assert(srcElemBlendIndices->getType() == VET_UBYTE4 && "Blend indices must be VET_UBYTE4");
 
-        // Lock source buffers for reading
-        HardwareBufferLockGuard srcPosLock(srcPosBuf, HardwareBuffer::HBL_READ_ONLY);
-        srcElemPos->baseVertexPointerToElement(srcPosLock.pData, &pSrcPos);
+        // only record the buffers, they are locked by flush
+        auto getElement = [](const VertexData* data, const VertexElement* elem) {
+            Element ret = Element();
+            ret.buffer = data->vertexBufferBinding->getBuffer(elem->getSource());
+            ret.offset = elem->getOffset();
+            ret.stride = ret.buffer->getVertexSize();
+            return ret;
+        };
+
+        Blend blend = Blend();
+        blend.srcPos = getElement(sourceVertexData, srcElemPos);
+        blend.destPos = getElement(targetVertexData, destElemPos);
+        blend.blendIndex = getElement(sourceVertexData, srcElemBlendIndices);
+        blend.blendWeight = getElement(sourceVertexData, srcElemBlendWeights);
 
         // Do we have normals and want to blend them?
         bool includeNormals = blendNormals && srcElemNorm && destElemNorm;
-        HardwareVertexBufferSharedPtr destNormBuf;
-        HardwareBufferLockGuard srcNormLock;
         if (includeNormals)
         {
-            // Get buffers for source
-            srcNormBuf = sourceVertexData->vertexBufferBinding->getBuffer(srcElemNorm->getSource());
-            srcNormStride = srcNormBuf->getVertexSize();
-            // Get buffers for target
-            destNormBuf = targetVertexData->vertexBufferBinding->getBuffer(destElemNorm->getSource());
-            destNormStride = destNormBuf->getVertexSize();
+            blend.srcNorm = getElement(sourceVertexData, srcElemNorm);
+            blend.destNorm = getElement(targetVertexData, destElemNorm);
+        }
 
-            if (srcNormBuf != srcPosBuf)
+        // discard the destination contents, unless other elements share the buffer
+        const auto& destPosBuf = blend.destPos.buffer;
+        const auto& destNormBuf = blend.destNorm.buffer;
+        blend.destPosOptions =
+            (destNormBuf != destPosBuf && destPosBuf->getVertexSize() == destElemPos->getSize()) ||
+                    (destNormBuf == destPosBuf &&
+                     destPosBuf->getVertexSize() == destElemPos->getSize() + destElemNorm->getSize())
+                ? HardwareBuffer::HBL_DISCARD
+                : HardwareBuffer::HBL_NORMAL;
+        blend.destNormOptions = includeNormals && destNormBuf->getVertexSize() == destElemNorm->getSize()
+                                    ? HardwareBuffer::HBL_DISCARD
+                                    : HardwareBuffer::HBL_NORMAL;
+
+        blend.numWeightsPerVertex = VertexElement::getTypeCount(srcElemBlendWeights->getType());
+        blend.numVertices = targetVertexData->vertexCount;
+        // the array of the caller is usually on the stack, so keep a copy
+        blend.firstMatrix = mMatrices.size();
+        mMatrices.insert(mMatrices.end(), blendMatrices, blendMatrices + numMatrices);
+        mBlends.push_back(blend);
+    }
+    //---------------------------------------------------------------------
+    template <typename T> static T* offsetVertices(void* p, size_t stride, size_t index)
+    {
+        return p ? reinterpret_cast<T*>(static_cast<uchar*>(p) + stride * index) : NULL;
+    }
+    //---------------------------------------------------------------------
+    void SoftwareVertexBlendQueue::flush()
+    {
+        // split large blends, so a few big meshes are distributed as well. A multiple of 16 vertices keeps
+        // the alignment of the buffers for SIMD.
+        const size_t verticesPerSlice = 2048;
+        mSlices.clear();
+        for (size_t i = 0; i < mBlends.size(); i++)
+        {
+            Blend& b = mBlends[i];
+            auto lockElement = [](Element& e, void* base) {
+                e.ptr = base ? static_cast<uchar*>(base) + e.offset : NULL;
+            };
+
+            // Lock source buffers for reading
+            lockElement(b.srcPos, lockForRead(b.srcPos.buffer));
+            lockElement(b.blendIndex, lockForRead(b.blendIndex.buffer));
+            lockElement(b.blendWeight, lockForRead(b.blendWeight.buffer));
+            if (b.srcNorm.buffer)
+                lockElement(b.srcNorm, lockForRead(b.srcNorm.buffer));
+
+            // Lock destination buffers for writing
+            void* pDestPosData = lockForWrite(b.destPos.buffer, b.destPosOptions);
+            lockElement(b.destPos, pDestPosData);
+            if (b.destNorm.buffer)
             {
-                // Different buffer
-                srcNormLock.lock(srcNormBuf, HardwareBuffer::HBL_READ_ONLY);
+                lockElement(b.destNorm, b.destNorm.buffer == b.destPos.buffer
+                                            ? pDestPosData
+                                            : lockForWrite(b.destNorm.buffer, b.destNormOptions));
             }
-            srcElemNorm->baseVertexPointerToElement(srcNormLock.pData ? srcNormLock.pData : srcPosLock.pData, &pSrcNorm);
-        }
 
-        // Indices must be 4 bytes
-        assert(srcElemBlendIndices->getType() == VET_UBYTE4 && "Blend indices must be VET_UBYTE4");
-        HardwareBufferLockGuard srcIdxLock(srcIdxBuf, HardwareBuffer::HBL_READ_ONLY);
-        srcElemBlendIndices->baseVertexPointerToElement(srcIdxLock.pData, &pBlendIdx);
-        HardwareBufferLockGuard srcWeightLock;
-        if (srcWeightBuf != srcIdxBuf)
-        {
-            // Lock buffer
-            srcWeightLock.lock(srcWeightBuf, HardwareBuffer::HBL_READ_ONLY);
+            for (size_t v = 0; v < b.numVertices; v += verticesPerSlice)
+            {
+                Slice slice = {i, v, std::min(v + verticesPerSlice, b.numVertices)};
+                mSlices.push_back(slice);
+            }
         }
-        srcElemBlendWeights->baseVertexPointerToElement(srcWeightLock.pData ? srcWeightLock.pData : srcIdxLock.pData, &pBlendWeight);
-        unsigned short numWeightsPerVertex = VertexElement::getTypeCount(srcElemBlendWeights->getType());
 
-        // Lock destination buffers for writing
-        HardwareBufferLockGuard destPosLock(destPosBuf,
-            (destNormBuf != destPosBuf && destPosBuf->getVertexSize() == destElemPos->getSize()) ||
-            (destNormBuf == destPosBuf && destPosBuf->getVertexSize() == destElemPos->getSize() + destElemNorm->getSize()) ?
-            HardwareBuffer::HBL_DISCARD : HardwareBuffer::HBL_NORMAL);
-        destElemPos->baseVertexPointerToElement(destPosLock.pData, &pDestPos);
-        HardwareBufferLockGuard destNormLock;
-        if (includeNormals)
-        {
-            if (destNormBuf != destPosBuf)
+        auto blendSlices = [this](size_t begin, size_t end) {
+            OptimisedUtil* util = OptimisedUtil::getImplementation();
+            for (size_t i = begin; i < end; i++)
             {
-                destNormLock.lock(destNormBuf, destNormBuf->getVertexSize() == destElemNorm->getSize()
-                                                   ? HardwareBuffer::HBL_DISCARD
-                                                   : HardwareBuffer::HBL_NORMAL);
+                const Slice& s = mSlices[i];
+                const Blend& b = mBlends[s.blend];
+                util->softwareVertexSkinning(
+                    offsetVertices<float>(b.srcPos.ptr, b.srcPos.stride, s.begin),
+                    offsetVertices<float>(b.destPos.ptr, b.destPos.stride, s.begin),
+                    offsetVertices<float>(b.srcNorm.ptr, b.srcNorm.stride, s.begin),
+                    offsetVertices<float>(b.destNorm.ptr, b.destNorm.stride, s.begin),
+                    offsetVertices<float>(b.blendWeight.ptr, b.blendWeight.stride, s.begin),
+                    offsetVertices<unsigned char>(b.blendIndex.ptr, b.blendIndex.stride, s.begin),
+                    mMatrices.data() + b.firstMatrix,
+                    b.srcPos.stride, b.destPos.stride,
+                    b.srcNorm.stride, b.destNorm.stride,
+                    b.blendWeight.stride, b.blendIndex.stride,
+                    b.numWeightsPerVertex,
+                    s.end - s.begin);
             }
-            destElemNorm->baseVertexPointerToElement(destNormLock.pData ? destNormLock.pData : destPosLock.pData, &pDestNorm);
-        }
-
-        auto srcPosStride = srcPosBuf->getVertexSize();
-        auto destPosStride = destPosBuf->getVertexSize();
-        auto blendIdxStride = srcIdxBuf->getVertexSize();
-        auto blendWeightStride = srcWeightBuf->getVertexSize();
-
-        OptimisedUtil::getImplementation()->softwareVertexSkinning(
-            pSrcPos, pDestPos,
-            pSrcNorm, pDestNorm,
-            pBlendWeight, pBlendIdx,
-            blendMatrices,
-            srcPosStride, destPosStride,
-            srcNormStride, destNormStride,
-            blendWeightStride, blendIdxStride,
-            numWeightsPerVertex,
-            targetVertexData->vertexCount);
+        };
+        WorkQueue* workQueue = Root::getSingletonPtr() ? Root::getSingleton().getWorkQueue() : NULL;
+        WorkQueue::parallelFor(workQueue, mSlices.size(), 1, blendSlices);
+
+        // drop the buffer references along with the blends
+        mBlends.clear();
+        mMatrices.clear();
+        unlockBuffers();
+    }
+    //---------------------------------------------------------------------
+    void* SoftwareVertexBlendQueue::lockForRead(const HardwareVertexBufferSharedPtr& buf)
+    {
+        auto it = mReadLocks.find(buf.get());
+        if (it != mReadLocks.end())
+            return it->second;
+
+        void* pData = buf->lock(HardwareBuffer::HBL_READ_ONLY);
+        mLockedBuffers.push_back(buf);
+        mReadLocks[buf.get()] = pData;
+        return pData;
+    }
+    //---------------------------------------------------------------------
+    void* SoftwareVertexBlendQueue::lockForWrite(const HardwareVertexBufferSharedPtr& buf,
+                                                 HardwareBuffer::LockOptions options)
+    {
+        OgreAssert(mReadLocks.find(buf.get()) == mReadLocks.end(), "Blend target is used as a source");
+        void* pData = buf->lock(options);
+        mLockedBuffers.push_back(buf);
+        return pData;
+    }
+    //---------------------------------------------------------------------
+    void SoftwareVertexBlendQueue::unlockBuffers()
+    {
+        for (auto& buf : mLockedBuffers)
+            buf->unlock();
+        mLockedBuffers.clear();
+        mReadLocks.clear();
     }
     //---------------------------------------------------------------------
     void Mesh::softwareVertexMorph(float t,
@@ -77,6 +77,15 @@ namespace Ogre {
                     // unsigned int vertexIndex;
                     // unsigned short boneIndex;
                     // float weight;
+                M_SUBMESH_BONE_WEIGHTS = 0x4110,
+                    // Optional bone weights of all vertices, replaces M_SUBMESH_BONE_ASSIGNMENT (since 14.4)
+                    // unsigned short weightsPerVertex;
+                    // unsigned short blendIndexCount;
+                    // unsigned short* blendIndexToBoneIndex (x blendIndexCount)
+                    // unsigned char* assignmentCount (x vertexCount)
+                    // for each vertex, like a buffer of VET_UBYTE4 blend indices and VET_FLOATn blend weights:
+                    //     unsigned char blendIndices[4];
+                    //     float weights[weightsPerVertex];
                 // Optional chunk that matches a texture name to an alias
                 // a texture alias is sent to the submesh material to use this texture name
                 // instead of the one in the texture unit with a matching alias name
@@ -106,6 +115,9 @@ namespace Ogre {
                 // unsigned int vertexIndex;
                 // unsigned short boneIndex;
                 // float weight;
+            M_MESH_BONE_WEIGHTS = 0x7100,
+                // Optional bone weights of all shared vertices, replaces M_MESH_BONE_ASSIGNMENT (since 14.4)
+                // same layout as M_SUBMESH_BONE_WEIGHTS
             M_MESH_LOD_LEVEL = 0x8000,
                 // Optional LOD information
                 // string strategyName;
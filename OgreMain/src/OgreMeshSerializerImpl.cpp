@@ -44,11 +44,15 @@ namespace Ogre {
 
     /// stream overhead = ID + size
     const long MSTREAM_OVERHEAD_SIZE = sizeof(uint16) + sizeof(uint32);
+    /// below this, decoding is not worth handing out to the workers
+    const size_t PARALLEL_DECODE_MIN_BYTES = 256 * 1024;
+    /// bytes decoded by a single job
+    const size_t DECODE_JOB_BYTES = 128 * 1024;
     //---------------------------------------------------------------------
-    MeshSerializerImpl::MeshSerializerImpl()
+    MeshSerializerImpl::MeshSerializerImpl() : mDecodeJobBytes(0), mWorkersCanAccessRenderSystem(false)
     {
         // Version number
-        mVersion = "[MeshSerializer_v1.100]";
+        mVersion = "[MeshSerializer_v14.4]";
     }
     //---------------------------------------------------------------------
     MeshSerializerImpl::~MeshSerializerImpl()
@@ -78,6 +82,7 @@ namespace Ogre {
                 "MeshSerializerImpl::exportMesh");
         }
 
+        mPackedBoneWeights.clear();
         writeFileHeader();
         LogManager::getSingleton().logMessage("File header written.");
 
@@ -88,6 +93,7 @@ namespace Ogre {
         popInnerChunk(mStream);
         LogManager::getSingleton().logMessage("Mesh data exported.");
 
+        mPackedBoneWeights.clear();
         LogManager::getSingleton().logMessage("MeshSerializer export successful.");
     }
     //---------------------------------------------------------------------
@@ -99,6 +105,15 @@ namespace Ogre {
 #if OGRE_SERIALIZER_VALIDATE_CHUNKSIZE
         enableValidation();
 #endif
+        // the chunks are parsed in order, while decoding the large ones is deferred to runDeferredJobs
+        mDecodeJobs.clear();
+        mUploadJobs.clear();
+        mDecodeJobBytes = 0;
+        // custom queues are assumed not to set up their threads for the render system
+        auto root = Root::getSingletonPtr();
+        auto workQueue = root ? dynamic_cast<DefaultWorkQueueBase*>(root->getWorkQueue()) : NULL;
+        mWorkersCanAccessRenderSystem = workQueue && workQueue->getWorkersCanAccessRenderSystem();
+
         // Check header
         readFileHeader(stream);
         pushInnerChunk(stream);
@@ -116,6 +131,8 @@ namespace Ogre {
             streamID = readChunk(stream);
         }
         popInnerChunk(stream);
+
+        runDeferredJobs();
     }
     //---------------------------------------------------------------------
     void MeshSerializerImpl::writeMesh(const Mesh* pMesh)
@@ -156,12 +173,7 @@ namespace Ogre {
             {
                 LogManager::getSingleton().logMessage("Exporting shared geometry bone assignments...");
 
-                Mesh::VertexBoneAssignmentList::const_iterator vi;
-                for (vi = pMesh->mBoneAssignments.begin();
-                vi != pMesh->mBoneAssignments.end(); ++vi)
-                {
-                    writeMeshBoneAssignment(vi->second);
-                }
+                writeMeshBoneAssignments(pMesh);
 
                 LogManager::getSingleton().logMessage("Shared geometry bone assignments exported.");
             }
@@ -281,10 +293,7 @@ namespace Ogre {
         if (!s->mBoneAssignments.empty())
         {
             LogManager::getSingleton().logMessage("Exporting dedicated geometry bone assignments...");
-            for (auto& vi : s->mBoneAssignments)
-            {
-                writeSubMeshBoneAssignment(vi.second);
-            }
+            writeSubMeshBoneAssignments(s);
             LogManager::getSingleton().logMessage("Dedicated geometry bone assignments exported.");
         }
         popInnerChunk(mStream);
@@ -479,7 +488,7 @@ namespace Ogre {
         {
             size += calcSkeletonLinkSize(pMesh->getSkeletonName());
             // Write bone assignments
-            size += pMesh->mBoneAssignments.size() * calcBoneAssignmentSize();
+            size += calcMeshBoneAssignmentsSize(pMesh);
         }
         
 #if !OGRE_NO_MESHLOD
@@ -546,7 +555,7 @@ namespace Ogre {
         size += calcSubMeshOperationSize();
 
         // Bone assignments
-        size += pSub->mBoneAssignments.size() * calcBoneAssignmentSize();
+        size += calcSubMeshBoneAssignmentsSize(pSub);
 
         return size;
     }
@@ -622,11 +631,25 @@ namespace Ogre {
             popInnerChunk(stream);
         }
 
+        auto rs = Root::getSingletonPtr() ? Root::getSingleton().getRenderSystem() : NULL;
+        bool convert16x3 = rs && !rs->getCapabilities()->hasCapability(RSC_VERTEX_FORMAT_16X3);
+
+        // the conversions need the buffer contents
+        for (auto& elem : dest->vertexDeclaration->getElements())
+        {
+            VertexElementType type = elem.getType();
+            if (type == _DETAIL_SWAP_RB ||
+                (convert16x3 && (type == VET_HALF3 || type == VET_SHORT3 || type == VET_USHORT3)))
+            {
+                runDeferredJobs();
+                break;
+            }
+        }
+
         // Perform any necessary colour conversions from ARGB to ABGR (UBYTE4)
         dest->convertPackedColour(_DETAIL_SWAP_RB, VET_UBYTE4_NORM);
 
-        auto rs = Root::getSingletonPtr() ? Root::getSingleton().getRenderSystem() : NULL;
-        if(!rs || rs->getCapabilities()->hasCapability(RSC_VERTEX_FORMAT_16X3))
+        if(!convert16x3)
             return;
 
         for(auto& elem : dest->vertexDeclaration->getElements())
@@ -737,15 +760,12 @@ namespace Ogre {
             dest->vertexCount,
             pMesh->mVertexBufferUsage,
             pMesh->mVertexBufferShadowBuffer);
-        HardwareBufferLockGuard vbufLock(vbuf, HardwareBuffer::HBL_DISCARD);
-        stream->read(vbufLock.pData, dest->vertexCount * vertexSize);
-
         // endian conversion for OSX
-        flipFromLittleEndian(
-            vbufLock.pData,
-            dest->vertexCount,
-            vertexSize,
-            dest->vertexDeclaration->findElementsBySource(bindIndex));
+        auto elems = dest->vertexDeclaration->findElementsBySource(bindIndex);
+        size_t vertexCount = dest->vertexCount;
+        readBufferData(stream, vbuf, vertexCount * vertexSize, [this, elems, vertexCount, vertexSize](void* pData) {
+            flipEndian(pData, vertexCount, vertexSize, elems);
+        });
 
         // Set binding
         dest->vertexBufferBinding->setBinding(bindIndex, vbuf);
@@ -820,6 +840,7 @@ namespace Ogre {
                  streamID == M_SUBMESH ||
                  streamID == M_MESH_SKELETON_LINK ||
                  streamID == M_MESH_BONE_ASSIGNMENT ||
+                 streamID == M_MESH_BONE_WEIGHTS ||
                  streamID == M_MESH_LOD_LEVEL ||
                  streamID == M_MESH_BOUNDS ||
                  streamID == M_SUBMESH_NAME_TABLE ||
@@ -852,6 +873,9 @@ namespace Ogre {
                 case M_MESH_BONE_ASSIGNMENT:
                     readMeshBoneAssignment(stream, pMesh);
                     break;
+                case M_MESH_BONE_WEIGHTS:
+                    readMeshBoneWeights(stream, pMesh);
+                    break;
                 case M_MESH_LOD_LEVEL:
                     readMeshLodLevel(stream, pMesh);
                     break;
@@ -931,8 +955,8 @@ namespace Ogre {
                         sm->indexData->indexCount,
                         pMesh->mIndexBufferUsage,
                         pMesh->mIndexBufferShadowBuffer);
-                HardwareBufferLockGuard ibufLock(ibuf, HardwareBuffer::HBL_DISCARD);
-                readInts(stream, static_cast<unsigned int*>(ibufLock.pData), sm->indexData->indexCount);
+                readBufferData(stream, ibuf, indexCount * sizeof(uint32),
+                               [indexCount](void* pData) { Bitwise::bswapChunks(pData, sizeof(uint32), indexCount); });
 
             }
             else // 16-bit
@@ -942,8 +966,8 @@ namespace Ogre {
                         sm->indexData->indexCount,
                         pMesh->mIndexBufferUsage,
                         pMesh->mIndexBufferShadowBuffer);
-                HardwareBufferLockGuard ibufLock(ibuf, HardwareBuffer::HBL_DISCARD);
-                readShorts(stream, static_cast<unsigned short*>(ibufLock.pData), sm->indexData->indexCount);
+                readBufferData(stream, ibuf, indexCount * sizeof(uint16),
+                               [indexCount](void* pData) { Bitwise::bswapChunks(pData, sizeof(uint16), indexCount); });
             }
         }
         sm->indexData->indexBuffer = ibuf;
@@ -971,6 +995,7 @@ namespace Ogre {
             bool seenTexAlias = false;
             while(!stream->eof() &&
                 (streamID == M_SUBMESH_BONE_ASSIGNMENT ||
+                 streamID == M_SUBMESH_BONE_WEIGHTS ||
                  streamID == M_SUBMESH_OPERATION ||
                  streamID == M_SUBMESH_TEXTURE_ALIAS))
             {
@@ -982,6 +1007,9 @@ namespace Ogre {
                 case M_SUBMESH_BONE_ASSIGNMENT:
                     readSubMeshBoneAssignment(stream, pMesh, sm);
                     break;
+                case M_SUBMESH_BONE_WEIGHTS:
+                    readSubMeshBoneWeights(stream, pMesh, sm);
+                    break;
                 case M_SUBMESH_TEXTURE_ALIAS:
                     seenTexAlias = true;
                     String aliasName = readString(stream);
@@ -1123,6 +1151,190 @@ namespace Ogre {
         return size;
     }
     //---------------------------------------------------------------------
+    const MeshSerializerImpl::PackedBoneWeights& MeshSerializerImpl::packBoneWeights(
+        const Mesh* pMesh, const Mesh::VertexBoneAssignmentList& assignments, const VertexData* vertexData)
+    {
+        auto it = mPackedBoneWeights.find(vertexData);
+        if (it != mPackedBoneWeights.end())
+            return it->second;
+
+        PackedBoneWeights& ret = mPackedBoneWeights[vertexData];
+        if (!vertexData || !vertexData->vertexCount || assignments.empty())
+            return ret; // nothing to write
+
+        // store them as they are compiled, so this is not needed when loading
+        Mesh::VertexBoneAssignmentList rationalised = assignments;
+        unsigned short numWeights = pMesh->_rationaliseBoneAssignments(vertexData->vertexCount, rationalised);
+        if (!numWeights)
+            return ret;
+
+        Mesh::IndexMap boneIndexToBlendIndexMap;
+        Mesh::buildIndexMap(rationalised, boneIndexToBlendIndexMap, ret.packed.blendIndexToBoneIndexMap);
+        ret.packed.weightsPerVertex = numWeights;
+        ret.packed.data.resize(vertexData->vertexCount * (4 + sizeof(float) * numWeights));
+        Mesh::packBoneAssignments(rationalised, numWeights, boneIndexToBlendIndexMap, vertexData->vertexCount,
+                                  ret.packed.data.data());
+
+        ret.assignmentCounts.resize(vertexData->vertexCount);
+        for (auto& a : rationalised)
+        {
+            if (a.first < vertexData->vertexCount)
+                ret.assignmentCounts[a.first]++;
+        }
+        return ret;
+    }
+    //---------------------------------------------------------------------
+    size_t MeshSerializerImpl::calcBoneWeightsSize(const PackedBoneWeights& weights)
+    {
+        size_t size = MSTREAM_OVERHEAD_SIZE;
+        // weightsPerVertex, blendIndexCount
+        size += sizeof(unsigned short) * 2;
+        // blendIndexToBoneIndex
+        size += sizeof(unsigned short) * weights.packed.blendIndexToBoneIndexMap.size();
+        // assignmentCount
+        size += weights.assignmentCounts.size();
+        // blend indices and weights
+        size += weights.packed.data.size();
+        return size;
+    }
+    //---------------------------------------------------------------------
+    void MeshSerializerImpl::writeBoneWeights(uint16 chunkID, const PackedBoneWeights& weights)
+    {
+        const auto& packed = weights.packed;
+        writeChunkHeader(chunkID, calcBoneWeightsSize(weights));
+
+        // unsigned short weightsPerVertex
+        writeShorts(&packed.weightsPerVertex, 1);
+        // unsigned short blendIndexCount
+        uint16 blendIndexCount = static_cast<uint16>(packed.blendIndexToBoneIndexMap.size());
+        writeShorts(&blendIndexCount, 1);
+        // unsigned short* blendIndexToBoneIndex
+        writeShorts(packed.blendIndexToBoneIndexMap.data(), blendIndexCount);
+        // unsigned char* assignmentCount
+        writeData(weights.assignmentCounts.data(), 1, weights.assignmentCounts.size());
+
+        // blend indices and weights
+        if (!mFlipEndian)
+        {
+            writeData(packed.data.data(), 1, packed.data.size());
+            return;
+        }
+
+        size_t vertexSize = 4 + sizeof(float) * packed.weightsPerVertex;
+        for (size_t i = 0; i < packed.data.size(); i += vertexSize)
+        {
+            float vertexWeights[4];
+            memcpy(vertexWeights, &packed.data[i + 4], sizeof(float) * packed.weightsPerVertex);
+            writeData(&packed.data[i], 1, 4);
+            writeFloats(vertexWeights, packed.weightsPerVertex);
+        }
+    }
+    //---------------------------------------------------------------------
+    void MeshSerializerImpl::readBoneWeights(const DataStreamPtr& stream, const VertexData* vertexData,
+                                             Mesh::VertexBoneAssignmentList& assignments,
+                                             PackedBoneAssignments& packed)
+    {
+        if (!vertexData)
+        {
+            OGRE_EXCEPT(Exception::ERR_ITEM_NOT_FOUND, "Bone weights without vertex data in " + stream->getName());
+        }
+
+        uint16 numWeights, blendIndexCount;
+        readShorts(stream, &numWeights, 1);
+        readShorts(stream, &blendIndexCount, 1);
+        if (numWeights < 1 || numWeights > OGRE_MAX_BLEND_WEIGHTS)
+        {
+            OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS,
+                        "Invalid number of bone weights per vertex in " + stream->getName());
+        }
+
+        Mesh::IndexMap blendIndexToBoneIndexMap(blendIndexCount);
+        readShorts(stream, blendIndexToBoneIndexMap.data(), blendIndexCount);
+
+        size_t vertexCount = vertexData->vertexCount;
+        std::vector<uchar> assignmentCounts(vertexCount);
+        stream->read(assignmentCounts.data(), vertexCount);
+
+        size_t vertexSize = 4 + sizeof(float) * numWeights;
+        std::vector<uchar> data(vertexCount * vertexSize);
+        stream->read(data.data(), data.size());
+
+        // only usable for compiling, if these are all the assignments
+        bool keepPacked = assignments.empty();
+
+        // expand to VertexBoneAssignments, which are in vertex order already
+        for (size_t v = 0; v < vertexCount; ++v)
+        {
+            uchar* pVertex = &data[v * vertexSize];
+            if (mFlipEndian)
+                Serializer::flipFromLittleEndian(pVertex + 4, sizeof(float), numWeights);
+
+            if (assignmentCounts[v] > numWeights)
+            {
+                OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, "Invalid bone weights in " + stream->getName());
+            }
+
+            for (uchar k = 0; k < assignmentCounts[v]; ++k)
+            {
+                if (pVertex[k] >= blendIndexCount)
+                {
+                    OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, "Invalid blend index in " + stream->getName());
+                }
+
+                VertexBoneAssignment assign;
+                assign.vertexIndex = static_cast<uint32>(v);
+                assign.boneIndex = blendIndexToBoneIndexMap[pVertex[k]];
+                memcpy(&assign.weight, pVertex + 4 + k * sizeof(float), sizeof(float));
+                assignments.emplace_hint(assignments.end(), v, assign);
+            }
+        }
+
+        if (keepPacked)
+        {
+            packed.data.swap(data);
+            packed.blendIndexToBoneIndexMap.swap(blendIndexToBoneIndexMap);
+            packed.weightsPerVertex = numWeights;
+        }
+    }
+    //---------------------------------------------------------------------
+    void MeshSerializerImpl::writeMeshBoneAssignments(const Mesh* pMesh)
+    {
+        const auto& weights = packBoneWeights(pMesh, pMesh->mBoneAssignments, pMesh->sharedVertexData);
+        if (weights.packed.weightsPerVertex)
+            writeBoneWeights(M_MESH_BONE_WEIGHTS, weights);
+    }
+    //---------------------------------------------------------------------
+    void MeshSerializerImpl::writeSubMeshBoneAssignments(const SubMesh* s)
+    {
+        const auto& weights = packBoneWeights(s->parent, s->mBoneAssignments, s->vertexData);
+        if (weights.packed.weightsPerVertex)
+            writeBoneWeights(M_SUBMESH_BONE_WEIGHTS, weights);
+    }
+    //---------------------------------------------------------------------
+    size_t MeshSerializerImpl::calcMeshBoneAssignmentsSize(const Mesh* pMesh)
+    {
+        const auto& weights = packBoneWeights(pMesh, pMesh->mBoneAssignments, pMesh->sharedVertexData);
+        return weights.packed.weightsPerVertex ? calcBoneWeightsSize(weights) : 0;
+    }
+    //---------------------------------------------------------------------
+    size_t MeshSerializerImpl::calcSubMeshBoneAssignmentsSize(const SubMesh* s)
+    {
+        const auto& weights = packBoneWeights(s->parent, s->mBoneAssignments, s->vertexData);
+        return weights.packed.weightsPerVertex ? calcBoneWeightsSize(weights) : 0;
+    }
+    //---------------------------------------------------------------------
+    void MeshSerializerImpl::readMeshBoneWeights(const DataStreamPtr& stream, Mesh* pMesh)
+    {
+        readBoneWeights(stream, pMesh->sharedVertexData, pMesh->mBoneAssignments, pMesh->mPackedBoneAssignments);
+        pMesh->mBoneAssignmentsOutOfDate = true;
+    }
+    //---------------------------------------------------------------------
+    void MeshSerializerImpl::readSubMeshBoneWeights(const DataStreamPtr& stream, Mesh* pMesh, SubMesh* sub)
+    {
+        readBoneWeights(stream, sub->vertexData, sub->mBoneAssignments, sub->mPackedBoneAssignments);
+        sub->mBoneAssignmentsOutOfDate = true;
+    }
+    //---------------------------------------------------------------------
 #if !OGRE_NO_MESHLOD
     void MeshSerializerImpl::writeLodLevel(const Mesh* pMesh)
     {
@@ -1475,20 +1687,119 @@ namespace Ogre {
                 indexData->indexBuffer = pMesh->getHardwareBufferManager()->createIndexBuffer(
                     idx32Bit ? HardwareIndexBuffer::IT_32BIT : HardwareIndexBuffer::IT_16BIT,
                     buffIndexCount, pMesh->mIndexBufferUsage, pMesh->mIndexBufferShadowBuffer);
-                HardwareBufferLockGuard ibufLock(indexData->indexBuffer, HardwareBuffer::HBL_DISCARD);
 
-                if (idx32Bit)
-                {
-                    readInts(stream, (uint32*)ibufLock.pData, buffIndexCount);
-                }
-                else
-                {
-                    readShorts(stream, (uint16*)ibufLock.pData, buffIndexCount);
-                }
+                size_t indexSize = idx32Bit ? sizeof(uint32) : sizeof(uint16);
+                readBufferData(stream, indexData->indexBuffer, buffIndexCount * indexSize,
+                               [indexSize, buffIndexCount](void* pData) {
+                                   Bitwise::bswapChunks(pData, indexSize, buffIndexCount);
+                               });
             }
         }
     }
 #endif
+    //---------------------------------------------------------------------
+    void MeshSerializerImpl::readBufferData(const DataStreamPtr& stream, const HardwareBufferPtr& buf, size_t size,
+                                            const std::function<void(void*)>& flip)
+    {
+        // use the stream memory in place, if it has any
+        auto memStream = dynamic_cast<MemoryDataStream*>(stream.get());
+        if (!memStream || memStream->size() - memStream->tell() < size)
+        {
+            HardwareBufferLockGuard bufLock(buf, HardwareBuffer::HBL_DISCARD);
+            stream->read(bufLock.pData, size);
+            if (mFlipEndian)
+                flip(bufLock.pData);
+            return;
+        }
+
+        const uchar* src = memStream->getCurrentPtr();
+        stream->skip(static_cast<long>(size));
+
+        if (mWorkersCanAccessRenderSystem)
+        {
+            bool flipEndian = mFlipEndian;
+            mDecodeJobs.push_back([buf, src, size, flip, flipEndian]() {
+                if (!flipEndian)
+                {
+                    buf->writeData(0, size, src, true);
+                    return;
+                }
+                HardwareBufferLockGuard bufLock(buf, HardwareBuffer::HBL_DISCARD);
+                memcpy(bufLock.pData, src, size);
+                flip(bufLock.pData);
+            });
+            mDecodeJobBytes += size;
+        }
+        else if (!mFlipEndian)
+        {
+            // upload straight from the stream memory
+            buf->writeData(0, size, src, true);
+        }
+        else
+        {
+            // convert on the workers, upload on this thread
+            auto staging = std::make_shared<std::vector<uchar>>();
+            mDecodeJobs.push_back([staging, src, size, flip]() {
+                staging->assign(src, src + size);
+                flip(staging->data());
+            });
+            mUploadJobs.push_back([buf, staging]() { buf->writeData(0, staging->size(), staging->data(), true); });
+            mDecodeJobBytes += size;
+        }
+    }
+    //---------------------------------------------------------------------
+    void MeshSerializerImpl::readDecoded(const DataStreamPtr& stream, size_t count, size_t elementSize,
+                                         const std::function<void(const uchar*, size_t, size_t)>& decode)
+    {
+        size_t size = count * elementSize;
+        auto memStream = dynamic_cast<MemoryDataStream*>(stream.get());
+        if (!memStream || memStream->size() - memStream->tell() < size)
+        {
+            std::vector<uchar> data(size);
+            stream->read(data.data(), size);
+            decode(data.data(), 0, count);
+            return;
+        }
+
+        const uchar* src = memStream->getCurrentPtr();
+        stream->skip(static_cast<long>(size));
+
+        // split large blocks, so they are decoded by several workers
+        size_t jobCount = std::max<size_t>(size / DECODE_JOB_BYTES, 1);
+        for (size_t i = 0; i < jobCount; ++i)
+        {
+            size_t begin = i * count / jobCount;
+            size_t end = (i + 1) * count / jobCount;
+            mDecodeJobs.push_back([decode, src, begin, end, elementSize]() {
+                decode(src + begin * elementSize, begin, end);
+            });
+        }
+        mDecodeJobBytes += size;
+    }
+    //---------------------------------------------------------------------
+    void MeshSerializerImpl::runDeferredJobs()
+    {
+        auto root = Root::getSingletonPtr();
+        if (root && mDecodeJobs.size() > 1 && mDecodeJobBytes >= PARALLEL_DECODE_MIN_BYTES)
+        {
+            root->getWorkQueue()->parallelFor(mDecodeJobs.size(), 1, [this](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i)
+                    mDecodeJobs[i]();
+            });
+        }
+        else
+        {
+            for (auto& job : mDecodeJobs)
+                job();
+        }
+
+        for (auto& job : mUploadJobs)
+            job();
+
+        mDecodeJobs.clear();
+        mUploadJobs.clear();
+        mDecodeJobBytes = 0;
+    }
     //---------------------------------------------------------------------
     void MeshSerializerImpl::flipFromLittleEndian(void* pData, size_t vertexCount,
         size_t vertexSize, const VertexDeclaration::VertexElementList& elems)
@@ -1868,31 +2179,37 @@ namespace Ogre {
         // Allocate correct amount of memory
         edgeData->edgeGroups.resize(numEdgeGroups);
         // Triangle* triangleList
-        uint32 tmp[3];
-        for (size_t t = 0; t < numTriangles; ++t)
-        {
-            EdgeData::Triangle& tri = edgeData->triangles[t];
-            // unsigned long indexSet
-            readInts(stream, tmp, 1);
-            tri.indexSet = tmp[0];
-            // unsigned long vertexSet
-            readInts(stream, tmp, 1);
-            tri.vertexSet = tmp[0];
-            // unsigned long vertIndex[3]
-            readInts(stream, tmp, 3);
+        bool flip = mFlipEndian;
+        readDecoded(stream, numTriangles, 8 * sizeof(uint32) + 4 * sizeof(float),
+                    [edgeData, flip](const uchar* src, size_t begin, size_t end) {
+            for (size_t t = begin; t < end; ++t, src += 8 * sizeof(uint32) + 4 * sizeof(float))
+            {
+                // unsigned long indexSet, vertexSet, vertIndex[3], sharedVertIndex[3]
+                uint32 tmp[8];
+                // float normal[4]
+                float normal[4];
+                memcpy(tmp, src, sizeof(tmp));
+                memcpy(normal, src + sizeof(tmp), sizeof(normal));
+                if (flip)
+                {
+                    Bitwise::bswapChunks(tmp, sizeof(uint32), 8);
+                    Bitwise::bswapChunks(normal, sizeof(float), 4);
+                }
 
-            tri.vertIndex[0] = tmp[0];
-            tri.vertIndex[1] = tmp[1];
-            tri.vertIndex[2] = tmp[2];
-            // unsigned long sharedVertIndex[3]
-            readInts(stream, tmp, 3);
-            tri.sharedVertIndex[0] = tmp[0];
-            tri.sharedVertIndex[1] = tmp[1];
-            tri.sharedVertIndex[2] = tmp[2];
-            // float normal[4]
-            readFloats(stream, &(edgeData->triangleFaceNormals[t].x), 4);
+                EdgeData::Triangle& tri = edgeData->triangles[t];
+                tri.indexSet = tmp[0];
+                tri.vertexSet = tmp[1];
+                tri.vertIndex[0] = tmp[2];
+                tri.vertIndex[1] = tmp[3];
+                tri.vertIndex[2] = tmp[4];
+                tri.sharedVertIndex[0] = tmp[5];
+                tri.sharedVertIndex[1] = tmp[6];
+                tri.sharedVertIndex[2] = tmp[7];
+                edgeData->triangleFaceNormals[t] = Vector4(normal[0], normal[1], normal[2], normal[3]);
+            }
+        });
 
-        }
+        uint32 tmp[3];
         pushInnerChunk(stream);
         for (uint32 eg = 0; eg < numEdgeGroups; ++eg)
         {
@@ -1919,24 +2236,28 @@ namespace Ogre {
             readInts(stream, &numEdges, 1);
             edgeGroup.edges.resize(numEdges);
             // Edge* edgeList
-            for (uint32 e = 0; e < numEdges; ++e)
-            {
-                EdgeData::Edge& edge = edgeGroup.edges[e];
-                // unsigned long  triIndex[2]
-                readInts(stream, tmp, 2);
-                edge.triIndex[0] = tmp[0];
-                edge.triIndex[1] = tmp[1];
-                // unsigned long  vertIndex[2]
-                readInts(stream, tmp, 2);
-                edge.vertIndex[0] = tmp[0];
-                edge.vertIndex[1] = tmp[1];
-                // unsigned long  sharedVertIndex[2]
-                readInts(stream, tmp, 2);
-                edge.sharedVertIndex[0] = tmp[0];
-                edge.sharedVertIndex[1] = tmp[1];
-                // bool degenerate
-                readBools(stream, &(edge.degenerate), 1);
-            }
+            EdgeData::EdgeList* edges = &edgeGroup.edges;
+            readDecoded(stream, numEdges, 6 * sizeof(uint32) + sizeof(bool),
+                        [edges, flip](const uchar* src, size_t begin, size_t end) {
+                for (size_t e = begin; e < end; ++e, src += 6 * sizeof(uint32) + sizeof(bool))
+                {
+                    // unsigned long  triIndex[2], vertIndex[2], sharedVertIndex[2]
+                    uint32 edgeTmp[6];
+                    memcpy(edgeTmp, src, sizeof(edgeTmp));
+                    if (flip)
+                        Bitwise::bswapChunks(edgeTmp, sizeof(uint32), 6);
+
+                    EdgeData::Edge& edge = (*edges)[e];
+                    edge.triIndex[0] = edgeTmp[0];
+                    edge.triIndex[1] = edgeTmp[1];
+                    edge.vertIndex[0] = edgeTmp[2];
+                    edge.vertIndex[1] = edgeTmp[3];
+                    edge.sharedVertIndex[0] = edgeTmp[4];
+                    edge.sharedVertIndex[1] = edgeTmp[5];
+                    // bool degenerate
+                    edge.degenerate = src[sizeof(edgeTmp)] != 0;
+                }
+            });
         }
         popInnerChunk(stream);
     }
@@ -2509,8 +2830,9 @@ namespace Ogre {
                 vertexSize, vertexCount,
                 HardwareBuffer::HBU_STATIC, true);
         // float x,y,z          // repeat by number of vertices in original geometry
-        HardwareBufferLockGuard vbufLock(vbuf, HardwareBuffer::HBL_DISCARD);
-        readFloats(stream, static_cast<float*>(vbufLock.pData), vertexCount * (includesNormals ? 6 : 3));
+        size_t floatCount = vertexCount * (includesNormals ? 6 : 3);
+        readBufferData(stream, vbuf, floatCount * sizeof(float),
+                       [floatCount](void* pData) { Bitwise::bswapChunks(pData, sizeof(float), floatCount); });
         kf->setVertexBuffer(vbuf);
 
     }
@@ -2584,6 +2906,42 @@ namespace Ogre {
     }
 
 
+    //---------------------------------------------------------------------
+    //---------------------------------------------------------------------
+    //---------------------------------------------------------------------
+    MeshSerializerImpl_v1_10::MeshSerializerImpl_v1_10()
+    {
+        // Version number
+        // This one is a little ugly, 1.10 is used for version 1.1 legacy meshes.
+        // So bump up to 1.100
+        mVersion = "[MeshSerializer_v1.100]";
+    }
+    //---------------------------------------------------------------------
+    void MeshSerializerImpl_v1_10::writeMeshBoneAssignments(const Mesh* pMesh)
+    {
+        for (auto& vi : pMesh->mBoneAssignments)
+        {
+            writeMeshBoneAssignment(vi.second);
+        }
+    }
+    //---------------------------------------------------------------------
+    void MeshSerializerImpl_v1_10::writeSubMeshBoneAssignments(const SubMesh* s)
+    {
+        for (auto& vi : s->mBoneAssignments)
+        {
+            writeSubMeshBoneAssignment(vi.second);
+        }
+    }
+    //---------------------------------------------------------------------
+    size_t MeshSerializerImpl_v1_10::calcMeshBoneAssignmentsSize(const Mesh* pMesh)
+    {
+        return pMesh->mBoneAssignments.size() * calcBoneAssignmentSize();
+    }
+    //---------------------------------------------------------------------
+    size_t MeshSerializerImpl_v1_10::calcSubMeshBoneAssignmentsSize(const SubMesh* s)
+    {
+        return s->mBoneAssignments.size() * calcBoneAssignmentSize();
+    }
     //---------------------------------------------------------------------
     //---------------------------------------------------------------------
     //---------------------------------------------------------------------
@@ -54,7 +54,7 @@ namespace Ogre {
     will remain to load the latest version.
 
      @note
-        This mesh format was used from Ogre v1.10.
+        This mesh format was used from Ogre v14.4.
 
     */
     class _OgrePrivate MeshSerializerImpl : public Serializer
@@ -93,6 +93,8 @@ namespace Ogre {
         virtual void writeSkeletonLink(const String& skelName);
         virtual void writeMeshBoneAssignment(const VertexBoneAssignment& assign);
         virtual void writeSubMeshBoneAssignment(const VertexBoneAssignment& assign);
+        virtual void writeMeshBoneAssignments(const Mesh* pMesh);
+        virtual void writeSubMeshBoneAssignments(const SubMesh* s);
 #if !OGRE_NO_MESHLOD
         virtual void writeLodLevel(const Mesh* pMesh);
         virtual void writeLodUsageManual(const MeshLodUsage& usage);
@@ -117,6 +119,8 @@ namespace Ogre {
         virtual size_t calcGeometrySize(const VertexData* pGeom);
         virtual size_t calcSkeletonLinkSize(const String& skelName);
         virtual size_t calcBoneAssignmentSize(void);
+        virtual size_t calcMeshBoneAssignmentsSize(const Mesh* pMesh);
+        virtual size_t calcSubMeshBoneAssignmentsSize(const SubMesh* s);
         virtual size_t calcSubMeshOperationSize();
         virtual size_t calcSubMeshNameTableSize(const Mesh* pMesh);
         virtual size_t calcLodLevelSize(const Mesh* pMesh);
@@ -153,6 +157,8 @@ namespace Ogre {
         virtual void readMeshBoneAssignment(const DataStreamPtr& stream, Mesh* pMesh);
         virtual void readSubMeshBoneAssignment(const DataStreamPtr& stream, Mesh* pMesh,
             SubMesh* sub);
+        virtual void readMeshBoneWeights(const DataStreamPtr& stream, Mesh* pMesh);
+        virtual void readSubMeshBoneWeights(const DataStreamPtr& stream, Mesh* pMesh, SubMesh* sub);
         virtual void readMeshLodLevel(const DataStreamPtr& stream, Mesh* pMesh);
 #if !OGRE_NO_MESHLOD
         virtual void readMeshLodUsageManual(const DataStreamPtr& stream, Mesh* pMesh, unsigned short lodNum, MeshLodUsage& usage);
@@ -183,14 +189,70 @@ namespace Ogre {
         /// This function can be overloaded to disable validation in debug builds.
         virtual void enableValidation();
 
+        /** Read size bytes into buf, which is done by runDeferredJobs if the stream is in memory
+
+            @param flip converts the data from little endian in place, only called if needed
+        */
+        void readBufferData(const DataStreamPtr& stream, const HardwareBufferPtr& buf, size_t size,
+                            const std::function<void(void*)>& flip);
+        /** Read count elements of elementSize bytes with decode(src, begin, end)
+
+            If the stream is in memory, decoding is done by runDeferredJobs, so it must not depend on
+            other chunks. The range may be split, src points to element begin.
+        */
+        void readDecoded(const DataStreamPtr& stream, size_t count, size_t elementSize,
+                         const std::function<void(const uchar*, size_t, size_t)>& decode);
+        /// Decode and upload what was deferred while parsing the chunks, on the workers if it is worth it
+        void runDeferredJobs();
+
         ushort exportedLodCount; // Needed to limit exported Edge data, when exporting
+
+        /// Decoding of chunk data when importing, independent of each other
+        std::vector<std::function<void()>> mDecodeJobs;
+        /// Buffer uploads after mDecodeJobs, which are done on the calling thread
+        std::vector<std::function<void()>> mUploadJobs;
+        /// Bytes decoded by mDecodeJobs
+        size_t mDecodeJobBytes;
+        /// Whether mDecodeJobs may write to hardware buffers
+        bool mWorkersCanAccessRenderSystem;
+
+        /// Bone assignments as written to M_MESH_BONE_WEIGHTS and M_SUBMESH_BONE_WEIGHTS
+        struct PackedBoneWeights
+        {
+            PackedBoneAssignments packed;
+            std::vector<uchar> assignmentCounts;
+        };
+        /// Packed per vertex data when exporting, so they are only rationalised once
+        std::map<const VertexData*, PackedBoneWeights> mPackedBoneWeights;
+
+        const PackedBoneWeights& packBoneWeights(const Mesh* pMesh,
+                                                 const std::multimap<size_t, VertexBoneAssignment>& assignments,
+                                                 const VertexData* vertexData);
+        size_t calcBoneWeightsSize(const PackedBoneWeights& weights);
+        void writeBoneWeights(uint16 chunkID, const PackedBoneWeights& weights);
+        void readBoneWeights(const DataStreamPtr& stream, const VertexData* vertexData,
+                             std::multimap<size_t, VertexBoneAssignment>& assignments, PackedBoneAssignments& packed);
+    };
+
+    /** Class for providing backwards-compatibility for loading version 1.10 of the .mesh format.
+     This mesh format was used from Ogre v1.10.
+     */
+    class _OgrePrivate MeshSerializerImpl_v1_10 : public MeshSerializerImpl
+    {
+    public:
+        MeshSerializerImpl_v1_10();
+    protected:
+        void writeMeshBoneAssignments(const Mesh* pMesh) override;
+        void writeSubMeshBoneAssignments(const SubMesh* s) override;
+        size_t calcMeshBoneAssignmentsSize(const Mesh* pMesh) override;
+        size_t calcSubMeshBoneAssignmentsSize(const SubMesh* s) override;
     };
 
 
     /** Class for providing backwards-compatibility for loading version 1.8 of the .mesh format. 
      This mesh format was used from Ogre v1.8.
      */
-    class _OgrePrivate MeshSerializerImpl_v1_8 : public MeshSerializerImpl
+    class _OgrePrivate MeshSerializerImpl_v1_8 : public MeshSerializerImpl_v1_10
     {
     public:
         MeshSerializerImpl_v1_8();
@@ -161,7 +161,10 @@ namespace Ogre {
         // Notify listener if exists
         if (mListener)
         {
-            mListener->objectMoved(this);
+            if (auto calls = Node::_getDeferredListenerCalls())
+                calls->push_back([this]() { mListener->objectMoved(this); });
+            else
+                mListener->objectMoved(this);
         }
     }
     //-----------------------------------------------------------------------
@@ -201,10 +201,29 @@ namespace Ogre {
         // Call listener (note, this method only called if there's something to do)
         if (mListener)
         {
-            mListener->nodeUpdated(this);
+            if (auto calls = _getDeferredListenerCalls())
+                calls->push_back([this]() { mListener->nodeUpdated(this); });
+            else
+                mListener->nodeUpdated(this);
         }
     }
     //-----------------------------------------------------------------------
+    static std::vector<std::function<void()> >*& deferredListenerCalls()
+    {
+        static thread_local std::vector<std::function<void()> >* calls = NULL;
+        return calls;
+    }
+    //-----------------------------------------------------------------------
+    void Node::_setDeferredListenerCalls(std::vector<std::function<void()> >* calls)
+    {
+        deferredListenerCalls() = calls;
+    }
+    //-----------------------------------------------------------------------
+    std::vector<std::function<void()> >* Node::_getDeferredListenerCalls(void)
+    {
+        return deferredListenerCalls();
+    }
+    //-----------------------------------------------------------------------
     void Node::updateFromParentImpl(void) const
     {
         mCachedTransformOutOfDate = true;
@@ -0,0 +1,854 @@
+// This file is part of the OGRE project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at https://www.ogre3d.org/licensing.
+// SPDX-License-Identifier: MIT
+#include "OgreStableHeaders.h"
+#include "OgreOptimisedUtil.h"
+
+#if __OGRE_HAVE_AVX2
+
+#include "OgreSIMDHelper.h"
+#include <immintrin.h>
+
+// Only the functions below are compiled for AVX2/FMA. Enabling the instructions for the whole file
+// would also affect the inline functions of the included headers, which the linker might then pick
+// for code running on CPUs without AVX2.
+#if OGRE_COMPILER == OGRE_COMPILER_GNUC || OGRE_COMPILER == OGRE_COMPILER_CLANG
+#define __OGRE_AVX2_TARGET __attribute__((target("avx2,fma")))
+#else
+#define __OGRE_AVX2_TARGET
+#endif
+
+namespace Ogre {
+
+    extern OptimisedUtil* _getOptimisedUtilSSE(void);
+
+    /** AVX2/FMA implementation of OptimisedUtil.
+
+        Provides 256-bit versions of the skinning related routines and of the culling kernels, and forwards
+        everything else to the SSE implementation.
+    @note
+        Don't use this class directly, use OptimisedUtil instead.
+    */
+    class _OgrePrivate OptimisedUtilAVX2 : public OptimisedUtil
+    {
+    protected:
+        OptimisedUtil* mSSE;
+
+    public:
+        OptimisedUtilAVX2(void) : mSSE(_getOptimisedUtilSSE()) {}
+
+        /// @copydoc OptimisedUtil::softwareVertexSkinning
+        void __OGRE_SIMD_ALIGN_ATTRIBUTE __OGRE_AVX2_TARGET softwareVertexSkinning(
+            const float *srcPosPtr, float *destPosPtr,
+            const float *srcNormPtr, float *destNormPtr,
+            const float *blendWeightPtr, const unsigned char* blendIndexPtr,
+            const Affine3* const* blendMatrices,
+            size_t srcPosStride, size_t destPosStride,
+            size_t srcNormStride, size_t destNormStride,
+            size_t blendWeightStride, size_t blendIndexStride,
+            size_t numWeightsPerVertex,
+            size_t numVertices) override;
+
+        /// @copydoc OptimisedUtil::softwareVertexMorph
+        void softwareVertexMorph(
+            float t,
+            const float *srcPos1, const float *srcPos2,
+            float *dstPos,
+            size_t pos1VSize, size_t pos2VSize, size_t dstVSize,
+            size_t numVertices,
+            bool morphNormals) override
+        {
+            mSSE->softwareVertexMorph(
+                t,
+                srcPos1, srcPos2,
+                dstPos,
+                pos1VSize, pos2VSize, dstVSize,
+                numVertices,
+                morphNormals);
+        }
+
+        /// @copydoc OptimisedUtil::concatenateAffineMatrices
+        void __OGRE_SIMD_ALIGN_ATTRIBUTE __OGRE_AVX2_TARGET concatenateAffineMatrices(
+            const Affine3& baseMatrix,
+            const Affine3* srcMatrices,
+            Affine3* dstMatrices,
+            size_t numMatrices) override;
+
+        /// @copydoc OptimisedUtil::calculateFaceNormals
+        void calculateFaceNormals(
+            const float *positions,
+            const EdgeData::Triangle *triangles,
+            Vector4 *faceNormals,
+            size_t numTriangles) override
+        {
+            mSSE->calculateFaceNormals(
+                positions,
+                triangles,
+                faceNormals,
+                numTriangles);
+        }
+
+        /// @copydoc OptimisedUtil::calculateLightFacing
+        void calculateLightFacing(
+            const Vector4& lightPos,
+            const Vector4* faceNormals,
+            char* lightFacings,
+            size_t numFaces) override
+        {
+            mSSE->calculateLightFacing(
+                lightPos,
+                faceNormals,
+                lightFacings,
+                numFaces);
+        }
+
+        /// @copydoc OptimisedUtil::extrudeVertices
+        void extrudeVertices(
+            const Vector4& lightPos,
+            Real extrudeDist,
+            const float* srcPositions,
+            float* destPositions,
+            size_t numVertices) override
+        {
+            mSSE->extrudeVertices(
+                lightPos,
+                extrudeDist,
+                srcPositions,
+                destPositions,
+                numVertices);
+        }
+
+        /// @copydoc OptimisedUtil::cullBoxes
+        void __OGRE_AVX2_TARGET cullBoxes(
+            const Vector4* planes, size_t numPlanes,
+            const float* centres, const float* halfSizes,
+            size_t numBoxes,
+            uint32* visibleMask) override;
+
+        /// @copydoc OptimisedUtil::cullSpheres
+        void __OGRE_AVX2_TARGET cullSpheres(
+            const Vector4* planes, size_t numPlanes,
+            const Vector4* spheres,
+            size_t numSpheres,
+            uint32* visibleMask) override;
+
+        /// @copydoc OptimisedUtil::intersectRayBoxes
+        void __OGRE_AVX2_TARGET intersectRayBoxes(
+            const Vector3& origin, const Vector3& direction,
+            const float* mins, const float* maxs,
+            size_t numBoxes,
+            uint32* hitMask,
+            float* distances) override;
+    };
+
+//-------------------------------------------------------------------------
+// Local functions
+//-------------------------------------------------------------------------
+
+    //---------------------------------------------------------------------
+    // Combines two 128-bit vectors to a 256-bit one.
+    static OGRE_FORCE_INLINE __OGRE_AVX2_TARGET __m256 pairPS(__m128 lo, __m128 hi)
+    {
+        return _mm256_insertf128_ps(_mm256_castps128_ps256(lo), hi, 1);
+    }
+    //---------------------------------------------------------------------
+    // Loads a vector as x y z 0, without reading past it.
+    static OGRE_FORCE_INLINE __OGRE_AVX2_TARGET __m128 loadVector3(const float* p)
+    {
+        return _mm_movelh_ps(_mm_castpd_ps(_mm_load_sd((const double*)p)), _mm_load_ss(p + 2));
+    }
+    //---------------------------------------------------------------------
+    // Stores the x y z components of a vector.
+    static OGRE_FORCE_INLINE __OGRE_AVX2_TARGET void storeVector3(float* p, __m128 v)
+    {
+        _mm_storel_pi((__m64*)p, v);
+        _mm_store_ss(p + 2, _mm_movehl_ps(v, v));
+    }
+    //---------------------------------------------------------------------
+    // Adds a weighted matrix to the collapsed one. Rows 0 and 1 of an Affine3 are adjacent, so they
+    // are blended as one 256-bit vector.
+    static OGRE_FORCE_INLINE __OGRE_AVX2_TARGET void accumWeightedMatrix(
+        __m256& r01, __m128& r2, const float* pWeight, const Affine3* pMatrix)
+    {
+        __m256 weight = _mm256_broadcast_ss(pWeight);
+        r01 = _mm256_fmadd_ps(weight, _mm256_loadu_ps((*pMatrix)[0]), r01);
+        r2 = _mm_fmadd_ps(_mm256_castps256_ps128(weight), _mm_loadu_ps((*pMatrix)[2]), r2);
+    }
+    //---------------------------------------------------------------------
+    // Collapses the blend matrices of one vertex. NumWeights is zero if only known at run-time.
+    template <size_t NumWeights>
+    static OGRE_FORCE_INLINE __OGRE_AVX2_TARGET void collapseOneMatrix(
+        __m256& r01, __m128& r2,
+        const float* pBlendWeight, const unsigned char* pBlendIndex,
+        const Affine3* const* blendMatrices,
+        size_t numWeightsPerVertex)
+    {
+        __m256 weight = _mm256_broadcast_ss(pBlendWeight);
+        const Affine3& mat = *blendMatrices[pBlendIndex[0]];
+        r01 = _mm256_mul_ps(weight, _mm256_loadu_ps(mat[0]));
+        r2 = _mm_mul_ps(_mm256_castps256_ps128(weight), _mm_loadu_ps(mat[2]));
+
+        if (NumWeights == 0)
+        {
+            for (size_t j = 1; j < numWeightsPerVertex; ++j)
+                accumWeightedMatrix(r01, r2, pBlendWeight + j, blendMatrices[pBlendIndex[j]]);
+        }
+        else
+        {
+            if (NumWeights > 1)
+                accumWeightedMatrix(r01, r2, pBlendWeight + 1, blendMatrices[pBlendIndex[1]]);
+            if (NumWeights > 2)
+                accumWeightedMatrix(r01, r2, pBlendWeight + 2, blendMatrices[pBlendIndex[2]]);
+            if (NumWeights > 3)
+                accumWeightedMatrix(r01, r2, pBlendWeight + 3, blendMatrices[pBlendIndex[3]]);
+        }
+    }
+    //---------------------------------------------------------------------
+    // Collapses the blend matrices of up to eight vertices and transposes the result, such that
+    // m[row * 4 + col] holds the matrix element [row][col] of vertex i in lane i.
+    // Lanes past count are zero.
+    template <size_t NumWeights>
+    static OGRE_FORCE_INLINE __OGRE_AVX2_TARGET void collapseEightMatrices(
+        __m256 m[12],
+        const float* pBlendWeight, const unsigned char* pBlendIndex,
+        const Affine3* const* blendMatrices,
+        size_t blendWeightStride, size_t blendIndexStride,
+        size_t numWeightsPerVertex,
+        size_t count)
+    {
+        __m256 r01[8];
+        __m128 r2[8];
+        for (size_t i = 0; i < 8; ++i)
+        {
+            if (i < count)
+            {
+                collapseOneMatrix<NumWeights>(
+                    r01[i], r2[i],
+                    pBlendWeight, pBlendIndex,
+                    blendMatrices,
+                    numWeightsPerVertex);
+
+                advanceRawPointer(pBlendWeight, blendWeightStride);
+                advanceRawPointer(pBlendIndex, blendIndexStride);
+            }
+            else
+            {
+                r01[i] = _mm256_setzero_ps();
+                r2[i] = _mm_setzero_ps();
+            }
+        }
+
+        // Transpose the 8x8 matrix of rows 0 and 1
+        __m256 t0 = _mm256_unpacklo_ps(r01[0], r01[1]);
+        __m256 t1 = _mm256_unpackhi_ps(r01[0], r01[1]);
+        __m256 t2 = _mm256_unpacklo_ps(r01[2], r01[3]);
+        __m256 t3 = _mm256_unpackhi_ps(r01[2], r01[3]);
+        __m256 t4 = _mm256_unpacklo_ps(r01[4], r01[5]);
+        __m256 t5 = _mm256_unpackhi_ps(r01[4], r01[5]);
+        __m256 t6 = _mm256_unpacklo_ps(r01[6], r01[7]);
+        __m256 t7 = _mm256_unpackhi_ps(r01[6], r01[7]);
+
+        __m256 s0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1,0,1,0));
+        __m256 s1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3,2,3,2));
+        __m256 s2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1,0,1,0));
+        __m256 s3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3,2,3,2));
+        __m256 s4 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(1,0,1,0));
+        __m256 s5 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(3,2,3,2));
+        __m256 s6 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(1,0,1,0));
+        __m256 s7 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(3,2,3,2));
+
+        m[0] = _mm256_permute2f128_ps(s0, s4, 0x20);
+        m[1] = _mm256_permute2f128_ps(s1, s5, 0x20);
+        m[2] = _mm256_permute2f128_ps(s2, s6, 0x20);
+        m[3] = _mm256_permute2f128_ps(s3, s7, 0x20);
+        m[4] = _mm256_permute2f128_ps(s0, s4, 0x31);
+        m[5] = _mm256_permute2f128_ps(s1, s5, 0x31);
+        m[6] = _mm256_permute2f128_ps(s2, s6, 0x31);
+        m[7] = _mm256_permute2f128_ps(s3, s7, 0x31);
+
+        // Transpose row 2, vertex i and i + 4 share a register
+        t0 = pairPS(r2[0], r2[4]);
+        t1 = pairPS(r2[1], r2[5]);
+        t2 = pairPS(r2[2], r2[6]);
+        t3 = pairPS(r2[3], r2[7]);
+
+        s0 = _mm256_unpacklo_ps(t0, t1);
+        s1 = _mm256_unpackhi_ps(t0, t1);
+        s2 = _mm256_unpacklo_ps(t2, t3);
+        s3 = _mm256_unpackhi_ps(t2, t3);
+
+        m[8] = _mm256_shuffle_ps(s0, s2, _MM_SHUFFLE(1,0,1,0));
+        m[9] = _mm256_shuffle_ps(s0, s2, _MM_SHUFFLE(3,2,3,2));
+        m[10] = _mm256_shuffle_ps(s1, s3, _MM_SHUFFLE(1,0,1,0));
+        m[11] = _mm256_shuffle_ps(s1, s3, _MM_SHUFFLE(3,2,3,2));
+    }
+    //---------------------------------------------------------------------
+    // Loads eight packed vectors.
+    static OGRE_FORCE_INLINE __OGRE_AVX2_TARGET void loadPackedVectors(
+        const float* src, __m256& x, __m256& y, __m256& z)
+    {
+        // x0 y0 z0 x1 | y1 z1 x2 y2 | z2 x3 y3 z3, upper halves hold vertex 4 to 7
+        __m256 m0 = pairPS(_mm_loadu_ps(src + 0), _mm_loadu_ps(src + 12));
+        __m256 m1 = pairPS(_mm_loadu_ps(src + 4), _mm_loadu_ps(src + 16));
+        __m256 m2 = pairPS(_mm_loadu_ps(src + 8), _mm_loadu_ps(src + 20));
+
+        __m256 xy = _mm256_shuffle_ps(m1, m2, _MM_SHUFFLE(2,1,3,2));   // x2 y2 x3 y3
+        __m256 yz = _mm256_shuffle_ps(m0, m1, _MM_SHUFFLE(1,0,2,1));   // y0 z0 y1 z1
+
+        x = _mm256_shuffle_ps(m0, xy, _MM_SHUFFLE(2,0,3,0));
+        y = _mm256_shuffle_ps(yz, xy, _MM_SHUFFLE(3,1,2,0));
+        z = _mm256_shuffle_ps(yz, m2, _MM_SHUFFLE(3,0,3,1));
+    }
+    //---------------------------------------------------------------------
+    // Stores eight packed vectors, the reverse of loadPackedVectors.
+    static OGRE_FORCE_INLINE __OGRE_AVX2_TARGET void storePackedVectors(
+        float* dst, __m256 x, __m256 y, __m256 z)
+    {
+        __m256 xy = _mm256_shuffle_ps(x, y, _MM_SHUFFLE(2,0,2,0));     // x0 x2 y0 y2
+        __m256 yz = _mm256_shuffle_ps(y, z, _MM_SHUFFLE(3,1,3,1));     // y1 y3 z1 z3
+        __m256 zx = _mm256_shuffle_ps(z, x, _MM_SHUFFLE(3,1,2,0));     // z0 z2 x1 x3
+
+        __m256 m0 = _mm256_shuffle_ps(xy, zx, _MM_SHUFFLE(2,0,2,0));   // x0 y0 z0 x1
+        __m256 m1 = _mm256_shuffle_ps(yz, xy, _MM_SHUFFLE(3,1,2,0));   // y1 z1 x2 y2
+        __m256 m2 = _mm256_shuffle_ps(zx, yz, _MM_SHUFFLE(3,1,3,1));   // z2 x3 y3 z3
+
+        _mm256_storeu_ps(dst + 0, _mm256_permute2f128_ps(m0, m1, 0x20));
+        _mm256_storeu_ps(dst + 8, _mm256_permute2f128_ps(m2, m0, 0x30));
+        _mm256_storeu_ps(dst + 16, _mm256_permute2f128_ps(m1, m2, 0x31));
+    }
+    //---------------------------------------------------------------------
+    // Splits the even and odd lanes of sixteen values into vertex order.
+    static OGRE_FORCE_INLINE __OGRE_AVX2_TARGET void splitEvenOdd(__m256 a, __m256 b, __m256& even, __m256& odd)
+    {
+        // Lanes are in vertex order 0 1 4 5 | 2 3 6 7 after the in-lane shuffle, swap the middle pairs
+        even = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(2,0,2,0));
+        odd = _mm256_shuffle_ps(a, b, _MM_SHUFFLE(3,1,3,1));
+        even = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(even), _MM_SHUFFLE(3,1,2,0)));
+        odd = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(odd), _MM_SHUFFLE(3,1,2,0)));
+    }
+    //---------------------------------------------------------------------
+    // Interleaves two sets of eight values, the reverse of splitEvenOdd.
+    static OGRE_FORCE_INLINE __OGRE_AVX2_TARGET void mergeEvenOdd(__m256 even, __m256 odd, __m256& a, __m256& b)
+    {
+        even = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(even), _MM_SHUFFLE(3,1,2,0)));
+        odd = _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(odd), _MM_SHUFFLE(3,1,2,0)));
+        a = _mm256_unpacklo_ps(even, odd);
+        b = _mm256_unpackhi_ps(even, odd);
+    }
+    //---------------------------------------------------------------------
+    // Loads eight vertices of position and normal sharing a packed buffer.
+    static OGRE_FORCE_INLINE __OGRE_AVX2_TARGET void loadPackedPosNorm(
+        const float* src, __m256& px, __m256& py, __m256& pz, __m256& nx, __m256& ny, __m256& nz)
+    {
+        // Load as sixteen vectors, positions are the even and normals the odd ones
+        __m256 x0, y0, z0, x1, y1, z1;
+        loadPackedVectors(src, x0, y0, z0);
+        loadPackedVectors(src + 24, x1, y1, z1);
+
+        splitEvenOdd(x0, x1, px, nx);
+        splitEvenOdd(y0, y1, py, ny);
+        splitEvenOdd(z0, z1, pz, nz);
+    }
+    //---------------------------------------------------------------------
+    // Stores eight vertices of position and normal sharing a packed buffer.
+    static OGRE_FORCE_INLINE __OGRE_AVX2_TARGET void storePackedPosNorm(
+        float* dst, __m256 px, __m256 py, __m256 pz, __m256 nx, __m256 ny, __m256 nz)
+    {
+        __m256 x0, y0, z0, x1, y1, z1;
+        mergeEvenOdd(px, nx, x0, x1);
+        mergeEvenOdd(py, ny, y0, y1);
+        mergeEvenOdd(pz, nz, z0, z1);
+
+        storePackedVectors(dst, x0, y0, z0);
+        storePackedVectors(dst + 24, x1, y1, z1);
+    }
+    //---------------------------------------------------------------------
+    // Loads up to eight strided vectors, lanes past count are zero.
+    static OGRE_FORCE_INLINE __OGRE_AVX2_TARGET void loadEightVectors(
+        const float* src, size_t stride, size_t count, __m256& x, __m256& y, __m256& z)
+    {
+        if (count == 8 && stride == 3 * sizeof(float))
+        {
+            loadPackedVectors(src, x, y, z);
+            return;
+        }
+
+        // Load as x y z 0, vertex i and i + 4 share a register
+        __m256 v04, v15, v26, v37;
+        if (count == 8)
+        {
+            v04 = pairPS(loadVector3(src), loadVector3(rawOffsetPointer(src, 4 * stride)));
+            v15 = pairPS(loadVector3(rawOffsetPointer(src, stride)), loadVector3(rawOffsetPointer(src, 5 * stride)));
+            v26 = pairPS(loadVector3(rawOffsetPointer(src, 2 * stride)), loadVector3(rawOffsetPointer(src, 6 * stride)));
+            v37 = pairPS(loadVector3(rawOffsetPointer(src, 3 * stride)), loadVector3(rawOffsetPointer(src, 7 * stride)));
+        }
+        else
+        {
+            __m128 v[8];
+            for (size_t i = 0; i < 8; ++i)
+                v[i] = i < count ? loadVector3(rawOffsetPointer(src, i * stride)) : _mm_setzero_ps();
+            v04 = pairPS(v[0], v[4]);
+            v15 = pairPS(v[1], v[5]);
+            v26 = pairPS(v[2], v[6]);
+            v37 = pairPS(v[3], v[7]);
+        }
+
+        __m256 t0 = _mm256_unpacklo_ps(v04, v15);
+        __m256 t1 = _mm256_unpackhi_ps(v04, v15);
+        __m256 t2 = _mm256_unpacklo_ps(v26, v37);
+        __m256 t3 = _mm256_unpackhi_ps(v26, v37);
+
+        x = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1,0,1,0));
+        y = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3,2,3,2));
+        z = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1,0,1,0));
+    }
+    //---------------------------------------------------------------------
+    // Stores up to eight strided vectors, writing exactly three floats per vector.
+    static OGRE_FORCE_INLINE __OGRE_AVX2_TARGET void storeEightVectors(
+        float* dst, size_t stride, size_t count, __m256 x, __m256 y, __m256 z)
+    {
+        if (count == 8 && stride == 3 * sizeof(float))
+        {
+            storePackedVectors(dst, x, y, z);
+            return;
+        }
+
+        // Transpose to x y z 0, vertex i and i + 4 share a register
+        __m256 t0 = _mm256_unpacklo_ps(x, y);
+        __m256 t1 = _mm256_unpackhi_ps(x, y);
+        __m256 t2 = _mm256_unpacklo_ps(z, _mm256_setzero_ps());
+        __m256 t3 = _mm256_unpackhi_ps(z, _mm256_setzero_ps());
+
+        __m256 v04 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1,0,1,0));
+        __m256 v15 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3,2,3,2));
+        __m256 v26 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1,0,1,0));
+        __m256 v37 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3,2,3,2));
+
+        if (count == 8)
+        {
+            storeVector3(dst, _mm256_castps256_ps128(v04));
+            storeVector3(rawOffsetPointer(dst, stride), _mm256_castps256_ps128(v15));
+            storeVector3(rawOffsetPointer(dst, 2 * stride), _mm256_castps256_ps128(v26));
+            storeVector3(rawOffsetPointer(dst, 3 * stride), _mm256_castps256_ps128(v37));
+            storeVector3(rawOffsetPointer(dst, 4 * stride), _mm256_extractf128_ps(v04, 1));
+            storeVector3(rawOffsetPointer(dst, 5 * stride), _mm256_extractf128_ps(v15, 1));
+            storeVector3(rawOffsetPointer(dst, 6 * stride), _mm256_extractf128_ps(v26, 1));
+            storeVector3(rawOffsetPointer(dst, 7 * stride), _mm256_extractf128_ps(v37, 1));
+        }
+        else
+        {
+            __m128 v[8] = {
+                _mm256_castps256_ps128(v04), _mm256_castps256_ps128(v15),
+                _mm256_castps256_ps128(v26), _mm256_castps256_ps128(v37),
+                _mm256_extractf128_ps(v04, 1), _mm256_extractf128_ps(v15, 1),
+                _mm256_extractf128_ps(v26, 1), _mm256_extractf128_ps(v37, 1) };
+            for (size_t i = 0; i < count; ++i)
+                storeVector3(rawOffsetPointer(dst, i * stride), v[i]);
+        }
+    }
+    //---------------------------------------------------------------------
+    // Skins up to eight vertices, stored as one vertex per lane. Called with a constant count for the
+    // full blocks, so the compiler removes the handling of the partial one.
+    template <size_t NumWeights>
+    static OGRE_FORCE_INLINE __OGRE_AVX2_TARGET void softwareVertexSkinning_AVX2_Block(
+        const float *pSrcPos, float *pDestPos,
+        const float *pSrcNorm, float *pDestNorm,
+        const float *pBlendWeight, const unsigned char* pBlendIndex,
+        const Affine3* const* blendMatrices,
+        size_t srcPosStride, size_t destPosStride,
+        size_t srcNormStride, size_t destNormStride,
+        size_t blendWeightStride, size_t blendIndexStride,
+        size_t numWeightsPerVertex,
+        size_t count,
+        bool sharedPacked)
+    {
+        __m256 m[12];
+        collapseEightMatrices<NumWeights>(
+            m,
+            pBlendWeight, pBlendIndex,
+            blendMatrices,
+            blendWeightStride, blendIndexStride,
+            numWeightsPerVertex,
+            count);
+
+        __m256 px, py, pz, nx, ny, nz;
+        if (sharedPacked && count == 8)
+        {
+            loadPackedPosNorm(pSrcPos, px, py, pz, nx, ny, nz);
+        }
+        else
+        {
+            loadEightVectors(pSrcPos, srcPosStride, count, px, py, pz);
+            if (pSrcNorm)
+                loadEightVectors(pSrcNorm, srcNormStride, count, nx, ny, nz);
+        }
+
+        //------------------------------------------------------------------
+        // Transform position
+        //------------------------------------------------------------------
+
+        __m256 x = _mm256_fmadd_ps(m[0], px, _mm256_fmadd_ps(m[1], py, _mm256_fmadd_ps(m[2], pz, m[3])));
+        __m256 y = _mm256_fmadd_ps(m[4], px, _mm256_fmadd_ps(m[5], py, _mm256_fmadd_ps(m[6], pz, m[7])));
+        __m256 z = _mm256_fmadd_ps(m[8], px, _mm256_fmadd_ps(m[9], py, _mm256_fmadd_ps(m[10], pz, m[11])));
+
+        if (!pSrcNorm)
+        {
+            storeEightVectors(pDestPos, destPosStride, count, x, y, z);
+            return;
+        }
+
+        //------------------------------------------------------------------
+        // Optional blend normal
+        //------------------------------------------------------------------
+
+        __m256 tx = _mm256_fmadd_ps(m[0], nx, _mm256_fmadd_ps(m[1], ny, _mm256_mul_ps(m[2], nz)));
+        __m256 ty = _mm256_fmadd_ps(m[4], nx, _mm256_fmadd_ps(m[5], ny, _mm256_mul_ps(m[6], nz)));
+        __m256 tz = _mm256_fmadd_ps(m[8], nx, _mm256_fmadd_ps(m[9], ny, _mm256_mul_ps(m[10], nz)));
+
+        // Normalise, refining the reciprocal square root estimate by one Newton-Raphson step.
+        // Zero length normals stay zero.
+        __m256 sqLen = _mm256_fmadd_ps(tx, tx, _mm256_fmadd_ps(ty, ty, _mm256_mul_ps(tz, tz)));
+        __m256 rlen = _mm256_rsqrt_ps(sqLen);
+        __m256 halfSqLen = _mm256_mul_ps(_mm256_set1_ps(0.5f), sqLen);
+        rlen = _mm256_mul_ps(rlen, _mm256_fnmadd_ps(halfSqLen, _mm256_mul_ps(rlen, rlen), _mm256_set1_ps(1.5f)));
+        rlen = _mm256_and_ps(rlen, _mm256_cmp_ps(sqLen, _mm256_setzero_ps(), _CMP_GT_OQ));
+        tx = _mm256_mul_ps(tx, rlen);
+        ty = _mm256_mul_ps(ty, rlen);
+        tz = _mm256_mul_ps(tz, rlen);
+
+        if (sharedPacked && count == 8)
+        {
+            storePackedPosNorm(pDestPos, x, y, z, tx, ty, tz);
+        }
+        else
+        {
+            storeEightVectors(pDestPos, destPosStride, count, x, y, z);
+            storeEightVectors(pDestNorm, destNormStride, count, tx, ty, tz);
+        }
+    }
+    //---------------------------------------------------------------------
+    template <size_t NumWeights>
+    static __OGRE_AVX2_TARGET void softwareVertexSkinning_AVX2(
+        const float *pSrcPos, float *pDestPos,
+        const float *pSrcNorm, float *pDestNorm,
+        const float *pBlendWeight, const unsigned char* pBlendIndex,
+        const Affine3* const* blendMatrices,
+        size_t srcPosStride, size_t destPosStride,
+        size_t srcNormStride, size_t destNormStride,
+        size_t blendWeightStride, size_t blendIndexStride,
+        size_t numWeightsPerVertex,
+        size_t numVertices)
+    {
+        // Position and normal are sharing a packed buffer
+        const bool sharedPacked =
+            pSrcNorm == pSrcPos + 3 && pDestNorm == pDestPos + 3 &&
+            srcPosStride == sizeof(float) * (3 + 3) && destPosStride == sizeof(float) * (3 + 3);
+
+        // Blend vertices, eight vertices per-iteration
+        size_t numIterations = numVertices / 8;
+        for (size_t i = 0; i < numIterations; ++i)
+        {
+            softwareVertexSkinning_AVX2_Block<NumWeights>(
+                pSrcPos, pDestPos,
+                pSrcNorm, pDestNorm,
+                pBlendWeight, pBlendIndex,
+                blendMatrices,
+                srcPosStride, destPosStride,
+                srcNormStride, destNormStride,
+                blendWeightStride, blendIndexStride,
+                numWeightsPerVertex,
+                8, sharedPacked);
+
+            advanceRawPointer(pSrcPos, 8 * srcPosStride);
+            advanceRawPointer(pDestPos, 8 * destPosStride);
+            if (pSrcNorm)
+            {
+                advanceRawPointer(pSrcNorm, 8 * srcNormStride);
+                advanceRawPointer(pDestNorm, 8 * destNormStride);
+            }
+            advanceRawPointer(pBlendWeight, 8 * blendWeightStride);
+            advanceRawPointer(pBlendIndex, 8 * blendIndexStride);
+        }
+
+        // Blend remaining vertices
+        if (numVertices & 7)
+        {
+            softwareVertexSkinning_AVX2_Block<NumWeights>(
+                pSrcPos, pDestPos,
+                pSrcNorm, pDestNorm,
+                pBlendWeight, pBlendIndex,
+                blendMatrices,
+                srcPosStride, destPosStride,
+                srcNormStride, destNormStride,
+                blendWeightStride, blendIndexStride,
+                numWeightsPerVertex,
+                numVertices & 7, sharedPacked);
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilAVX2::softwareVertexSkinning(
+        const float *pSrcPos, float *pDestPos,
+        const float *pSrcNorm, float *pDestNorm,
+        const float *pBlendWeight, const unsigned char* pBlendIndex,
+        const Affine3* const* blendMatrices,
+        size_t srcPosStride, size_t destPosStride,
+        size_t srcNormStride, size_t destNormStride,
+        size_t blendWeightStride, size_t blendIndexStride,
+        size_t numWeightsPerVertex,
+        size_t numVertices)
+    {
+        // Unlike the SSE version, the vertex per lane layout does not depend on whether the buffers are
+        // packed, shared or aligned. The remaining vertices are blended by the same code with partially
+        // filled registers, so all vertices get identical floating-point results.
+        //
+        // Unroll the blending of the common weight counts.
+        //
+        typedef void (*SkinningFunc)(
+            const float*, float*, const float*, float*, const float*, const unsigned char*, const Affine3* const*,
+            size_t, size_t, size_t, size_t, size_t, size_t, size_t, size_t);
+        static const SkinningFunc msSkinningFuncs[] = {
+            softwareVertexSkinning_AVX2<0>,
+            softwareVertexSkinning_AVX2<1>,
+            softwareVertexSkinning_AVX2<2>,
+            softwareVertexSkinning_AVX2<3>,
+            softwareVertexSkinning_AVX2<4>,
+        };
+
+        if (!numWeightsPerVertex)
+            return;
+
+        msSkinningFuncs[numWeightsPerVertex <= 4 ? numWeightsPerVertex : 0](
+            pSrcPos, pDestPos,
+            pSrcNorm, pDestNorm,
+            pBlendWeight, pBlendIndex,
+            blendMatrices,
+            srcPosStride, destPosStride,
+            srcNormStride, destNormStride,
+            blendWeightStride, blendIndexStride,
+            numWeightsPerVertex,
+            numVertices);
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilAVX2::concatenateAffineMatrices(
+        const Affine3& baseMatrix,
+        const Affine3* pSrcMat,
+        Affine3* pDstMat,
+        size_t numMatrices)
+    {
+        // Rows 0 and 1 of the result are computed together, each half of the base matrix columns
+        // holds the element of the respective row
+        __m256 c0 = pairPS(_mm_set1_ps(baseMatrix[0][0]), _mm_set1_ps(baseMatrix[1][0]));
+        __m256 c1 = pairPS(_mm_set1_ps(baseMatrix[0][1]), _mm_set1_ps(baseMatrix[1][1]));
+        __m256 c2 = pairPS(_mm_set1_ps(baseMatrix[0][2]), _mm_set1_ps(baseMatrix[1][2]));
+        __m256 c3 = _mm256_setr_ps(0, 0, 0, baseMatrix[0][3], 0, 0, 0, baseMatrix[1][3]);
+
+        __m128 d0 = _mm_set1_ps(baseMatrix[2][0]);
+        __m128 d1 = _mm_set1_ps(baseMatrix[2][1]);
+        __m128 d2 = _mm_set1_ps(baseMatrix[2][2]);
+        __m128 d3 = _mm_setr_ps(0, 0, 0, baseMatrix[2][3]);
+
+        for (size_t i = 0; i < numMatrices; ++i)
+        {
+            // Source rows, duplicated to both halves
+            __m256 s0 = _mm256_broadcast_ps((const __m128*)(*pSrcMat)[0]);
+            __m256 s1 = _mm256_broadcast_ps((const __m128*)(*pSrcMat)[1]);
+            __m256 s2 = _mm256_broadcast_ps((const __m128*)(*pSrcMat)[2]);
+
+            ++pSrcMat;
+
+            __m256 r01 = _mm256_fmadd_ps(c2, s2, _mm256_fmadd_ps(c1, s1, _mm256_fmadd_ps(c0, s0, c3)));
+            __m128 r2 = _mm_fmadd_ps(d2, _mm256_castps256_ps128(s2),
+                        _mm_fmadd_ps(d1, _mm256_castps256_ps128(s1),
+                        _mm_fmadd_ps(d0, _mm256_castps256_ps128(s0), d3)));
+
+            _mm256_storeu_ps((*pDstMat)[0], r01);
+            _mm_storeu_ps((*pDstMat)[2], r2);
+
+            ++pDstMat;
+        }
+    }
+    //---------------------------------------------------------------------
+    // Loads up to eight Vector4 and transposes them to one register per component, lanes past count are zero.
+    static OGRE_FORCE_INLINE __OGRE_AVX2_TARGET void loadEightVector4(
+        const Vector4* src, size_t count, __m256& x, __m256& y, __m256& z, __m256& w)
+    {
+        // vertex i and i + 4 share a register
+        __m128 v[8];
+        for (size_t i = 0; i < 8; ++i)
+            v[i] = i < count ? _mm_loadu_ps(src[i].ptr()) : _mm_setzero_ps();
+        __m256 v04 = pairPS(v[0], v[4]);
+        __m256 v15 = pairPS(v[1], v[5]);
+        __m256 v26 = pairPS(v[2], v[6]);
+        __m256 v37 = pairPS(v[3], v[7]);
+
+        __m256 t0 = _mm256_unpacklo_ps(v04, v15);
+        __m256 t1 = _mm256_unpackhi_ps(v04, v15);
+        __m256 t2 = _mm256_unpacklo_ps(v26, v37);
+        __m256 t3 = _mm256_unpackhi_ps(v26, v37);
+
+        x = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1,0,1,0));
+        y = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3,2,3,2));
+        z = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1,0,1,0));
+        w = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3,2,3,2));
+    }
+    //---------------------------------------------------------------------
+    // Absolute value of each component.
+    static OGRE_FORCE_INLINE __OGRE_AVX2_TARGET __m256 absPS(__m256 v)
+    {
+        return _mm256_max_ps(v, _mm256_sub_ps(_mm256_setzero_ps(), v));
+    }
+    //---------------------------------------------------------------------
+    // Dot product of a broadcast plane normal and eight vectors. Multiplies and adds in the order of
+    // the SSE version instead of using FMA, so all implementations cull exactly the same boxes.
+    static OGRE_FORCE_INLINE __OGRE_AVX2_TARGET __m256 dotPlanePS(
+        const Vector4& plane, __m256 x, __m256 y, __m256 z)
+    {
+        return _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(plane.x), x),
+                                           _mm256_mul_ps(_mm256_set1_ps(plane.y), y)),
+                             _mm256_mul_ps(_mm256_set1_ps(plane.z), z));
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilAVX2::cullBoxes(
+        const Vector4* planes,
+        size_t numPlanes,
+        const float* centres,
+        const float* halfSizes,
+        size_t numBoxes,
+        uint32* visibleMask)
+    {
+        std::fill(visibleMask, visibleMask + (numBoxes + 31) / 32, 0);
+
+        for (size_t i = 0; i < numBoxes; i += 8)
+        {
+            size_t count = std::min<size_t>(numBoxes - i, 8);
+
+            __m256 cx, cy, cz, hx, hy, hz;
+            loadEightVectors(centres + i * 3, 3 * sizeof(float), count, cx, cy, cz);
+            loadEightVectors(halfSizes + i * 3, 3 * sizeof(float), count, hx, hy, hz);
+
+            __m256 culled = _mm256_setzero_ps();
+            for (size_t p = 0; p < numPlanes; ++p)
+            {
+                const Vector4& plane = planes[p];
+
+                // same as Plane::getSide
+                __m256 dist = _mm256_add_ps(dotPlanePS(plane, cx, cy, cz), _mm256_set1_ps(plane.w));
+                __m256 maxAbsDist = _mm256_add_ps(
+                    _mm256_add_ps(absPS(_mm256_mul_ps(_mm256_set1_ps(plane.x), hx)),
+                                  absPS(_mm256_mul_ps(_mm256_set1_ps(plane.y), hy))),
+                    absPS(_mm256_mul_ps(_mm256_set1_ps(plane.z), hz)));
+                culled = _mm256_or_ps(
+                    culled, _mm256_cmp_ps(dist, _mm256_sub_ps(_mm256_setzero_ps(), maxAbsDist), _CMP_LT_OQ));
+            }
+
+            uint32 visible = ~uint32(_mm256_movemask_ps(culled)) & ((1u << count) - 1);
+            visibleMask[i / 32] |= visible << (i % 32);
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilAVX2::cullSpheres(
+        const Vector4* planes,
+        size_t numPlanes,
+        const Vector4* spheres,
+        size_t numSpheres,
+        uint32* visibleMask)
+    {
+        std::fill(visibleMask, visibleMask + (numSpheres + 31) / 32, 0);
+
+        for (size_t i = 0; i < numSpheres; i += 8)
+        {
+            size_t count = std::min<size_t>(numSpheres - i, 8);
+
+            __m256 cx, cy, cz, r;
+            loadEightVector4(spheres + i, count, cx, cy, cz, r);
+            __m256 negR = _mm256_sub_ps(_mm256_setzero_ps(), r);
+
+            __m256 culled = _mm256_setzero_ps();
+            for (size_t p = 0; p < numPlanes; ++p)
+            {
+                const Vector4& plane = planes[p];
+                __m256 dist = _mm256_add_ps(dotPlanePS(plane, cx, cy, cz), _mm256_set1_ps(plane.w));
+                culled = _mm256_or_ps(culled, _mm256_cmp_ps(dist, negR, _CMP_LT_OQ));
+            }
+
+            uint32 visible = ~uint32(_mm256_movemask_ps(culled)) & ((1u << count) - 1);
+            visibleMask[i / 32] |= visible << (i % 32);
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilAVX2::intersectRayBoxes(
+        const Vector3& origin,
+        const Vector3& direction,
+        const float* mins,
+        const float* maxs,
+        size_t numBoxes,
+        uint32* hitMask,
+        float* distances)
+    {
+        std::fill(hitMask, hitMask + (numBoxes + 31) / 32, 0);
+
+        // The direction is shared by all boxes, so axes parallel to the ray are
+        // resolved once here instead of per lane
+        bool parallel[3];
+        __m256 orig[3], invDir[3];
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            parallel[axis] = direction[axis] == 0;
+            orig[axis] = _mm256_set1_ps(origin[axis]);
+            invDir[axis] = _mm256_set1_ps(parallel[axis] ? 0.0f : 1.0f / direction[axis]);
+        }
+
+        for (size_t i = 0; i < numBoxes; i += 8)
+        {
+            size_t count = std::min<size_t>(numBoxes - i, 8);
+
+            __m256 boxMin[3], boxMax[3];
+            loadEightVectors(mins + i * 3, 3 * sizeof(float), count, boxMin[0], boxMin[1], boxMin[2]);
+            loadEightVectors(maxs + i * 3, 3 * sizeof(float), count, boxMax[0], boxMax[1], boxMax[2]);
+
+            // slab test, the ray starts at the origin
+            __m256 tNear = _mm256_setzero_ps();
+            __m256 tFar = _mm256_set1_ps(std::numeric_limits<float>::infinity());
+            __m256 miss = _mm256_setzero_ps();
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                if (parallel[axis])
+                {
+                    // must start inside of the slab
+                    miss = _mm256_or_ps(miss, _mm256_or_ps(_mm256_cmp_ps(orig[axis], boxMin[axis], _CMP_LT_OQ),
+                                                           _mm256_cmp_ps(boxMax[axis], orig[axis], _CMP_LT_OQ)));
+                    continue;
+                }
+
+                __m256 t1 = _mm256_mul_ps(_mm256_sub_ps(boxMin[axis], orig[axis]), invDir[axis]);
+                __m256 t2 = _mm256_mul_ps(_mm256_sub_ps(boxMax[axis], orig[axis]), invDir[axis]);
+                tNear = _mm256_max_ps(tNear, _mm256_min_ps(t1, t2));
+                tFar = _mm256_min_ps(tFar, _mm256_max_ps(t1, t2));
+            }
+            miss = _mm256_or_ps(miss, _mm256_cmp_ps(tFar, tNear, _CMP_LT_OQ));
+
+            uint32 hit = ~uint32(_mm256_movemask_ps(miss)) & ((1u << count) - 1);
+            hitMask[i / 32] |= hit << (i % 32);
+
+            if (distances)
+            {
+                float entry[8];
+                _mm256_storeu_ps(entry, tNear);
+                std::copy(entry, entry + count, distances + i);
+            }
+        }
+    }
+    //---------------------------------------------------------------------
+    //---------------------------------------------------------------------
+    //---------------------------------------------------------------------
+    extern OptimisedUtil* _getOptimisedUtilAVX2(void);
+    extern OptimisedUtil* _getOptimisedUtilAVX2(void)
+    {
+        static OptimisedUtilAVX2 msOptimisedUtilAVX2;
+        return &msOptimisedUtilAVX2;
+    }
+
+}
+
+#endif // __OGRE_HAVE_AVX2
@@ -91,6 +91,33 @@ namespace Ogre {
             const float* srcPositions,
             float* destPositions,
             size_t numVertices) override;
+
+        /// @copydoc OptimisedUtil::cullBoxes
+        void cullBoxes(
+            const Vector4* planes,
+            size_t numPlanes,
+            const float* centres,
+            const float* halfSizes,
+            size_t numBoxes,
+            uint32* visibleMask) override;
+
+        /// @copydoc OptimisedUtil::cullSpheres
+        void cullSpheres(
+            const Vector4* planes,
+            size_t numPlanes,
+            const Vector4* spheres,
+            size_t numSpheres,
+            uint32* visibleMask) override;
+
+        /// @copydoc OptimisedUtil::intersectRayBoxes
+        void intersectRayBoxes(
+            const Vector3& origin,
+            const Vector3& direction,
+            const float* mins,
+            const float* maxs,
+            size_t numBoxes,
+            uint32* hitMask,
+            float* distances) override;
     };
     //---------------------------------------------------------------------
     //---------------------------------------------------------------------
@@ -364,6 +391,106 @@ namespace Ogre {
         }
     }
     //---------------------------------------------------------------------
+    void OptimisedUtilGeneral::cullBoxes(
+        const Vector4* planes,
+        size_t numPlanes,
+        const float* centres,
+        const float* halfSizes,
+        size_t numBoxes,
+        uint32* visibleMask)
+    {
+        std::fill(visibleMask, visibleMask + (numBoxes + 31) / 32, 0);
+
+        for (size_t i = 0; i < numBoxes; ++i)
+        {
+            const float* c = centres + i * 3;
+            const float* h = halfSizes + i * 3;
+
+            bool visible = true;
+            for (size_t p = 0; p < numPlanes && visible; ++p)
+            {
+                // same as Plane::getSide
+                const Vector4& plane = planes[p];
+                Real dist = plane.x * c[0] + plane.y * c[1] + plane.z * c[2] + plane.w;
+                Real maxAbsDist = std::abs(plane.x * h[0]) + std::abs(plane.y * h[1]) + std::abs(plane.z * h[2]);
+                visible = !(dist < -maxAbsDist);
+            }
+
+            if (visible)
+                visibleMask[i / 32] |= 1u << (i % 32);
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilGeneral::cullSpheres(
+        const Vector4* planes,
+        size_t numPlanes,
+        const Vector4* spheres,
+        size_t numSpheres,
+        uint32* visibleMask)
+    {
+        std::fill(visibleMask, visibleMask + (numSpheres + 31) / 32, 0);
+
+        for (size_t i = 0; i < numSpheres; ++i)
+        {
+            const Vector4& sphere = spheres[i];
+
+            bool visible = true;
+            for (size_t p = 0; p < numPlanes && visible; ++p)
+            {
+                const Vector4& plane = planes[p];
+                Real dist = plane.x * sphere.x + plane.y * sphere.y + plane.z * sphere.z + plane.w;
+                visible = !(dist < -sphere.w);
+            }
+
+            if (visible)
+                visibleMask[i / 32] |= 1u << (i % 32);
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilGeneral::intersectRayBoxes(
+        const Vector3& origin,
+        const Vector3& direction,
+        const float* mins,
+        const float* maxs,
+        size_t numBoxes,
+        uint32* hitMask,
+        float* distances)
+    {
+        std::fill(hitMask, hitMask + (numBoxes + 31) / 32, 0);
+
+        for (size_t i = 0; i < numBoxes; ++i)
+        {
+            const float* boxMin = mins + i * 3;
+            const float* boxMax = maxs + i * 3;
+
+            // slab test, the ray starts at the origin
+            Real tNear = 0;
+            Real tFar = std::numeric_limits<Real>::infinity();
+            bool hit = true;
+            for (int axis = 0; axis < 3 && hit; ++axis)
+            {
+                if (direction[axis] == 0)
+                {
+                    // parallel to the slab, must start inside of it
+                    hit = origin[axis] >= boxMin[axis] && origin[axis] <= boxMax[axis];
+                    continue;
+                }
+
+                Real invDir = 1 / direction[axis];
+                Real t1 = (boxMin[axis] - origin[axis]) * invDir;
+                Real t2 = (boxMax[axis] - origin[axis]) * invDir;
+                tNear = std::max(tNear, std::min(t1, t2));
+                tFar = std::min(tFar, std::max(t1, t2));
+                hit = tNear <= tFar;
+            }
+
+            if (hit)
+                hitMask[i / 32] |= 1u << (i % 32);
+            if (distances)
+                distances[i] = float(tNear);
+        }
+    }
+    //---------------------------------------------------------------------
     //---------------------------------------------------------------------
     //---------------------------------------------------------------------
     extern OptimisedUtil* _getOptimisedUtilGeneral(void);
@@ -129,6 +129,33 @@ namespace Ogre {
             const float* srcPositions,
             float* destPositions,
             size_t numVertices) override;
+
+        /// @copydoc OptimisedUtil::cullBoxes
+        void __OGRE_SIMD_ALIGN_ATTRIBUTE cullBoxes(
+            const Vector4* planes,
+            size_t numPlanes,
+            const float* centres,
+            const float* halfSizes,
+            size_t numBoxes,
+            uint32* visibleMask) override;
+
+        /// @copydoc OptimisedUtil::cullSpheres
+        void __OGRE_SIMD_ALIGN_ATTRIBUTE cullSpheres(
+            const Vector4* planes,
+            size_t numPlanes,
+            const Vector4* spheres,
+            size_t numSpheres,
+            uint32* visibleMask) override;
+
+        /// @copydoc OptimisedUtil::intersectRayBoxes
+        void __OGRE_SIMD_ALIGN_ATTRIBUTE intersectRayBoxes(
+            const Vector3& origin,
+            const Vector3& direction,
+            const float* mins,
+            const float* maxs,
+            size_t numBoxes,
+            uint32* hitMask,
+            float* distances) override;
     };
 
 #if defined(__OGRE_SIMD_ALIGN_STACK)
@@ -268,6 +295,66 @@ namespace Ogre {
                 destPositions,
                 numVertices);
         }
+
+        /// @copydoc OptimisedUtil::cullBoxes
+        virtual void cullBoxes(
+            const Vector4* planes,
+            size_t numPlanes,
+            const float* centres,
+            const float* halfSizes,
+            size_t numBoxes,
+            uint32* visibleMask)
+        {
+            __OGRE_SIMD_ALIGN_STACK();
+
+            mImpl->cullBoxes(
+                planes,
+                numPlanes,
+                centres,
+                halfSizes,
+                numBoxes,
+                visibleMask);
+        }
+
+        /// @copydoc OptimisedUtil::cullSpheres
+        virtual void cullSpheres(
+            const Vector4* planes,
+            size_t numPlanes,
+            const Vector4* spheres,
+            size_t numSpheres,
+            uint32* visibleMask)
+        {
+            __OGRE_SIMD_ALIGN_STACK();
+
+            mImpl->cullSpheres(
+                planes,
+                numPlanes,
+                spheres,
+                numSpheres,
+                visibleMask);
+        }
+
+        /// @copydoc OptimisedUtil::intersectRayBoxes
+        virtual void intersectRayBoxes(
+            const Vector3& origin,
+            const Vector3& direction,
+            const float* mins,
+            const float* maxs,
+            size_t numBoxes,
+            uint32* hitMask,
+            float* distances)
+        {
+            __OGRE_SIMD_ALIGN_STACK();
+
+            mImpl->intersectRayBoxes(
+                origin,
+                direction,
+                mins,
+                maxs,
+                numBoxes,
+                hitMask,
+                distances);
+        }
     };
 #endif  // !defined(__OGRE_SIMD_ALIGN_STACK)
 
@@ -2134,6 +2221,176 @@ namespace Ogre {
         }
     }
     //---------------------------------------------------------------------
+    /** Load four packed (x, y, z) vectors and transpose them to one register per component.
+        The vectors past the given count are filled with zero.
+    */
+    static OGRE_FORCE_INLINE void loadPackedVectors(const float* src, size_t count, __m128& x, __m128& y, __m128& z)
+    {
+        const float* ptr = src;
+        float padded[12];
+        if (count < 4)
+        {
+            std::fill(padded, padded + 12, 0.0f);
+            std::copy(src, src + count * 3, padded);
+            ptr = padded;
+        }
+
+        x = _mm_loadu_ps(ptr + 0);
+        y = _mm_loadu_ps(ptr + 4);
+        z = _mm_loadu_ps(ptr + 8);
+        __MM_TRANSPOSE4x3_PS(x, y, z);
+    }
+    //---------------------------------------------------------------------
+    /// absolute value of each component
+    static OGRE_FORCE_INLINE __m128 absPS(__m128 v)
+    {
+        return _mm_max_ps(v, _mm_sub_ps(_mm_setzero_ps(), v));
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilSSE::cullBoxes(
+        const Vector4* planes,
+        size_t numPlanes,
+        const float* centres,
+        const float* halfSizes,
+        size_t numBoxes,
+        uint32* visibleMask)
+    {
+        __OGRE_CHECK_STACK_ALIGNED_FOR_SSE();
+
+        std::fill(visibleMask, visibleMask + (numBoxes + 31) / 32, 0);
+
+        // Four boxes per iteration, transposed to one register per component,
+        // so each plane is tested with plain multiply and add
+        for (size_t i = 0; i < numBoxes; i += 4)
+        {
+            size_t count = std::min<size_t>(numBoxes - i, 4);
+
+            __m128 cx, cy, cz, hx, hy, hz;
+            loadPackedVectors(centres + i * 3, count, cx, cy, cz);
+            loadPackedVectors(halfSizes + i * 3, count, hx, hy, hz);
+
+            __m128 culled = _mm_setzero_ps();
+            for (size_t p = 0; p < numPlanes; ++p)
+            {
+                const Vector4& plane = planes[p];
+                __m128 nx = _mm_set1_ps(plane.x);
+                __m128 ny = _mm_set1_ps(plane.y);
+                __m128 nz = _mm_set1_ps(plane.z);
+
+                // same as Plane::getSide
+                __m128 dist = _mm_add_ps(__MM_DOT3x3_PS(nx, ny, nz, cx, cy, cz), _mm_set1_ps(plane.w));
+                __m128 maxAbsDist = __MM_ACCUM3_PS(
+                    absPS(_mm_mul_ps(nx, hx)), absPS(_mm_mul_ps(ny, hy)), absPS(_mm_mul_ps(nz, hz)));
+                culled = _mm_or_ps(culled, _mm_cmplt_ps(dist, _mm_sub_ps(_mm_setzero_ps(), maxAbsDist)));
+            }
+
+            uint32 visible = ~uint32(_mm_movemask_ps(culled)) & ((1u << count) - 1);
+            visibleMask[i / 32] |= visible << (i % 32);
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilSSE::cullSpheres(
+        const Vector4* planes,
+        size_t numPlanes,
+        const Vector4* spheres,
+        size_t numSpheres,
+        uint32* visibleMask)
+    {
+        __OGRE_CHECK_STACK_ALIGNED_FOR_SSE();
+
+        std::fill(visibleMask, visibleMask + (numSpheres + 31) / 32, 0);
+
+        for (size_t i = 0; i < numSpheres; i += 4)
+        {
+            size_t count = std::min<size_t>(numSpheres - i, 4);
+
+            __m128 cx = _mm_loadu_ps(spheres[i].ptr());
+            __m128 cy = count > 1 ? _mm_loadu_ps(spheres[i + 1].ptr()) : _mm_setzero_ps();
+            __m128 cz = count > 2 ? _mm_loadu_ps(spheres[i + 2].ptr()) : _mm_setzero_ps();
+            __m128 r = count > 3 ? _mm_loadu_ps(spheres[i + 3].ptr()) : _mm_setzero_ps();
+            __MM_TRANSPOSE4x4_PS(cx, cy, cz, r);
+            __m128 negR = _mm_sub_ps(_mm_setzero_ps(), r);
+
+            __m128 culled = _mm_setzero_ps();
+            for (size_t p = 0; p < numPlanes; ++p)
+            {
+                const Vector4& plane = planes[p];
+                __m128 dist = _mm_add_ps(
+                    __MM_DOT3x3_PS(_mm_set1_ps(plane.x), _mm_set1_ps(plane.y), _mm_set1_ps(plane.z), cx, cy, cz),
+                    _mm_set1_ps(plane.w));
+                culled = _mm_or_ps(culled, _mm_cmplt_ps(dist, negR));
+            }
+
+            uint32 visible = ~uint32(_mm_movemask_ps(culled)) & ((1u << count) - 1);
+            visibleMask[i / 32] |= visible << (i % 32);
+        }
+    }
+    //---------------------------------------------------------------------
+    void OptimisedUtilSSE::intersectRayBoxes(
+        const Vector3& origin,
+        const Vector3& direction,
+        const float* mins,
+        const float* maxs,
+        size_t numBoxes,
+        uint32* hitMask,
+        float* distances)
+    {
+        __OGRE_CHECK_STACK_ALIGNED_FOR_SSE();
+
+        std::fill(hitMask, hitMask + (numBoxes + 31) / 32, 0);
+
+        // The direction is shared by all boxes, so axes parallel to the ray are
+        // resolved once here instead of per lane
+        bool parallel[3];
+        __m128 orig[3], invDir[3];
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            parallel[axis] = direction[axis] == 0;
+            orig[axis] = _mm_set1_ps(origin[axis]);
+            invDir[axis] = _mm_set1_ps(parallel[axis] ? 0.0f : 1.0f / direction[axis]);
+        }
+
+        for (size_t i = 0; i < numBoxes; i += 4)
+        {
+            size_t count = std::min<size_t>(numBoxes - i, 4);
+
+            __m128 boxMin[3], boxMax[3];
+            loadPackedVectors(mins + i * 3, count, boxMin[0], boxMin[1], boxMin[2]);
+            loadPackedVectors(maxs + i * 3, count, boxMax[0], boxMax[1], boxMax[2]);
+
+            // slab test, the ray starts at the origin
+            __m128 tNear = _mm_setzero_ps();
+            __m128 tFar = _mm_set1_ps(std::numeric_limits<float>::infinity());
+            __m128 miss = _mm_setzero_ps();
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                if (parallel[axis])
+                {
+                    // must start inside of the slab
+                    miss = _mm_or_ps(miss, _mm_or_ps(_mm_cmplt_ps(orig[axis], boxMin[axis]),
+                                                     _mm_cmplt_ps(boxMax[axis], orig[axis])));
+                    continue;
+                }
+
+                __m128 t1 = _mm_mul_ps(_mm_sub_ps(boxMin[axis], orig[axis]), invDir[axis]);
+                __m128 t2 = _mm_mul_ps(_mm_sub_ps(boxMax[axis], orig[axis]), invDir[axis]);
+                tNear = _mm_max_ps(tNear, _mm_min_ps(t1, t2));
+                tFar = _mm_min_ps(tFar, _mm_max_ps(t1, t2));
+            }
+            miss = _mm_or_ps(miss, _mm_cmplt_ps(tFar, tNear));
+
+            uint32 hit = ~uint32(_mm_movemask_ps(miss)) & ((1u << count) - 1);
+            hitMask[i / 32] |= hit << (i % 32);
+
+            if (distances)
+            {
+                float entry[4];
+                _mm_storeu_ps(entry, tNear);
+                std::copy(entry, entry + count, distances + i);
+            }
+        }
+    }
+    //---------------------------------------------------------------------
     //---------------------------------------------------------------------
     //---------------------------------------------------------------------
     extern OptimisedUtil* _getOptimisedUtilSSE(void);
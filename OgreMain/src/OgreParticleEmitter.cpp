@@ -28,6 +28,7 @@ THE SOFTWARE.
 #include "OgreStableHeaders.h"
 
 #include "OgreParticleEmitter.h"
+#include "OgreParticleSystem.h"
 #include "OgreParticleEmitterFactory.h"
 #include "OgreParticleEmitterCommands.h"
 
@@ -232,11 +233,26 @@ namespace Ogre
         mEmitted = emitted;
     }
     //-----------------------------------------------------------------------
-    static float sampleSphereUniform(const float& maxAngle)
+    static float sampleSphereUniform(const float& maxAngle, float unitRandom)
     {
         float cosMax = -std::cos(maxAngle) + 1; // for maxAngle = pi, cosMax = 2
         // see https://corysimon.github.io/articles/uniformdistn-on-sphere/
-        return std::acos(1 - cosMax * Math::UnitRandom());
+        return std::acos(1 - cosMax * unitRandom);
+    }
+
+    /// Vector3::randomDeviant using the random numbers of the particle system
+    static Vector3 randomDeviant(const Vector3& v, const Radian& angle, const Vector3& up, float unitRandom)
+    {
+        Vector3 newUp = up == Vector3::ZERO ? v.perpendicular() : up;
+
+        // Rotate up vector by random amount around this
+        Quaternion q;
+        q.FromAngleAxis(Radian(unitRandom * Math::TWO_PI), v);
+        newUp = q * newUp;
+
+        // Finally rotate this by given angle around randomised up
+        q.FromAngleAxis(angle, newUp);
+        return q * v;
     }
 
     void ParticleEmitter::genEmissionDirection( const Vector3 &particlePos, Vector3& destVector )
@@ -249,10 +265,10 @@ namespace Ogre
             if (mAngle != Radian(0))
             {
                 // Randomise angle
-                Radian angle(sampleSphereUniform(mAngle.valueRadians()));
+                Radian angle(sampleSphereUniform(mAngle.valueRadians(), mParent->_unitRandom()));
 
                 // Randomise direction
-                destVector = particleDir.randomDeviant( angle );
+                destVector = randomDeviant(particleDir, angle, Vector3::ZERO, mParent->_unitRandom());
             }
             else
             {
@@ -265,10 +281,10 @@ namespace Ogre
             if (mAngle != Radian(0))
             {
                 // Randomise angle
-                Radian angle(sampleSphereUniform(mAngle.valueRadians()));
+                Radian angle(sampleSphereUniform(mAngle.valueRadians(), mParent->_unitRandom()));
 
                 // Randomise direction
-                destVector = mDirection.randomDeviant(angle, mUp);
+                destVector = randomDeviant(mDirection, angle, mUp, mParent->_unitRandom());
             }
             else
             {
@@ -286,7 +302,7 @@ namespace Ogre
         Real scalar;
         if (mMinSpeed != mMaxSpeed)
         {
-            scalar = mMinSpeed + (Math::UnitRandom() * (mMaxSpeed - mMinSpeed));
+            scalar = mMinSpeed + (mParent->_unitRandom() * (mMaxSpeed - mMinSpeed));
         }
         else
         {
@@ -300,7 +316,7 @@ namespace Ogre
     {
         if (mMaxTTL != mMinTTL)
         {
-            return mMinTTL + (Math::UnitRandom() * (mMaxTTL - mMinTTL));
+            return mMinTTL + (mParent->_unitRandom() * (mMaxTTL - mMinTTL));
         }
         else
         {
@@ -368,7 +384,7 @@ namespace Ogre
         if (mColourRangeStart != mColourRangeEnd)
         {
             // Randomise
-            ColourValue t(Math::UnitRandom(), Math::UnitRandom(), Math::UnitRandom(), Math::UnitRandom());
+            ColourValue t(mParent->_unitRandom(), mParent->_unitRandom(), mParent->_unitRandom(), mParent->_unitRandom());
             destColour = (mColourRangeStart + t * (mColourRangeEnd - mColourRangeStart)).getAsBYTE();
         }
         else
@@ -616,7 +632,7 @@ namespace Ogre
             }
             else
             {
-                mDurationRemain = Math::RangeRandom(mDurationMin, mDurationMax);
+                mDurationRemain = mParent->_rangeRandom(mDurationMin, mDurationMax);
             }
         }
         else
@@ -628,7 +644,7 @@ namespace Ogre
             }
             else
             {
-                mRepeatDelayRemain = Math::RangeRandom(mRepeatDelayMax, mRepeatDelayMin);
+                mRepeatDelayRemain = mParent->_rangeRandom(mRepeatDelayMax, mRepeatDelayMin);
             }
 
         }
@@ -0,0 +1,360 @@
+// This file is part of the OGRE project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at https://www.ogre3d.org/licensing.
+// SPDX-License-Identifier: MIT
+#include "OgreStableHeaders.h"
+#include "OgreParticleStreams.h"
+#include "OgreParticle.h"
+#include "OgreSIMDHelper.h"
+
+#if (__OGRE_HAVE_SSE || __OGRE_HAVE_NEON) && OGRE_DOUBLE_PRECISION == 0
+#define OGRE_PARTICLESTREAMS_SIMD 1
+#else
+#define OGRE_PARTICLESTREAMS_SIMD 0
+#endif
+
+// the colour channels are processed as integers
+#if __OGRE_HAVE_SSE && (OGRE_ARCH_TYPE == OGRE_ARCHITECTURE_64 || defined(__SSE2__))
+#include <emmintrin.h>
+#define OGRE_PARTICLESTREAMS_SSE2 1
+#else
+#define OGRE_PARTICLESTREAMS_SSE2 0
+#endif
+
+namespace Ogre
+{
+    static const size_t GROUP_SIZE = 4;
+
+    //-----------------------------------------------------------------------
+    void ParticleStreams::reserve(size_t count)
+    {
+        for (auto arr : {&mPosition, &mDirection})
+        {
+            arr->x.reserve(count);
+            arr->y.reserve(count);
+            arr->z.reserve(count);
+        }
+        mColour.reserve(count);
+        mTimeToLive.reserve(count);
+        mTotalTimeToLive.reserve(count);
+        mWidth.reserve(count);
+        mHeight.reserve(count);
+        mRotation.reserve(count);
+        mRotationSpeed.reserve(count);
+        mTexcoordIndex.reserve(count);
+        mRandomTexcoordOffset.reserve(count);
+    }
+    //-----------------------------------------------------------------------
+    void ParticleStreams::clear()
+    {
+        for (auto arr : {&mPosition, &mDirection})
+        {
+            arr->x.clear();
+            arr->y.clear();
+            arr->z.clear();
+        }
+        mColour.clear();
+        mTimeToLive.clear();
+        mTotalTimeToLive.clear();
+        mWidth.clear();
+        mHeight.clear();
+        mRotation.clear();
+        mRotationSpeed.clear();
+        mTexcoordIndex.clear();
+        mRandomTexcoordOffset.clear();
+    }
+    //-----------------------------------------------------------------------
+    void ParticleStreams::push_back(const Particle& p)
+    {
+        mPosition.x.push_back(p.mPosition.x);
+        mPosition.y.push_back(p.mPosition.y);
+        mPosition.z.push_back(p.mPosition.z);
+        mDirection.x.push_back(p.mDirection.x);
+        mDirection.y.push_back(p.mDirection.y);
+        mDirection.z.push_back(p.mDirection.z);
+        mColour.push_back(p.mColour);
+        mTimeToLive.push_back(p.mTimeToLive);
+        mTotalTimeToLive.push_back(p.mTotalTimeToLive);
+        mWidth.push_back(p.mWidth);
+        mHeight.push_back(p.mHeight);
+        mRotation.push_back(p.mRotation.valueRadians());
+        mRotationSpeed.push_back(p.mRotationSpeed.valueRadians());
+        mTexcoordIndex.push_back(p.mTexcoordIndex);
+        mRandomTexcoordOffset.push_back(p.mRandomTexcoordOffset);
+    }
+    //-----------------------------------------------------------------------
+    void ParticleStreams::get(size_t i, Particle& p) const
+    {
+        p.mPosition = Vector3(mPosition.x[i], mPosition.y[i], mPosition.z[i]);
+        p.mDirection = Vector3(mDirection.x[i], mDirection.y[i], mDirection.z[i]);
+        p.mColour = mColour[i];
+        p.mTimeToLive = mTimeToLive[i];
+        p.mTotalTimeToLive = mTotalTimeToLive[i];
+        p.mWidth = mWidth[i];
+        p.mHeight = mHeight[i];
+        p.mRotation = Radian(mRotation[i]);
+        p.mRotationSpeed = Radian(mRotationSpeed[i]);
+        p.mTexcoordIndex = mTexcoordIndex[i];
+        p.mRandomTexcoordOffset = mRandomTexcoordOffset[i];
+        p.mParticleType = Particle::Visual;
+    }
+    //-----------------------------------------------------------------------
+    void ParticleStreams::set(size_t i, const Particle& p)
+    {
+        mPosition.x[i] = p.mPosition.x;
+        mPosition.y[i] = p.mPosition.y;
+        mPosition.z[i] = p.mPosition.z;
+        mDirection.x[i] = p.mDirection.x;
+        mDirection.y[i] = p.mDirection.y;
+        mDirection.z[i] = p.mDirection.z;
+        mColour[i] = p.mColour;
+        mTimeToLive[i] = p.mTimeToLive;
+        mTotalTimeToLive[i] = p.mTotalTimeToLive;
+        mWidth[i] = p.mWidth;
+        mHeight[i] = p.mHeight;
+        mRotation[i] = p.mRotation.valueRadians();
+        mRotationSpeed[i] = p.mRotationSpeed.valueRadians();
+        mTexcoordIndex[i] = p.mTexcoordIndex;
+        mRandomTexcoordOffset[i] = p.mRandomTexcoordOffset;
+    }
+    //-----------------------------------------------------------------------
+    template <typename T> static void removeSwapLast(std::vector<T>& v, size_t i)
+    {
+        v[i] = v.back();
+        v.pop_back();
+    }
+    void ParticleStreams::removeSwapLast(size_t i)
+    {
+        for (auto arr : {&mPosition, &mDirection})
+        {
+            Ogre::removeSwapLast(arr->x, i);
+            Ogre::removeSwapLast(arr->y, i);
+            Ogre::removeSwapLast(arr->z, i);
+        }
+        Ogre::removeSwapLast(mColour, i);
+        Ogre::removeSwapLast(mTimeToLive, i);
+        Ogre::removeSwapLast(mTotalTimeToLive, i);
+        Ogre::removeSwapLast(mWidth, i);
+        Ogre::removeSwapLast(mHeight, i);
+        Ogre::removeSwapLast(mRotation, i);
+        Ogre::removeSwapLast(mRotationSpeed, i);
+        Ogre::removeSwapLast(mTexcoordIndex, i);
+        Ogre::removeSwapLast(mRandomTexcoordOffset, i);
+    }
+    //-----------------------------------------------------------------------
+    template <typename T> static void reorder(std::vector<T>& v, const std::vector<uint32>& order)
+    {
+        std::vector<T> tmp(v.size());
+        for (size_t i = 0; i < order.size(); i++)
+            tmp[i] = v[order[i]];
+        v.swap(tmp);
+    }
+    void ParticleStreams::reorder(const std::vector<uint32>& order)
+    {
+        assert(order.size() == size());
+        for (auto arr : {&mPosition, &mDirection})
+        {
+            Ogre::reorder(arr->x, order);
+            Ogre::reorder(arr->y, order);
+            Ogre::reorder(arr->z, order);
+        }
+        Ogre::reorder(mColour, order);
+        Ogre::reorder(mTimeToLive, order);
+        Ogre::reorder(mTotalTimeToLive, order);
+        Ogre::reorder(mWidth, order);
+        Ogre::reorder(mHeight, order);
+        Ogre::reorder(mRotation, order);
+        Ogre::reorder(mRotationSpeed, order);
+        Ogre::reorder(mTexcoordIndex, order);
+        Ogre::reorder(mRandomTexcoordOffset, order);
+    }
+    //-----------------------------------------------------------------------
+    void ParticleStreams::applyMotion(Real timeElapsed)
+    {
+        size_t count = size(), i = 0;
+#if OGRE_PARTICLESTREAMS_SIMD
+        __m128 t = _mm_set1_ps(timeElapsed);
+        for (; i + GROUP_SIZE <= count; i += GROUP_SIZE)
+        {
+            _mm_storeu_ps(&mPosition.x[i], _mm_add_ps(_mm_loadu_ps(&mPosition.x[i]),
+                                                      _mm_mul_ps(_mm_loadu_ps(&mDirection.x[i]), t)));
+            _mm_storeu_ps(&mPosition.y[i], _mm_add_ps(_mm_loadu_ps(&mPosition.y[i]),
+                                                      _mm_mul_ps(_mm_loadu_ps(&mDirection.y[i]), t)));
+            _mm_storeu_ps(&mPosition.z[i], _mm_add_ps(_mm_loadu_ps(&mPosition.z[i]),
+                                                      _mm_mul_ps(_mm_loadu_ps(&mDirection.z[i]), t)));
+        }
+#endif
+        for (; i < count; i++)
+        {
+            mPosition.x[i] += mDirection.x[i] * timeElapsed;
+            mPosition.y[i] += mDirection.y[i] * timeElapsed;
+            mPosition.z[i] += mDirection.z[i] * timeElapsed;
+        }
+    }
+    //-----------------------------------------------------------------------
+    void ParticleStreams::addDirection(const Vector3& v)
+    {
+        size_t count = size(), i = 0;
+#if OGRE_PARTICLESTREAMS_SIMD
+        __m128 vx = _mm_set1_ps(v.x), vy = _mm_set1_ps(v.y), vz = _mm_set1_ps(v.z);
+        for (; i + GROUP_SIZE <= count; i += GROUP_SIZE)
+        {
+            _mm_storeu_ps(&mDirection.x[i], _mm_add_ps(_mm_loadu_ps(&mDirection.x[i]), vx));
+            _mm_storeu_ps(&mDirection.y[i], _mm_add_ps(_mm_loadu_ps(&mDirection.y[i]), vy));
+            _mm_storeu_ps(&mDirection.z[i], _mm_add_ps(_mm_loadu_ps(&mDirection.z[i]), vz));
+        }
+#endif
+        for (; i < count; i++)
+        {
+            mDirection.x[i] += v.x;
+            mDirection.y[i] += v.y;
+            mDirection.z[i] += v.z;
+        }
+    }
+    //-----------------------------------------------------------------------
+    void ParticleStreams::averageDirection(const Vector3& v)
+    {
+        // Vector3 divides by multiplying with the reciprocal, which is exact for 2
+        size_t count = size(), i = 0;
+#if OGRE_PARTICLESTREAMS_SIMD
+        __m128 vx = _mm_set1_ps(v.x), vy = _mm_set1_ps(v.y), vz = _mm_set1_ps(v.z);
+        __m128 half = _mm_set1_ps(0.5f);
+        for (; i + GROUP_SIZE <= count; i += GROUP_SIZE)
+        {
+            _mm_storeu_ps(&mDirection.x[i], _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(&mDirection.x[i]), vx), half));
+            _mm_storeu_ps(&mDirection.y[i], _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(&mDirection.y[i]), vy), half));
+            _mm_storeu_ps(&mDirection.z[i], _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(&mDirection.z[i]), vz), half));
+        }
+#endif
+        for (; i < count; i++)
+        {
+            mDirection.x[i] = (mDirection.x[i] + v.x) * Real(0.5);
+            mDirection.y[i] = (mDirection.y[i] + v.y) * Real(0.5);
+            mDirection.z[i] = (mDirection.z[i] + v.z) * Real(0.5);
+        }
+    }
+    //-----------------------------------------------------------------------
+    void ParticleStreams::adjustColour(const ColourValue& delta)
+    {
+        size_t count = size(), i = 0;
+#if OGRE_PARTICLESTREAMS_SSE2
+        // one particle per register, with the channels in memory order like ColourValue(const uchar*)
+        __m128 d = _mm_setr_ps(delta.r, delta.g, delta.b, delta.a);
+        __m128 scale = _mm_set1_ps(255.0f);
+        __m128 zero = _mm_setzero_ps(), one = _mm_set1_ps(1.0f);
+        __m128i zeroi = _mm_setzero_si128();
+        auto adjust = [&](__m128i c) {
+            __m128 v = _mm_div_ps(_mm_cvtepi32_ps(c), scale);
+            v = _mm_min_ps(_mm_max_ps(_mm_add_ps(v, d), zero), one);
+            return _mm_cvttps_epi32(_mm_mul_ps(v, scale));
+        };
+        for (; i + GROUP_SIZE <= count; i += GROUP_SIZE)
+        {
+            __m128i c = _mm_loadu_si128(reinterpret_cast<const __m128i*>(&mColour[i]));
+            __m128i lo = _mm_unpacklo_epi8(c, zeroi), hi = _mm_unpackhi_epi8(c, zeroi);
+            __m128i c0 = adjust(_mm_unpacklo_epi16(lo, zeroi));
+            __m128i c1 = adjust(_mm_unpackhi_epi16(lo, zeroi));
+            __m128i c2 = adjust(_mm_unpacklo_epi16(hi, zeroi));
+            __m128i c3 = adjust(_mm_unpackhi_epi16(hi, zeroi));
+            // all values are within 0..255, so saturation does not change them
+            c = _mm_packus_epi16(_mm_packs_epi32(c0, c1), _mm_packs_epi32(c2, c3));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(&mColour[i]), c);
+        }
+#endif
+        for (; i < count; i++)
+            mColour[i] = (ColourValue(reinterpret_cast<const uchar*>(&mColour[i])) + delta).saturateCopy().getAsBYTE();
+    }
+    //-----------------------------------------------------------------------
+    void ParticleStreams::adjustDimensions(float delta)
+    {
+        size_t count = size(), i = 0;
+#if OGRE_PARTICLESTREAMS_SIMD
+        __m128 d = _mm_set1_ps(delta), zero = _mm_setzero_ps();
+        for (; i + GROUP_SIZE <= count; i += GROUP_SIZE)
+        {
+            _mm_storeu_ps(&mWidth[i], _mm_max_ps(_mm_add_ps(_mm_loadu_ps(&mWidth[i]), d), zero));
+            _mm_storeu_ps(&mHeight[i], _mm_max_ps(_mm_add_ps(_mm_loadu_ps(&mHeight[i]), d), zero));
+        }
+#endif
+        for (; i < count; i++)
+        {
+            mWidth[i] = std::max(0.0f, mWidth[i] + delta);
+            mHeight[i] = std::max(0.0f, mHeight[i] + delta);
+        }
+    }
+    //-----------------------------------------------------------------------
+    void ParticleStreams::applyRotationSpeed(Real timeElapsed)
+    {
+        size_t count = size(), i = 0;
+#if OGRE_PARTICLESTREAMS_SIMD
+        __m128 t = _mm_set1_ps(timeElapsed);
+        for (; i + GROUP_SIZE <= count; i += GROUP_SIZE)
+        {
+            _mm_storeu_ps(&mRotation[i], _mm_add_ps(_mm_loadu_ps(&mRotation[i]),
+                                                    _mm_mul_ps(t, _mm_loadu_ps(&mRotationSpeed[i]))));
+        }
+#endif
+        for (; i < count; i++)
+            mRotation[i] += timeElapsed * mRotationSpeed[i];
+    }
+    //-----------------------------------------------------------------------
+    void ParticleStreams::deflect(const Vector3& n, Real planeDistance, Real bounce, Real timeElapsed)
+    {
+        // same operations as DeflectorPlaneAffector, the SIMD part only finds the particles to bounce
+        auto deflectParticle = [&](size_t i) {
+            Vector3 position(mPosition.x[i], mPosition.y[i], mPosition.z[i]);
+            Vector3 dir(mDirection.x[i], mDirection.y[i], mDirection.z[i]);
+            Vector3 direction(dir * timeElapsed);
+            if (n.dotProduct(position + direction) + planeDistance > 0.0)
+                return;
+
+            Real a = n.dotProduct(position) + planeDistance;
+            if (a <= 0.0)
+                return;
+
+            // for intersection point
+            Vector3 directionPart = direction * (-a / direction.dotProduct(n));
+            // set new position
+            position = (position + directionPart) + ((directionPart - direction) * bounce);
+            // reflect direction vector
+            dir = (dir - (2.0f * dir.dotProduct(n) * n)) * bounce;
+
+            mPosition.x[i] = position.x;
+            mPosition.y[i] = position.y;
+            mPosition.z[i] = position.z;
+            mDirection.x[i] = dir.x;
+            mDirection.y[i] = dir.y;
+            mDirection.z[i] = dir.z;
+        };
+
+        size_t count = size(), i = 0;
+#if OGRE_PARTICLESTREAMS_SIMD
+        __m128 t = _mm_set1_ps(timeElapsed), d = _mm_set1_ps(planeDistance), zero = _mm_setzero_ps();
+        __m128 nx = _mm_set1_ps(n.x), ny = _mm_set1_ps(n.y), nz = _mm_set1_ps(n.z);
+        for (; i + GROUP_SIZE <= count; i += GROUP_SIZE)
+        {
+            __m128 px = _mm_loadu_ps(&mPosition.x[i]);
+            __m128 py = _mm_loadu_ps(&mPosition.y[i]);
+            __m128 pz = _mm_loadu_ps(&mPosition.z[i]);
+            __m128 ex = _mm_add_ps(px, _mm_mul_ps(_mm_loadu_ps(&mDirection.x[i]), t));
+            __m128 ey = _mm_add_ps(py, _mm_mul_ps(_mm_loadu_ps(&mDirection.y[i]), t));
+            __m128 ez = _mm_add_ps(pz, _mm_mul_ps(_mm_loadu_ps(&mDirection.z[i]), t));
+            __m128 endDist = _mm_add_ps(
+                _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, ex), _mm_mul_ps(ny, ey)), _mm_mul_ps(nz, ez)), d);
+            __m128 startDist = _mm_add_ps(
+                _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, px), _mm_mul_ps(ny, py)), _mm_mul_ps(nz, pz)), d);
+            int mask = _mm_movemask_ps(_mm_and_ps(_mm_cmple_ps(endDist, zero), _mm_cmpgt_ps(startDist, zero)));
+            if (!mask)
+                continue;
+
+            for (size_t l = 0; l < GROUP_SIZE; l++)
+            {
+                if (mask & (1 << l))
+                    deflectParticle(i + l);
+            }
+        }
+#endif
+        for (; i < count; i++)
+            deflectParticle(i);
+    }
+}
@@ -32,6 +32,7 @@ THE SOFTWARE.
 #include "OgreParticleEmitter.h"
 #include "OgreParticleAffector.h"
 #include "OgreParticle.h"
+#include "OgreParticleStreams.h"
 #include "OgreParticleAffectorFactory.h"
 #include "OgreParticleSystemRenderer.h"
 #include "OgreControllerManager.h"
@@ -114,6 +115,13 @@ namespace Ogre {
         String doGet(const void* target) const override;
         void doSet(void* target, const String& val) override;
     };
+    /** Command object for stream storage (see ParamCommand).*/
+    class CmdStreamStorage : public ParamCommand
+    {
+    public:
+        String doGet(const void* target) const override;
+        void doSet(void* target, const String& val) override;
+    };
     /// Command objects
     static CmdCull msCullCmd;
     static CmdHeight msHeightCmd;
@@ -126,6 +134,7 @@ namespace Ogre {
     static CmdLocalSpace msLocalSpaceCmd;
     static CmdIterationInterval msIterationIntervalCmd;
     static CmdNonvisibleTimeout msNonvisibleTimeoutCmd;
+    static CmdStreamStorage msStreamStorageCmd;
 
     Real ParticleSystem::msDefaultIterationInterval = 0;
     Real ParticleSystem::msDefaultNonvisibleTimeout = 0;
@@ -141,10 +150,29 @@ namespace Ogre {
 
         float getValue(void) const override { return 0; } // N/A
 
-        void setValue(float value) override { mTarget->_update(value); }
+        void setValue(float value) override
+        {
+            ParticleSystemManager* mgr = ParticleSystemManager::getSingletonPtr();
+            if (mgr && mgr->getParallelUpdate())
+                mgr->_queueUpdate(mTarget, value);
+            else
+                mTarget->_update(value);
+        }
 
     };
     //-----------------------------------------------------------------------
+    /// FNV-1a over the bytes of the name, unlike std::hash the same with every compiler and platform
+    static uint32 seedFromName(const String& name)
+    {
+        uint32 hash = 2166136261u;
+        for (unsigned char c : name)
+        {
+            hash ^= c;
+            hash *= 16777619u;
+        }
+        return hash;
+    }
+    //-----------------------------------------------------------------------
     ParticleSystem::ParticleSystem() 
       : mAABB(),
         mBoundingRadius(1.0f),
@@ -201,7 +229,8 @@ namespace Ogre {
         mRenderer(0), 
         mCullIndividual(false),
         mPoolSize(0),
-        mEmittedEmitterPoolSize(0)
+        mEmittedEmitterPoolSize(0),
+        mRandom(seedFromName(name))
     {
         setDefaultDimensions( 100, 100 );
         mMaterial = MaterialManager::getSingleton().getDefaultMaterial();
@@ -217,6 +246,9 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     ParticleSystem::~ParticleSystem()
     {
+        if (auto mgr = ParticleSystemManager::getSingletonPtr())
+            mgr->_cancelUpdate(this);
+
         if (mTimeController)
         {
             // Destroy controller
@@ -357,6 +389,7 @@ namespace Ogre {
         mIterationIntervalSet = rhs.mIterationIntervalSet;
         mNonvisibleTimeout = rhs.mNonvisibleTimeout;
         mNonvisibleTimeoutSet = rhs.mNonvisibleTimeoutSet;
+        setStreamStorage(rhs.getStreamStorage());
         // last frame visible and time since last visible should be left default
 
         setRenderer(rhs.getRendererName());
@@ -372,7 +405,7 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     size_t ParticleSystem::getNumParticles(void) const
     {
-        return mActiveParticles.size();
+        return mActiveParticles.size() + (mStreams ? mStreams->size() : 0);
     }
     //-----------------------------------------------------------------------
     size_t ParticleSystem::getParticleQuota(void) const
@@ -429,9 +462,18 @@ namespace Ogre {
     void ParticleSystem::_update(Real timeElapsed)
     {
         OgreProfile("ParticleSystem");
+        if (!_beginUpdate(timeElapsed))
+            return;
+
+        _simulate(timeElapsed);
+        _endUpdate(timeElapsed);
+    }
+    //-----------------------------------------------------------------------
+    bool ParticleSystem::_beginUpdate(Real& timeElapsed)
+    {
         // Only update if attached to a node
         if (!mParentNode)
-            return;
+            return false;
 
         Real nonvisibleTimeout = mNonvisibleTimeoutSet ?
             mNonvisibleTimeout : msDefaultNonvisibleTimeout;
@@ -447,7 +489,7 @@ namespace Ogre {
                 if (mTimeSinceLastVisible >= nonvisibleTimeout)
                 {
                     // No update
-                    return;
+                    return false;
                 }
             }
         }
@@ -461,6 +503,17 @@ namespace Ogre {
         // Initialise emitted emitters list if not done already
         initialiseEmittedEmitters();
 
+        for (auto a : mAffectors)
+            a->_prepare();
+
+        // Bring the cached node transform up to date, so it is only read while emitting
+        mParentNode->_getDerivedPosition();
+        mParentNode->_getFullTransform();
+        return true;
+    }
+    //-----------------------------------------------------------------------
+    void ParticleSystem::_simulate(Real timeElapsed)
+    {
         Real iterationInterval = mIterationIntervalSet ? 
             mIterationInterval : msDefaultIterationInterval;
         if (iterationInterval > 0)
@@ -496,11 +549,13 @@ namespace Ogre {
                 _triggerEmitters(timeElapsed);
             }
         }
-
+    }
+    //-----------------------------------------------------------------------
+    void ParticleSystem::_endUpdate(Real timeElapsed)
+    {
         if (!mBoundsAutoUpdate && mBoundsUpdateTime > 0.0f)
             mBoundsUpdateTime -= timeElapsed; // count down 
         _updateBounds();
-
     }
     //-----------------------------------------------------------------------
     void ParticleSystem::_expire(Real timeElapsed)
@@ -509,6 +564,29 @@ namespace Ogre {
         Particle* pParticle;
         ParticleEmitter* pParticleEmitter;
 
+        if (mStreams)
+        {
+            ParticleStreams& streams = *mStreams;
+            Particle expired;
+            for (size_t i = 0; i < streams.size();)
+            {
+                if (streams.mTimeToLive[i] < timeElapsed)
+                {
+                    // Notify renderer
+                    streams.get(i, expired);
+                    mRenderer->_notifyParticleExpired(&expired);
+
+                    streams.removeSwapLast(i);
+                }
+                else
+                {
+                    // Decrement TTL
+                    streams.mTimeToLive[i] -= timeElapsed;
+                    ++i;
+                }
+            }
+        }
+
         auto iend = mActiveParticles.end();
         for (auto i = mActiveParticles.begin(); i != iend;)
         {
@@ -553,8 +631,8 @@ namespace Ogre {
     {
         OgreProfile("_triggerEmitters");
         // Add up requests for emission
-        static std::vector<unsigned> requested;
-        static std::vector<unsigned> emittedRequested;
+        std::vector<unsigned>& requested = mRequested;
+        std::vector<unsigned>& emittedRequested = mEmittedRequested;
 
         if( requested.size() != mEmitters.size() )
             requested.resize( mEmitters.size() );
@@ -569,7 +647,10 @@ namespace Ogre {
         emitterCount = mEmitters.size();
         emittedEmitterCount=mActiveEmittedEmitters.size();
         itActiveEnd=mActiveEmittedEmitters.end();
-        emissionAllowed = mFreeParticles.size();
+        if (mStreams)
+            emissionAllowed = mPoolSize - std::min(mPoolSize, mStreams->size());
+        else
+            emissionAllowed = mFreeParticles.size();
         totalRequested = 0;
 
         // Count up total requested emissions for regular emitters (and exclude the ones that are used as
@@ -634,16 +715,24 @@ namespace Ogre {
 
         Real timeInc = timeElapsed / requested;
 
+        // visual particles are set up here and then appended to the streams
+        Particle streamParticle;
+
         for (unsigned int j = 0; j < requested; ++j)
         {
             // Create a new particle & init using emitter
             // The particle is a visual particle if the emit_emitter property of the emitter isn't set 
             Particle* p = 0;
             String  emitterName = emitter->getEmittedEmitter();
-            if (emitterName.empty())
-                p = createParticle();
-            else
+            if (!emitterName.empty())
                 p = createEmitterParticle(emitterName);
+            else if (!mStreams)
+                p = createParticle();
+            else if (mStreams->size() < mPoolSize)
+            {
+                streamParticle = Particle();
+                p = &streamParticle;
+            }
 
             // Only continue if the particle was really created (not null)
             if (!p)
@@ -670,11 +759,17 @@ namespace Ogre {
 
             // Notify renderer
             mRenderer->_notifyParticleEmitted(p);
+
+            if (p == &streamParticle)
+                mStreams->push_back(streamParticle);
         }
     }
     //-----------------------------------------------------------------------
     void ParticleSystem::_applyMotion(Real timeElapsed)
     {
+        if (mStreams)
+            mStreams->applyMotion(timeElapsed);
+
         for (auto pParticle : mActiveParticles)
         {
             pParticle->mPosition += (pParticle->mDirection * timeElapsed);
@@ -687,10 +782,67 @@ namespace Ogre {
     void ParticleSystem::_triggerAffectors(Real timeElapsed)
     {
         OgreProfile("_triggerAffectors");
+        if (!mStreams)
+        {
+            for (auto a : mAffectors)
+            {
+                a->_affectParticles(this, timeElapsed);
+            }
+            return;
+        }
+
+        // consecutive affectors without stream support share the same copies
+        size_t numActive = mActiveParticles.size();
+        bool gathered = false;
         for (auto a : mAffectors)
         {
-            a->_affectParticles(this, timeElapsed);
+            if (a->_supportsParticleStreams())
+            {
+                if (gathered)
+                {
+                    releaseStreamParticles(numActive, true);
+                    gathered = false;
+                }
+                a->_affectParticleStreams(*mStreams, timeElapsed);
+                // emitted emitters
+                if (numActive)
+                    a->_affectParticles(this, timeElapsed);
+            }
+            else
+            {
+                if (!gathered)
+                {
+                    gatherStreamParticles();
+                    gathered = true;
+                }
+                a->_affectParticles(this, timeElapsed);
+            }
+        }
+
+        if (gathered)
+            releaseStreamParticles(numActive, true);
+    }
+    //-----------------------------------------------------------------------
+    size_t ParticleSystem::gatherStreamParticles(void)
+    {
+        size_t numActive = mActiveParticles.size();
+        mStreamParticles.resize(mStreams->size());
+        for (size_t i = 0; i < mStreamParticles.size(); i++)
+        {
+            mStreams->get(i, mStreamParticles[i]);
+            mActiveParticles.push_back(&mStreamParticles[i]);
+        }
+        return numActive;
+    }
+    //-----------------------------------------------------------------------
+    void ParticleSystem::releaseStreamParticles(size_t numActive, bool writeBack)
+    {
+        if (writeBack)
+        {
+            for (size_t i = 0; i < mStreamParticles.size(); i++)
+                mStreams->set(i, mStreamParticles[i]);
         }
+        mActiveParticles.resize(numActive);
     }
     //-----------------------------------------------------------------------
     void ParticleSystem::increasePool(size_t size)
@@ -709,6 +861,7 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     Particle* ParticleSystem::getParticle(size_t index) 
     {
+        OgreAssert(!mStreams, "not available with stream storage, use _getParticleStreams");
         assert (index < mActiveParticles.size() && "Index out of bounds!");
         return mActiveParticles[index];
     }
@@ -716,7 +869,7 @@ namespace Ogre {
     Particle* ParticleSystem::createParticle(void)
     {
         Particle* p = 0;
-        if (!mFreeParticles.empty())
+        if (!mStreams && !mFreeParticles.empty())
         {
             // Fast creation (don't use superclass since emitter will init)
             p = mFreeParticles.back();
@@ -751,10 +904,22 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     void ParticleSystem::_updateRenderQueue(RenderQueue* queue)
     {
-        if (mRenderer)
+        if (!mRenderer)
+            return;
+
+        if (!mStreams)
         {
             mRenderer->_updateRenderQueue(queue, mActiveParticles, mCullIndividual);
+            return;
         }
+
+        if (mRenderer->_updateRenderQueueFromStreams(queue, *mStreams, mActiveParticles, mCullIndividual))
+            return;
+
+        // the copies stay valid until the next gather, in case the renderer keeps them
+        size_t numActive = gatherStreamParticles();
+        mRenderer->_updateRenderQueue(queue, mActiveParticles, mCullIndividual);
+        releaseStreamParticles(numActive, false);
     }
     //---------------------------------------------------------------------
     void ParticleSystem::visitRenderables(Renderable::Visitor* visitor, 
@@ -830,6 +995,12 @@ namespace Ogre {
                 PT_REAL),
                 &msNonvisibleTimeoutCmd);
 
+            dict->addParameter(ParameterDef("stream_storage",
+                "Sets whether visual particles are stored as a structure of arrays, "
+                "so supporting affectors and renderers can process them in bulk.",
+                PT_BOOL),
+                &msStreamStorageCmd);
+
         }
     }
     //-----------------------------------------------------------------------
@@ -838,7 +1009,7 @@ namespace Ogre {
         OgreProfile("_updateBounds");
         if (mParentNode && (mBoundsAutoUpdate || mBoundsUpdateTime > 0.0f))
         {
-            if (mActiveParticles.empty())
+            if (mActiveParticles.empty() && (!mStreams || mStreams->empty()))
             {
                 // No particles, reset to null if auto update bounds
                 if (mBoundsAutoUpdate)
@@ -869,6 +1040,17 @@ namespace Ogre {
                     min.makeFloor(p->mPosition - padding);
                     max.makeCeil(p->mPosition + padding);
                 }
+                if (mStreams)
+                {
+                    const ParticleStreams& s = *mStreams;
+                    for (size_t i = 0; i < s.size(); i++)
+                    {
+                        Vector3 pos(s.mPosition.x[i], s.mPosition.y[i], s.mPosition.z[i]);
+                        Vector3 padding = halfScale * std::max(s.mWidth[i], s.mHeight[i]);
+                        min.makeFloor(pos - padding);
+                        max.makeCeil(pos + padding);
+                    }
+                }
                 mWorldAABB.setExtents(min, max);
             }
 
@@ -1052,7 +1234,10 @@ namespace Ogre {
         // reset active and free lists
         mActiveParticles.clear();
         mFreeParticles.clear();
-        mFreeParticles.insert(mFreeParticles.end(), mParticlePool.begin(), mParticlePool.end());
+        if (!mStreams)
+            mFreeParticles.insert(mFreeParticles.end(), mParticlePool.begin(), mParticlePool.end());
+        else
+            mStreams->clear();
 
         // Add active emitted emitters to free list
         addActiveEmittedEmittersToFreeList();
@@ -1064,6 +1249,20 @@ namespace Ogre {
         mUpdateRemainTime = 0;
     }
     //-----------------------------------------------------------------------
+    void ParticleSystem::setStreamStorage(bool enabled)
+    {
+        if (enabled == getStreamStorage())
+            return;
+
+        clear();
+        mStreams.reset(enabled ? OGRE_NEW ParticleStreams() : NULL);
+        mStreamParticles.clear();
+        // the particle pool is only filled when not using streams
+        mFreeParticles.clear();
+        if (!enabled)
+            mFreeParticles.insert(mFreeParticles.end(), mParticlePool.begin(), mParticlePool.end());
+    }
+    //-----------------------------------------------------------------------
     void ParticleSystem::setRenderer(const String& rendererName)
     {
         if (mRenderer)
@@ -1085,7 +1284,21 @@ namespace Ogre {
         // Actual allocate particles
         size_t currSize = mParticlePool.size();
         size_t size = mPoolSize;
-        if( currSize < size )
+        if (mStreams)
+        {
+            // visual particles live in the streams, so the pool is not used
+            if (mStreams->capacity() < size)
+            {
+                mStreams->reserve(size);
+
+                // Tell the renderer, if already configured
+                if (mRenderer && mIsRendererConfigured)
+                {
+                    mRenderer->_notifyParticleQuota(size);
+                }
+            }
+        }
+        else if( currSize < size )
         {
             this->increasePool(size);
 
@@ -1102,7 +1315,7 @@ namespace Ogre {
 
         if (mRenderer && !mIsRendererConfigured)
         {
-            mRenderer->_notifyParticleQuota(mParticlePool.size());
+            mRenderer->_notifyParticleQuota(mStreams ? mPoolSize : mParticlePool.size());
             mRenderer->_notifyAttached(mParentNode, mParentIsTagPoint);
             mRenderer->_notifyDefaultDimensions(mDefaultWidth, mDefaultHeight);
             mMaterial->load();
@@ -1184,6 +1397,16 @@ namespace Ogre {
     void ParticleSystem::_sortParticles(Camera* cam)
     {
         static RadixSort<ParticlePool, Particle*, float> mRadixSorter;
+        // the stream particles are sorted through an index permutation, separately from the emitted emitters
+        static RadixSort<std::vector<uint32>, uint32, float> mStreamRadixSorter;
+        static std::vector<uint32> mStreamOrder;
+        auto sortStreams = [this](const auto& key) {
+            mStreamOrder.resize(mStreams->size());
+            for (uint32 i = 0; i < mStreamOrder.size(); i++)
+                mStreamOrder[i] = i;
+            mStreamRadixSorter.sort(mStreamOrder, key);
+            mStreams->reorder(mStreamOrder);
+        };
         if (mRenderer)
         {
             SortMode sortMode =
@@ -1198,6 +1421,14 @@ namespace Ogre {
                     camDir = mParentNode->convertWorldToLocalDirection(camDir, false);
                 }
                 mRadixSorter.sort(mActiveParticles, SortByDirectionFunctor(- camDir));
+
+                if (mStreams)
+                {
+                    const auto& pos = mStreams->mPosition;
+                    sortStreams([&pos, camDir](uint32 i) {
+                        return -camDir.dotProduct(Vector3(pos.x[i], pos.y[i], pos.z[i]));
+                    });
+                }
             }
             else if (sortMode == SM_DISTANCE)
             {
@@ -1208,6 +1439,14 @@ namespace Ogre {
                     camPos = mParentNode->convertWorldToLocalPosition(camPos);
                 }
                 mRadixSorter.sort(mActiveParticles, SortByDistanceFunctor(camPos));
+
+                if (mStreams)
+                {
+                    const auto& pos = mStreams->mPosition;
+                    sortStreams([&pos, camPos](uint32 i) {
+                        return -(camPos - Vector3(pos.x[i], pos.y[i], pos.z[i])).squaredLength();
+                    });
+                }
             }
         }
     }
@@ -1550,6 +1789,17 @@ namespace Ogre {
         static_cast<ParticleSystem*>(target)->setNonVisibleUpdateTimeout(
             StringConverter::parseReal(val));
     }
+    //-----------------------------------------------------------------------
+    String CmdStreamStorage::doGet(const void* target) const
+    {
+        return StringConverter::toString(
+            static_cast<const ParticleSystem*>(target)->getStreamStorage());
+    }
+    void CmdStreamStorage::doSet(void* target, const String& val)
+    {
+        static_cast<ParticleSystem*>(target)->setStreamStorage(
+            StringConverter::parseBool(val));
+    }
    //-----------------------------------------------------------------------
     ParticleAffector::~ParticleAffector() 
     {
@@ -48,7 +48,7 @@ namespace Ogre {
         assert( msSingleton );  return ( *msSingleton );  
     }
     //-----------------------------------------------------------------------
-    ParticleSystemManager::ParticleSystemManager()
+    ParticleSystemManager::ParticleSystemManager() : mParallelUpdate(false)
     {
         OGRE_LOCK_AUTO_MUTEX;
         mFactory = OGRE_NEW ParticleSystemFactory();
@@ -331,6 +331,45 @@ namespace Ogre {
 
     }
     //-----------------------------------------------------------------------
+    void ParticleSystemManager::_queueUpdate(ParticleSystem* system, Real timeElapsed)
+    {
+        mQueuedUpdates.push_back({system, timeElapsed});
+    }
+    //-----------------------------------------------------------------------
+    void ParticleSystemManager::_cancelUpdate(ParticleSystem* system)
+    {
+        mQueuedUpdates.erase(std::remove_if(mQueuedUpdates.begin(), mQueuedUpdates.end(),
+                                            [system](const QueuedUpdate& u) { return u.system == system; }),
+                             mQueuedUpdates.end());
+    }
+    //-----------------------------------------------------------------------
+    void ParticleSystemManager::_updateQueuedSystems(void)
+    {
+        if (mQueuedUpdates.empty())
+            return;
+
+        OgreProfile("ParticleSystemManager");
+        // skip the systems that need no update
+        size_t numUpdates = 0;
+        for (auto& u : mQueuedUpdates)
+        {
+            if (u.system->_beginUpdate(u.timeElapsed))
+                mQueuedUpdates[numUpdates++] = u;
+        }
+        mQueuedUpdates.resize(numUpdates);
+
+        const std::vector<QueuedUpdate>& updates = mQueuedUpdates;
+        WorkQueue* workQueue = Root::getSingletonPtr() ? Root::getSingleton().getWorkQueue() : NULL;
+        WorkQueue::parallelFor(workQueue, updates.size(), 1, [&updates](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++)
+                updates[i].system->_simulate(updates[i].timeElapsed);
+        });
+
+        for (auto& u : mQueuedUpdates)
+            u.system->_endUpdate(u.timeElapsed);
+        mQueuedUpdates.clear();
+    }
+    //-----------------------------------------------------------------------
     ParticleSystemManager::ParticleAffectorFactoryIterator 
     ParticleSystemManager::getAffectorFactoryIterator(void)
     {
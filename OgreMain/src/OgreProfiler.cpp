@@ -41,6 +41,8 @@ Ogre-dependent is in the visualization/logging routines and the use of the Timer
 
 #include "OgreTimer.h"
 
+#include <unordered_map>
+
 #ifdef USE_REMOTERY
 #include "Remotery.h"
 static Remotery* rmt;
@@ -62,11 +64,72 @@ namespace Ogre {
 
     //-----------------------------------------------------------------------
     // PROFILER DEFINITIONS
+    //-----------------------------------------------------------------------
+    /** The events recorded by one thread
+
+        A ring buffer, which the thread writes and the thread ending the frames reads.
+    */
+    struct Profiler::ThreadEvents
+    {
+        static const size_t CAPACITY = 8192;
+
+        std::vector<Event> ring;
+        std::atomic<size_t> head;
+        std::atomic<size_t> tail;
+        uint32 index;
+        bool isMain;
+
+        // used by the recording thread
+        /// the number of open profiles
+        uint32 depth;
+        /// the depth of the outermost profile that is dropped with its children, as the ring was full
+        uint32 dropDepth;
+        /// the generation of the profiler the depth counts for
+        uint32 generation;
+        uint64 frameStart;
+
+        // used when the events are gathered
+        struct Open
+        {
+            /// NULL if the profile is disabled
+            ProfileInstance* instance;
+            bool captured;
+        };
+        std::vector<Open> open;
+        ProfileInstance* current;
+
+        ThreadEvents(uint32 i, bool main, ProfileInstance* root)
+            : ring(CAPACITY), head(0), tail(0), index(i), isMain(main), depth(0), dropDepth(0), generation(0),
+              frameStart(0), current(root)
+        {
+        }
+    };
+
+    /// the profile names by id, shared by all profilers
+    struct ProfileNameRegistry
+    {
+        std::unordered_map<String, uint32> ids;
+        std::vector<String> names;
+        OGRE_WQ_MUTEX(mutex);
+
+        ProfileNameRegistry() : names(1) { ids[""] = 0; }
+    };
+    static ProfileNameRegistry& getNameRegistry()
+    {
+        static ProfileNameRegistry registry;
+        return registry;
+    }
+
+    static std::atomic<uint32> sProfilerSerial(0);
+
     //-----------------------------------------------------------------------
     Profiler::Profiler() 
-        : mCurrent(&mRoot)
-        , mLast(NULL)
-        , mRoot()
+        : mRoot()
+        , mGeneration(0)
+        , mSerial(++sProfilerSerial)
+        , mMainThread(std::this_thread::get_id())
+        , mDiscardFrame(false)
+        , mCapturing(false)
         , mInitialized(false)
         , mUpdateDisplayFrequency(10)
         , mCurrentFrame(0)
@@ -82,6 +145,9 @@ namespace Ogre {
         mRoot.hierarchicalLvl = 0 - 1;
 
 #ifdef USE_REMOTERY
+        // Remotery collects the samples itself, so they are always recorded
+        mEnabled = mNewEnableState = true;
+
         rmt_Settings()->reuse_open_port = true;
         if(auto error = rmt_CreateGlobalInstance(&rmt))
         {
@@ -136,6 +202,8 @@ namespace Ogre {
         // clear all our lists
         mDisabledProfiles.clear();
 #endif
+        for (auto events : mThreadEvents)
+            delete events;
     }
     //-----------------------------------------------------------------------
     void Profiler::setTimer(Timer* t)
@@ -165,23 +233,21 @@ namespace Ogre {
 
             mInitialized = false;
             mEnabled = false;
+            discardEvents();
         }
         // We store this enable/disable request until the frame ends
         // (don't want to screw up any open profiles!)
         mNewEnableState = enabled;
     }
     //-----------------------------------------------------------------------
-    bool Profiler::getEnabled() const
-    {
-        return mEnabled;
-    }
-    //-----------------------------------------------------------------------
     void Profiler::changeEnableState() 
     {
         for(auto & l : mListeners)
             l->changeEnableState(mNewEnableState);
 
-        mEnabled = mNewEnableState;
+        mEnabled = mNewEnableState.load();
+        // the profiles that are open now began before, so their ends will not match
+        mDiscardFrame = mNewEnableState;
     }
     //-----------------------------------------------------------------------
     void Profiler::disableProfile(const String& profileName)
@@ -195,87 +261,131 @@ namespace Ogre {
         mDisabledProfiles.erase(profileName);
     }
     //-----------------------------------------------------------------------
+    uint32 Profiler::getNameID(const String& profileName)
+    {
+        ProfileNameRegistry& registry = getNameRegistry();
+        OGRE_WQ_LOCK_MUTEX(registry.mutex);
+        auto it = registry.ids.emplace(profileName, uint32(registry.names.size())).first;
+        if (it->second == registry.names.size())
+            registry.names.push_back(profileName);
+        return it->second;
+    }
+    //-----------------------------------------------------------------------
+    String Profiler::getName(uint32 nameID)
+    {
+        ProfileNameRegistry& registry = getNameRegistry();
+        OGRE_WQ_LOCK_MUTEX(registry.mutex);
+        OgreAssert(nameID < registry.names.size(), "unknown profile name id");
+        return registry.names[nameID];
+    }
+    //-----------------------------------------------------------------------
+    Profiler::ThreadEvents* Profiler::getThreadEvents()
+    {
+        // the serial tells whether the events are of this profiler, or of one that was destroyed
+        static thread_local uint32 serial = 0;
+        static thread_local ThreadEvents* events = NULL;
+        if (serial != mSerial)
+        {
+            OGRE_WQ_LOCK_MUTEX(mThreadEventsMutex);
+            events = new ThreadEvents(uint32(mThreadEvents.size()), std::this_thread::get_id() == mMainThread,
+                                      &mRoot);
+            events->generation = mGeneration.load(std::memory_order_relaxed);
+            mThreadEvents.push_back(events);
+            serial = mSerial;
+        }
+        return events;
+    }
+    //-----------------------------------------------------------------------
     void Profiler::beginProfile(const String& profileName, uint32 groupID) 
+    {
+        if (!mEnabled.load(std::memory_order_relaxed))
+            return;
+
+        // empty string is reserved for the root
+        // not really fatal anymore, however one shouldn't name one's profile as an empty string anyway.
+        assert ((profileName != "") && ("Profile name can't be an empty string"));
+
+        beginProfile(getNameID(profileName), groupID);
+    }
+    //-----------------------------------------------------------------------
+    void Profiler::beginProfile(uint32 nameID, uint32 groupID)
     {
 #ifdef USE_REMOTERY
         // mask groups
         if ((groupID & mProfileMask) == 0)
             return;
 
-        rmt_BeginCPUSampleDynamic(profileName.c_str(), RMTSF_Aggregate);
+        rmt_BeginCPUSampleDynamic(getName(nameID).c_str(), RMTSF_Aggregate);
 #else
         // if the profiler is enabled
-        if (!mEnabled)
+        if (!mEnabled.load(std::memory_order_relaxed))
             return;
 
         // mask groups
-        if ((groupID & mProfileMask) == 0)
-            return;
-
-        // empty string is reserved for the root
-        // not really fatal anymore, however one shouldn't name one's profile as an empty string anyway.
-        assert ((profileName != "") && ("Profile name can't be an empty string"));
-
-        // we only process this profile if isn't disabled
-        if (mDisabledProfiles.find(profileName) != mDisabledProfiles.end())
+        if ((groupID & mProfileMask.load(std::memory_order_relaxed)) == 0)
             return;
 
-        // regardless of whether or not we are enabled, we need the application's root profile (ie the first profile started each frame)
-        // we need this so bogus profiles don't show up when users enable profiling mid frame
-        // so we check
-
-        // this would be an internal error.
-        assert (mCurrent);
+        assert (nameID && "Profile name can't be an empty string");
 
         // need a timer to profile!
         assert (mTimer && "Timer not set!");
 
-        ProfileInstance*& instance = mCurrent->children[profileName];
-        if(instance)
-        {   // found existing child.
+        ThreadEvents* events = getThreadEvents();
+        uint32 generation = mGeneration.load(std::memory_order_relaxed);
+        if (events->generation != generation)
+        {   // the profiler dropped the open profiles
+            events->depth = events->dropDepth = 0;
+            events->generation = generation;
+        }
 
-            // Sanity check.
-            assert(instance->name == profileName);
+        ++events->depth;
+        if (events->dropDepth)
+            return;
 
-            if(instance->frameNumber != mCurrentFrame)
-            {   // new frame, reset stats
-                instance->frame.calls = 0;
-                instance->frame.frameTime = 0;
-                instance->frameNumber = mCurrentFrame;
-            }
-        }
-        else
-        {   // new child!
-            instance = OGRE_NEW ProfileInstance();
-            instance->name = profileName;
-            instance->parent = mCurrent;
-            instance->hierarchicalLvl = mCurrent->hierarchicalLvl + 1;
+        // keep room for the ends of the open profiles, so that only whole profiles are dropped
+        size_t head = events->head.load(std::memory_order_relaxed);
+        size_t used = head - events->tail.load(std::memory_order_acquire);
+        if (ThreadEvents::CAPACITY - used <= events->depth)
+        {
+            events->dropDepth = events->depth;
+            return;
         }
 
-        instance->frameNumber = mCurrentFrame;
-
-        mCurrent = instance;
+        Event& e = events->ring[head % ThreadEvents::CAPACITY];
+        e.nameID = nameID;
+        e.groupID = groupID;
+        e.thread = events->index;
+        e.begin = true;
 
         // we do this at the very end of the function to get the most
         // accurate timing results
-        mCurrent->currTime = mTimer->getMicroseconds();
+        e.time = mTimer->getMicroseconds();
+        if (events->depth == 1)
+            events->frameStart = e.time;
+        events->head.store(head + 1, std::memory_order_release);
 #endif
     }
     //-----------------------------------------------------------------------
     void Profiler::endProfile(const String& profileName, uint32 groupID) 
+    {
+        // the name is not needed while disabled, only the handling of the enabled state
+        endProfile(mEnabled.load(std::memory_order_relaxed) ? getNameID(profileName) : 0, groupID);
+    }
+    //-----------------------------------------------------------------------
+    void Profiler::endProfile(uint32 nameID, uint32 groupID)
     {
 #ifdef USE_REMOTERY
         // mask groups
-        if ((groupID & mProfileMask) == 0)
+        if (!nameID || (groupID & mProfileMask) == 0)
             return;
 
         rmt_EndCPUSample();
 #else
-        if(!mEnabled) 
+        if (!mEnabled.load(std::memory_order_relaxed))
         {
-            // if the profiler received a request to be enabled or disabled
-            if(mNewEnableState != mEnabled) 
-            {   // note mNewEnableState == true to reach this.
+            // if the profiler received a request to be enabled, which the thread ending the frames handles
+            if (std::this_thread::get_id() == mMainThread && mNewEnableState)
+            {
                 changeEnableState();
 
                 // NOTE we will be in an 'error' state until the next begin. ie endProfile will likely get invoked using a profileName that was never started.
@@ -284,40 +394,59 @@ namespace Ogre {
 
             return;
         }
-        else
+
+        // a profile that was not begun, as the profiler was disabled then
+        if (!nameID)
+            return;
+
+        ThreadEvents* events = getThreadEvents();
+        if (events->isMain && !mNewEnableState)
         {
-            if(mNewEnableState != mEnabled) 
-            {   // note mNewEnableState == false to reach this.
-                changeEnableState();
+            changeEnableState();
 
-                // unwind the hierarchy, should be easy enough
-                mCurrent = &mRoot;
-                mLast = NULL;
-            }
+            // unwind the hierarchy, should be easy enough
+            discardEvents();
+            return;
+        }
+
+        // mask groups
+        if ((groupID & mProfileMask.load(std::memory_order_relaxed)) == 0)
+            return;
 
-            if(&mRoot == mCurrent && mLast)
+        uint32 generation = mGeneration.load(std::memory_order_relaxed);
+        if (events->generation != generation)
+        {   // the profiler dropped the open profiles
+            events->depth = events->dropDepth = 0;
+            events->generation = generation;
+        }
+
+        if (!events->depth)
+        {
+            if (events->isMain && mDiscardFrame)
             {   // profiler was enabled this frame, but the first subsequent beginProfile was NOT the beinging of a new frame as we had hoped.
                 // we have bogus ProfileInstance in our hierarchy, we will need to remove it, then update the overlays so as not to confuse ze user
-
+                discardEvents();
                 for(auto& e : mRoot.children)
                 {
                     OGRE_DELETE e.second;
                 }
                 mRoot.children.clear();
 
-                mLast = NULL;
+                mDiscardFrame = false;
 
                 processFrameStats();
                 displayResults();
             }
-        }
-
-        if(&mRoot == mCurrent)
             return;
+        }
 
-        // mask groups
-        if ((groupID & mProfileMask) == 0)
+        if (events->dropDepth)
+        {
+            if (events->dropDepth == events->depth)
+                events->dropDepth = 0;
+            --events->depth;
             return;
+        }
 
         // need a timer to profile!
         assert (mTimer && "Timer not set!");
@@ -325,38 +454,27 @@ namespace Ogre {
         // get the end time of this profile
         // we do this as close the beginning of this function as possible
         // to get more accurate timing results
-        const ulong endTime = mTimer->getMicroseconds();
-
-        // empty string is reserved for designating an empty parent
-        assert ((profileName != "") && ("Profile name can't be an empty string"));
-
-        // we only process this profile if isn't disabled
-        // we check the current instance name against the provided profileName as a guard against disabling a profile name /after/ said profile began
-        if(mCurrent->name != profileName && mDisabledProfiles.find(profileName) != mDisabledProfiles.end()) 
-            return;
-
-        // calculate the elapsed time of this profile
-        const ulong timeElapsed = endTime - mCurrent->currTime;
-
-        // update parent's accumulator if it isn't the root
-        if (&mRoot != mCurrent->parent) 
-        {
-            // add this profile's time to the parent's accumlator
-            mCurrent->parent->accum += timeElapsed;
-        }
+        const uint64 endTime = mTimer->getMicroseconds();
 
-        mCurrent->frame.frameTime += timeElapsed;
-        ++mCurrent->frame.calls;
+        // beginProfile left room for this
+        size_t head = events->head.load(std::memory_order_relaxed);
+        assert(head - events->tail.load(std::memory_order_acquire) < ThreadEvents::CAPACITY);
 
-        mLast = mCurrent;
-        mCurrent = mCurrent->parent;
+        Event& e = events->ring[head % ThreadEvents::CAPACITY];
+        e.time = endTime;
+        e.nameID = nameID;
+        e.groupID = groupID;
+        e.thread = events->index;
+        e.begin = false;
+        events->head.store(head + 1, std::memory_order_release);
 
-        if (&mRoot == mCurrent) 
+        if (--events->depth == 0 && events->isMain)
         {
             // the stack is empty and all the profiles have been completed
             // we have reached the end of the frame so process the frame statistics
 
             // we know that the time elapsed of the main loop is the total time the frame took
+            const ulong timeElapsed = ulong(endTime - events->frameStart);
             mTotalFrameTime = timeElapsed;
 
             if(timeElapsed > mMaxTotalFrameTime)
@@ -364,6 +482,7 @@ namespace Ogre {
 
             // we got all the information we need, so process the profiles
             // for this frame
+            processEvents();
             processFrameStats();
 
             // we display everything to the screen
@@ -372,6 +491,107 @@ namespace Ogre {
 #endif
     }
     //-----------------------------------------------------------------------
+    void Profiler::processEvents()
+    {
+        std::vector<ThreadEvents*> threads;
+        {
+            OGRE_WQ_LOCK_MUTEX(mThreadEventsMutex);
+            threads = mThreadEvents;
+        }
+
+        ProfileNameRegistry& registry = getNameRegistry();
+        OGRE_WQ_LOCK_MUTEX(registry.mutex);
+        for (auto events : threads)
+        {
+            size_t tail = events->tail.load(std::memory_order_relaxed);
+            size_t head = events->head.load(std::memory_order_acquire);
+            for (; tail != head; ++tail)
+            {
+                const Event& e = events->ring[tail % ThreadEvents::CAPACITY];
+                if (!e.begin)
+                {
+                    // the begin was dropped by discardEvents
+                    if (events->open.empty())
+                        continue;
+
+                    ThreadEvents::Open open = events->open.back();
+                    events->open.pop_back();
+                    if (open.captured)
+                        mCapture.push_back(e);
+
+                    ProfileInstance* instance = open.instance;
+                    if (!instance)
+                        continue;
+
+                    // calculate the elapsed time of this profile
+                    const ulong timeElapsed = ulong(e.time - instance->currTime);
+
+                    // update parent's accumulator if it isn't the root
+                    if (&mRoot != instance->parent)
+                    {
+                        // add this profile's time to the parent's accumlator
+                        instance->parent->accum += timeElapsed;
+                    }
+
+                    instance->frame.frameTime += timeElapsed;
+                    ++instance->frame.calls;
+
+                    events->current = instance->parent;
+                    continue;
+                }
+
+                if (mCapturing)
+                    mCapture.push_back(e);
+
+                // we only process this profile if isn't disabled
+                const String& profileName = registry.names[e.nameID];
+                if (mDisabledProfiles.find(profileName) != mDisabledProfiles.end())
+                {
+                    events->open.push_back({NULL, mCapturing});
+                    continue;
+                }
+
+                ProfileInstance*& instance = events->current->children[profileName];
+                if(instance)
+                {   // found existing child.
+                    if(instance->frameNumber != mCurrentFrame)
+                    {   // new frame, reset stats
+                        instance->frame.calls = 0;
+                        instance->frame.frameTime = 0;
+                    }
+                }
+                else
+                {   // new child!
+                    instance = OGRE_NEW ProfileInstance();
+                    instance->name = profileName;
+                    instance->parent = events->current;
+                    instance->hierarchicalLvl = events->current->hierarchicalLvl + 1;
+                }
+
+                instance->frameNumber = mCurrentFrame;
+                instance->currTime = ulong(e.time);
+
+                events->open.push_back({instance, mCapturing});
+                events->current = instance;
+            }
+            events->tail.store(tail, std::memory_order_release);
+        }
+    }
+    //-----------------------------------------------------------------------
+    void Profiler::discardEvents()
+    {
+        // the threads reset the depth of their open profiles once they see this
+        mGeneration.fetch_add(1, std::memory_order_relaxed);
+
+        OGRE_WQ_LOCK_MUTEX(mThreadEventsMutex);
+        for (auto events : mThreadEvents)
+        {
+            events->tail.store(events->head.load(std::memory_order_acquire), std::memory_order_release);
+            events->open.clear();
+            events->current = &mRoot;
+        }
+    }
+    //-----------------------------------------------------------------------
     void Profiler::processFrameStats(ProfileInstance* instance, Real& maxFrameTime)
     {
         // calculate what percentage of frame time this profile took
@@ -594,4 +814,74 @@ namespace Ogre {
             mListeners.erase(i);
     }
     //-----------------------------------------------------------------------
+    //-----------------------------------------------------------------------
+    void Profiler::startCapture()
+    {
+        // the events recorded so far are not part of the capture
+        processEvents();
+        mCapture.clear();
+        mCapturing = true;
+    }
+    //-----------------------------------------------------------------------
+    void Profiler::stopCapture()
+    {
+        OgreAssert(std::this_thread::get_id() == mMainThread, "must be called by the thread that created the Profiler");
+        processEvents();
+        mCapturing = false;
+    }
+    //-----------------------------------------------------------------------
+    static void writeJsonString(std::ostream& stream, const String& str)
+    {
+        stream << '"';
+        for (char c : str)
+        {
+            if (c == '"' || c == '\\')
+                stream << '\\' << c;
+            else if (uint8(c) < 0x20)
+                stream << StringUtil::format("\\u%04x", int(c));
+            else
+                stream << c;
+        }
+        stream << '"';
+    }
+
+    static const char* getGroupName(uint32 groupID)
+    {
+        if (groupID & OGREPROF_GENERAL)
+            return "General";
+        if (groupID & OGREPROF_CULLING)
+            return "Culling";
+        if (groupID & OGREPROF_RENDERING)
+            return "Rendering";
+        return "User";
+    }
+    //-----------------------------------------------------------------------
+    void Profiler::exportChromeTrace(std::ostream& stream) const
+    {
+        stream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+        const char* separator = "\n";
+        {
+            OGRE_WQ_LOCK_MUTEX(mThreadEventsMutex);
+            for (auto events : mThreadEvents)
+            {
+                stream << separator << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << events->index
+                       << ",\"args\":{\"name\":";
+                writeJsonString(stream, events->isMain ? "Main" : "Thread " + std::to_string(events->index));
+                stream << "}}";
+                separator = ",\n";
+            }
+        }
+
+        ProfileNameRegistry& registry = getNameRegistry();
+        OGRE_WQ_LOCK_MUTEX(registry.mutex);
+        for (const Event& e : mCapture)
+        {
+            stream << separator << "{\"name\":";
+            writeJsonString(stream, registry.names[e.nameID]);
+            stream << ",\"cat\":\"" << getGroupName(e.groupID) << "\",\"ph\":\"" << (e.begin ? 'B' : 'E')
+                   << "\",\"pid\":0,\"tid\":" << e.thread << ",\"ts\":" << e.time << "}";
+            separator = ",\n";
+        }
+        stream << "\n]}\n";
+    }
 }
@@ -33,6 +33,7 @@ THE SOFTWARE.
 #include "OgreMaterial.h"
 #include "OgreRenderQueueSortingGrouping.h"
 #include "OgreSceneManagerEnumerator.h"
+#include "OgreFrameCounters.h"
 
 namespace Ogre {
 
@@ -41,6 +42,7 @@ namespace Ogre {
         : mSplitPassesByLightingType(false)
         , mSplitNoShadowPasses(false)
         , mShadowCastersCannotBeReceivers(false)
+        , mSortSolidsFrontToBack(false)
         , mRenderableListener(0)
     {
         // Create the 'main' queue up-front since we'll always need that
@@ -116,6 +118,7 @@ namespace Ogre {
         // Find group
         RenderQueueGroup* pGroup = getQueueGroup(groupID);
         pGroup->addRenderable(pRend, pTech, priority);
+        FrameCounters::add(FrameCounters::RENDERABLES_QUEUED);
 
     }
     //-----------------------------------------------------------------------
@@ -183,6 +186,8 @@ namespace Ogre {
             // Insert new
             mGroups[groupID] = std::make_unique<RenderQueueGroup>(mSplitPassesByLightingType, mSplitNoShadowPasses,
                                                         mShadowCastersCannotBeReceivers);
+            if (mSortSolidsFrontToBack)
+                defaultOrganisationMode(groupID);
         }
 
         return mGroups[groupID].get();
@@ -237,6 +242,35 @@ namespace Ogre {
         return mShadowCastersCannotBeReceivers;
     }
     //-----------------------------------------------------------------------
+    void RenderQueue::setSortSolidsFrontToBack(bool sort)
+    {
+        mSortSolidsFrontToBack = sort;
+        defaultOrganisationMode();
+    }
+    //-----------------------------------------------------------------------
+    void RenderQueue::defaultOrganisationMode(void)
+    {
+        for (uint8 qid = 0; qid < RENDER_QUEUE_COUNT; ++qid)
+        {
+            if (mGroups[qid])
+                defaultOrganisationMode(qid);
+        }
+    }
+    //-----------------------------------------------------------------------
+    void RenderQueue::defaultOrganisationMode(uint8 qid)
+    {
+        RenderQueueGroup* group = mGroups[qid].get();
+        if (mSortSolidsFrontToBack && qid > RENDER_QUEUE_SKIES_EARLY && qid < RENDER_QUEUE_SKIES_LATE)
+        {
+            group->resetOrganisationModes();
+            group->addOrganisationMode(QueuedRenderableCollection::OM_SORT_ASCENDING);
+        }
+        else
+        {
+            group->defaultOrganisationMode();
+        }
+    }
+    //-----------------------------------------------------------------------
     void RenderQueue::merge( const RenderQueue* rhs )
     {
         for (size_t i = 0; i < RENDER_QUEUE_COUNT; ++i)
@@ -259,17 +293,24 @@ namespace Ogre {
         bool receiveShadows = getQueueGroup(mo->getRenderQueueGroup())->getShadowsEnabled() && mo->getReceivesShadows();
 
         if(onlyShadowCasters && !mo->getCastShadows() && !receiveShadows)
+        {
+            FrameCounters::add(FrameCounters::OBJECTS_CULLED);
             return;
+        }
 
         mo->_notifyCurrentCamera(cam);
         if (!mo->isVisible())
+        {
+            FrameCounters::add(FrameCounters::OBJECTS_CULLED);
             return;
+        }
 
         const auto& bbox = mo->getWorldBoundingBox(true);
         const auto& bsphere = mo->getWorldBoundingSphere(true);
 
         if (!onlyShadowCasters || mo->getCastShadows())
         {
+            FrameCounters::add(FrameCounters::OBJECTS_VISIBLE);
             mo->_updateRenderQueue(this);
             if (visibleBounds)
             {
@@ -279,6 +320,7 @@ namespace Ogre {
         // not shadow caster, receiver only?
         else if (receiveShadows)
         {
+            FrameCounters::add(FrameCounters::OBJECTS_CULLED);
             visibleBounds->mergeNonRenderedButInFrustum(bbox, bsphere, cam);
         }
     }
@@ -34,6 +34,7 @@ THE SOFTWARE.
 
 #include "OgreHardwareOcclusionQuery.h"
 #include "OgreComponents.h"
+#include "OgreFrameCounters.h"
 
 #ifdef OGRE_BUILD_COMPONENT_RTSHADERSYSTEM
 #include "OgreRTShaderConfig.h"
@@ -725,6 +726,7 @@ namespace Ogre {
                 continue;
             mActiveParameters[i]->incPassIterationNumber();
             bindGpuProgramParameters(GpuProgramType(i), mActiveParameters[i], mask);
+            FrameCounters::add(FrameCounters::GPU_PARAMETER_UPLOADS);
         }
 
         return true;
@@ -27,6 +27,7 @@ THE SOFTWARE.
 */
 // Ogre includes
 #include "OgreStableHeaders.h"
+#include "OgreFrameCounters.h"
 
 namespace Ogre 
 {
@@ -278,6 +279,7 @@ namespace Ogre
 
         mLoadingState.store(LOADSTATE_LOADED);
         _dirtyState();
+        FrameCounters::add(FrameCounters::RESOURCES_LOADED);
 
         // Notify manager
         if(mCreator)
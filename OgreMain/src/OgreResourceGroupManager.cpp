@@ -55,7 +55,7 @@ namespace Ogre {
     //-----------------------------------------------------------------------
     //-----------------------------------------------------------------------
     ResourceGroupManager::ResourceGroupManager()
-        : mLoadingListener(0), mCurrentGroup(0)
+        : mLoadingListener(0), mIndexGeneration(0), mGlobalIndexGeneration(0), mCurrentGroup(0)
     {
         // Create the 'General' group
         createResourceGroup(DEFAULT_RESOURCE_GROUP_NAME, true); // the "General" group is synonymous to global pool
@@ -96,6 +96,7 @@ namespace Ogre {
 
         OGRE_LOCK_AUTO_MUTEX;
         mResourceGroupMap.emplace(name, grp);
+        mIndexGeneration++;
     }
     //-----------------------------------------------------------------------
     void ResourceGroupManager::initialiseResourceGroup(const String& name)
@@ -369,6 +370,7 @@ namespace Ogre {
         dropGroupContents(grp);
         deleteGroup(grp);
         mResourceGroupMap.erase(mResourceGroupMap.find(name));
+        mIndexGeneration++;
         // reset current group
         mCurrentGroup = 0;
     }
@@ -432,7 +434,8 @@ namespace Ogre {
         // Index resources
         for (auto& s : *vec)
             grp->addToIndex(s, pArch);
-        
+        mIndexGeneration++;
+
         StringStream msg;
         msg << "Added resource location '" << name << "' of type '" << locType
             << "' to resource group '" << resGroup << "'";
@@ -457,6 +460,7 @@ namespace Ogre {
             {
                 grp->removeFromIndex(pArch);
                 grp->locationList.erase(li);
+                mIndexGeneration++;
                 ArchiveManager::getSingleton().unload(pArch);
                 break;
             }
@@ -613,6 +617,7 @@ namespace Ogre {
                 // create it
                 DataStreamPtr ret = arch->create(filename);
                 grp->addToIndex(filename, arch);
+                mIndexGeneration++;
 
                 return ret;
             }
@@ -642,6 +647,7 @@ namespace Ogre {
                 {
                     arch->remove(filename);
                     grp->removeFromIndex(filename, arch);
+                    mIndexGeneration++;
 
                     // only remove one file
                     break;
@@ -669,6 +675,7 @@ namespace Ogre {
                     arch->remove(f);
                     grp->removeFromIndex(f, arch);
                 }
+                mIndexGeneration++;
             }
         }
 
@@ -1381,17 +1388,67 @@ namespace Ogre {
         OgreAssert(!filename.empty(), "resourceName is empty string");
             OGRE_LOCK_AUTO_MUTEX;
 
-            // Iterate over resource groups and find
+        // Try the index of all groups first
+        updateGlobalIndex();
+        const GlobalResourceLocation* found = NULL;
+        auto it = mGlobalIndexCaseSensitive.find(filename);
+        if (it != mGlobalIndexCaseSensitive.end())
+            found = &it->second;
+
+#if !OGRE_RESOURCEMANAGER_STRICT
+        // try case insensitive, each group tries it after its case sensitive match but before later groups
+        String lcResourceName = filename;
+        StringUtil::toLowerCase(lcResourceName);
+        it = mGlobalIndexCaseInsensitive.find(lcResourceName);
+        if (it != mGlobalIndexCaseInsensitive.end() && (!found || it->second.groupOrder < found->groupOrder))
+            found = &it->second;
+#endif
+        if (found)
+            return std::make_pair(found->archive, found->group);
+
+#if !OGRE_RESOURCEMANAGER_STRICT
+        // Search the hard way
         for (const auto & i : mResourceGroupMap)
         {
-            Archive* arch = resourceExists(i.second, filename);
-            if (arch)
-                return std::make_pair(arch, i.second);
+            OGRE_LOCK_MUTEX(i.second->OGRE_AUTO_MUTEX_NAME); // lock group mutex
+            for (auto& li : i.second->locationList)
+            {
+                if (li.archive->exists(filename))
+                    return std::make_pair(li.archive, i.second);
+            }
         }
+#endif
         // Not found
         return std::pair<Archive*, ResourceGroup*>();
     }
     //-----------------------------------------------------------------------
+    void ResourceGroupManager::updateGlobalIndex() const
+    {
+        // read the generation first, so changes made while building trigger another rebuild
+        uint32 generation = mIndexGeneration;
+        if (generation == mGlobalIndexGeneration)
+            return;
+
+        mGlobalIndexCaseSensitive.clear();
+#if !OGRE_RESOURCEMANAGER_STRICT
+        mGlobalIndexCaseInsensitive.clear();
+#endif
+        size_t groupOrder = 0;
+        for (const auto & i : mResourceGroupMap)
+        {
+            OGRE_LOCK_MUTEX(i.second->OGRE_AUTO_MUTEX_NAME); // lock group mutex
+            // emplace keeps the entry of the first group
+            for (const auto & r : i.second->resourceIndexCaseSensitive)
+                mGlobalIndexCaseSensitive.emplace(r.first, GlobalResourceLocation{r.second, i.second, groupOrder});
+#if !OGRE_RESOURCEMANAGER_STRICT
+            for (const auto & r : i.second->resourceIndexCaseInsensitive)
+                mGlobalIndexCaseInsensitive.emplace(r.first, GlobalResourceLocation{r.second, i.second, groupOrder});
+#endif
+            groupOrder++;
+        }
+        mGlobalIndexGeneration = generation;
+    }
+    //-----------------------------------------------------------------------
     bool ResourceGroupManager::resourceExistsInAnyGroup(const String& filename) const
     {
         return resourceExistsInAnyGroupImpl(filename).first != 0;
@@ -47,6 +47,7 @@ THE SOFTWARE.
 #include "OgreConvexBody.h"
 #include "OgreTimer.h"
 #include "OgreFrameListener.h"
+#include "OgreFrameCounters.h"
 #include "OgreLodStrategyManager.h"
 #include "OgreFileSystemLayer.h"
 #include "OgreStaticGeometry.h"
@@ -622,6 +623,9 @@ namespace Ogre {
     bool Root::_fireFrameStarted(FrameEvent& evt)
     {
         OgreProfileBeginGroup("Frame", OGREPROF_GENERAL);
+        FrameCounters::_frameStarted();
+        // updates queued since the last SceneManager::_renderScene must not pile up or run late
+        mParticleManager->_updateQueuedSystems();
         _syncAddedRemovedFrameListeners();
 
         // Tell all listeners
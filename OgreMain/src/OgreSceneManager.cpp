@@ -43,6 +43,9 @@ THE SOFTWARE.
 #include "OgreRenderTexture.h"
 #include "OgreLodListener.h"
 #include "OgreDefaultDebugDrawer.h"
+#include "OgreSoftwareVertexBlend.h"
+#include "OgreFrameCounters.h"
+#include "OgreTransformStore.h"
 
 // This class implements the most basic scene manager
 
@@ -78,6 +81,13 @@ mShadowRenderer(this),
 mLightClippingInfoMapFrameNumber(999),
 mVisibilityMask(0xFFFFFFFF),
 mFindVisibleObjects(true),
+mParallelUpdateDepth(0),
+mParallelCullingDepth(0),
+mTransformStoreDirty(true),
+mTransformStoreUpdated(false),
+mParallelSoftwareAnimation(false),
+mCollectSoftwareVertexBlends(false),
+mParallelSkeletonAnimation(false),
 mCameraRelativeRendering(false),
 mLastLightHash(0),
 mGpuParamsDirty((uint16)GPV_ALL)
@@ -637,6 +647,8 @@ SceneNode* SceneManager::getSceneNode(const String& name, bool throwExceptionIfN
 //-----------------------------------------------------------------------
 const Pass* SceneManager::_setPass(const Pass* pass, bool shadowDerivation)
 {
+    FrameCounters::add(FrameCounters::PASS_CHANGES);
+
     //If using late material resolving, swap now.
     if (isLateMaterialResolving()) 
     {
@@ -890,13 +902,7 @@ void SceneManager::prepareRenderQueue(void)
 
     // Default all the queue groups that are there, new ones will be created
     // with defaults too
-    for (size_t i = 0; i < RENDER_QUEUE_COUNT; ++i)
-    {
-        if(!q->_getQueueGroups()[i])
-            continue;
-
-        q->_getQueueGroups()[i]->defaultOrganisationMode();
-    }
+    q->defaultOrganisationMode();
 
     // Global split options
     mShadowRenderer.updateSplitOptions(q);
@@ -943,6 +949,9 @@ void SceneManager::_renderScene(Camera* camera, Viewport* vp, bool includeOverla
 
     // Update controllers 
     ControllerManager::getSingleton().updateAllControllers();
+    // Update the particle systems queued by their controllers, see ParticleSystemManager::setParallelUpdate
+    if (auto particleSystemManager = ParticleSystemManager::getSingletonPtr())
+        particleSystemManager->_updateQueuedSystems();
 
     // Update the scene, only do this once per frame
     unsigned long thisFrameNumber = Root::getSingleton().getNextFrameNumber();
@@ -950,6 +959,8 @@ void SceneManager::_renderScene(Camera* camera, Viewport* vp, bool includeOverla
     {
         // Update animations
         _applySceneAnimations();
+        if (mParallelSkeletonAnimation)
+            evaluateSkeletons();
         updateDirtyInstanceManagers();
         mLastFrameNumber = thisFrameNumber;
     }
@@ -1046,7 +1057,7 @@ void SceneManager::_renderScene(Camera* camera, Viewport* vp, bool includeOverla
 
             // Parse the scene and tag visibles
             firePreFindVisibleObjects(vp);
-            _findVisibleObjects(camera, &(camVisObjIt->second),
+            _findVisibleObjectsAndBlend(camera, &(camVisObjIt->second),
                 mIlluminationStage == IRS_RENDER_TO_TEXTURE? true : false);
             firePostFindVisibleObjects(vp);
 
@@ -1247,22 +1258,247 @@ void SceneManager::_updateSceneGraph(Camera* cam)
     // Process queued needUpdate calls 
     Node::processQueuedUpdates();
 
+    if (mTransformStore)
+    {
+        if (mTransformStoreDirty)
+            rebuildTransformStore();
+        mTransformStore->update();
+        mTransformStoreUpdated = true;
+    }
+
     // Cascade down the graph updating transforms & world bounds
     // In this implementation, just update from the root
     // Smarter SceneManager subclasses may choose to update only
     //   certain scene graph branches
-    getRootSceneNode()->_update(true, false);
+    if (!mParallelUpdateDepth)
+    {
+        getRootSceneNode()->_update(true, false);
+    }
+    else
+    {
+        mUpdatedTopLevelNodes.clear();
+        mUpdateSubtrees.clear();
+        getRootSceneNode()->_updateTopLevels(mParallelUpdateDepth, false, mUpdatedTopLevelNodes, mUpdateSubtrees);
+
+        if (mDirtyBatchesOfSubtrees.size() < mUpdateSubtrees.size())
+        {
+            mDirtyBatchesOfSubtrees.resize(mUpdateSubtrees.size());
+            mListenerCallsOfSubtrees.resize(mUpdateSubtrees.size());
+        }
+
+        // subtrees are independent of each other, except for the instance batches, which may be shared,
+        // and the listeners, which need not be thread safe
+        WorkQueue* workQueue = Root::getSingletonPtr() ? Root::getSingleton().getWorkQueue() : NULL;
+        WorkQueue::parallelFor(workQueue, mUpdateSubtrees.size(), 1, [this](size_t begin, size_t end) {
+            // counted once per chunk, instead of contending for the counter per node
+            uint64 nodesUpdated = 0;
+            SceneNode::_setDeferredUpdateCount(&nodesUpdated);
+            for (size_t i = begin; i < end; i++)
+            {
+                mDirtyBatchesOfSubtrees[i].clear();
+                mListenerCallsOfSubtrees[i].clear();
+                InstanceBatch::_setDeferredBoundsDirty(&mDirtyBatchesOfSubtrees[i]);
+                Node::_setDeferredListenerCalls(&mListenerCallsOfSubtrees[i]);
+                mUpdateSubtrees[i].first->_update(true, mUpdateSubtrees[i].second);
+                InstanceBatch::_setDeferredBoundsDirty(NULL);
+                Node::_setDeferredListenerCalls(NULL);
+            }
+            SceneNode::_setDeferredUpdateCount(NULL);
+            FrameCounters::add(FrameCounters::NODES_UPDATED, nodesUpdated);
+        });
+
+        // registers the batches and their managers and calls the listeners on this thread only
+        for (size_t i = 0; i < mUpdateSubtrees.size(); i++)
+        {
+            for (auto batch : mDirtyBatchesOfSubtrees[i])
+                batch->_boundsDirty();
+            for (const auto& call : mListenerCallsOfSubtrees[i])
+                call();
+        }
+
+        // children before their parents
+        for (auto it = mUpdatedTopLevelNodes.rbegin(); it != mUpdatedTopLevelNodes.rend(); ++it)
+            (*it)->_updateBounds();
+    }
+    mTransformStoreUpdated = false;
 
     firePostUpdateSceneGraph(cam);
 }
 //-----------------------------------------------------------------------
+void SceneManager::setUseTransformStore(bool enabled)
+{
+#if OGRE_NODE_INHERIT_TRANSFORM
+    if (enabled)
+    {
+        LogManager::getSingleton().logWarning("TransformStore does not support OGRE_NODE_INHERIT_TRANSFORM");
+        enabled = false;
+    }
+#endif
+    if (enabled == getUseTransformStore())
+        return;
+
+    mTransformStoreDirty = true;
+    if (enabled)
+    {
+        mTransformStore.reset(new TransformStore());
+        return;
+    }
+
+    mTransformStore.reset();
+    getRootSceneNode()->mTransformStoreIndex = TransformStore::NO_PARENT;
+    for (auto n : mSceneNodes)
+        n->mTransformStoreIndex = TransformStore::NO_PARENT;
+}
+//-----------------------------------------------------------------------
+void SceneManager::rebuildTransformStore()
+{
+    mTransformStore->clear();
+    mTransformStore->reserve(mSceneNodes.size() + 1);
+    for (auto n : mSceneNodes)
+        n->mTransformStoreIndex = TransformStore::NO_PARENT;
+
+    // breadth first, so siblings are adjacent and the store can mostly update them four at a time
+    std::vector<SceneNode*> nodes(1, getRootSceneNode());
+    nodes.reserve(mSceneNodes.size() + 1);
+    for (size_t i = 0; i < nodes.size(); i++)
+    {
+        SceneNode* n = nodes[i];
+        uint32 parent = i ? static_cast<SceneNode*>(n->getParent())->mTransformStoreIndex : TransformStore::NO_PARENT;
+        n->mTransformStoreIndex = mTransformStore->add(parent, n->getPosition(), n->getOrientation(), n->getScale(),
+                                                       n->getInheritOrientation(), n->getInheritScale());
+        for (auto child : n->getChildren())
+            nodes.push_back(static_cast<SceneNode*>(child));
+    }
+    mTransformStoreDirty = false;
+}
+//-----------------------------------------------------------------------
+void SceneManager::_notifyLocalTransformChanged(const SceneNode* node)
+{
+    // nodes visited later in this update must not use the stale derived transforms
+    mTransformStoreUpdated = false;
+
+    // entries of nodes detached since the last rebuild are harmless, they are reassigned anyway
+    uint32 i = node->mTransformStoreIndex;
+    mTransformStore->setPosition(i, node->getPosition());
+    mTransformStore->setOrientation(i, node->getOrientation());
+    mTransformStore->setScale(i, node->getScale());
+    mTransformStore->setInheritance(i, node->getInheritOrientation(), node->getInheritScale());
+}
+//-----------------------------------------------------------------------
+void SceneManager::_notifySceneGraphChanged(void)
+{
+    mTransformStoreUpdated = false;
+    mTransformStoreDirty = true;
+}
+//-----------------------------------------------------------------------
+void SceneManager::setParallelUpdateDepth(uint16 depth)
+{
+    if (depth && !supportsParallelUpdate())
+    {
+        LogManager::getSingleton().logWarning("SceneManager '" + mName +
+                                              "' does not support the parallel scene graph update");
+        depth = 0;
+    }
+    mParallelUpdateDepth = depth;
+}
+//-----------------------------------------------------------------------
+void SceneManager::setParallelCullingDepth(uint16 depth)
+{
+    if (depth && !supportsParallelUpdate())
+    {
+        LogManager::getSingleton().logWarning("SceneManager '" + mName +
+                                              "' does not support the parallel culling");
+        depth = 0;
+    }
+    mParallelCullingDepth = depth;
+}
+//-----------------------------------------------------------------------
 void SceneManager::_findVisibleObjects(
     Camera* cam, VisibleObjectsBoundsInfo* visibleBounds, bool onlyShadowCasters)
 {
-    // Tell nodes to find, cascade down all nodes
-    getRootSceneNode()->_findVisibleObjects(cam, getRenderQueue(), visibleBounds, true, 
-        mDisplayNodes, onlyShadowCasters);
+    if (!mParallelCullingDepth)
+    {
+        // Tell nodes to find, cascade down all nodes
+        getRootSceneNode()->_findVisibleObjects(cam, getRenderQueue(), visibleBounds, true,
+            mDisplayNodes, onlyShadowCasters);
+        return;
+    }
+
+    // the tests below only read the planes, so they can run concurrently
+    cam->updateCullingPlanes();
+
+    mVisibleTopLevelNodes.clear();
+    mCullSubtrees.clear();
+    getRootSceneNode()->_findVisibleNodes(cam, mParallelCullingDepth, mVisibleTopLevelNodes, mCullSubtrees);
+
+    if (mVisibleSubtreeNodes.size() < mCullSubtrees.size())
+        mVisibleSubtreeNodes.resize(mCullSubtrees.size());
+
+    WorkQueue* workQueue = Root::getSingletonPtr() ? Root::getSingleton().getWorkQueue() : NULL;
+    WorkQueue::parallelFor(workQueue, mCullSubtrees.size(), 1, [this, cam](size_t begin, size_t end) {
+        std::vector<SceneNode*> unused;
+        for (size_t i = begin; i < end; i++)
+        {
+            mVisibleSubtreeNodes[i].clear();
+            mCullSubtrees[i]->_findVisibleNodes(cam, 0, mVisibleSubtreeNodes[i], unused);
+        }
+    });
+
+    // serial merge in the order of the recursive traversal, which queues all objects of a visible node
+    RenderQueue* queue = getRenderQueue();
+    // like the recursive traversal, the debug drawer gets each node after its visible descendants
+    std::vector<SceneNode*> undrawnAncestors;
+    auto addVisibleNode = [&](SceneNode* node) {
+        for (auto o : node->getAttachedObjects())
+            queue->processVisibleObject(o, cam, onlyShadowCasters, visibleBounds);
+
+        if (!mDebugDrawer)
+            return;
+
+        // the parent of a visible node is visible as well, and all nodes arrive in pre-order
+        while (!undrawnAncestors.empty() && undrawnAncestors.back() != node->getParent())
+        {
+            mDebugDrawer->drawSceneNode(undrawnAncestors.back());
+            undrawnAncestors.pop_back();
+        }
+        undrawnAncestors.push_back(node);
+    };
+
+    // the untested subtree roots appear in the same order in both lists
+    size_t subtree = 0;
+    for (auto node : mVisibleTopLevelNodes)
+    {
+        if (subtree < mCullSubtrees.size() && node == mCullSubtrees[subtree])
+        {
+            for (auto visible : mVisibleSubtreeNodes[subtree])
+                addVisibleNode(visible);
+            subtree++;
+            continue;
+        }
+
+        addVisibleNode(node);
+    }
+
+    for (auto it = undrawnAncestors.rbegin(); it != undrawnAncestors.rend(); ++it)
+        mDebugDrawer->drawSceneNode(*it);
+}
+//-----------------------------------------------------------------------
+void SceneManager::_findVisibleObjectsAndBlend(Camera* cam, VisibleObjectsBoundsInfo* visibleBounds,
+                                               bool onlyShadowCasters)
+{
+    if (!mParallelSoftwareAnimation)
+    {
+        _findVisibleObjects(cam, visibleBounds, onlyShadowCasters);
+        return;
+    }
 
+    // let the visible entities queue their software skinning, which is then done in parallel
+    if (!mSoftwareVertexBlendQueue)
+        mSoftwareVertexBlendQueue.reset(new SoftwareVertexBlendQueue());
+    mCollectSoftwareVertexBlends = true;
+    _findVisibleObjects(cam, visibleBounds, onlyShadowCasters);
+    mCollectSoftwareVertexBlends = false;
+    mSoftwareVertexBlendQueue->flush();
 }
 //-----------------------------------------------------------------------
 void SceneManager::_renderVisibleObjects(void)
@@ -3128,6 +3364,38 @@ void SceneManager::updateDirtyInstanceManagers(void)
     }
 }
 //---------------------------------------------------------------------
+void SceneManager::evaluateSkeletons(void)
+{
+    OgreProfileGroup("evaluateSkeletons", OGREPROF_GENERAL);
+
+    // animations and shared skeletons are prepared here, so the tasks only touch their own skeleton
+    mEvaluatedEntities.clear();
+    unsigned long frame = Root::getSingleton().getNextFrameNumber();
+    {
+        OGRE_LOCK_MUTEX(mMovableObjectCollectionMapMutex);
+        auto it = mMovableObjectCollectionMap.find(MOT_ENTITY);
+        if (it == mMovableObjectCollectionMap.end())
+            return;
+        MovableObjectCollection* coll = it->second;
+        OGRE_LOCK_MUTEX(coll->mutex);
+        for (auto& i : coll->map)
+        {
+            // like updateAnimation, which only runs for queued entities, skip those not queued last frame.
+            // Entities coming into view are evaluated by their updateAnimation instead.
+            Entity* ent = static_cast<Entity*>(i.second);
+            bool recentlyQueued = ent->_getFrameLastQueued() == frame || ent->_getFrameLastQueued() + 1 == frame;
+            if (recentlyQueued && ent->isInScene() && ent->isVisible() && ent->_prepareSkeletonEvaluation())
+                mEvaluatedEntities.push_back(ent);
+        }
+    }
+
+    WorkQueue* workQueue = Root::getSingletonPtr() ? Root::getSingleton().getWorkQueue() : NULL;
+    WorkQueue::parallelFor(workQueue, mEvaluatedEntities.size(), 1, [this](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+            mEvaluatedEntities[i]->_evaluateSkeleton();
+    });
+}
+//---------------------------------------------------------------------
 AxisAlignedBoxSceneQuery* 
 SceneManager::createAABBQuery(const AxisAlignedBox& box, uint32 mask)
 {
@@ -3592,6 +3860,7 @@ void SceneManager::bindGpuProgram(GpuProgram* prog)
     mLastLightHash = 1;
     mGpuParamsDirty = (uint16)GPV_ALL;
     mDestRenderSystem->bindGpuProgram(prog);
+    FrameCounters::add(FrameCounters::GPU_PROGRAM_BINDS);
 }
 //---------------------------------------------------------------------
 void SceneManager::_markGpuParamsDirty(uint16 mask)
@@ -3615,6 +3884,7 @@ void SceneManager::updateGpuProgramParameters(const Pass* pass)
             {
                 mDestRenderSystem->bindGpuProgramParameters(t, pass->getGpuProgramParameters(t),
                                                             mGpuParamsDirty);
+                FrameCounters::add(FrameCounters::GPU_PARAMETER_UPLOADS);
             }
         }
     }
@@ -3624,6 +3894,7 @@ void SceneManager::updateGpuProgramParameters(const Pass* pass)
     {
         mFixedFunctionParams->_updateAutoParams(mAutoParamDataSource.get(), mGpuParamsDirty);
         mDestRenderSystem->applyFixedFunctionParams(mFixedFunctionParams, mGpuParamsDirty);
+        FrameCounters::add(FrameCounters::GPU_PARAMETER_UPLOADS);
     }
 
     mGpuParamsDirty = 0;
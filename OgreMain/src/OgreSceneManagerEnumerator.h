@@ -59,6 +59,7 @@ namespace Ogre {
         DefaultSceneManager(const String& name);
         ~DefaultSceneManager();
         const String& getTypeName(void) const override;
+        bool supportsParallelUpdate() const override { return true; }
     };
 
     /** Enumerates the SceneManager classes available to applications.
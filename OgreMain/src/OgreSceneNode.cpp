@@ -26,6 +26,8 @@ THE SOFTWARE.
 -----------------------------------------------------------------------------
 */
 #include "OgreStableHeaders.h"
+#include "OgreFrameCounters.h"
+#include "OgreTransformStore.h"
 
 namespace Ogre {
     //-----------------------------------------------------------------------
@@ -38,6 +40,7 @@ namespace Ogre {
         , mCreator(creator)
         , mAutoTrackTarget(0)
         , mGlobalIndex(-1)
+        , mTransformStoreIndex(TransformStore::NO_PARENT)
         , mYawFixed(false)
         , mIsInSceneGraph(false)
         , mShowBoundingBox(false)
@@ -62,10 +65,55 @@ namespace Ogre {
         _updateBounds();
     }
     //-----------------------------------------------------------------------
+    void SceneNode::_updateTopLevels(uint16 depth, bool parentHasChanged, std::vector<SceneNode*>& updated,
+                                     SubtreeList& subtrees)
+    {
+        // mirrors Node::_update, but stops descending at the given depth
+        mParentNotified = false;
+
+        if (mNeedParentUpdate || parentHasChanged)
+            _updateFromParent();
+
+        updated.push_back(this);
+
+        auto visitChild = [&](Node* child, bool changed) {
+            SceneNode* sceneChild = static_cast<SceneNode*>(child);
+            if (depth > 1)
+                sceneChild->_updateTopLevels(depth - 1, changed, updated, subtrees);
+            else
+                subtrees.emplace_back(sceneChild, changed);
+        };
+
+        if (mNeedChildUpdate || parentHasChanged)
+        {
+            for (auto child : getChildren())
+                visitChild(child, true);
+        }
+        else
+        {
+            for (auto child : mChildrenToUpdate)
+                visitChild(child, false);
+        }
+
+        mChildrenToUpdate.clear();
+        mNeedChildUpdate = false;
+    }
+    //-----------------------------------------------------------------------
+    void SceneNode::needUpdate(bool forceParentUpdate)
+    {
+        Node::needUpdate(forceParentUpdate);
+
+        if (mTransformStoreIndex != TransformStore::NO_PARENT)
+            mCreator->_notifyLocalTransformChanged(this);
+    }
+    //-----------------------------------------------------------------------
     void SceneNode::setParent(Node* parent)
     {
         Node::setParent(parent);
 
+        if (mCreator)
+            mCreator->_notifySceneGraphChanged();
+
         if (parent)
         {
             SceneNode* sceneParent = static_cast<SceneNode*>(parent);
@@ -230,7 +278,10 @@ namespace Ogre {
     {
         // Check self visible
         if (!cam->isVisible(mWorldAABB))
+        {
+            FrameCounters::add(FrameCounters::NODES_CULLED);
             return;
+        }
 
         // Add all entities
         for (auto *o : mObjectsByName)
@@ -254,6 +305,33 @@ namespace Ogre {
         }
     }
 
+    //-----------------------------------------------------------------------
+    void SceneNode::_findVisibleNodes(const Camera* cam, uint16 depth, std::vector<SceneNode*>& visible,
+                                      std::vector<SceneNode*>& subtrees)
+    {
+        if (!cam->isVisible(mWorldAABB))
+        {
+            FrameCounters::add(FrameCounters::NODES_CULLED);
+            return;
+        }
+
+        visible.push_back(this);
+
+        for (auto child : getChildren())
+        {
+            SceneNode* sceneChild = static_cast<SceneNode*>(child);
+            if (depth == 1)
+            {
+                visible.push_back(sceneChild);
+                subtrees.push_back(sceneChild);
+            }
+            else
+            {
+                sceneChild->_findVisibleNodes(cam, depth ? depth - 1 : 0, visible, subtrees);
+            }
+        }
+    }
+
     SceneNode::ObjectIterator SceneNode::getAttachedObjectIterator(void) {
         return ObjectIterator(mObjectsByName.begin(), mObjectsByName.end());
     }
@@ -261,10 +339,38 @@ namespace Ogre {
         return ConstObjectIterator(mObjectsByName.begin(), mObjectsByName.end());
     }
 
+    //-----------------------------------------------------------------------
+    static uint64*& deferredUpdateCount()
+    {
+        static thread_local uint64* count = NULL;
+        return count;
+    }
+    //-----------------------------------------------------------------------
+    void SceneNode::_setDeferredUpdateCount(uint64* count)
+    {
+        deferredUpdateCount() = count;
+    }
     //-----------------------------------------------------------------------
     void SceneNode::updateFromParentImpl(void) const
     {
-        Node::updateFromParentImpl();
+        const TransformStore* store = mCreator ? mCreator->_getUpdatedTransformStore() : NULL;
+        if (store && mTransformStoreIndex != TransformStore::NO_PARENT)
+        {
+            // already computed by the sweep in SceneManager::_updateSceneGraph
+            mDerivedPosition = store->getDerivedPosition(mTransformStoreIndex);
+            mDerivedOrientation = store->getDerivedOrientation(mTransformStoreIndex);
+            mDerivedScale = store->getDerivedScale(mTransformStoreIndex);
+            mCachedTransformOutOfDate = true;
+            mNeedParentUpdate = false;
+        }
+        else
+        {
+            Node::updateFromParentImpl();
+        }
+        if (auto count = deferredUpdateCount())
+            ++*count;
+        else
+            FrameCounters::add(FrameCounters::NODES_UPDATED);
 
         // Notify objects that it has been moved
         for (auto o : mObjectsByName)
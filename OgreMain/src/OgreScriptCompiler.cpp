@@ -516,7 +516,7 @@ namespace Ogre
             if (!stream)
                 return retval;
 
-            nodes = ScriptParser::parse(ScriptLexer::tokenize(stream->getAsString(), name), name);
+            nodes = ScriptParser::parse(ScriptLexer::tokenize(stream, name), name);
         }
 
         if(nodes)
@@ -1609,7 +1609,7 @@ namespace Ogre
     void ScriptCompilerManager::parseScript(DataStreamPtr& stream, const String& groupName)
     {
         ConcreteNodeListPtr nodes =
-            ScriptParser::parse(ScriptLexer::tokenize(stream->getAsString(), stream->getName()), stream->getName());
+            ScriptParser::parse(ScriptLexer::tokenize(stream, stream->getName()), stream->getName());
         {
             // compile is not reentrant
             OGRE_LOCK_AUTO_MUTEX;
@@ -30,9 +30,23 @@ THE SOFTWARE.
 
 namespace Ogre {
     ScriptTokenList ScriptLexer::tokenize(const String &str, const String& source)
+    {
+        return tokenize(str.data(), str.size(), source);
+    }
+
+    ScriptTokenList ScriptLexer::tokenize(const DataStreamPtr& stream, const String& source)
+    {
+        // lex the stream memory, if it has any, instead of a copy
+        if (auto memStream = dynamic_cast<MemoryDataStream*>(stream.get()))
+            return tokenize((const char*)memStream->getPtr(), memStream->size(), source);
+
+        return tokenize(stream->getAsString(), source);
+    }
+
+    ScriptTokenList ScriptLexer::tokenize(const char* str, size_t size, const String& source)
     {
         String error;
-        ScriptTokenList ret = _tokenize(str, source.c_str(), error);
+        ScriptTokenList ret = _tokenize(str, size, source.c_str(), error);
 
         if (!error.empty())
             LogManager::getSingleton().logError("ScriptLexer - " + error);
@@ -40,7 +54,7 @@ namespace Ogre {
         return ret;
     }
 
-    ScriptTokenList ScriptLexer::_tokenize(const String &str, const char* source, String& error)
+    ScriptTokenList ScriptLexer::_tokenize(const char* str, size_t size, const char* source, String& error)
     {
         // State enums
         enum{ READY = 0, COMMENT, MULTICOMMENT, WORD, QUOTE, VAR, POSSIBLECOMMENT };
@@ -54,10 +68,10 @@ namespace Ogre {
         ScriptTokenList tokens;
 
         // Iterate over the input
-        for(char i : str)
+        for(const char* end = str + size; str != end; ++str)
         {
             lastc = c;
-            c = i;
+            c = *str;
 
             if(c == quote)
                 lastQuote = line;
@@ -72,8 +72,12 @@ namespace Ogre {
     public:
         /** Tokenizes the given input and returns the list of tokens found */
         static ScriptTokenList tokenize(const String &str, const String &source);
+        /// @overload
+        static ScriptTokenList tokenize(const char* str, size_t size, const String &source);
+        /** Tokenizes the whole stream, in place if it is a MemoryDataStream */
+        static ScriptTokenList tokenize(const DataStreamPtr& stream, const String &source);
     private: // Private utility operations
-        static ScriptTokenList _tokenize(const String &str, const char* source, String& error);
+        static ScriptTokenList _tokenize(const char* str, size_t size, const char* source, String& error);
         static void setToken(const String &lexeme, uint32 line, ScriptTokenList& tokens);
         static bool isWhitespace(Ogre::String::value_type c);
         static bool isNewline(Ogre::String::value_type c);
@@ -32,10 +32,28 @@ THE SOFTWARE.
 // Just for logging
 #include "OgreAnimationTrack.h"
 #include "OgreKeyFrame.h"
+#include "OgreAnimationEvaluationCache.h"
+#include "OgreTransformStore.h"
 
 
 namespace Ogre {
 
+    /// local transforms indexed by bone handle, blended before computing the derived ones in store
+    struct Skeleton::PoseEvaluation
+    {
+        std::vector<Vector3> position;
+        std::vector<Quaternion> orientation;
+        std::vector<Vector3> scale;
+        /// index of each bone in store
+        std::vector<uint32> storeIndex;
+        /// parent and inheritance flags of each bone when store was built
+        std::vector<std::pair<Node*, uint8> > hierarchy;
+        /// bones still to be added to store
+        std::vector<Bone*> chain;
+        TransformStore store;
+        /// the evaluated animation, if not using the cache
+        AnimationPose pose;
+    };
     //---------------------------------------------------------------------
     Skeleton::Skeleton()
         : Resource(),
@@ -191,6 +209,43 @@ namespace Ogre {
         // Reset bones
         reset();
 
+        Real weightFactor = getAnimationWeightFactor(animSet);
+
+        AnimationEvaluationCache* cache = _getAnimationCache();
+
+        // Per enabled animation state
+        for(auto *animState : animSet.getEnabledAnimationStates())
+        {
+            const LinkedSkeletonAnimationSource* linked = 0;
+            Animation* anim = _getAnimationImpl(animState->getAnimationName(), &linked);
+            // tolerate state entries for animations we're not aware of
+            if (anim)
+            {
+              if (cache)
+              {
+                // the pose is shared with the other instances
+                auto pose = cache->getPose(anim, animState->getTimePosition());
+                applyAnimationPose(*pose, animState->getWeight() * weightFactor,
+                  animState->hasBlendMask() ? animState->getBlendMask() : NULL, linked ? linked->scale : 1.0f);
+              }
+              else if(animState->hasBlendMask())
+              {
+                anim->apply(this, animState->getTimePosition(), animState->getWeight() * weightFactor,
+                  animState->getBlendMask(), linked ? linked->scale : 1.0f);
+              }
+              else
+              {
+                anim->apply(this, animState->getTimePosition(), 
+                  animState->getWeight() * weightFactor, linked ? linked->scale : 1.0f);
+              }
+            }
+        }
+
+
+    }
+    //---------------------------------------------------------------------
+    Real Skeleton::getAnimationWeightFactor(const AnimationStateSet& animSet) const
+    {
         Real weightFactor = 1.0f;
         if (mBlendState == ANIMBLEND_AVERAGE)
         {
@@ -214,29 +269,288 @@ namespace Ogre {
                 weightFactor = 1.0f / totalWeights;
             }
         }
+        return weightFactor;
+    }
+    //---------------------------------------------------------------------
+    void Skeleton::applyAnimationPose(const AnimationPose& pose, Real weight,
+                                      const AnimationState::BoneBlendMask* blendMask, Real scl)
+    {
+        // same as NodeAnimationTrack::applyToNode, with the interpolated keyframe from the pose
+        for (size_t i = 0; i < pose.handle.size(); i++)
+        {
+            Bone* b = getBone(pose.handle[i]);
+            Real w = blendMask ? (*blendMask)[b->getHandle()] * weight : weight;
+            if (!w)
+                continue;
 
-        // Per enabled animation state
-        for(auto *animState : animSet.getEnabledAnimationStates())
+            b->translate(pose.translate[i] * w * scl);
+
+            Quaternion rotate;
+            if (pose.rotationInterpolation == Animation::RIM_LINEAR)
+                rotate = Quaternion::nlerp(w, Quaternion::IDENTITY, pose.rotate[i], pose.useShortestRotationPath[i]);
+            else
+                rotate = Quaternion::Slerp(w, Quaternion::IDENTITY, pose.rotate[i], pose.useShortestRotationPath[i]);
+            b->rotate(rotate);
+
+            Vector3 scale = pose.scale[i];
+            if (scale != Vector3::UNIT_SCALE)
+            {
+                if (scl != 1.0f)
+                    scale = Vector3::UNIT_SCALE + (scale - Vector3::UNIT_SCALE) * scl;
+                else if (w != 1.0f)
+                    scale = Vector3::UNIT_SCALE + (scale - Vector3::UNIT_SCALE) * w;
+            }
+            b->scale(scale);
+        }
+    }
+    //---------------------------------------------------------------------
+    void Skeleton::applyAnimationPose(const AnimationPose& pose, Real weight,
+                                      const AnimationState::BoneBlendMask* blendMask, Real scl,
+                                      PoseEvaluation& eval) const
+    {
+        // same operations as applyAnimationPose on the bones
+        for (size_t i = 0; i < pose.handle.size(); i++)
+        {
+            unsigned short handle = pose.handle[i];
+            OgreAssert(handle < mBoneList.size(), "Index out of bounds");
+            Real w = blendMask ? (*blendMask)[handle] * weight : weight;
+            if (!w)
+                continue;
+
+            eval.position[handle] += pose.translate[i] * w * scl;
+
+            Quaternion rotate;
+            if (pose.rotationInterpolation == Animation::RIM_LINEAR)
+                rotate = Quaternion::nlerp(w, Quaternion::IDENTITY, pose.rotate[i], pose.useShortestRotationPath[i]);
+            else
+                rotate = Quaternion::Slerp(w, Quaternion::IDENTITY, pose.rotate[i], pose.useShortestRotationPath[i]);
+            Quaternion& orientation = eval.orientation[handle];
+            orientation = orientation * rotate;
+            orientation.normalise();
+
+            Vector3 scale = pose.scale[i];
+            if (scale != Vector3::UNIT_SCALE)
+            {
+                if (scl != 1.0f)
+                    scale = Vector3::UNIT_SCALE + (scale - Vector3::UNIT_SCALE) * scl;
+                else if (w != 1.0f)
+                    scale = Vector3::UNIT_SCALE + (scale - Vector3::UNIT_SCALE) * w;
+            }
+            eval.scale[handle] *= scale;
+        }
+    }
+    //---------------------------------------------------------------------
+    void Skeleton::_evaluateBoneMatrices(const AnimationStateSet& animSet, Affine3* pMatrices)
+    {
+#if OGRE_NODE_INHERIT_TRANSFORM
+        // not supported by TransformStore
+        setAnimationState(animSet);
+        _getBoneMatrices(pMatrices);
+#else
+        if (!mPoseEvaluation)
+            mPoseEvaluation.reset(new PoseEvaluation());
+        PoseEvaluation& eval = *mPoseEvaluation;
+
+        // start from the binding pose, keeping the manual bones like reset() does
+        size_t numBones = mBoneList.size();
+        eval.position.resize(numBones);
+        eval.orientation.resize(numBones);
+        eval.scale.resize(numBones);
+        for (size_t i = 0; i < numBones; ++i)
+        {
+            const Bone* b = mBoneList[i];
+            bool manual = b->isManuallyControlled();
+            eval.position[i] = manual ? b->getPosition() : b->getInitialPosition();
+            eval.orientation[i] = manual ? b->getOrientation() : b->getInitialOrientation();
+            eval.scale[i] = manual ? b->getScale() : b->getInitialScale();
+        }
+
+        Real weightFactor = getAnimationWeightFactor(animSet);
+        AnimationEvaluationCache* cache = _getAnimationCache();
+
+        for (auto *animState : animSet.getEnabledAnimationStates())
         {
             const LinkedSkeletonAnimationSource* linked = 0;
             Animation* anim = _getAnimationImpl(animState->getAnimationName(), &linked);
             // tolerate state entries for animations we're not aware of
-            if (anim)
+            if (!anim)
+                continue;
+
+            std::shared_ptr<const AnimationPose> sharedPose;
+            const AnimationPose* pose = &eval.pose;
+            if (cache)
             {
-              if(animState->hasBlendMask())
-              {
-                anim->apply(this, animState->getTimePosition(), animState->getWeight() * weightFactor,
-                  animState->getBlendMask(), linked ? linked->scale : 1.0f);
-              }
-              else
-              {
-                anim->apply(this, animState->getTimePosition(), 
-                  animState->getWeight() * weightFactor, linked ? linked->scale : 1.0f);
-              }
+                sharedPose = cache->getPose(anim, animState->getTimePosition());
+                pose = sharedPose.get();
+            }
+            else
+            {
+                AnimationEvaluationCache::evaluate(anim, animState->getTimePosition(), eval.pose);
             }
+            applyAnimationPose(*pose, animState->getWeight() * weightFactor,
+                               animState->hasBlendMask() ? animState->getBlendMask() : NULL,
+                               linked ? linked->scale : 1.0f, eval);
         }
 
+        // the hierarchy rarely changes, so the store is only rebuilt if it did
+        bool rebuild = eval.hierarchy.size() != numBones;
+        eval.hierarchy.resize(numBones);
+        for (size_t i = 0; i < numBones; ++i)
+        {
+            const Bone* b = mBoneList[i];
+            std::pair<Node*, uint8> entry(b->getParent(), b->getInheritOrientation() | b->getInheritScale() << 1);
+            rebuild |= eval.hierarchy[i] != entry;
+            eval.hierarchy[i] = entry;
+        }
+
+        if (rebuild)
+        {
+            // add the bones with their parents first
+            static const uint32 NOT_ADDED = TransformStore::NO_PARENT - 1;
+            eval.store.clear();
+            eval.store.reserve(numBones);
+            eval.storeIndex.assign(numBones, NOT_ADDED);
+            std::vector<Bone*>& chain = eval.chain;
+            for (size_t i = 0; i < numBones; ++i)
+            {
+                // walk up to the first bone that was added, then add the chain down to this one
+                chain.clear();
+                for (Bone* b = mBoneList[i]; b && eval.storeIndex[b->getHandle()] == NOT_ADDED;
+                     b = static_cast<Bone*>(b->getParent()))
+                    chain.push_back(b);
 
+                for (auto it = chain.rbegin(); it != chain.rend(); ++it)
+                {
+                    Bone* b = *it;
+                    Node* parent = b->getParent();
+                    uint32 parentIndex = parent ? eval.storeIndex[static_cast<Bone*>(parent)->getHandle()]
+                                                : TransformStore::NO_PARENT;
+                    eval.storeIndex[b->getHandle()] = eval.store.add(
+                        parentIndex, Vector3::ZERO, Quaternion::IDENTITY, Vector3::UNIT_SCALE,
+                        b->getInheritOrientation(), b->getInheritScale());
+                }
+            }
+        }
+
+        for (size_t i = 0; i < numBones; ++i)
+        {
+            uint32 index = eval.storeIndex[i];
+            eval.store.setPosition(index, eval.position[i]);
+            eval.store.setOrientation(index, eval.orientation[i]);
+            eval.store.setScale(index, eval.scale[i]);
+        }
+        eval.store.update();
+
+        // keep the bones in sync, so their derived transforms can be queried, e.g. by the tag points
+        for (size_t i = 0; i < numBones; ++i)
+        {
+            Bone* b = mBoneList[i];
+            uint32 index = eval.storeIndex[i];
+            b->_setTransforms(eval.position[i], eval.orientation[i], eval.scale[i],
+                              eval.store.getDerivedPosition(index), eval.store.getDerivedOrientation(index),
+                              eval.store.getDerivedScale(index));
+            b->_getOffsetTransform(pMatrices[i]);
+        }
+        mManualBonesDirty = false;
+#endif
+    }
+    //---------------------------------------------------------------------
+    void Skeleton::_prepareAnimations(const AnimationStateSet& animSet)
+    {
+        for (auto *animState : animSet.getEnabledAnimationStates())
+        {
+            if (Animation* anim = _getAnimationImpl(animState->getAnimationName()))
+                anim->_prepareNodeTracks();
+        }
+    }
+    //---------------------------------------------------------------------
+    void Skeleton::setAnimationCache(bool enabled, Real timeQuantum)
+    {
+        OgreAssert(timeQuantum >= 0, "negative time quantum");
+        if (enabled)
+            mAnimationCache.reset(new AnimationEvaluationCache(timeQuantum));
+        else
+            mAnimationCache.reset();
+    }
+    //---------------------------------------------------------------------
+    Real Skeleton::getAnimationCacheQuantum(void) const
+    {
+        AnimationEvaluationCache* cache = _getAnimationCache();
+        return cache ? cache->getTimeQuantum() : 0;
+    }
+    //---------------------------------------------------------------------
+    std::shared_ptr<const AnimationPose> AnimationEvaluationCache::getPose(Animation* anim, Real timePos)
+    {
+        // poses beyond this are dropped, in case the frame number does not advance
+        static const size_t MAX_POSES = 4096;
+
+        if (mTimeQuantum > 0)
+            timePos = std::min(std::round(timePos / mTimeQuantum) * mTimeQuantum, anim->getLength());
+        Key key = {anim, timePos, anim->getInterpolationMode(), anim->getRotationInterpolationMode()};
+
+        std::promise<std::shared_ptr<const AnimationPose> > promise;
+        PoseFuture pending;
+        {
+            OGRE_WQ_LOCK_MUTEX(mMutex);
+            unsigned long frame = Root::getSingleton().getNextFrameNumber();
+            if (frame != mFrame || mPoses.size() >= MAX_POSES)
+            {
+                // keyframes may have changed since, the instances still hold on to the poses they use
+                mPoses.clear();
+                mFrame = frame;
+            }
+
+            auto it = mPoses.emplace(key, PoseFuture());
+            if (it.second)
+                it.first->second = promise.get_future().share();
+            else
+                pending = it.first->second;
+        }
+
+        // cached, or being evaluated by another thread
+        if (pending.valid())
+            return pending.get();
+
+        auto pose = std::make_shared<AnimationPose>();
+        try
+        {
+            evaluate(anim, timePos, *pose);
+        }
+        catch (...)
+        {
+            promise.set_exception(std::current_exception());
+            throw;
+        }
+        promise.set_value(pose);
+        return pose;
+    }
+    //---------------------------------------------------------------------
+    void AnimationEvaluationCache::evaluate(Animation* anim, Real timePos, AnimationPose& pose)
+    {
+        pose.handle.clear();
+        pose.translate.clear();
+        pose.rotate.clear();
+        pose.scale.clear();
+        pose.useShortestRotationPath.clear();
+        pose.rotationInterpolation = anim->getRotationInterpolationMode();
+
+        anim->_applyBaseKeyFrame();
+        TimeIndex timeIndex = anim->_getTimeIndex(timePos);
+        for (const auto& t : anim->_getNodeTrackList())
+        {
+            NodeAnimationTrack* track = t.second;
+            // skipped by applyToNode too
+            if (track->getNumKeyFrames() == 0 && !track->isCompressed())
+                continue;
+
+            TransformKeyFrame kf(0, timeIndex.getTimePos());
+            track->getInterpolatedKeyFrame(timeIndex, &kf);
+            pose.handle.push_back(t.first);
+            pose.translate.push_back(kf.getTranslate());
+            pose.rotate.push_back(kf.getRotation());
+            pose.scale.push_back(kf.getScale());
+            pose.useShortestRotationPath.push_back(track->getUseShortestRotationPath());
+        }
     }
     //---------------------------------------------------------------------
     void Skeleton::setBindingPose(void)
@@ -542,11 +856,16 @@ namespace Ogre {
                 NodeAnimationTrack* track = anim->getNodeTrack(ti);
                 o << "  -- AnimationTrack " << ti << " --" << std::endl;
                 o << "  Affects bone: " << static_cast<Bone*>(track->getAssociatedNode())->getHandle() << std::endl;
-                o << "  Number of keyframes: " << track->getNumKeyFrames() << std::endl;
+                // compressed tracks have no keyframes, dump their decoded keys
+                std::vector<TransformKeyFrame> decodedKeys;
+                track->_decodeCompressedKeys(decodedKeys);
+                size_t numKeyFrames = track->isCompressed() ? decodedKeys.size() : track->getNumKeyFrames();
+                o << "  Number of keyframes: " << numKeyFrames << std::endl;
 
-                for (unsigned short ki = 0; ki < track->getNumKeyFrames(); ++ki)
+                for (unsigned short ki = 0; ki < numKeyFrames; ++ki)
                 {
-                    TransformKeyFrame* key = track->getNodeKeyFrame(ki);
+                    const TransformKeyFrame* key =
+                        track->isCompressed() ? &decodedKeys[ki] : track->getNodeKeyFrame(ki);
                     o << "    -- KeyFrame " << ki << " --" << std::endl;
                     o << "    Time index: " << key->getTime();
                     o << "    Translation: " << key->getTranslate() << std::endl;
@@ -627,6 +946,16 @@ namespace Ogre {
         }
     }
     //---------------------------------------------------------------------
+    void Skeleton::compressAllAnimations(Real translateTolerance, const Radian& rotateTolerance,
+                                         Real scaleTolerance)
+    {
+        for (auto& a : mAnimationsList)
+        {
+            for (auto& t : a.second->_getNodeTrackList())
+                t.second->compress(translateTolerance, rotateTolerance, scaleTolerance);
+        }
+    }
+    //---------------------------------------------------------------------
     void Skeleton::addLinkedSkeletonAnimationSource(const String& skelName, 
         Real scale)
     {
@@ -884,10 +1213,15 @@ namespace Ogre {
                     NodeAnimationTrack* dstTrack = dstAnimation->createNodeTrack(dstHandle, this->getBone(dstHandle));
                     dstTrack->setUseShortestRotationPath(srcTrack->getUseShortestRotationPath());
 
-                    ushort numKeyFrames = srcTrack->getNumKeyFrames();
-                    for (ushort k = 0; k < numKeyFrames; ++k)
+                    // Compressed tracks have no keyframes, copy their decoded keys instead
+                    std::vector<TransformKeyFrame> decodedKeys;
+                    srcTrack->_decodeCompressedKeys(decodedKeys);
+                    size_t numKeyFrames = srcTrack->isCompressed() ? decodedKeys.size() : srcTrack->getNumKeyFrames();
+                    for (size_t k = 0; k < numKeyFrames; ++k)
                     {
-                        const TransformKeyFrame* srcKeyFrame = srcTrack->getNodeKeyFrame(k);
+                        const TransformKeyFrame* srcKeyFrame = srcTrack->isCompressed()
+                                                                   ? &decodedKeys[k]
+                                                                   : srcTrack->getNodeKeyFrame(ushort(k));
                         TransformKeyFrame* dstKeyFrame = dstTrack->createNodeKeyFrame(srcKeyFrame->getTime());
 
                         // Adjust keyframes to match target binding pose
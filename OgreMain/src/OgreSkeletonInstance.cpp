@@ -80,6 +80,16 @@ namespace Ogre {
         mSkeleton->removeAnimation(name);
     }
     //-------------------------------------------------------------------------
+    void SkeletonInstance::setAnimationCache(bool enabled, Real timeQuantum)
+    {
+        mSkeleton->setAnimationCache(enabled, timeQuantum);
+    }
+    //-------------------------------------------------------------------------
+    AnimationEvaluationCache* SkeletonInstance::_getAnimationCache(void) const
+    {
+        return mSkeleton->_getAnimationCache();
+    }
+    //-------------------------------------------------------------------------
     void SkeletonInstance::addLinkedSkeletonAnimationSource(const String& skelName, 
         Real scale)
     {
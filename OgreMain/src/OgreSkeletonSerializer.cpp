@@ -32,11 +32,20 @@ THE SOFTWARE.
 #include "OgreAnimation.h"
 #include "OgreAnimationTrack.h"
 #include "OgreKeyFrame.h"
+#include "OgreCompressedTransformTrack.h"
 
 namespace Ogre {
     /// stream overhead = ID + size
     const long SSTREAM_OVERHEAD_SIZE = sizeof(uint16) + sizeof(uint32);
     const uint16 HEADER_STREAM_ID_EXT = 0x1000;
+
+    /// keyframes at the keys of a compressed track, for the versions without compressed tracks
+    static std::vector<TransformKeyFrame> getCompressedKeyFrames(const NodeAnimationTrack* track)
+    {
+        std::vector<TransformKeyFrame> keys;
+        track->_decodeCompressedKeys(keys);
+        return keys;
+    }
     //---------------------------------------------------------------------
     SkeletonSerializer::SkeletonSerializer()
     {
@@ -118,7 +127,8 @@ namespace Ogre {
         // Read version
         String ver = readString(stream);
         if ((ver != "[Serializer_v1.10]") &&
-            (ver != "[Serializer_v1.80]"))
+            (ver != "[Serializer_v1.80]") &&
+            (ver != "[Serializer_v1.90]"))
         {
             OGRE_EXCEPT(Exception::ERR_INTERNAL_ERROR,
                 "Invalid file: version incompatible, file reports " + String(ver),
@@ -170,7 +180,9 @@ namespace Ogre {
     {
         if (ver == SKELETON_VERSION_1_0)
             mVersion = "[Serializer_v1.10]";
-        else mVersion = "[Serializer_v1.80]";
+        else if (ver == SKELETON_VERSION_1_8)
+            mVersion = "[Serializer_v1.80]";
+        else mVersion = "[Serializer_v1.90]";
     }
     //---------------------------------------------------------------------
     void SkeletonSerializer::writeSkeleton(const Skeleton* pSkel, SkeletonVersion ver)
@@ -277,7 +289,7 @@ namespace Ogre {
         // Write all tracks
         for (const auto& it : anim->_getNodeTrackList())
         {
-            writeAnimationTrack(pSkel, it.second);
+            writeAnimationTrack(pSkel, it.second, ver);
         }
         }
         popInnerChunk(mStream);
@@ -285,15 +297,28 @@ namespace Ogre {
     }
     //---------------------------------------------------------------------
     void SkeletonSerializer::writeAnimationTrack(const Skeleton* pSkel, 
-        const NodeAnimationTrack* track)
+        const NodeAnimationTrack* track, SkeletonVersion ver)
     {
-        writeChunkHeader(SKELETON_ANIMATION_TRACK, calcAnimationTrackSize(pSkel, track));
+        writeChunkHeader(SKELETON_ANIMATION_TRACK, calcAnimationTrackSize(pSkel, track, ver));
 
         // unsigned short boneIndex     : Index of bone to apply to
         Bone* bone = static_cast<Bone*>(track->getAssociatedNode());
         unsigned short boneid = bone->getHandle();
         writeShorts(&boneid, 1);
         pushInnerChunk(mStream);
+        if (track->isCompressed())
+        {
+            if ((int)ver >= (int)SKELETON_VERSION_1_9)
+            {
+                writeCompressedKeys(track->_getCompressedKeys());
+            }
+            else
+            {
+                // Older versions only know keyframes
+                for (const auto& key : getCompressedKeyFrames(track))
+                    writeKeyFrame(pSkel, &key);
+            }
+        }
         // Write all keyframes
         for (unsigned short i = 0; i < track->getNumKeyFrames(); ++i)
         {
@@ -302,6 +327,28 @@ namespace Ogre {
         popInnerChunk(mStream);
     }
     //---------------------------------------------------------------------
+    void SkeletonSerializer::writeCompressedKeys(const CompressedTransformTrack* keys)
+    {
+        writeChunkHeader(SKELETON_ANIMATION_TRACK_COMPRESSED, calcCompressedKeysSize(keys));
+
+        // float timeScale              : key time units per second
+        float timeScale = keys->timeScale;
+        writeFloats(&timeScale, 1);
+
+        // unsigned short animated      : channels with keys
+        writeShorts(&keys->animated, 1);
+        // unsigned int numKeys
+        uint32 numKeys = uint32(keys->times.size());
+        writeInts(&numKeys, 1);
+        writeObject(keys->translateBase);
+        writeObject(keys->translateStep);
+        writeObject(keys->rotation);
+        writeObject(keys->scaleBase);
+        writeObject(keys->scaleStep);
+        writeShorts(keys->times.data(), keys->times.size());
+        writeShorts(keys->values.data(), keys->values.size());
+    }
+    //---------------------------------------------------------------------
     void SkeletonSerializer::writeKeyFrame(const Skeleton* pSkel, 
         const TransformKeyFrame* key)
     {
@@ -394,20 +441,33 @@ namespace Ogre {
         // Nested animation tracks
         for (const auto& it : pAnim->_getNodeTrackList())
         {
-            size += calcAnimationTrackSize(pSkel, it.second);
+            size += calcAnimationTrackSize(pSkel, it.second, ver);
         }
 
         return size;
     }
     //---------------------------------------------------------------------
     size_t SkeletonSerializer::calcAnimationTrackSize(const Skeleton* pSkel, 
-        const NodeAnimationTrack* pTrack)
+        const NodeAnimationTrack* pTrack, SkeletonVersion ver)
     {
         size_t size = SSTREAM_OVERHEAD_SIZE;
 
         // unsigned short boneIndex     : Index of bone to apply to
         size += sizeof(unsigned short);
 
+        if (pTrack->isCompressed())
+        {
+            if ((int)ver >= (int)SKELETON_VERSION_1_9)
+            {
+                size += calcCompressedKeysSize(pTrack->_getCompressedKeys());
+            }
+            else
+            {
+                for (const auto& key : getCompressedKeyFrames(pTrack))
+                    size += calcKeyFrameSize(pSkel, &key);
+            }
+        }
+
         // Nested keyframes
         for (unsigned short i = 0; i < pTrack->getNumKeyFrames(); ++i)
         {
@@ -417,6 +477,20 @@ namespace Ogre {
         return size;
     }
     //---------------------------------------------------------------------
+    size_t SkeletonSerializer::calcCompressedKeysSize(const CompressedTransformTrack* keys)
+    {
+        size_t size = SSTREAM_OVERHEAD_SIZE;
+
+        // float timeScale, unsigned short animated, unsigned int numKeys
+        size += sizeof(float) + sizeof(uint16) + sizeof(uint32);
+        // bases, steps and rotation
+        size += sizeof(float) * 16;
+        // times and values
+        size += sizeof(uint16) * (keys->times.size() + keys->values.size());
+
+        return size;
+    }
+    //---------------------------------------------------------------------
     size_t SkeletonSerializer::calcKeyFrameSize(const Skeleton* pSkel, 
         const TransformKeyFrame* pKey)
     {
@@ -572,6 +646,16 @@ namespace Ogre {
         {
             pushInnerChunk(stream);
             unsigned short streamID = readChunk(stream);
+            if (streamID == SKELETON_ANIMATION_TRACK_COMPRESSED)
+            {
+                readCompressedKeys(stream, pTrack);
+
+                if (!stream->eof())
+                {
+                    // Get next stream
+                    streamID = readChunk(stream);
+                }
+            }
             while(streamID == SKELETON_ANIMATION_TRACK_KEYFRAME && !stream->eof())
             {
                 readKeyFrame(stream, pTrack, pSkel);
@@ -619,6 +703,33 @@ namespace Ogre {
         }
     }
     //---------------------------------------------------------------------
+    void SkeletonSerializer::readCompressedKeys(DataStreamPtr& stream, NodeAnimationTrack* track)
+    {
+        auto keys = std::make_shared<CompressedTransformTrack>();
+
+        // float timeScale              : key time units per second
+        float timeScale;
+        readFloats(stream, &timeScale, 1);
+        keys->timeScale = timeScale;
+
+        // unsigned short animated      : channels with keys
+        readShorts(stream, &keys->animated, 1);
+        // unsigned int numKeys
+        uint32 numKeys;
+        readInts(stream, &numKeys, 1);
+        readObject(stream, keys->translateBase);
+        readObject(stream, keys->translateStep);
+        readObject(stream, keys->rotation);
+        readObject(stream, keys->scaleBase);
+        readObject(stream, keys->scaleStep);
+        keys->times.resize(numKeys);
+        keys->values.resize(numKeys * keys->getStride());
+        readShorts(stream, keys->times.data(), keys->times.size());
+        readShorts(stream, keys->values.data(), keys->values.size());
+
+        track->_setCompressedKeys(keys);
+    }
+    //---------------------------------------------------------------------
     void SkeletonSerializer::writeSkeletonAnimationLink(const Skeleton* pSkel, 
         const LinkedSkeletonAnimationSource& link)
     {
@@ -0,0 +1,87 @@
+// This file is part of the OGRE project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at https://www.ogre3d.org/licensing.
+// SPDX-License-Identifier: MIT
+#ifndef __SoftwareVertexBlend_H__
+#define __SoftwareVertexBlend_H__
+
+#include "OgrePrerequisites.h"
+#include "OgreHardwareVertexBuffer.h"
+
+#include <unordered_map>
+
+namespace Ogre
+{
+    /** Collects software vertex blends, so they can be run in parallel by flush
+
+        add only records the buffers, as other objects may still lock them while the blends are collected,
+        e.g. an entity that applies pose animation to a mesh that is skinned by another one. flush locks
+        them on the calling thread, so the WorkQueue workers only touch the locked memory, and unlocks
+        them afterwards. Source buffers shared by several blends, like the ones of a mesh used by many
+        entities, are locked only once.
+    */
+    class SoftwareVertexBlendQueue
+    {
+    public:
+        SoftwareVertexBlendQueue() {}
+        ~SoftwareVertexBlendQueue() { unlockBuffers(); }
+
+        /// Queues a blend, the parameters are the same as for Mesh::softwareVertexBlend
+        void add(const VertexData* sourceVertexData, const VertexData* targetVertexData,
+                 const Affine3* const* blendMatrices, size_t numMatrices, bool blendNormals);
+
+        /// Locks the buffers, performs the queued blends on the WorkQueue and unlocks the buffers
+        void flush();
+
+        bool empty() const { return mBlends.empty(); }
+
+    private:
+        /// a vertex element of a blend, the pointer is only set while flushing
+        struct Element
+        {
+            HardwareVertexBufferSharedPtr buffer;
+            size_t offset;
+            size_t stride;
+            void* ptr;
+        };
+
+        struct Blend
+        {
+            Element srcPos;
+            Element destPos;
+            Element srcNorm;
+            Element destNorm;
+            Element blendWeight;
+            Element blendIndex;
+            HardwareBuffer::LockOptions destPosOptions;
+            HardwareBuffer::LockOptions destNormOptions;
+            size_t numWeightsPerVertex;
+            size_t numVertices;
+            /// offset of the blend matrices in mMatrices
+            size_t firstMatrix;
+        };
+
+        /// vertex range of a blend, processed as one task
+        struct Slice
+        {
+            size_t blend;
+            size_t begin;
+            size_t end;
+        };
+
+        void* lockForRead(const HardwareVertexBufferSharedPtr& buf);
+        void* lockForWrite(const HardwareVertexBufferSharedPtr& buf, HardwareBuffer::LockOptions options);
+        void unlockBuffers();
+
+        std::vector<Blend> mBlends;
+        std::vector<const Affine3*> mMatrices;
+        std::vector<Slice> mSlices;
+        std::vector<HardwareVertexBufferSharedPtr> mLockedBuffers;
+        std::unordered_map<HardwareVertexBuffer*, void*> mReadLocks;
+
+        SoftwareVertexBlendQueue(const SoftwareVertexBlendQueue&);
+        SoftwareVertexBlendQueue& operator=(const SoftwareVertexBlendQueue&);
+    };
+}
+
+#endif
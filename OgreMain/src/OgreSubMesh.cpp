@@ -82,18 +82,31 @@ namespace Ogre {
         OgreAssert(!useSharedVertices,
                    "This SubMesh uses shared geometry, you must assign bones to the Mesh, not the SubMesh");
         mBoneAssignments.emplace(vertBoneAssign.vertexIndex, vertBoneAssign);
+        mPackedBoneAssignments = PackedBoneAssignments();
         mBoneAssignmentsOutOfDate = true;
     }
     //-----------------------------------------------------------------------
     void SubMesh::clearBoneAssignments(void)
     {
         mBoneAssignments.clear();
+        mPackedBoneAssignments = PackedBoneAssignments();
         mBoneAssignmentsOutOfDate = true;
     }
 
     //-----------------------------------------------------------------------
     void SubMesh::_compileBoneAssignments(void)
     {
+        const auto& packed = mPackedBoneAssignments;
+        if (packed.weightsPerVertex &&
+            packed.data.size() == vertexData->vertexCount * (4 + sizeof(float) * packed.weightsPerVertex))
+        {
+            // as loaded, no need to rationalise them again
+            parent->compileBoneAssignments(mPackedBoneAssignments, blendIndexToBoneIndexMap, vertexData);
+            mPackedBoneAssignments = PackedBoneAssignments();
+            mBoneAssignmentsOutOfDate = false;
+            return;
+        }
+
         unsigned short maxBones =
             parent->_rationaliseBoneAssignments(vertexData->vertexCount, mBoneAssignments);
 
@@ -384,6 +397,7 @@ namespace Ogre {
         newSub->indexData = this->indexData->clone(true, bufferManager);
         // Copy any bone assignments
         newSub->mBoneAssignments = this->mBoneAssignments;
+        newSub->mPackedBoneAssignments = this->mPackedBoneAssignments;
         newSub->mBoneAssignmentsOutOfDate = this->mBoneAssignmentsOutOfDate;
 
         // Copy lod face lists
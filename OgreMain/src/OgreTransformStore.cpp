@@ -0,0 +1,292 @@
+// This file is part of the OGRE project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at https://www.ogre3d.org/licensing.
+// SPDX-License-Identifier: MIT
+#include "OgreStableHeaders.h"
+#include "OgreTransformStore.h"
+#include "OgreSIMDHelper.h"
+
+#if (__OGRE_HAVE_SSE || __OGRE_HAVE_NEON) && OGRE_DOUBLE_PRECISION == 0
+#define OGRE_TRANSFORMSTORE_SIMD 1
+#else
+#define OGRE_TRANSFORMSTORE_SIMD 0
+#endif
+
+namespace Ogre
+{
+    enum
+    {
+        INHERIT_ORIENTATION = 1,
+        INHERIT_SCALE = 2
+    };
+
+    static const size_t GROUP_SIZE = 4;
+
+    TransformStore::TransformStore() {}
+    //-----------------------------------------------------------------------
+    uint32 TransformStore::add(uint32 parent, const Vector3& position, const Quaternion& orientation,
+                               const Vector3& scale, bool inheritOrientation, bool inheritScale)
+    {
+        uint32 index = uint32(size());
+        OgreAssert(parent == NO_PARENT || parent < index, "parent must be added before its children");
+
+        mParents.push_back(parent);
+        mFlags.push_back((inheritOrientation ? INHERIT_ORIENTATION : 0) | (inheritScale ? INHERIT_SCALE : 0));
+
+        for (auto arr : {&mPosition, &mScale, &mDerivedPosition, &mDerivedScale})
+        {
+            arr->x.push_back(0);
+            arr->y.push_back(0);
+            arr->z.push_back(0);
+        }
+        for (auto arr : {&mOrientation, &mDerivedOrientation})
+        {
+            arr->w.push_back(1);
+            arr->x.push_back(0);
+            arr->y.push_back(0);
+            arr->z.push_back(0);
+        }
+
+        setPosition(index, position);
+        setOrientation(index, orientation);
+        setScale(index, scale);
+
+        size_t group = index / GROUP_SIZE;
+        if (group == mIndependentGroups.size())
+            mIndependentGroups.push_back(true);
+        if (parent != NO_PARENT && parent >= group * GROUP_SIZE)
+            mIndependentGroups[group] = false;
+
+        return index;
+    }
+    //-----------------------------------------------------------------------
+    void TransformStore::reserve(size_t count)
+    {
+        mParents.reserve(count);
+        mFlags.reserve(count);
+        for (auto arr : {&mPosition, &mScale, &mDerivedPosition, &mDerivedScale})
+        {
+            arr->x.reserve(count);
+            arr->y.reserve(count);
+            arr->z.reserve(count);
+        }
+        for (auto arr : {&mOrientation, &mDerivedOrientation})
+        {
+            arr->w.reserve(count);
+            arr->x.reserve(count);
+            arr->y.reserve(count);
+            arr->z.reserve(count);
+        }
+        mIndependentGroups.reserve((count + GROUP_SIZE - 1) / GROUP_SIZE);
+    }
+    //-----------------------------------------------------------------------
+    void TransformStore::clear()
+    {
+        mParents.clear();
+        mFlags.clear();
+        for (auto arr : {&mPosition, &mScale, &mDerivedPosition, &mDerivedScale})
+        {
+            arr->x.clear();
+            arr->y.clear();
+            arr->z.clear();
+        }
+        for (auto arr : {&mOrientation, &mDerivedOrientation})
+        {
+            arr->w.clear();
+            arr->x.clear();
+            arr->y.clear();
+            arr->z.clear();
+        }
+        mIndependentGroups.clear();
+    }
+    //-----------------------------------------------------------------------
+    void TransformStore::setInheritance(uint32 index, bool inheritOrientation, bool inheritScale)
+    {
+        mFlags[index] = (inheritOrientation ? INHERIT_ORIENTATION : 0) | (inheritScale ? INHERIT_SCALE : 0);
+    }
+    //-----------------------------------------------------------------------
+    Affine3 TransformStore::getTransform(uint32 index) const
+    {
+        Affine3 ret;
+        ret.makeTransform(getDerivedPosition(index), getDerivedScale(index), getDerivedOrientation(index));
+        return ret;
+    }
+    void TransformStore::getTransforms(Affine3* dst) const
+    {
+        for (uint32 i = 0; i < size(); i++)
+            dst[i] = getTransform(i);
+    }
+    //-----------------------------------------------------------------------
+    void TransformStore::update()
+    {
+        size_t count = size();
+        size_t i = 0;
+#if OGRE_TRANSFORMSTORE_SIMD
+        for (; i + GROUP_SIZE <= count; i += GROUP_SIZE)
+        {
+            if (mIndependentGroups[i / GROUP_SIZE])
+            {
+                updateGroup(i);
+                continue;
+            }
+
+            for (size_t j = i; j < i + GROUP_SIZE; j++)
+                updateEntry(j);
+        }
+#endif
+        for (; i < count; i++)
+            updateEntry(i);
+    }
+    //-----------------------------------------------------------------------
+    void TransformStore::updateEntry(size_t i)
+    {
+        // same operations as Node::updateFromParentImpl
+        uint32 parent = mParents[i];
+        if (parent == NO_PARENT)
+        {
+            mDerivedOrientation.w[i] = mOrientation.w[i];
+            mDerivedOrientation.x[i] = mOrientation.x[i];
+            mDerivedOrientation.y[i] = mOrientation.y[i];
+            mDerivedOrientation.z[i] = mOrientation.z[i];
+            mDerivedPosition.x[i] = mPosition.x[i];
+            mDerivedPosition.y[i] = mPosition.y[i];
+            mDerivedPosition.z[i] = mPosition.z[i];
+            mDerivedScale.x[i] = mScale.x[i];
+            mDerivedScale.y[i] = mScale.y[i];
+            mDerivedScale.z[i] = mScale.z[i];
+            return;
+        }
+
+        Quaternion parentOrientation = getDerivedOrientation(parent);
+        Vector3 parentScale = getDerivedScale(parent);
+
+        Quaternion orientation = getOrientation(uint32(i));
+        if (mFlags[i] & INHERIT_ORIENTATION)
+            orientation = parentOrientation * orientation;
+
+        Vector3 scale = getScale(uint32(i));
+        if (mFlags[i] & INHERIT_SCALE)
+            scale = parentScale * scale;
+
+        Vector3 position = parentOrientation * (parentScale * getPosition(uint32(i))) + getDerivedPosition(parent);
+
+        mDerivedOrientation.w[i] = orientation.w;
+        mDerivedOrientation.x[i] = orientation.x;
+        mDerivedOrientation.y[i] = orientation.y;
+        mDerivedOrientation.z[i] = orientation.z;
+        mDerivedPosition.x[i] = position.x;
+        mDerivedPosition.y[i] = position.y;
+        mDerivedPosition.z[i] = position.z;
+        mDerivedScale.x[i] = scale.x;
+        mDerivedScale.y[i] = scale.y;
+        mDerivedScale.z[i] = scale.z;
+    }
+    //-----------------------------------------------------------------------
+#if OGRE_TRANSFORMSTORE_SIMD
+    /// load the parent values of four lanes, using identity for roots
+    static inline __m128 gatherParent(const std::vector<Real>& src, const uint32* parents, float identity)
+    {
+        // siblings are usually adjacent
+        if (parents[0] == parents[1] && parents[0] == parents[2] && parents[0] == parents[3] &&
+            parents[0] != TransformStore::NO_PARENT)
+            return _mm_set1_ps(src[parents[0]]);
+
+        float v[GROUP_SIZE];
+        for (size_t l = 0; l < GROUP_SIZE; l++)
+            v[l] = parents[l] == TransformStore::NO_PARENT ? identity : src[parents[l]];
+        return _mm_loadu_ps(v);
+    }
+
+    static inline __m128 select(__m128 mask, __m128 a, __m128 b)
+    {
+        return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+    }
+
+    void TransformStore::updateGroup(size_t i)
+    {
+        const uint32* parents = &mParents[i];
+
+        // roots behave like children of an identity transform that inherit everything
+        float inheritO[GROUP_SIZE], inheritS[GROUP_SIZE];
+        for (size_t l = 0; l < GROUP_SIZE; l++)
+        {
+            bool root = parents[l] == NO_PARENT;
+            // all bits set selects the inherited value
+            inheritO[l] = (root || (mFlags[i + l] & INHERIT_ORIENTATION)) ? -1.0f : 0.0f;
+            inheritS[l] = (root || (mFlags[i + l] & INHERIT_SCALE)) ? -1.0f : 0.0f;
+        }
+        __m128 zero = _mm_setzero_ps();
+        __m128 maskO = _mm_cmplt_ps(_mm_loadu_ps(inheritO), zero);
+        __m128 maskS = _mm_cmplt_ps(_mm_loadu_ps(inheritS), zero);
+
+        __m128 pqw = gatherParent(mDerivedOrientation.w, parents, 1);
+        __m128 pqx = gatherParent(mDerivedOrientation.x, parents, 0);
+        __m128 pqy = gatherParent(mDerivedOrientation.y, parents, 0);
+        __m128 pqz = gatherParent(mDerivedOrientation.z, parents, 0);
+        __m128 psx = gatherParent(mDerivedScale.x, parents, 1);
+        __m128 psy = gatherParent(mDerivedScale.y, parents, 1);
+        __m128 psz = gatherParent(mDerivedScale.z, parents, 1);
+        __m128 ppx = gatherParent(mDerivedPosition.x, parents, 0);
+        __m128 ppy = gatherParent(mDerivedPosition.y, parents, 0);
+        __m128 ppz = gatherParent(mDerivedPosition.z, parents, 0);
+
+        // orientation, see Quaternion::operator*
+        __m128 qw = _mm_loadu_ps(&mOrientation.w[i]);
+        __m128 qx = _mm_loadu_ps(&mOrientation.x[i]);
+        __m128 qy = _mm_loadu_ps(&mOrientation.y[i]);
+        __m128 qz = _mm_loadu_ps(&mOrientation.z[i]);
+
+        __m128 dqw = _mm_sub_ps(_mm_sub_ps(_mm_sub_ps(_mm_mul_ps(pqw, qw), _mm_mul_ps(pqx, qx)), _mm_mul_ps(pqy, qy)),
+                                _mm_mul_ps(pqz, qz));
+        __m128 dqx = _mm_sub_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(pqw, qx), _mm_mul_ps(pqx, qw)), _mm_mul_ps(pqy, qz)),
+                                _mm_mul_ps(pqz, qy));
+        __m128 dqy = _mm_sub_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(pqw, qy), _mm_mul_ps(pqy, qw)), _mm_mul_ps(pqz, qx)),
+                                _mm_mul_ps(pqx, qz));
+        __m128 dqz = _mm_sub_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(pqw, qz), _mm_mul_ps(pqz, qw)), _mm_mul_ps(pqx, qy)),
+                                _mm_mul_ps(pqy, qx));
+
+        _mm_storeu_ps(&mDerivedOrientation.w[i], select(maskO, dqw, qw));
+        _mm_storeu_ps(&mDerivedOrientation.x[i], select(maskO, dqx, qx));
+        _mm_storeu_ps(&mDerivedOrientation.y[i], select(maskO, dqy, qy));
+        _mm_storeu_ps(&mDerivedOrientation.z[i], select(maskO, dqz, qz));
+
+        // scale
+        __m128 sx = _mm_loadu_ps(&mScale.x[i]);
+        __m128 sy = _mm_loadu_ps(&mScale.y[i]);
+        __m128 sz = _mm_loadu_ps(&mScale.z[i]);
+        _mm_storeu_ps(&mDerivedScale.x[i], select(maskS, _mm_mul_ps(psx, sx), sx));
+        _mm_storeu_ps(&mDerivedScale.y[i], select(maskS, _mm_mul_ps(psy, sy), sy));
+        _mm_storeu_ps(&mDerivedScale.z[i], select(maskS, _mm_mul_ps(psz, sz), sz));
+
+        // position, see Quaternion::operator*(const Vector3&)
+        __m128 vx = _mm_mul_ps(psx, _mm_loadu_ps(&mPosition.x[i]));
+        __m128 vy = _mm_mul_ps(psy, _mm_loadu_ps(&mPosition.y[i]));
+        __m128 vz = _mm_mul_ps(psz, _mm_loadu_ps(&mPosition.z[i]));
+
+        // uv = qvec x v
+        __m128 uvx = _mm_sub_ps(_mm_mul_ps(pqy, vz), _mm_mul_ps(pqz, vy));
+        __m128 uvy = _mm_sub_ps(_mm_mul_ps(pqz, vx), _mm_mul_ps(pqx, vz));
+        __m128 uvz = _mm_sub_ps(_mm_mul_ps(pqx, vy), _mm_mul_ps(pqy, vx));
+        // uuv = qvec x uv
+        __m128 uuvx = _mm_sub_ps(_mm_mul_ps(pqy, uvz), _mm_mul_ps(pqz, uvy));
+        __m128 uuvy = _mm_sub_ps(_mm_mul_ps(pqz, uvx), _mm_mul_ps(pqx, uvz));
+        __m128 uuvz = _mm_sub_ps(_mm_mul_ps(pqx, uvy), _mm_mul_ps(pqy, uvx));
+
+        __m128 two = _mm_set1_ps(2.0f);
+        __m128 twoW = _mm_mul_ps(two, pqw);
+        vx = _mm_add_ps(_mm_add_ps(vx, _mm_mul_ps(uvx, twoW)), _mm_mul_ps(uuvx, two));
+        vy = _mm_add_ps(_mm_add_ps(vy, _mm_mul_ps(uvy, twoW)), _mm_mul_ps(uuvy, two));
+        vz = _mm_add_ps(_mm_add_ps(vz, _mm_mul_ps(uvz, twoW)), _mm_mul_ps(uuvz, two));
+
+        _mm_storeu_ps(&mDerivedPosition.x[i], _mm_add_ps(vx, ppx));
+        _mm_storeu_ps(&mDerivedPosition.y[i], _mm_add_ps(vy, ppy));
+        _mm_storeu_ps(&mDerivedPosition.z[i], _mm_add_ps(vz, ppz));
+    }
+#else
+    void TransformStore::updateGroup(size_t i)
+    {
+        for (size_t j = i; j < i + GROUP_SIZE; j++)
+            updateEntry(j);
+    }
+#endif
+}
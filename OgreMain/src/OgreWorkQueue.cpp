@@ -29,6 +29,8 @@ THE SOFTWARE.
 #include "OgreWorkQueue.h"
 #include "OgreTimer.h"
 
+#include <thread>
+
 namespace Ogre {
     void WorkQueue::processMainThreadTasks()
     {
@@ -37,6 +39,85 @@ namespace Ogre {
         OGRE_IGNORE_DEPRECATED_END
     }
     //---------------------------------------------------------------------
+    void WorkQueue::addTask(std::function<void()> task, TaskGroup& group)
+    {
+        group._addPending(1);
+        addTask([task, &group]() mutable {
+            task();
+            // release the captures before the waiting thread continues
+            task = nullptr;
+            group._addPending(-1);
+        });
+    }
+    //---------------------------------------------------------------------
+    void WorkQueue::waitForTasks(const TaskGroup& group)
+    {
+        while (!group.isDone())
+            std::this_thread::yield();
+    }
+    //---------------------------------------------------------------------
+    struct TaskGraph::RunState
+    {
+        TaskGraph* graph;
+        WorkQueue* queue;
+        WorkQueue::TaskGroup group;
+        /// dependencies left per task
+        std::unique_ptr<std::atomic<uint32>[]> pending;
+    };
+    //---------------------------------------------------------------------
+    TaskGraph::TaskID TaskGraph::addTask(std::function<void()> task, const std::vector<TaskID>& dependencies)
+    {
+        TaskID id = mTasks.size();
+        for (TaskID dep : dependencies)
+        {
+            OgreAssert(dep < id, "dependencies must be added before");
+            mTasks[dep].successors.push_back(id);
+        }
+        mTasks.push_back({task, {}, uint32(dependencies.size())});
+        return id;
+    }
+    //---------------------------------------------------------------------
+    void TaskGraph::startTask(RunState* state, TaskID id)
+    {
+        state->queue->addTask(
+            [state, id]() {
+                const Task& task = state->graph->mTasks[id];
+                task.func();
+                for (TaskID succ : task.successors)
+                {
+                    // the last dependency to finish starts it
+                    if (--state->pending[succ] == 0)
+                        startTask(state, succ);
+                }
+            },
+            state->group);
+    }
+    //---------------------------------------------------------------------
+    void TaskGraph::run(WorkQueue* queue)
+    {
+        if (!OGRE_THREAD_SUPPORT || !queue)
+        {
+            // dependencies are added before their successors, so this order satisfies them
+            for (const Task& task : mTasks)
+                task.func();
+            return;
+        }
+
+        RunState state;
+        state.graph = this;
+        state.queue = queue;
+        state.pending.reset(new std::atomic<uint32>[mTasks.size()]);
+        for (size_t i = 0; i < mTasks.size(); i++)
+            state.pending[i] = mTasks[i].numDependencies;
+
+        for (size_t i = 0; i < mTasks.size(); i++)
+        {
+            if (!mTasks[i].numDependencies)
+                startTask(&state, i);
+        }
+        queue->waitForTasks(state.group);
+    }
+    //---------------------------------------------------------------------
     WorkQueue::Request::Request(uint16 channel, uint16 rtype, const Any& rData, uint8 retry, RequestID rid)
         : mChannel(channel), mType(rtype), mData(rData), mRetryCount(retry), mID(rid), mAborted(false)
     {
@@ -61,6 +142,99 @@ namespace Ogre {
     }
     //---------------------------------------------------------------------
     //---------------------------------------------------------------------
+    struct DefaultWorkQueueBase::Task
+    {
+        std::function<void()> func;
+        TaskGroup* group;
+    };
+
+    /** Lock-free work stealing deque of tasks, after Chase and Lev with the memory orders of Le et al.
+
+        Only the owning worker pushes and pops at the bottom, any other thread may steal from the top.
+    */
+    class DefaultWorkQueueBase::TaskDeque
+    {
+    public:
+        TaskDeque(const DefaultWorkQueueBase* owner, size_t i) : queue(owner), index(i), mTop(0), mBottom(0) {}
+
+        /// Add a task at the bottom, fails if the deque is full
+        bool push(Task* task)
+        {
+            int64 b = mBottom.load(std::memory_order_relaxed);
+            int64 t = mTop.load(std::memory_order_acquire);
+            if (b - t >= CAPACITY)
+                return false;
+            mTasks[b & (CAPACITY - 1)].store(task, std::memory_order_relaxed);
+            mGroups[b & (CAPACITY - 1)].store(task->group, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+            mBottom.store(b + 1, std::memory_order_relaxed);
+            return true;
+        }
+
+        /// Take the newest task
+        Task* pop()
+        {
+            int64 b = mBottom.load(std::memory_order_relaxed) - 1;
+            mBottom.store(b, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            int64 t = mTop.load(std::memory_order_relaxed);
+            Task* task = NULL;
+            if (t <= b)
+            {
+                task = mTasks[b & (CAPACITY - 1)].load(std::memory_order_relaxed);
+                // the last task, race against the thieves for it
+                if (t == b)
+                {
+                    if (!mTop.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                                      std::memory_order_relaxed))
+                        task = NULL;
+                    mBottom.store(b + 1, std::memory_order_relaxed);
+                }
+            }
+            else
+            {
+                mBottom.store(b + 1, std::memory_order_relaxed);
+            }
+            return task;
+        }
+
+        /** Take the oldest task, may fail spuriously if another thread takes it at the same time
+            @param group only take the task if it belongs to this group, any task if NULL
+        */
+        Task* steal(const TaskGroup* group = NULL)
+        {
+            int64 t = mTop.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            int64 b = mBottom.load(std::memory_order_acquire);
+            if (t >= b)
+                return NULL;
+            // the task may be taken and recycled by another thread until the slot is claimed below, so
+            // its group is read from the slot instead
+            if (group && mGroups[t & (CAPACITY - 1)].load(std::memory_order_relaxed) != group)
+                return NULL;
+            Task* task = mTasks[t & (CAPACITY - 1)].load(std::memory_order_relaxed);
+            if (!mTop.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+                return NULL;
+            return task;
+        }
+
+        const DefaultWorkQueueBase* queue;
+        /// in DefaultWorkQueueBase::mTaskDeques
+        size_t index;
+        /// finished tasks for reuse, only accessed by the owner
+        std::vector<Task*> freeTasks;
+
+    private:
+        static const int64 CAPACITY = 1024;
+        std::atomic<int64> mTop;
+        // thieves write the top, keep it off the cache line of the bottom
+        char mPadding[64];
+        std::atomic<int64> mBottom;
+        std::atomic<Task*> mTasks[CAPACITY];
+        /// Task::group of mTasks
+        std::atomic<TaskGroup*> mGroups[CAPACITY];
+    };
+    //---------------------------------------------------------------------
     DefaultWorkQueueBase::DefaultWorkQueueBase(const String& name)
         : mName(name)
         , mWorkerThreadCount(1)
@@ -71,6 +245,9 @@ namespace Ogre {
         , mAcceptRequests(true)
         , mShuttingDown(false)
     {
+        mNextTaskDeque = 0;
+        mNumPendingTasks = 0;
+        mNumSleepingWorkers = 0;
     }
     //---------------------------------------------------------------------
     const String& DefaultWorkQueueBase::getName() const
@@ -91,6 +268,9 @@ namespace Ogre {
     DefaultWorkQueueBase::~DefaultWorkQueueBase()
     {
         //shutdown(); // can't call here; abstract function
+        destroyTaskDeques();
+        for (Task* task : mTasks)
+            delete task;
     }
     void DefaultWorkQueueBase::addMainThreadTask(std::function<void()> task)
     {
@@ -102,18 +282,225 @@ namespace Ogre {
     //---------------------------------------------------------------------
     void DefaultWorkQueueBase::addTask(std::function<void()> task)
     {
-        OGRE_WQ_LOCK_MUTEX(mRequestMutex);
         if (!mAcceptRequests || mShuttingDown)
             return;
 
 #if OGRE_THREAD_SUPPORT
-        mTasks.push_back(task);
-        notifyWorkers();
+        pushTask(createTask(task, NULL));
 #else
         task(); // no threading, just run it
 #endif
-        LogManager::getSingleton().stream(LML_TRIVIAL)
-            << "DefaultWorkQueueBase('" << mName << "') - QUEUED(thread:" << OGRE_THREAD_CURRENT_ID << ")";
+    }
+    //---------------------------------------------------------------------
+    void DefaultWorkQueueBase::addTask(std::function<void()> task, TaskGroup& group)
+    {
+#if OGRE_THREAD_SUPPORT
+        if (mAcceptRequests && !mShuttingDown)
+        {
+            group._addPending(1);
+            pushTask(createTask(task, &group));
+            return;
+        }
+#endif
+        // someone waits for the group, so run it right away instead of dropping it
+        task();
+    }
+    //---------------------------------------------------------------------
+    void DefaultWorkQueueBase::waitForTasks(const TaskGroup& group)
+    {
+        // help with the tasks of the group instead of blocking, but not with unrelated ones, which may
+        // take much longer than the group
+        while (!group.isDone())
+        {
+            Task* task = takeGroupTask(group);
+            if (!task)
+            {
+                std::this_thread::yield();
+                continue;
+            }
+            mNumPendingTasks--;
+            runTask(task);
+        }
+    }
+    //---------------------------------------------------------------------
+    DefaultWorkQueueBase::TaskDeque*& DefaultWorkQueueBase::currentTaskDeque()
+    {
+        static thread_local TaskDeque* deque = NULL;
+        return deque;
+    }
+    //---------------------------------------------------------------------
+    DefaultWorkQueueBase::TaskDeque* DefaultWorkQueueBase::getWorkerTaskDeque() const
+    {
+        TaskDeque* deque = currentTaskDeque();
+        return deque && deque->queue == this ? deque : NULL;
+    }
+    //---------------------------------------------------------------------
+    void DefaultWorkQueueBase::createTaskDeques()
+    {
+        OgreAssert(mTaskDeques.empty(), "task deques already created");
+        for (size_t i = 0; i < mWorkerThreadCount; ++i)
+            mTaskDeques.push_back(new TaskDeque(this, i));
+        mNextTaskDeque = 0;
+    }
+    //---------------------------------------------------------------------
+    void DefaultWorkQueueBase::destroyTaskDeques()
+    {
+        OGRE_WQ_LOCK_MUTEX(mRequestMutex);
+        for (TaskDeque* deque : mTaskDeques)
+        {
+            // keep the remaining tasks for a restart, like the ones in mTasks
+            while (Task* task = deque->steal())
+                mTasks.push_back(task);
+            for (Task* task : deque->freeTasks)
+                delete task;
+            delete deque;
+        }
+        mTaskDeques.clear();
+    }
+    //---------------------------------------------------------------------
+    void DefaultWorkQueueBase::registerWorkerThread()
+    {
+        size_t index = mNextTaskDeque++;
+        currentTaskDeque() = index < mTaskDeques.size() ? mTaskDeques[index] : NULL;
+    }
+    //---------------------------------------------------------------------
+    DefaultWorkQueueBase::Task* DefaultWorkQueueBase::createTask(std::function<void()>& func, TaskGroup* group)
+    {
+        TaskDeque* deque = getWorkerTaskDeque();
+        Task* task;
+        if (deque && !deque->freeTasks.empty())
+        {
+            task = deque->freeTasks.back();
+            deque->freeTasks.pop_back();
+        }
+        else
+        {
+            task = new Task;
+        }
+        task->func = std::move(func);
+        task->group = group;
+        return task;
+    }
+    //---------------------------------------------------------------------
+    void DefaultWorkQueueBase::pushTask(Task* task)
+    {
+        // counted first, so a worker never sees the task without it
+        mNumPendingTasks++;
+
+        TaskDeque* deque = getWorkerTaskDeque();
+        if (!deque || !deque->push(task))
+        {
+            OGRE_WQ_LOCK_MUTEX(mRequestMutex);
+            mTasks.push_back(task);
+        }
+
+        // waitForNextRequest checks the pending tasks with the lock held
+        if (mNumSleepingWorkers > 0)
+        {
+            OGRE_WQ_LOCK_MUTEX(mRequestMutex);
+            notifyWorkers();
+        }
+    }
+    //---------------------------------------------------------------------
+    DefaultWorkQueueBase::Task* DefaultWorkQueueBase::takeTask()
+    {
+        if (!mNumPendingTasks)
+            return NULL;
+
+        // own tasks first, the newest is the most likely to be in cache
+        TaskDeque* deque = getWorkerTaskDeque();
+        Task* task = deque ? deque->pop() : NULL;
+        if (task)
+            return task;
+
+        {
+            OGRE_WQ_LOCK_MUTEX(mRequestMutex);
+            if (!mTasks.empty())
+            {
+                task = mTasks.front();
+                mTasks.pop_front();
+                return task;
+            }
+        }
+
+        // steal the oldest task of another worker, which likely splits up the most work
+        size_t count = mTaskDeques.size();
+        size_t start = deque ? deque->index : 0;
+        for (size_t i = 1; i <= count && !task; ++i)
+        {
+            TaskDeque* victim = mTaskDeques[(start + i) % count];
+            if (victim != deque)
+                task = victim->steal();
+        }
+        return task;
+    }
+    //---------------------------------------------------------------------
+    DefaultWorkQueueBase::Task* DefaultWorkQueueBase::takeGroupTask(const TaskGroup& group)
+    {
+        if (!mNumPendingTasks)
+            return NULL;
+
+        // the tasks a worker adds to the group before waiting are the newest ones of its deque
+        TaskDeque* deque = getWorkerTaskDeque();
+        while (Task* task = deque ? deque->pop() : NULL)
+        {
+            if (task->group == &group)
+                return task;
+
+            // hand the others to the remaining threads, so they do not hide the tasks of the group
+            OGRE_WQ_LOCK_MUTEX(mRequestMutex);
+            mTasks.push_back(task);
+            if (mNumSleepingWorkers > 0)
+                notifyWorkers();
+        }
+
+        {
+            OGRE_WQ_LOCK_MUTEX(mRequestMutex);
+            auto it = std::find_if(mTasks.begin(), mTasks.end(),
+                                   [&group](const Task* task) { return task->group == &group; });
+            if (it != mTasks.end())
+            {
+                Task* task = *it;
+                mTasks.erase(it);
+                return task;
+            }
+        }
+
+        Task* task = NULL;
+        for (size_t i = 0; i < mTaskDeques.size() && !task; ++i)
+        {
+            if (mTaskDeques[i] != deque)
+                task = mTaskDeques[i]->steal(&group);
+        }
+        return task;
+    }
+    //---------------------------------------------------------------------
+    void DefaultWorkQueueBase::runTask(Task* task)
+    {
+        task->func();
+
+        // release the captures before the waiting thread continues
+        TaskGroup* group = task->group;
+        task->func = nullptr;
+
+        TaskDeque* deque = getWorkerTaskDeque();
+        if (deque && deque->freeTasks.size() < 256)
+            deque->freeTasks.push_back(task);
+        else
+            delete task;
+
+        if (group)
+            group->_addPending(-1);
+    }
+    //---------------------------------------------------------------------
+    bool DefaultWorkQueueBase::processNextTask()
+    {
+        Task* task = takeTask();
+        if (!task)
+            return false;
+        mNumPendingTasks--;
+        runTask(task);
+        return true;
     }
     //---------------------------------------------------------------------
     void DefaultWorkQueueBase::setPaused(bool pause)
@@ -142,19 +529,7 @@ namespace Ogre {
     //---------------------------------------------------------------------
     void DefaultWorkQueueBase::_processNextRequest()
     {
-        std::function<void()> task;
-        {
-            // scoped to only lock while retrieving the next request
-            OGRE_WQ_LOCK_MUTEX(mRequestMutex);
-            if (mTasks.empty())
-                return;
-            LogManager::getSingleton().stream(LML_TRIVIAL)
-                << "DefaultWorkQueueBase('" << mName << "') - PROCESS_TASK(thread:" << OGRE_THREAD_CURRENT_ID
-                << ")";
-            task = std::move(mTasks.front());
-            mTasks.pop_front();
-        }
-        task();
+        processNextTask();
     }
     //---------------------------------------------------------------------
     void DefaultWorkQueueBase::processMainThreadTasks()
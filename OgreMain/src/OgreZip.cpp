@@ -28,19 +28,60 @@ THE SOFTWARE.
 #include "OgreStableHeaders.h"
 
 #if OGRE_NO_ZIP_ARCHIVE == 0
-#include <zip.h>
+#include "OgreDeflate.h"
+
+#define MINIZ_HEADER_FILE_ONLY
+#include <miniz.h>
 
 namespace Ogre {
 namespace {
+    size_t gLazyInflateThreshold = 0;
+
+    /// Read-only view of an entry in the archive buffer, keeping the buffer alive
+    class ZipEntryDataStream : public MemoryDataStream
+    {
+        MemoryDataStreamPtr mArchiveBuffer;
+    public:
+        ZipEntryDataStream(const String& name, const MemoryDataStreamPtr& buffer, size_t offset, size_t size)
+            : MemoryDataStream(name, buffer->getPtr() + offset, size, false, true), mArchiveBuffer(buffer)
+        {
+        }
+    };
+
+    /// Inflates a deflated entry on read
+    class ZipInflateDataStream : public DeflateStream
+    {
+    public:
+        ZipInflateDataStream(const String& name, const DataStreamPtr& compressed, size_t uncompressedSize)
+            : DeflateStream(name, compressed, Deflate)
+        {
+            mSize = uncompressedSize;
+        }
+    };
+
     class ZipArchive : public Archive
     {
     protected:
-        /// Handle to root zip file
-        zip_t* mZipFile;
+        /// Location of an entry in mBuffer
+        struct Entry
+        {
+            size_t localHeaderOffset;
+            size_t compressedSize;
+            size_t uncompressedSize;
+            uint32 crc32;
+            uint16 method;
+        };
+        /// Contents of the zip file
         MemoryDataStreamPtr mBuffer;
-        /// File list (since zziplib seems to only allow scanning of dir tree once)
+        /// File list, built once on load
         FileInfoList mFileList;
+        /// Entries of files by normalised name, lower case unless OGRE_RESOURCEMANAGER_STRICT
+        std::unordered_map<String, Entry> mEntries;
+        bool mLoaded;
         OGRE_AUTO_MUTEX;
+
+        static String entryKey(const String& filename);
+        const Entry* findEntry(const String& filename) const;
     public:
         ZipArchive(const String& name, const String& archType, const uint8* externBuf = 0, size_t externBufSz = 0);
         ~ZipArchive();
@@ -84,7 +125,7 @@ namespace {
 }
     //-----------------------------------------------------------------------
     ZipArchive::ZipArchive(const String& name, const String& archType, const uint8* externBuf, size_t externBufSz)
-        : Archive(name, archType), mZipFile(0)
+        : Archive(name, archType), mLoaded(false)
     {
         if(externBuf)
             mBuffer.reset(new MemoryDataStream(const_cast<uint8*>(externBuf), externBufSz));
@@ -95,33 +136,63 @@ namespace {
         unload();
     }
     //-----------------------------------------------------------------------
+    String ZipArchive::entryKey(const String& filename)
+    {
+        // same normalisation as zip_entry_open
+        size_t start = filename.find_first_not_of("/\\");
+        String key = start == String::npos ? BLANKSTRING : filename.substr(start);
+        std::replace(key.begin(), key.end(), '\\', '/');
+#if !OGRE_RESOURCEMANAGER_STRICT
+        StringUtil::toLowerCase(key);
+#endif
+        return key;
+    }
+    //-----------------------------------------------------------------------
+    const ZipArchive::Entry* ZipArchive::findEntry(const String& filename) const
+    {
+        auto it = mEntries.find(entryKey(filename));
+        return it == mEntries.end() ? NULL : &it->second;
+    }
+    //-----------------------------------------------------------------------
     void ZipArchive::load()
     {
         OGRE_LOCK_AUTO_MUTEX;
-        if (!mZipFile)
+        if (!mLoaded)
         {
             if(!mBuffer)
-                mBuffer.reset(new MemoryDataStream(_openFileStream(mName, std::ios::binary)));
+            {
+                if (FileSystemArchiveFactory::getUseMmap())
+                    mBuffer = std::make_shared<MmapDataStream>(mName, mName);
+                else
+                    mBuffer.reset(new MemoryDataStream(_openFileStream(mName, std::ios::binary)));
+            }
 
-            mZipFile = zip_stream_open((const char*)mBuffer->getPtr(), mBuffer->size(), 0, 'r');
+            // Only the central directory is read here. Entries are inflated by open, straight from mBuffer,
+            // so concurrent opens do not share any decompression state.
+            mz_zip_archive zip;
+            memset(&zip, 0, sizeof(zip));
+            if (!mz_zip_reader_init_mem(&zip, mBuffer->getPtr(), mBuffer->size(), 0))
+                OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, "could not open zip archive " + mName);
 
             // Cache names
-            int n = zip_entries_total(mZipFile);
-            for (int i = 0; i < n; ++i) {
+            mz_uint n = mz_zip_reader_get_num_files(&zip);
+            for (mz_uint i = 0; i < n; ++i) {
+                mz_zip_archive_file_stat stat;
+                if (!mz_zip_reader_file_stat(&zip, i, &stat))
+                    continue;
+
                 FileInfo info;
                 info.archive = this;
 
-                zip_entry_openbyindex(mZipFile, i);
-
-                info.filename = zip_entry_name(mZipFile);
+                info.filename = stat.m_filename;
                 // Get basename / path
                 StringUtil::splitFilename(info.filename, info.basename, info.path);
 
                 // Get sizes
-                info.uncompressedSize = zip_entry_size(mZipFile);
-                info.compressedSize = zip_entry_comp_size(mZipFile);
+                info.uncompressedSize = stat.m_uncomp_size;
+                info.compressedSize = stat.m_comp_size;
 
-                if (zip_entry_isdir(mZipFile))
+                if (stat.m_is_directory)
                 {
                     info.filename = info.filename.substr(0, info.filename.length() - 1);
                     StringUtil::splitFilename(info.filename, info.basename, info.path);
@@ -129,40 +200,46 @@ namespace {
                     // the compressed size of a folder, and if he does, its useless anyway
                     info.compressedSize = size_t(-1);
                 }
-#if !OGRE_RESOURCEMANAGER_STRICT
                 else
                 {
+                    Entry& entry = mEntries[entryKey(stat.m_filename)];
+                    entry.localHeaderOffset = stat.m_local_header_ofs;
+                    entry.compressedSize = stat.m_comp_size;
+                    entry.uncompressedSize = stat.m_uncomp_size;
+                    entry.crc32 = stat.m_crc32;
+                    // mark encrypted entries as unsupported
+                    entry.method = stat.m_is_encrypted ? uint16(-1) : stat.m_method;
+#if !OGRE_RESOURCEMANAGER_STRICT
                     info.filename = info.basename;
-                }
 #endif
-                zip_entry_close(mZipFile);
+                }
                 mFileList.push_back(info);
             }
+            mz_zip_reader_end(&zip);
+            mLoaded = true;
         }
     }
     //-----------------------------------------------------------------------
     void ZipArchive::unload()
     {
         OGRE_LOCK_AUTO_MUTEX;
-        if (mZipFile)
+        if (mLoaded)
         {
-            zip_close(mZipFile);
-            mZipFile = 0;
+            mLoaded = false;
+            mEntries.clear();
             mFileList.clear();
             mBuffer.reset();
         }
-    
     }
     //-----------------------------------------------------------------------
     DataStreamPtr ZipArchive::open(const String& filename, bool readOnly) const
     {
-        // zip is not threadsafe
-        OGRE_LOCK_AUTO_MUTEX;
+        // no lock: entries are immutable after load and each open inflates on its own
         String lookUpFileName = filename;
 
-        bool open = zip_entry_open(mZipFile, lookUpFileName.c_str(), OGRE_RESOURCEMANAGER_STRICT) == 0;
+        const Entry* entry = findEntry(lookUpFileName);
 #if !OGRE_RESOURCEMANAGER_STRICT
-        if (!open) // Try if we find the file
+        if (!entry) // Try if we find the file
         {
             String basename, path;
             StringUtil::splitFilename(lookUpFileName, basename, path);
@@ -171,22 +248,48 @@ namespace {
             {
                 Ogre::FileInfo info = fileNfo->at(0);
                 lookUpFileName = info.path + info.basename;
-                open = zip_entry_open(mZipFile, lookUpFileName.c_str(), OGRE_RESOURCEMANAGER_STRICT) == 0;
+                entry = findEntry(lookUpFileName);
             }
         }
 #endif
 
-        if (!open)
+        if (!entry)
         {
             OGRE_EXCEPT(Exception::ERR_FILE_NOT_FOUND, "could not open "+lookUpFileName);
         }
 
+        // locate the data behind the local file header
+        const uchar* header = mBuffer->getPtr() + entry->localHeaderOffset;
+        size_t offset = entry->localHeaderOffset + 30;
+        if (offset > mBuffer->size() || header[0] != 'P' || header[1] != 'K' || header[2] != 3 || header[3] != 4)
+            OGRE_EXCEPT(Exception::ERR_FILE_NOT_FOUND, "could not read "+lookUpFileName);
+        offset += (header[26] | header[27] << 8) + (header[28] | header[29] << 8);
+        if (offset + entry->compressedSize > mBuffer->size() ||
+            (entry->method != MZ_NO_COMPRESSION && entry->method != MZ_DEFLATED))
+            OGRE_EXCEPT(Exception::ERR_FILE_NOT_FOUND, "could not read "+lookUpFileName);
+
+        if (entry->method == MZ_NO_COMPRESSION && readOnly)
+            return std::make_shared<ZipEntryDataStream>(lookUpFileName, mBuffer, offset, entry->compressedSize);
+
+        if (entry->method == MZ_DEFLATED && gLazyInflateThreshold &&
+            entry->uncompressedSize >= gLazyInflateThreshold)
+        {
+            auto compressed = std::make_shared<ZipEntryDataStream>(lookUpFileName, mBuffer, offset,
+                                                                   entry->compressedSize);
+            return std::make_shared<ZipInflateDataStream>(lookUpFileName, compressed, entry->uncompressedSize);
+        }
+
         // Construct & return stream
-        auto ret = std::make_shared<MemoryDataStream>(lookUpFileName, zip_entry_size(mZipFile));
+        auto ret = std::make_shared<MemoryDataStream>(lookUpFileName, entry->uncompressedSize);
+        const uchar* src = mBuffer->getPtr() + offset;
+        if (entry->method == MZ_NO_COMPRESSION)
+            memcpy(ret->getPtr(), src, entry->uncompressedSize);
+        else if (tinfl_decompress_mem_to_mem(ret->getPtr(), ret->size(), src, entry->compressedSize, 0) !=
+                 entry->uncompressedSize)
+            OGRE_EXCEPT(Exception::ERR_FILE_NOT_FOUND, "could not read "+lookUpFileName);
 
-        if(zip_entry_noallocread(mZipFile, ret->getPtr(), ret->size()) < 0)
+        if (mz_crc32(MZ_CRC32_INIT, ret->getPtr(), ret->size()) != entry->crc32)
             OGRE_EXCEPT(Exception::ERR_FILE_NOT_FOUND, "could not read "+lookUpFileName);
-        zip_entry_close(mZipFile);
 
         return ret;
     }
@@ -203,7 +306,6 @@ namespace {
     //-----------------------------------------------------------------------
     StringVectorPtr ZipArchive::list(bool recursive, bool dirs) const
     {
-        OGRE_LOCK_AUTO_MUTEX;
         auto ret = std::make_shared<StringVector>();
 
         for (auto& f : mFileList)
@@ -216,7 +318,6 @@ namespace {
     //-----------------------------------------------------------------------
     FileInfoListPtr ZipArchive::listFileInfo(bool recursive, bool dirs) const
     {
-        OGRE_LOCK_AUTO_MUTEX;
         auto ret = std::make_shared<FileInfoList>();
         for (auto& f : mFileList)
             if ((dirs == (f.compressedSize == size_t (-1))) &&
@@ -228,7 +329,6 @@ namespace {
     //-----------------------------------------------------------------------
     StringVectorPtr ZipArchive::find(const String& pattern, bool recursive, bool dirs) const
     {
-        OGRE_LOCK_AUTO_MUTEX;
         auto ret = std::make_shared<StringVector>();
         // If pattern contains a directory name, do a full match
         bool full_match = (pattern.find ('/') != String::npos) ||
@@ -248,7 +348,6 @@ namespace {
     FileInfoListPtr ZipArchive::findFileInfo(const String& pattern, 
         bool recursive, bool dirs) const
     {
-        OGRE_LOCK_AUTO_MUTEX;
         auto ret = std::make_shared<FileInfoList>();
         // If pattern contains a directory name, do a full match
         bool full_match = (pattern.find ('/') != String::npos) ||
@@ -267,7 +366,6 @@ namespace {
     //-----------------------------------------------------------------------
     bool ZipArchive::exists(const String& filename) const
     {       
-        OGRE_LOCK_AUTO_MUTEX;
         String cleanName = filename;
 #if !OGRE_RESOURCEMANAGER_STRICT
         if(filename.rfind('/') != String::npos)
@@ -316,6 +414,16 @@ namespace {
         return name;
     }
     //-----------------------------------------------------------------------
+    void ZipArchiveFactory::setLazyInflateThreshold(size_t bytes)
+    {
+        gLazyInflateThreshold = bytes;
+    }
+    //-----------------------------------------------------------------------
+    size_t ZipArchiveFactory::getLazyInflateThreshold()
+    {
+        return gLazyInflateThreshold;
+    }
+    //-----------------------------------------------------------------------
     //-----------------------------------------------------------------------
     //  EmbeddedZipArchiveFactory
     //-----------------------------------------------------------------------
@@ -389,11 +389,13 @@ namespace Ogre {
     {
         Image* image = any_cast<Image*>(output);
 
-        // Buffer stream into memory (TODO: override IO functions instead?)
-        MemoryDataStream memStream(input, true);
+        // Buffer stream into memory, unless it already is in memory or mapped
+        MemoryDataStreamPtr memStream = dynamic_pointer_cast<MemoryDataStream>(input);
+        if (!memStream)
+            memStream = std::make_shared<MemoryDataStream>(input, true);
 
-        FIMEMORY* fiMem = 
-            FreeImage_OpenMemory(memStream.getPtr(), static_cast<DWORD>(memStream.size()));
+        FIMEMORY* fiMem = FreeImage_OpenMemory(memStream->getCurrentPtr(),
+                                               static_cast<DWORD>(memStream->size() - memStream->tell()));
 
         FIBITMAP* fiBitmap = FreeImage_LoadFromMemory(
             (FREE_IMAGE_FORMAT)mFreeImageType, fiMem);
@@ -185,6 +185,16 @@ protected:
 
     Octree::NodeList mVisible;
 
+    /** Frustum culls the nodes of an octant in one batch.
+    @return mask with bit (i % 32) of word (i / 32) set if node i is visible. Valid until the next call.
+    */
+    const uint32* cullNodes( OctreeCamera *camera, const Octree::NodeList &nodes );
+
+    /// Scratch data of cullNodes
+    std::vector<float> mCullCentres;
+    std::vector<float> mCullHalfSizes;
+    std::vector<uint32> mCullMask;
+
     /// The root octree
     Octree *mOctree;
 
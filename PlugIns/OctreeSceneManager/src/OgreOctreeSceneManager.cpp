@@ -39,6 +39,7 @@ email                : janders@users.sf.net
 #include "OgreOctreeNode.h"
 #include "OgreOctreeCamera.h"
 #include "OgreWireBoundingBox.h"
+#include "OgreOptimisedUtil.h"
 
 namespace Ogre
 {
@@ -552,6 +553,51 @@ void OctreeSceneManager::_findVisibleObjects(Camera * cam,
     }
 }
 
+const uint32* OctreeSceneManager::cullNodes( OctreeCamera *camera, const Octree::NodeList &nodes )
+{
+    // the same planes Camera::isVisible tests against
+    Vector4 planes[ 6 ];
+    size_t numPlanes = 0;
+    for ( unsigned short plane = 0; plane < 6; ++plane )
+    {
+        // Skip far plane if infinite view frustum
+        if ( plane == FRUSTUM_PLANE_FAR && camera -> getFarClipDistance() == 0 )
+            continue;
+
+        const Plane& p = camera -> getFrustumPlane( plane );
+        planes[ numPlanes++ ] = Vector4( p.normal.x, p.normal.y, p.normal.z, p.d );
+    }
+
+    size_t numNodes = nodes.size();
+    mCullCentres.resize( numNodes * 3 );
+    mCullHalfSizes.resize( numNodes * 3 );
+    mCullMask.resize( ( numNodes + 31 ) / 32 );
+
+    for ( size_t i = 0; i < numNodes; ++i )
+    {
+        const AxisAlignedBox& box = nodes[ i ] -> _getWorldAABB();
+        Vector3 centre = box.isFinite() ? box.getCenter() : Vector3::ZERO;
+        Vector3 halfSize = box.isFinite() ? box.getHalfSize() : Vector3::ZERO;
+        std::copy( centre.ptr(), centre.ptr() + 3, &mCullCentres[ i * 3 ] );
+        std::copy( halfSize.ptr(), halfSize.ptr() + 3, &mCullHalfSizes[ i * 3 ] );
+    }
+
+    OptimisedUtil::getImplementation() -> cullBoxes( planes, numPlanes, mCullCentres.data(),
+        mCullHalfSizes.data(), numNodes, mCullMask.data() );
+
+    // Null boxes are always invisible, infinite boxes always visible
+    for ( size_t i = 0; i < numNodes; ++i )
+    {
+        const AxisAlignedBox& box = nodes[ i ] -> _getWorldAABB();
+        if ( box.isNull() )
+            mCullMask[ i / 32 ] &= ~( 1u << ( i % 32 ) );
+        else if ( box.isInfinite() )
+            mCullMask[ i / 32 ] |= 1u << ( i % 32 );
+    }
+
+    return mCullMask.data();
+}
+
 void OctreeSceneManager::walkOctree( OctreeCamera *camera, RenderQueue *queue, 
     Octree *octant, VisibleObjectsBoundsInfo* visibleBounds, 
     bool foundvisible, bool onlyShadowCasters )
@@ -595,15 +641,18 @@ void OctreeSceneManager::walkOctree( OctreeCamera *camera, RenderQueue *queue,
 
         bool vis = true;
 
-        while ( it != octant -> mNodes.end() )
+        // if this octree is partially visible, manually cull all
+        // scene nodes attached directly to this level.
+        const uint32* visibleMask = NULL;
+        if ( v == OctreeCamera::PARTIAL )
+            visibleMask = cullNodes( camera, octant -> mNodes );
+
+        for ( size_t i = 0; it != octant -> mNodes.end(); ++i )
         {
             OctreeNode * sn = *it;
 
-            // if this octree is partially visible, manually cull all
-            // scene nodes attached directly to this level.
-
-            if ( v == OctreeCamera::PARTIAL )
-                vis = camera -> isVisible( sn -> _getWorldAABB() );
+            if ( visibleMask )
+                vis = ( visibleMask[ i / 32 ] & ( 1u << ( i % 32 ) ) ) != 0;
 
             if ( vis )
             {
@@ -83,6 +83,8 @@ namespace Ogre {
         ColourFaderAffector(ParticleSystem* psys);
 
         void _affectParticles(ParticleSystem* pSystem, Real timeElapsed) override;
+        bool _supportsParticleStreams(void) const override { return true; }
+        void _affectParticleStreams(ParticleStreams& streams, Real timeElapsed) override;
 
         /** Sets the colour adjustment to be made per second to particles. 
         @param red, green, blue, alpha
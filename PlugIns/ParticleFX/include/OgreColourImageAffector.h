@@ -55,6 +55,9 @@ namespace Ogre {
 
         void _affectParticles(ParticleSystem* pSystem, Real timeElapsed) override;
 
+        /// Loads the image, so the other methods can run on any thread
+        void _prepare(void) override;
+
         void setImageAdjust(String name);
         String getImageAdjust(void) const;
         
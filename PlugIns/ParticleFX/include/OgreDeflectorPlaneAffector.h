@@ -73,6 +73,8 @@ namespace Ogre {
         DeflectorPlaneAffector(ParticleSystem* psys);
 
         void _affectParticles(ParticleSystem* pSystem, Real timeElapsed) override;
+        bool _supportsParticleStreams(void) const override { return true; }
+        void _affectParticleStreams(ParticleStreams& streams, Real timeElapsed) override;
 
         /** Sets the plane point of the deflector plane. */
         void setPlanePoint(const Vector3& pos);
@@ -82,6 +82,8 @@ namespace Ogre {
         LinearForceAffector(ParticleSystem* psys);
 
         void _affectParticles(ParticleSystem* pSystem, Real timeElapsed) override;
+        bool _supportsParticleStreams(void) const override { return true; }
+        void _affectParticleStreams(ParticleStreams& streams, Real timeElapsed) override;
 
 
         /** Sets the force vector to apply to the particles in a system. */
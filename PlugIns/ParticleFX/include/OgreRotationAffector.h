@@ -84,6 +84,8 @@ namespace Ogre {
         void _initParticle(Particle* pParticle) override;
 
         void _affectParticles(ParticleSystem* pSystem, Real timeElapsed) override;
+        bool _supportsParticleStreams(void) const override { return true; }
+        void _affectParticleStreams(ParticleStreams& streams, Real timeElapsed) override;
 
 
 
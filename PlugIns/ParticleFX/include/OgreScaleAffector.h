@@ -59,6 +59,8 @@ namespace Ogre {
 
         void _initParticle(Particle* pParticle) override;
         void _affectParticles(ParticleSystem* pSystem, Real timeElapsed) override;
+        bool _supportsParticleStreams(void) const override { return true; }
+        void _affectParticleStreams(ParticleStreams& streams, Real timeElapsed) override;
 
         /** Sets the scale adjustment to be made per second to particles. 
         @param rate
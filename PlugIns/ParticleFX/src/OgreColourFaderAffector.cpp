@@ -29,6 +29,7 @@ THE SOFTWARE.
 #include "OgreParticleSystem.h"
 #include "OgreStringConverter.h"
 #include "OgreParticle.h"
+#include "OgreParticleStreams.h"
 
 
 namespace Ogre {
@@ -78,6 +79,11 @@ namespace Ogre {
         }
     }
     //-----------------------------------------------------------------------
+    void ColourFaderAffector::_affectParticleStreams(ParticleStreams& streams, Real timeElapsed)
+    {
+        streams.adjustColour(ColourValue(mRedAdj, mGreenAdj, mBlueAdj, mAlphaAdj) * timeElapsed);
+    }
+    //-----------------------------------------------------------------------
     void ColourFaderAffector::setAdjust(float red, float green, float blue, float alpha)
     {
         mRedAdj = red;
@@ -52,24 +52,22 @@ namespace Ogre {
         }
     }
     //-----------------------------------------------------------------------
-    void ColourImageAffector::_initParticle(Particle* pParticle)
+    void ColourImageAffector::_prepare(void)
     {
         if (!mColourImageLoaded)
         {
             _loadImage();
         }
-
+    }
+    //-----------------------------------------------------------------------
+    void ColourImageAffector::_initParticle(Particle* pParticle)
+    {
         pParticle->mColour = mColourImage.getColourAt(0, 0, 0).getAsBYTE();
     
     }
     //-----------------------------------------------------------------------
     void ColourImageAffector::_affectParticles(ParticleSystem* pSystem, Real timeElapsed)
     {
-        if (!mColourImageLoaded)
-        {
-            _loadImage();
-        }
-
         int                width            = (int)mColourImage.getWidth()  - 1;
         
         for (auto p : pSystem->_getActiveParticles())
@@ -28,6 +28,7 @@ THE SOFTWARE.
 #include "OgreDeflectorPlaneAffector.h"
 #include "OgreParticleSystem.h"
 #include "OgreParticle.h"
+#include "OgreParticleStreams.h"
 #include "OgreStringConverter.h"
 
 
@@ -88,6 +89,13 @@ namespace Ogre {
         }
     }
     //-----------------------------------------------------------------------
+    void DeflectorPlaneAffector::_affectParticleStreams(ParticleStreams& streams, Real timeElapsed)
+    {
+        // precalculate distance of plane from origin
+        Real planeDistance = - mPlaneNormal.dotProduct(mPlanePoint) / Math::Sqrt(mPlaneNormal.dotProduct(mPlaneNormal));
+        streams.deflect(mPlaneNormal, planeDistance, mBounce, timeElapsed);
+    }
+    //-----------------------------------------------------------------------
     void DeflectorPlaneAffector::setPlanePoint(const Vector3& pos)
     {
         mPlanePoint = pos;
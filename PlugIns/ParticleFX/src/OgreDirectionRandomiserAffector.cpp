@@ -73,7 +73,7 @@ namespace Ogre {
 
         for (auto p : pSystem->_getActiveParticles())
         {
-            if (mScope > Math::UnitRandom())
+            if (mScope > pSystem->_unitRandom())
             {
                 if (!p->mDirection.isZeroLength())
                 {
@@ -82,9 +82,9 @@ namespace Ogre {
                         length = p->mDirection.length();
                     }
 
-                    p->mDirection += Vector3(Math::RangeRandom(-mRandomness, mRandomness) * timeElapsed,
-                        Math::RangeRandom(-mRandomness, mRandomness) * timeElapsed,
-                        Math::RangeRandom(-mRandomness, mRandomness) * timeElapsed);
+                    p->mDirection += Vector3(pSystem->_rangeRandom(-mRandomness, mRandomness) * timeElapsed,
+                        pSystem->_rangeRandom(-mRandomness, mRandomness) * timeElapsed,
+                        pSystem->_rangeRandom(-mRandomness, mRandomness) * timeElapsed);
 
                     if (mKeepVelocity)
                     {
@@ -28,6 +28,7 @@ THE SOFTWARE.
 // Original author: Tels <http://bloodgate.com>, released as public domain
 #include "OgreEllipsoidEmitter.h"
 #include "OgreParticle.h"
+#include "OgreParticleSystem.h"
 #include "OgreException.h"
 #include "OgreStringConverter.h"
 
@@ -66,9 +67,9 @@ namespace Ogre {
         {
             // three random values for one random point in 3D space
 
-            x = Math::SymmetricRandom();
-            y = Math::SymmetricRandom();
-            z = Math::SymmetricRandom();
+            x = mParent->_symmetricRandom();
+            y = mParent->_symmetricRandom();
+            z = mParent->_symmetricRandom();
 
             // the distance of x,y,z from 0,0,0 is sqrt(x*x+y*y+z*z), but
             // as usual we can omit the sqrt(), since sqrt(1) == 1 and we
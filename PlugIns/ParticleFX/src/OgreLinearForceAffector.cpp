@@ -28,6 +28,7 @@ THE SOFTWARE.
 #include "OgreLinearForceAffector.h"
 #include "OgreParticleSystem.h"
 #include "OgreParticle.h"
+#include "OgreParticleStreams.h"
 #include "OgreStringConverter.h"
 
 
@@ -91,6 +92,14 @@ namespace Ogre {
         
     }
     //-----------------------------------------------------------------------
+    void LinearForceAffector::_affectParticleStreams(ParticleStreams& streams, Real timeElapsed)
+    {
+        if (mForceApplication == FA_ADD)
+            streams.addDirection(mForceVector * timeElapsed);
+        else // FA_AVERAGE
+            streams.averageDirection(mForceVector);
+    }
+    //-----------------------------------------------------------------------
     void LinearForceAffector::setForceVector(const Vector3& force)
     {
         mForceVector = force;
@@ -29,6 +29,7 @@ THE SOFTWARE.
 #include "OgreParticleSystem.h"
 #include "OgreStringConverter.h"
 #include "OgreParticle.h"
+#include "OgreParticleStreams.h"
 
 
 namespace Ogre {
@@ -77,11 +78,11 @@ namespace Ogre {
     {
         pParticle->setRotation(
             mRotationRangeStart + 
-            (Math::UnitRandom() * 
+            (mParent->_unitRandom() * 
                 (mRotationRangeEnd - mRotationRangeStart)));
         pParticle->mRotationSpeed =
             mRotationSpeedRangeStart + 
-            (Math::UnitRandom() * 
+            (mParent->_unitRandom() * 
                 (mRotationSpeedRangeEnd - mRotationSpeedRangeStart));
         
     }
@@ -103,6 +104,11 @@ namespace Ogre {
 
     }
     //-----------------------------------------------------------------------
+    void RotationAffector::_affectParticleStreams(ParticleStreams& streams, Real timeElapsed)
+    {
+        streams.applyRotationSpeed(timeElapsed);
+    }
+    //-----------------------------------------------------------------------
     const Radian& RotationAffector::getRotationSpeedRangeStart(void) const
     {
         return mRotationSpeedRangeStart;
@@ -29,6 +29,7 @@ THE SOFTWARE.
 #include "OgreParticleSystem.h"
 #include "OgreStringConverter.h"
 #include "OgreParticle.h"
+#include "OgreParticleStreams.h"
 
 
 namespace Ogre {
@@ -61,7 +62,7 @@ namespace Ogre {
     {
         float w = p->getOwnWidth();
         float h = p->getOwnHeight();
-        float s = Math::RangeRandom(mScaleRange[0], mScaleRange[1]);
+        float s = mParent->_rangeRandom(mScaleRange[0], mScaleRange[1]);
         p->setDimensions(s * w, s * h);
     }
     //-----------------------------------------------------------------------
@@ -78,6 +79,11 @@ namespace Ogre {
         }
     }
     //-----------------------------------------------------------------------
+    void ScaleAffector::_affectParticleStreams(ParticleStreams& streams, Real timeElapsed)
+    {
+        streams.adjustDimensions(mScaleAdj * timeElapsed);
+    }
+    //-----------------------------------------------------------------------
     void ScaleAffector::setAdjust( Real rate )
     {
         mScaleAdj = rate;
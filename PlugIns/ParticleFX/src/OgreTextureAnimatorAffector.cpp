@@ -95,7 +95,7 @@ public:
         if (!mRandomStartOffset)
             return;
 
-        pParticle->mRandomTexcoordOffset = Math::UnitRandom() * mTexcoordCount;
+        pParticle->mRandomTexcoordOffset = mParent->_unitRandom() * mTexcoordCount;
         pParticle->mTexcoordIndex = pParticle->mRandomTexcoordOffset;
     }
 
@@ -167,11 +167,24 @@ namespace Ogre {
     void STBIImageCodec::decode(const DataStreamPtr& input, const Any& output) const
     {
         auto image = any_cast<Image*>(output);
-        String contents = input->getAsString();
+        // decode straight from the stream memory, if it has any
+        String contents;
+        const uchar* data;
+        size_t size;
+        if (auto memStream = dynamic_cast<MemoryDataStream*>(input.get()))
+        {
+            data = memStream->getPtr();
+            size = memStream->size();
+        }
+        else
+        {
+            contents = input->getAsString();
+            data = (const uchar*)contents.data();
+            size = contents.size();
+        }
 
         int width, height, components;
-        stbi_uc* pixelData = stbi_load_from_memory((const uchar*)contents.data(),
-                static_cast<int>(contents.size()), &width, &height, &components, 0);
+        stbi_uc* pixelData = stbi_load_from_memory(data, static_cast<int>(size), &width, &height, &components, 0);
 
         if (!pixelData)
         {
@@ -10,6 +10,8 @@
 #include "OgreRenderSystem.h"
 #include "OgreImage.h"
 
+#include <deque>
+
 namespace Ogre {
     /** \addtogroup RenderSystems RenderSystems
     *  @{
@@ -19,6 +21,7 @@ namespace Ogre {
     *  @{
     */
     class HardwareBufferManager;
+    class TinyRasterizer;
 
     struct IShader {
         // typedefs to make Ogre types more GLSLy
@@ -35,13 +38,53 @@ namespace Ogre {
             return (b + (a % b)) % b;
         }
 
+        /// vertex shader outputs that are interpolated across the triangle
+        struct Varying
+        {
+            vec2 uv;
+            vec3 normal;
+        };
+
+        /// fragments of one triangle that are shaded together, stored as SoA
+        struct FragmentBatch
+        {
+            static const int SIZE = 8;
+
+            int count;
+            /// perspective correct barycentric coordinates
+            float bar[3][SIZE];
+            ColourValue colour[SIZE];
+            /// set by the shader for fragments that should be discarded
+            bool discard[SIZE];
+        };
+
         static const vec4b& sample2D(const Image& img, const vec2& uv)
         {
             Vector2i uvi(uv.x * (img.getWidth() - 1), uv.y * (img.getHeight() - 1));
             return *img.getData<const vec4b>(mod(uvi[0], img.getWidth()), mod(uvi[1], img.getHeight()));
         }
 
-        virtual bool fragment(const vec3& bar, ColourValue& gl_FragColor) = 0;
+        /** shade a fragment
+            @param var the varyings of the three triangle vertices
+            @param bar perspective correct barycentric coordinates of the fragment
+            @param gl_FragColor the output colour
+            @return true if the fragment should be discarded
+        */
+        virtual bool fragment(const Varying var[3], const vec3& bar, ColourValue& gl_FragColor) const = 0;
+
+        /** shade up to FragmentBatch::SIZE fragments at once
+
+            The default implementation calls fragment() for each of them. Override it to process the
+            batch in a vectorisable loop.
+        */
+        virtual void fragmentBatch(const Varying var[3], FragmentBatch& batch) const
+        {
+            for (int i = 0; i < batch.count; i++)
+            {
+                vec3 bar(batch.bar[0][i], batch.bar[1][i], batch.bar[2][i]);
+                batch.discard[i] = fragment(var, bar, batch.colour[i]);
+            }
+        }
     };
 
     /**
@@ -66,14 +109,31 @@ namespace Ogre {
 
             const Image* image;
 
-            vec2 var_uv[3];
-            vec3 var_normal[3];
-
-            void vertex(const vec4& vertex, const vec2* uv, const vec3* normal, int gl_VertexID,
-                        vec4& gl_Position);
-            bool fragment(const vec3& bar, ColourValue& gl_FragColor) override;
+            void vertex(const vec4& vertex, const vec2* uv, const vec3* normal, vec4& gl_Position,
+                        Varying& out) const;
+            bool fragment(const Varying var[3], const vec3& bar, ColourValue& gl_FragColor) const override;
+            void fragmentBatch(const Varying var[3], FragmentBatch& batch) const override;
         } mDefaultShader;
 
+        /// vertex shader outputs of the current draw call, as separate streams indexed by vertex
+        struct TransformedVertices
+        {
+            std::vector<IShader::vec4> position;
+            std::vector<IShader::Varying> varyings;
+            std::vector<uchar> valid;
+
+            void reset(size_t vertexCount)
+            {
+                position.resize(vertexCount);
+                varyings.resize(vertexCount);
+                valid.assign(vertexCount, false);
+            }
+        } mTransformedVertices;
+
+        /// snapshots of mDefaultShader referenced by the draws pending in mRasterizer
+        std::deque<DefaultShader> mPendingShaders;
+        std::unique_ptr<TinyRasterizer> mRasterizer;
+
         bool mDepthTest;
         bool mDepthWrite;
         bool mBlendAdd;
@@ -157,6 +217,9 @@ namespace Ogre {
          */
         void _setRenderTarget(RenderTarget *target) override;
 
+        /// rasterize all draws recorded for the active render target
+        void _flushPendingDraws();
+
         void bindGpuProgramParameters(GpuProgramType gptype,
             const GpuProgramParametersPtr& params, uint16 variabilityMask) override {}
 
@@ -13,10 +13,12 @@ struct SDL_Window;
 
 namespace Ogre
 {
+    class TinyRenderSystem;
+
     class _OgrePrivate TinyWindow : public RenderWindow
     {
     public:
-        TinyWindow();
+        TinyWindow(TinyRenderSystem* renderSystem);
 
         void create(const String& name, unsigned int width, unsigned int height,
                     bool fullScreen, const NameValuePairList *miscParams) override;
@@ -35,6 +37,8 @@ namespace Ogre
     protected:
         Image mBuffer;
         SDL_Window* mParentWindow;
+        /// to resolve pending draws before the contents are read
+        TinyRenderSystem* mRenderSystem;
     };
 }
 
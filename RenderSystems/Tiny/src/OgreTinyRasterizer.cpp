@@ -0,0 +1,593 @@
+/**
+Tiny Renderer, https://github.com/ssloy/tinyrenderer
+Copyright Dmitry V. Sokolov
+
+This software is provided 'as-is', without any express or implied warranty.
+In no event will the authors be held liable for any damages arising from the use of this software.
+Permission is granted to anyone to use this software for any purpose,
+including commercial applications, and to alter it and redistribute it freely,
+subject to the following restrictions:
+
+1. The origin of this software must not be misrepresented; you must not claim that you wrote the original software. If you use this software in a product, an acknowledgment in the product documentation would be appreciated but is not required.
+2. Altered source versions must be plainly marked as such, and must not be misrepresented as being the original software.
+3. This notice may not be removed or altered from any source distribution.
+
+Altered for OGRE: tile-binned rasterization using incremental edge functions.
+*/
+
+#include "OgreTinyRasterizer.h"
+
+#include "OgrePlatformInformation.h"
+#include "OgreRoot.h"
+#include "OgreSIMDHelper.h"
+#include "OgreWorkQueue.h"
+
+namespace Ogre
+{
+    typedef Vector<3, uchar> vec3b;
+    typedef Vector<4, uchar> vec4b;
+
+    TinyRasterizer::TinyRasterizer()
+        : mColourBuffer(NULL), mDepthBuffer(NULL), mColourSize(0, 0), mDepthSize(0, 0), mTilesX(0), mTilesY(0)
+    {
+    }
+
+    /// slack for depth values accumulated along a span, so the tile depth range stays conservative
+    static const float DEPTH_EPSILON = 1e-5f;
+
+    void TinyRasterizer::setTarget(Image* colour, Image* depth)
+    {
+        Vector2i colourSize = colour ? Vector2i(colour->getWidth(), colour->getHeight()) : Vector2i(0, 0);
+        Vector2i depthSize = depth ? Vector2i(depth->getWidth(), depth->getHeight()) : Vector2i(0, 0);
+
+        // the window reallocates its buffer in place on resize, so compare the sizes as well
+        if (colour == mColourBuffer && depth == mDepthBuffer && colourSize == mColourSize && depthSize == mDepthSize)
+            return;
+
+        flush();
+
+        mColourBuffer = colour;
+        mDepthBuffer = depth;
+        mColourSize = colourSize;
+        mDepthSize = depthSize;
+
+        mTilesX = (colourSize[0] + TILE_SIZE - 1) / TILE_SIZE;
+        mTilesY = (colourSize[1] + TILE_SIZE - 1) / TILE_SIZE;
+        mBins.resize(mTilesX * mTilesY);
+        mTileDepth.resize(mTilesX * mTilesY);
+        mBlockDepth.resize(mTilesX * mTilesY * BLOCKS_PER_TILE);
+
+        for (size_t tile = 0; depth && tile < mTileDepth.size(); tile++)
+        {
+            for (int block = 0; block < BLOCKS_PER_TILE; block++)
+                updateBlockDepth(tile, block);
+            updateTileDepth(tile);
+        }
+    }
+
+    void TinyRasterizer::clearDepth(float depth)
+    {
+        flush();
+
+        mDepthBuffer->setTo(ColourValue(depth));
+        for (size_t tile = 0; tile < mTileDepth.size(); tile++)
+        {
+            for (int block = 0; block < BLOCKS_PER_TILE; block++)
+            {
+                // blocks outside of the buffer keep their empty range
+                auto& blockDepth = mBlockDepth[tile * BLOCKS_PER_TILE + block];
+                if (blockDepth.min <= blockDepth.max)
+                    blockDepth = {depth, depth};
+            }
+            mTileDepth[tile] = {depth, depth};
+        }
+    }
+
+    void TinyRasterizer::updateBlockDepth(size_t tile, int block)
+    {
+        int x0 = (tile % mTilesX) * TILE_SIZE + (block % BLOCKS_PER_ROW) * BLOCK_SIZE;
+        int y0 = (tile / mTilesX) * TILE_SIZE + (block / BLOCKS_PER_ROW) * BLOCK_SIZE;
+        int x1 = std::min<int>(x0 + BLOCK_SIZE, mDepthBuffer->getWidth());
+        int y1 = std::min<int>(y0 + BLOCK_SIZE, mDepthBuffer->getHeight());
+
+        TileDepth range = {std::numeric_limits<float>::max(), -std::numeric_limits<float>::max()};
+        for (int y = y0; y < y1; y++)
+        {
+            auto depthRow = mDepthBuffer->getData<float>(0, y);
+            for (int x = x0; x < x1; x++)
+            {
+                range.min = std::min(range.min, depthRow[x]);
+                range.max = std::max(range.max, depthRow[x]);
+            }
+        }
+        mBlockDepth[tile * BLOCKS_PER_TILE + block] = range;
+    }
+
+    void TinyRasterizer::updateTileDepth(size_t tile)
+    {
+        const TileDepth* blockDepth = &mBlockDepth[tile * BLOCKS_PER_TILE];
+        TileDepth range = blockDepth[0];
+        for (int block = 1; block < BLOCKS_PER_TILE; block++)
+        {
+            range.min = std::min(range.min, blockDepth[block].min);
+            range.max = std::max(range.max, blockDepth[block].max);
+        }
+        mTileDepth[tile] = range;
+    }
+
+    bool TinyRasterizer::outsideEdge(const Triangle& tri, float minX, float minY, float maxX, float maxY)
+    {
+        for (int i = 0; i < 3; i++)
+        {
+            float maxEdge = tri.edgeA[i] * (tri.edgeA[i] > 0 ? maxX : minX) +
+                            tri.edgeB[i] * (tri.edgeB[i] > 0 ? maxY : minY) + tri.edgeC[i];
+            if (maxEdge < 0)
+                return true;
+        }
+        return false;
+    }
+
+    void TinyRasterizer::depthBounds(const Triangle& tri, int minX, int minY, int maxX, int maxY, float& zMin,
+                                     float& zMax)
+    {
+        // depth is affine, so the extrema over the rectangle are at its corners
+        float x0 = tri.depthDx > 0 ? minX : maxX, x1 = tri.depthDx > 0 ? maxX : minX;
+        float y0 = tri.depthDy > 0 ? minY : maxY, y1 = tri.depthDy > 0 ? maxY : minY;
+        zMin = std::max(tri.depthAt(x0, y0), tri.depthMin) - DEPTH_EPSILON;
+        zMax = std::min(tri.depthAt(x1, y1), tri.depthMax) + DEPTH_EPSILON;
+    }
+
+    void TinyRasterizer::beginDraw(const DrawState& state) { mDraws.push_back(state); }
+
+    /// signed distance of a clip space position to the near, far and guard band planes
+    static float clipDistance(int plane, const TinyRasterizer::vec4& p)
+    {
+        const float guard = TinyRasterizer::GUARD_BAND;
+        switch (plane)
+        {
+        case 0:
+            return p.w + p.z; // near
+        case 1:
+            return p.w - p.z; // far
+        case 2:
+            return guard * p.w + p.x;
+        case 3:
+            return guard * p.w - p.x;
+        case 4:
+            return guard * p.w + p.y;
+        default:
+            return guard * p.w - p.y;
+        }
+    }
+
+    static int clipOutcode(const TinyRasterizer::vec4& p)
+    {
+        int code = 0;
+        for (int plane = 0; plane < 6; plane++)
+            code |= (clipDistance(plane, p) < 0) << plane;
+        return code;
+    }
+
+    void TinyRasterizer::addTriangle(const Matrix4& viewport, const vec4 clipVerts[3],
+                                     const IShader::Varying varyings[3], bool doCull)
+    {
+        OgreAssertDbg(!mDraws.empty(), "beginDraw must be called first");
+
+        int outcode[3] = {clipOutcode(clipVerts[0]), clipOutcode(clipVerts[1]), clipOutcode(clipVerts[2])};
+
+        if (outcode[0] & outcode[1] & outcode[2])
+            return; // all vertices outside of the same plane
+
+        int crossed = outcode[0] | outcode[1] | outcode[2];
+        if (!crossed)
+        {
+            setupTriangle(viewport, clipVerts, varyings, doCull);
+            return;
+        }
+
+        // Sutherland-Hodgman against the planes the triangle crosses. Each plane adds at most one vertex.
+        const int MAX_VERTS = 3 + 6;
+        vec4 pos[2][MAX_VERTS];
+        IShader::Varying var[2][MAX_VERTS];
+        int count = 3, src = 0;
+        std::copy(clipVerts, clipVerts + 3, pos[src]);
+        std::copy(varyings, varyings + 3, var[src]);
+
+        for (int plane = 0; plane < 6; plane++)
+        {
+            if (!(crossed & (1 << plane)))
+                continue;
+
+            int dst = 1 - src, outCount = 0;
+            for (int i = 0; i < count; i++)
+            {
+                int j = (i + 1) % count;
+                float di = clipDistance(plane, pos[src][i]);
+                float dj = clipDistance(plane, pos[src][j]);
+
+                if (di >= 0)
+                {
+                    pos[dst][outCount] = pos[src][i];
+                    var[dst][outCount++] = var[src][i];
+                }
+
+                if ((di >= 0) != (dj >= 0))
+                {
+                    // attributes are linear in clip space
+                    float t = di / (di - dj);
+                    const IShader::Varying &vi = var[src][i], &vj = var[src][j];
+                    pos[dst][outCount] = pos[src][i] + (pos[src][j] - pos[src][i]) * t;
+                    var[dst][outCount].uv = vi.uv + (vj.uv - vi.uv) * t;
+                    var[dst][outCount++].normal = vi.normal + (vj.normal - vi.normal) * t;
+                }
+            }
+
+            src = dst;
+            count = outCount;
+            if (count < 3)
+                return;
+        }
+
+        // the clipped polygon is convex and keeps the winding, so triangulate it as a fan
+        for (int i = 1; i + 1 < count; i++)
+        {
+            vec4 triPos[3] = {pos[src][0], pos[src][i], pos[src][i + 1]};
+            IShader::Varying triVar[3] = {var[src][0], var[src][i], var[src][i + 1]};
+            setupTriangle(viewport, triPos, triVar, doCull);
+        }
+    }
+
+    void TinyRasterizer::setupTriangle(const Matrix4& viewport, const vec4 clipVerts[3],
+                                       const IShader::Varying varyings[3], bool doCull)
+    {
+        vec4 pts[3];
+        for (int i = 0; i < 3; i++)
+        {
+            pts[i] = viewport * clipVerts[i];
+            float w = pts[i][3];
+            pts[i] /= w;
+            pts[i][3] = 1 / w;
+        }
+
+        // twice the signed area, positive for clockwise triangles in window space
+        float area = (pts[1].x - pts[0].x) * (pts[2].y - pts[0].y) - (pts[2].x - pts[0].x) * (pts[1].y - pts[0].y);
+
+        if (doCull && area > 0)
+            return; // culled
+
+        if (std::abs(area) < 1e-6f)
+            return; // degenerate
+
+        Triangle tri;
+        tri.minX = std::max<int>(0, std::min({pts[0].x, pts[1].x, pts[2].x}));
+        tri.minY = std::max<int>(0, std::min({pts[0].y, pts[1].y, pts[2].y}));
+        tri.maxX = std::min<int>(mColourBuffer->getWidth() - 1, std::max({pts[0].x, pts[1].x, pts[2].x}));
+        tri.maxY = std::min<int>(mColourBuffer->getHeight() - 1, std::max({pts[0].y, pts[1].y, pts[2].y}));
+
+        if (tri.minX > tri.maxX || tri.minY > tri.maxY)
+            return; // off screen
+
+        float invArea = 1 / area;
+        for (int i = 0; i < 3; i++)
+        {
+            // edge opposite of vertex i
+            const vec4& v1 = pts[(i + 1) % 3];
+            const vec4& v2 = pts[(i + 2) % 3];
+            tri.edgeA[i] = (v1.y - v2.y) * invArea;
+            tri.edgeB[i] = (v2.x - v1.x) * invArea;
+            tri.edgeC[i] = (v1.x * v2.y - v2.x * v1.y) * invArea;
+            tri.invW[i] = pts[i].w;
+            tri.varyings[i] = varyings[i];
+        }
+
+        // window space depth is affine in screen space. Use differences to the first vertex, as the
+        // depth values are close to each other and absolute window coordinates would cancel out precision.
+        float dz1 = pts[1].z - pts[0].z, dz2 = pts[2].z - pts[0].z;
+        tri.depthDx = (dz1 * (pts[2].y - pts[0].y) - dz2 * (pts[1].y - pts[0].y)) * invArea;
+        tri.depthDy = (dz2 * (pts[1].x - pts[0].x) - dz1 * (pts[2].x - pts[0].x)) * invArea;
+        tri.depthOrigin = vec3(pts[0].x, pts[0].y, pts[0].z);
+        tri.depthMin = std::min({pts[0].z, pts[1].z, pts[2].z});
+        tri.depthMax = std::max({pts[0].z, pts[1].z, pts[2].z});
+        tri.draw = mDraws.size() - 1;
+        const DrawState& state = mDraws.back();
+
+        uint32 triIdx = mTriangles.size();
+        bool binned = false;
+
+        int tileMinX = tri.minX / TILE_SIZE, tileMaxX = tri.maxX / TILE_SIZE;
+        int tileMinY = tri.minY / TILE_SIZE, tileMaxY = tri.maxY / TILE_SIZE;
+        for (int ty = tileMinY; ty <= tileMaxY; ty++)
+        {
+            for (int tx = tileMinX; tx <= tileMaxX; tx++)
+            {
+                float x0 = tx * TILE_SIZE, x1 = x0 + TILE_SIZE - 1;
+                float y0 = ty * TILE_SIZE, y1 = y0 + TILE_SIZE - 1;
+
+                if (outsideEdge(tri, x0, y0, x1, y1))
+                    continue;
+
+                int tile = ty * mTilesX + tx;
+                TileDepth& tileDepth = mTileDepth[tile];
+                float zMin, zMax;
+                depthBounds(tri, std::max<int>(tri.minX, x0), std::max<int>(tri.minY, y0),
+                            std::min<int>(tri.maxX, x1), std::min<int>(tri.maxY, y1), zMin, zMax);
+
+                if (state.depthCheck && zMin > tileDepth.max)
+                    continue; // occluded
+
+                // rasterization only lowers the stored depth, unless it is written without testing.
+                // Widen the range for those right away, so the test above stays conservative for all
+                // triangles binned after it.
+                if (state.depthWrite && !state.depthCheck)
+                    tileDepth = {std::min(tileDepth.min, zMin), std::max(tileDepth.max, zMax)};
+
+                auto& bin = mBins[tile];
+                if (bin.empty())
+                    mActiveTiles.push_back(tile);
+                bin.push_back(triIdx);
+                binned = true;
+            }
+        }
+
+        if (binned)
+            mTriangles.push_back(tri);
+    }
+
+    void TinyRasterizer::flush()
+    {
+        if (mTriangles.empty())
+        {
+            mDraws.clear();
+            return;
+        }
+
+        // tiles cover disjoint pixels, so they can be rasterized in parallel
+        WorkQueue* workQueue = Root::getSingletonPtr() ? Root::getSingleton().getWorkQueue() : NULL;
+        WorkQueue::parallelFor(workQueue, mActiveTiles.size(), 1, [this](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; i++)
+                rasterizeTile(mActiveTiles[i]);
+        });
+
+        for (auto tile : mActiveTiles)
+            mBins[tile].clear();
+        mActiveTiles.clear();
+        mTriangles.clear();
+        mDraws.clear();
+    }
+
+    /// covered fragments of one triangle that passed the depth test, waiting to be shaded
+    struct TinyRasterizer::FragmentQueue
+    {
+        IShader::FragmentBatch batch;
+        int x[IShader::FragmentBatch::SIZE];
+        int y[IShader::FragmentBatch::SIZE];
+        float depth[IShader::FragmentBatch::SIZE];
+
+        FragmentQueue() { batch.count = 0; }
+
+        bool full() const { return batch.count == IShader::FragmentBatch::SIZE; }
+
+        void push(int px, int py, float z, float bar0, float bar1, float bar2)
+        {
+            int i = batch.count++;
+            x[i] = px;
+            y[i] = py;
+            depth[i] = z;
+            batch.bar[0][i] = bar0;
+            batch.bar[1][i] = bar1;
+            batch.bar[2][i] = bar2;
+        }
+    };
+
+    void TinyRasterizer::shadeFragments(FragmentQueue& queue, const Triangle& tri, const DrawState& state)
+    {
+        if (!queue.batch.count)
+            return;
+
+        state.shader->fragmentBatch(tri.varyings, queue.batch);
+
+        for (int i = 0; i < queue.batch.count; i++)
+        {
+            if (queue.batch.discard[i])
+                continue;
+
+            ColourValue& fragColour = queue.batch.colour[i];
+            auto& dst = *mColourBuffer->getData<vec3b>(queue.x[i], queue.y[i]);
+            if (state.blendAdd)
+                fragColour += ColourValue(vec4b(dst[0], dst[1], dst[2], 0).ptr());
+            fragColour.saturate();
+            fragColour *= 255;
+
+            dst = vec3b(fragColour.ptr());
+            if (state.depthWrite)
+                *mDepthBuffer->getData<float>(queue.x[i], queue.y[i]) = queue.depth[i];
+        }
+
+        queue.batch.count = 0;
+    }
+
+    void TinyRasterizer::rasterizeTile(size_t tile)
+    {
+        int tileX = (tile % mTilesX) * TILE_SIZE;
+        int tileY = (tile / mTilesX) * TILE_SIZE;
+        TileDepth* blockDepth = &mBlockDepth[tile * BLOCKS_PER_TILE];
+
+        FragmentQueue queue;
+
+        for (auto triIdx : mBins[tile])
+        {
+            const Triangle& tri = mTriangles[triIdx];
+            const DrawState& state = mDraws[tri.draw];
+
+            int minX = std::max(tri.minX, tileX), maxX = std::min(tri.maxX, tileX + TILE_SIZE - 1);
+            int minY = std::max(tri.minY, tileY), maxY = std::min(tri.maxY, tileY + TILE_SIZE - 1);
+
+            float zMin, zMax;
+            depthBounds(tri, minX, minY, maxX, maxY, zMin, zMax);
+            if (state.depthCheck && zMin > mTileDepth[tile].max)
+                continue; // occluded by the triangles drawn before
+
+            uint64 writtenBlocks = 0;
+            for (int by = (minY - tileY) / BLOCK_SIZE; by <= (maxY - tileY) / BLOCK_SIZE; by++)
+            {
+                for (int bx = (minX - tileX) / BLOCK_SIZE; bx <= (maxX - tileX) / BLOCK_SIZE; bx++)
+                {
+                    int x0 = std::max(minX, tileX + bx * BLOCK_SIZE);
+                    int x1 = std::min(maxX, tileX + bx * BLOCK_SIZE + BLOCK_SIZE - 1);
+                    int y0 = std::max(minY, tileY + by * BLOCK_SIZE);
+                    int y1 = std::min(maxY, tileY + by * BLOCK_SIZE + BLOCK_SIZE - 1);
+
+                    if (outsideEdge(tri, x0, y0, x1, y1))
+                        continue;
+
+                    int block = by * BLOCKS_PER_ROW + bx;
+                    depthBounds(tri, x0, y0, x1, y1, zMin, zMax);
+                    if (state.depthCheck && zMin > blockDepth[block].max)
+                        continue; // occluded
+
+                    // the test can only fail if the triangle reaches behind the nearest stored depth
+                    bool depthCheck = state.depthCheck && zMax > blockDepth[block].min;
+                    if (rasterizeBlock(queue, tri, state, x0, y0, x1, y1, depthCheck) && state.depthWrite)
+                        writtenBlocks |= uint64(1) << block;
+                }
+            }
+
+            // fragments of different triangles may overlap, so resolve before moving on
+            shadeFragments(queue, tri, state);
+
+            if (!writtenBlocks)
+                continue;
+
+            for (int block = 0; block < BLOCKS_PER_TILE; block++)
+            {
+                if (writtenBlocks & (uint64(1) << block))
+                    updateBlockDepth(tile, block);
+            }
+            updateTileDepth(tile);
+        }
+    }
+
+    bool TinyRasterizer::rasterizeBlock(FragmentQueue& queue, const Triangle& tri, const DrawState& state, int minX,
+                                        int minY, int maxX, int maxY, bool depthCheck)
+    {
+        int width = mDepthBuffer->getWidth();
+        bool queued = false;
+
+#if __OGRE_HAVE_SSE || __OGRE_HAVE_NEON
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 one = _mm_set1_ps(1);
+        const __m128 lanes = _mm_setr_ps(0, 1, 2, 3);
+        const __m128 depthStep = _mm_set1_ps(tri.depthDx * 4);
+        __m128 edgeStep[3], invW[3];
+        for (int i = 0; i < 3; i++)
+        {
+            edgeStep[i] = _mm_set1_ps(tri.edgeA[i] * 4);
+            invW[i] = _mm_set1_ps(tri.invW[i]);
+        }
+#endif
+
+        for (int y = minY; y <= maxY; y++)
+        {
+            auto depthRow = mDepthBuffer->getData<float>(0, y);
+
+#if __OGRE_HAVE_SSE || __OGRE_HAVE_NEON
+            // evaluate the edge functions and depth once per row and step them along x, four pixels at a time
+            __m128 bcRow[3];
+            for (int i = 0; i < 3; i++)
+                bcRow[i] = _mm_add_ps(_mm_set1_ps(tri.edgeA[i] * minX + tri.edgeB[i] * y + tri.edgeC[i]),
+                                      _mm_mul_ps(lanes, _mm_set1_ps(tri.edgeA[i])));
+            __m128 depthRowStart =
+                _mm_add_ps(_mm_set1_ps(tri.depthAt(minX, y)), _mm_mul_ps(lanes, _mm_set1_ps(tri.depthDx)));
+
+            for (int x = minX; x <= maxX; x += 4)
+            {
+                __m128 bc0 = bcRow[0], bc1 = bcRow[1], bc2 = bcRow[2];
+                __m128 fragDepth = depthRowStart;
+                for (int i = 0; i < 3; i++)
+                    bcRow[i] = _mm_add_ps(bcRow[i], edgeStep[i]);
+                depthRowStart = _mm_add_ps(depthRowStart, depthStep);
+
+                int spanLength = maxX - x + 1;
+                int mask = spanLength < 4 ? (1 << spanLength) - 1 : 0xF;
+
+                __m128 pass = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(bc0, zero), _mm_cmpge_ps(bc1, zero)),
+                                         _mm_cmpge_ps(bc2, zero));
+
+                if (depthCheck)
+                {
+                    __m128 stored;
+                    if (x + 4 <= width)
+                        stored = _mm_loadu_ps(depthRow + x);
+                    else
+                    {
+                        float tail[4] = {};
+                        memcpy(tail, depthRow + x, (width - x) * sizeof(float));
+                        stored = _mm_loadu_ps(tail);
+                    }
+                    pass = _mm_and_ps(pass, _mm_cmple_ps(fragDepth, stored));
+                }
+
+                mask &= _mm_movemask_ps(pass);
+                if (!mask)
+                    continue;
+
+                // check https://github.com/ssloy/tinyrenderer/wiki/Technical-difficulties-linear-interpolation-with-perspective-deformations
+                bc0 = _mm_mul_ps(bc0, invW[0]);
+                bc1 = _mm_mul_ps(bc1, invW[1]);
+                bc2 = _mm_mul_ps(bc2, invW[2]);
+                __m128 norm = _mm_div_ps(one, _mm_add_ps(_mm_add_ps(bc0, bc1), bc2));
+
+                float z[4], bar0[4], bar1[4], bar2[4];
+                _mm_storeu_ps(z, fragDepth);
+                _mm_storeu_ps(bar0, _mm_mul_ps(bc0, norm));
+                _mm_storeu_ps(bar1, _mm_mul_ps(bc1, norm));
+                _mm_storeu_ps(bar2, _mm_mul_ps(bc2, norm));
+
+                for (int i = 0; i < 4; i++)
+                {
+                    if (!(mask & (1 << i)))
+                        continue;
+
+                    queue.push(x + i, y, z[i], bar0[i], bar1[i], bar2[i]);
+                    if (queue.full())
+                        shadeFragments(queue, tri, state);
+                }
+                queued = true;
+            }
+#else
+            // evaluate the edge functions once per row and step them along x
+            vec3 bcRow;
+            for (int i = 0; i < 3; i++)
+                bcRow[i] = tri.edgeA[i] * minX + tri.edgeB[i] * y + tri.edgeC[i];
+            float depthRowStart = tri.depthAt(minX, y);
+
+            for (int x = minX; x <= maxX; x++)
+            {
+                vec3 bcScreen = bcRow;
+                float fragDepth = depthRowStart;
+                bcRow.x += tri.edgeA[0];
+                bcRow.y += tri.edgeA[1];
+                bcRow.z += tri.edgeA[2];
+                depthRowStart += tri.depthDx;
+
+                if (bcScreen.x < 0 || bcScreen.y < 0 || bcScreen.z < 0)
+                    continue;
+
+                if (depthCheck && fragDepth > depthRow[x])
+                    continue;
+
+                // check https://github.com/ssloy/tinyrenderer/wiki/Technical-difficulties-linear-interpolation-with-perspective-deformations
+                vec3 bcClip(bcScreen.x * tri.invW[0], bcScreen.y * tri.invW[1], bcScreen.z * tri.invW[2]);
+                bcClip /= (bcClip.x + bcClip.y + bcClip.z);
+
+                queue.push(x, y, fragDepth, bcClip.x, bcClip.y, bcClip.z);
+                if (queue.full())
+                    shadeFragments(queue, tri, state);
+                queued = true;
+            }
+#endif
+        }
+
+        return queued;
+    }
+}
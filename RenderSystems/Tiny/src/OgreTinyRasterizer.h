@@ -0,0 +1,160 @@
+// This file is part of the OGRE project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at https://www.ogre3d.org/licensing.
+// SPDX-License-Identifier: MIT
+#ifndef __TinyRasterizer_H__
+#define __TinyRasterizer_H__
+
+#include "OgreTinyRenderSystem.h"
+
+namespace Ogre
+{
+    /** Deferred, tile-binned triangle rasterizer
+
+        Triangles are set up when they are submitted and appended to the bins of all screen tiles
+        they overlap. Nothing is written to the target until flush() is called, which then
+        rasterizes the tiles in parallel. Every tile is owned by exactly one worker and processes its
+        bin in submission order, so no synchronisation on the colour or depth buffer is needed and
+        the result matches immediate rendering.
+
+        Coverage, perspective correct barycentrics and the depth test are evaluated for spans of four
+        pixels using SSE or NEON where available. Surviving fragments are shaded in batches of
+        IShader::FragmentBatch::SIZE.
+
+        The depth range of each tile and of each block within a tile is kept alongside the depth buffer.
+        Triangles behind the farthest depth of a tile are dropped from it when binning, and again per
+        tile and block when rasterizing. Blocks completely in front of the nearest depth skip the per
+        pixel depth test.
+    */
+    class TinyRasterizer
+    {
+    public:
+        typedef IShader::vec2 vec2;
+        typedef IShader::vec3 vec3;
+        typedef IShader::vec4 vec4;
+
+        /// edge length of the square screen tiles in pixels
+        static const int TILE_SIZE = 64;
+        /// edge length of the blocks a tile is subdivided into for occlusion culling
+        static const int BLOCK_SIZE = 8;
+        /// extent of the guard band in multiples of the viewport, only geometry reaching beyond it is clipped
+        static constexpr float GUARD_BAND = 4;
+
+        /// raster state captured at draw time
+        struct DrawState
+        {
+            /// must stay alive until the next flush()
+            const IShader* shader;
+            bool depthCheck;
+            bool depthWrite;
+            bool blendAdd;
+        };
+
+        TinyRasterizer();
+
+        /** set the buffers draws are resolved to. Any work pending on the previous target is flushed.
+
+            Call again after resizing the buffers in place, so the tile and block depth ranges are rebuilt.
+        */
+        void setTarget(Image* colour, Image* depth);
+
+        /// fill the depth buffer with the given value. Must be used instead of writing it directly.
+        void clearDepth(float depth);
+
+        /// start a new draw call. All triangles added afterwards use this state.
+        void beginDraw(const DrawState& state);
+
+        /** clip a triangle against the near and far planes and the guard band, then set up and bin it
+
+            @param viewport transform from NDC to window coordinates
+            @param clipVerts vertex positions in clip space, as written by the vertex shader
+            @param varyings the remaining vertex shader outputs
+            @param doCull whether to discard back facing triangles
+        */
+        void addTriangle(const Matrix4& viewport, const vec4 clipVerts[3], const IShader::Varying varyings[3],
+                         bool doCull);
+
+        /// rasterize all pending triangles and release the recorded draw states
+        void flush();
+
+        /// whether there are triangles waiting for flush()
+        bool hasPendingWork() const { return !mTriangles.empty(); }
+
+    private:
+        struct Triangle
+        {
+            /// edge functions normalised by the triangle area, evaluating to the screen space barycentrics
+            float edgeA[3];
+            float edgeB[3];
+            float edgeC[3];
+            /// window space depth gradient and a point on the depth plane
+            float depthDx, depthDy;
+            vec3 depthOrigin;
+            /// depth range of the vertices
+            float depthMin, depthMax;
+            /// 1 / w for perspective correction
+            float invW[3];
+            /// clamped bounding box in pixels
+            int minX, minY, maxX, maxY;
+            IShader::Varying varyings[3];
+            uint32 draw;
+
+            float depthAt(float x, float y) const
+            {
+                return depthOrigin.z + depthDx * (x - depthOrigin.x) + depthDy * (y - depthOrigin.y);
+            }
+        };
+
+        typedef std::vector<uint32> TriangleBin;
+
+        static const int BLOCKS_PER_ROW = TILE_SIZE / BLOCK_SIZE;
+        static const int BLOCKS_PER_TILE = BLOCKS_PER_ROW * BLOCKS_PER_ROW;
+
+        /// bounds of the depth values stored in a tile or block. They may be wider than the actual range.
+        struct TileDepth
+        {
+            float min;
+            float max;
+        };
+
+        struct FragmentQueue;
+
+        void setupTriangle(const Matrix4& viewport, const vec4 clipVerts[3], const IShader::Varying varyings[3],
+                           bool doCull);
+        /// depth range of a triangle over the given pixel rectangle
+        static void depthBounds(const Triangle& tri, int minX, int minY, int maxX, int maxY, float& zMin,
+                                float& zMax);
+        /// whether the pixel rectangle lies completely outside of one of the triangle edges
+        static bool outsideEdge(const Triangle& tri, float minX, float minY, float maxX, float maxY);
+        /// recompute the exact depth range of a block from the depth buffer
+        void updateBlockDepth(size_t tile, int block);
+        /// recompute the depth range of a tile from its blocks
+        void updateTileDepth(size_t tile);
+        void rasterizeTile(size_t tile);
+        /// queue the fragments of a triangle in the given pixel rectangle. Returns whether any were queued.
+        bool rasterizeBlock(FragmentQueue& queue, const Triangle& tri, const DrawState& state, int minX, int minY,
+                            int maxX, int maxY, bool depthCheck);
+        /// run the batched fragment shader on the queued fragments and write the results
+        void shadeFragments(FragmentQueue& queue, const Triangle& tri, const DrawState& state);
+
+        Image* mColourBuffer;
+        Image* mDepthBuffer;
+        /// sizes of the buffers when the tile and block depth ranges were last rebuilt
+        Vector2i mColourSize;
+        Vector2i mDepthSize;
+
+        int mTilesX;
+        int mTilesY;
+
+        std::vector<DrawState> mDraws;
+        std::vector<Triangle> mTriangles;
+        std::vector<TriangleBin> mBins;
+        /// tiles with a non-empty bin, to skip empty screen regions when flushing
+        std::vector<uint32> mActiveTiles;
+        std::vector<TileDepth> mTileDepth;
+        /// BLOCKS_PER_TILE entries per tile
+        std::vector<TileDepth> mBlockDepth;
+    };
+}
+
+#endif
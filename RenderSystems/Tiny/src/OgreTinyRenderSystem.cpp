@@ -21,11 +21,11 @@
 #include "OgreTinyWindow.h"
 #include "OgreTinyTexture.h"
 
-#include "tinyrenderer.h"
+#include "OgreTinyRasterizer.h"
 
 namespace Ogre {
     TinyRenderSystem::TinyRenderSystem()
-        : mHardwareBufferManager(0)
+        : mRasterizer(new TinyRasterizer()), mHardwareBufferManager(0)
     {
         LogManager::getSingleton().logMessage(getName() + " created.");
 
@@ -143,6 +143,9 @@ namespace Ogre {
 
     void TinyRenderSystem::shutdown(void)
     {
+        mRasterizer->setTarget(NULL, NULL);
+        mPendingShaders.clear();
+
         RenderSystem::shutdown();
 
         OGRE_DELETE mHardwareBufferManager;
@@ -160,7 +163,7 @@ namespace Ogre {
         RenderSystem::_createRenderWindow(name, width, height, fullScreen, miscParams);
 
         // Create the window
-        RenderWindow* win = new TinyWindow();
+        RenderWindow* win = new TinyWindow(this);
         win->create(name, width, height, fullScreen, miscParams);
         attachRenderTarget(*win);
 
@@ -269,6 +272,13 @@ namespace Ogre {
 
     void TinyRenderSystem::_endFrame(void)
     {
+        _flushPendingDraws();
+    }
+
+    void TinyRenderSystem::_flushPendingDraws()
+    {
+        mRasterizer->flush();
+        mPendingShaders.clear();
     }
 
     void TinyRenderSystem::_setCullingMode(CullingMode mode)
@@ -303,21 +313,22 @@ namespace Ogre {
     }
 
     void TinyRenderSystem::DefaultShader::vertex(const vec4& vertex, const vec2* uv, const vec3* normal,
-                                                 int gl_VertexID, vec4& gl_Position)
+                                                 vec4& gl_Position, Varying& out) const
     {
         gl_Position = uniform_MVP * vertex;
 
-        if(uv)
-            var_uv[gl_VertexID] = (uniform_Tex*vec4(uv->x, uv->y, 0, 1)).xy();
+        // the cache reuses varyings across draws, so meshes without texcoords must not inherit stale ones
+        out.uv = uv ? (uniform_Tex*vec4(uv->x, uv->y, 0, 1)).xy() : vec2(0, 0);
 
         if(normal)
-            var_normal[gl_VertexID] = uniform_MVIT.linear() * *normal;
+            out.normal = uniform_MVIT.linear() * *normal;
     }
-    bool TinyRenderSystem::DefaultShader::fragment(const vec3& bar, ColourValue& gl_FragColor)
+    bool TinyRenderSystem::DefaultShader::fragment(const Varying var[3], const vec3& bar,
+                                                   ColourValue& gl_FragColor) const
     {
         if(image)
         {
-            vec2 uv = var_uv[0]*bar.x + var_uv[1]*bar.y + var_uv[2]*bar.z;
+            vec2 uv = var[0].uv*bar.x + var[1].uv*bar.y + var[2].uv*bar.z;
 
             const vec4b& tex = sample2D(*image, uv);
 
@@ -329,7 +340,7 @@ namespace Ogre {
 
         if(uniform_doLighting)
         {
-            vec3 n = var_normal[0]*bar.x + var_normal[1]*bar.y + var_normal[2]*bar.z;
+            vec3 n = var[0].normal*bar.x + var[1].normal*bar.y + var[2].normal*bar.z;
             float diffuse = std::max(0.f, n.dotProduct(uniform_lightDir));
             gl_FragColor *= diffuse;
             gl_FragColor += uniform_ambientCol;
@@ -337,6 +348,42 @@ namespace Ogre {
 
         return false;
     }
+    void TinyRenderSystem::DefaultShader::fragmentBatch(const Varying var[3], FragmentBatch& batch) const
+    {
+        for (int i = 0; i < batch.count; i++)
+        {
+            batch.colour[i] = ColourValue::White;
+            batch.discard[i] = false;
+        }
+
+        if(image)
+        {
+            for (int i = 0; i < batch.count; i++)
+            {
+                vec2 uv = var[0].uv * batch.bar[0][i] + var[1].uv * batch.bar[1][i] + var[2].uv * batch.bar[2][i];
+
+                const vec4b& tex = sample2D(*image, uv);
+
+                batch.discard[i] = tex[3] < 1;
+                batch.colour[i] = ColourValue(tex.ptr());
+            }
+        }
+
+        if(uniform_doLighting)
+        {
+            // the normal is interpolated linearly, so the same holds for its dot product with the light
+            float nDotL[3];
+            for (int j = 0; j < 3; j++)
+                nDotL[j] = var[j].normal.dotProduct(uniform_lightDir);
+
+            for (int i = 0; i < batch.count; i++)
+            {
+                float diffuse = std::max(
+                    0.f, nDotL[0] * batch.bar[0][i] + nDotL[1] * batch.bar[1][i] + nDotL[2] * batch.bar[2][i]);
+                batch.colour[i] = batch.colour[i] * diffuse + uniform_ambientCol;
+            }
+        }
+    }
 
     static uchar* getData(const RenderOperation& op, VertexElementSemantic sem, size_t& step)
     {
@@ -374,46 +421,71 @@ namespace Ogre {
 
         mDefaultShader.uniform_doLighting &= bool(normData);
 
-        int16* idx16Data = NULL;
-        int32* idx32Data = NULL;
+        uint16* idx16Data = NULL;
+        uint32* idx32Data = NULL;
         size_t drawCount = op.vertexData->vertexCount;
         if (op.useIndexes)
         {
             if(op.indexData->indexBuffer->getIndexSize() == 2)
             {
-                idx16Data = (int16*)op.indexData->indexBuffer->lock(HardwareBuffer::HBL_NORMAL);
+                idx16Data = (uint16*)op.indexData->indexBuffer->lock(HardwareBuffer::HBL_NORMAL);
                 idx16Data += op.indexData->indexStart;
             }
             else
             {
-                idx32Data = (int32*)op.indexData->indexBuffer->lock(HardwareBuffer::HBL_NORMAL);
+                idx32Data = (uint32*)op.indexData->indexBuffer->lock(HardwareBuffer::HBL_NORMAL);
                 idx32Data += op.indexData->indexStart;
             }
             op.indexData->indexBuffer->unlock();
             drawCount = op.indexData->indexCount;
         }
 
-        Vector3f* v = NULL;
-        Vector2* uv = NULL;
-        Vector3f* n = NULL;
-        vec4 clip_vert[3]; // triangle coordinates (clip coordinates), written by VS, read by FS
+        // the draw is resolved later, so it needs its own copy of the shader state
+        mPendingShaders.push_back(mDefaultShader);
+        mRasterizer->beginDraw({&mPendingShaders.back(), mDepthTest, mDepthWrite, mBlendAdd});
+
+        // post-transform cache: every referenced vertex runs through the vertex shader only once
+        mTransformedVertices.reset(op.vertexData->vertexCount);
+
+        auto transformVertex = [&](size_t idx) {
+            // malformed index data must not address vertices outside of the cache
+            if (idx >= op.vertexData->vertexCount)
+                return false;
+            if (!mTransformedVertices.valid[idx])
+            {
+                auto v = (Vector3f*)(posData + posStep * idx);
+                auto uv = uvData ? (Vector2*)(uvData + uvStep * idx) : NULL;
+                auto n = normData ? (Vector3f*)(normData + normStep * idx) : NULL;
+                mDefaultShader.vertex(IShader::vec4(*v), uv, n, mTransformedVertices.position[idx],
+                                      mTransformedVertices.varyings[idx]);
+                mTransformedVertices.valid[idx] = true;
+            }
+            return true;
+        };
+
+        size_t triangleCount = isStrip ? (drawCount < 3 ? 0 : drawCount - 2) : drawCount / 3;
+
+        IShader::vec4 clip_vert[3]; // triangle coordinates (clip coordinates), written by VS, read by FS
+        IShader::Varying varyings[3];
         do
         {
-            for(size_t i = 0; i < drawCount; i += 3)
+            for(size_t i = 0; i < triangleCount; i++)
             {
-                if (i && isStrip)
-                    i -= 2;
+                size_t first = isStrip ? i : i * 3;
+                bool valid = true;
                 for(int j= 0; j < 3; j++)
                 {
-                    int idx = i + j;
+                    size_t idx = first + j;
                     idx = idx16Data ? idx16Data[idx] : (idx32Data ? idx32Data[idx] : idx);
-                    v = (Vector3f*)(posData + posStep*idx);
-                    uv = (Vector2*)(uvData + uvStep*idx);
-                    n = (Vector3f*)(normData + normStep*idx);
-                    mDefaultShader.vertex(vec4(*v), uv, n, j, clip_vert[j]);
+                    valid = transformVertex(idx);
+                    if (!valid)
+                        break;
+                    clip_vert[j] = mTransformedVertices.position[idx];
+                    varyings[j] = mTransformedVertices.varyings[idx];
                 }
-                triangle(mVP, clip_vert, mDefaultShader, *mActiveColourBuffer, *mActiveDepthBuffer,
-                            mDepthTest, mDepthWrite, mBlendAdd, !isStrip);
+                // skip triangles with an index out of range
+                if (valid)
+                    mRasterizer->addTriangle(mVP, clip_vert, varyings, !isStrip);
             }
 
         } while (updatePassIterationRenderState());
@@ -428,18 +500,24 @@ namespace Ogre {
                                                const ColourValue& colour,
                                                float depth, unsigned short stencil)
     {
+        // clears are not binned, so resolve everything drawn before
+        _flushPendingDraws();
+
         if (buffers & FBT_COLOUR)
         {
             mActiveColourBuffer->setTo(colour);
         }
         if (buffers & FBT_DEPTH)
         {
-            mActiveDepthBuffer->setTo(ColourValue(depth));
+            mRasterizer->clearDepth(depth);
         }
     }
 
     void TinyRenderSystem::_setRenderTarget(RenderTarget *target)
     {
+        if (target != mActiveRenderTarget)
+            _flushPendingDraws();
+
         mActiveRenderTarget = target;
 
         if (!target)
@@ -449,6 +527,7 @@ namespace Ogre {
         {
             mActiveColourBuffer = win->getImage();
             mActiveDepthBuffer = dynamic_cast<TinyDepthBuffer*>(win->getDepthBuffer())->getImage();
+            mRasterizer->setTarget(mActiveColourBuffer, mActiveDepthBuffer);
         }
 
         // Check the depth buffer status
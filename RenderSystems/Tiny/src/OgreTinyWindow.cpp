@@ -4,6 +4,7 @@
 // SPDX-License-Identifier: MIT
 
 #include "OgreTinyWindow.h"
+#include "OgreTinyRenderSystem.h"
 #include "OgreException.h"
 #include "OgreStringConverter.h"
 
@@ -14,7 +15,7 @@
 
 namespace Ogre
 {
-TinyWindow::TinyWindow() : mParentWindow(NULL)
+TinyWindow::TinyWindow(TinyRenderSystem* renderSystem) : mParentWindow(NULL), mRenderSystem(renderSystem)
 {
     mIsFullScreen = false;
     mActive = true;
@@ -43,6 +44,8 @@ void TinyWindow::resize(uint width, uint height)
 
 void TinyWindow::swapBuffers()
 {
+    mRenderSystem->_flushPendingDraws();
+
 #if OGRE_BITES_HAVE_SDL
     if(!mParentWindow)
         return;
@@ -76,6 +79,8 @@ void TinyWindow::copyContentsToMemory(const Box& src, const PixelBox& dst, Frame
         OGRE_EXCEPT(Exception::ERR_INVALIDPARAMS, "Invalid box");
     }
 
+    mRenderSystem->_flushPendingDraws();
+
     PixelUtil::bulkPixelConversion(mBuffer.getPixelBox().getSubVolume(src), dst);
 }
 } // namespace Ogre
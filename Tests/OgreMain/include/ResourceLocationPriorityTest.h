@@ -33,26 +33,30 @@ THE SOFTWARE.
 #include "OgreArchiveFactory.h"
 #include "OgreDataStream.h"
 
-// Barebones archive containing a single 1-byte file "dummyArchiveTest" whose
-// contents are an unsigned char that increments on each construction of the
+// Barebones archive containing a single 1-byte file, "dummyArchiveTest" by default,
+// whose contents are an unsigned char that increments on each construction of the
 // archive.
 class DummyArchive : public Ogre::Archive
 {
 public:
-    DummyArchive(const Ogre::String& name, const Ogre::String& archType)
-        : Ogre::Archive(name, archType), mContents(DummyArchive::makeContents()) {}
+    DummyArchive(const Ogre::String& name, const Ogre::String& archType,
+                 const Ogre::String& fileName = "dummyArchiveTest", bool caseSensitive = true)
+        : Ogre::Archive(name, archType), mFileName(fileName), mCaseSensitive(caseSensitive),
+          mContents(DummyArchive::makeContents())
+    {
+    }
 
     virtual ~DummyArchive() {}
 
-    bool exists(const Ogre::String& name) const override { return name == "dummyArchiveTest"; }
+    bool exists(const Ogre::String& name) const override { return name == mFileName; }
 
     Ogre::StringVectorPtr find(const Ogre::String& pattern, bool recursive = true, bool dirs = false) const override
     {
         Ogre::StringVectorPtr results = std::make_shared<Ogre::StringVector>();
         if (dirs) return results;
-        if (Ogre::StringUtil::match("dummyArchiveTest", pattern))
+        if (Ogre::StringUtil::match(mFileName, pattern))
         {
-            results->push_back("dummyArchiveTest");
+            results->push_back(mFileName);
         }
         return results;
     }
@@ -62,22 +66,22 @@ public:
     {
         Ogre::FileInfoListPtr results = std::make_shared<Ogre::FileInfoList>();
         if (dirs) return results;
-        if (Ogre::StringUtil::match("dummyArchiveTest", pattern))
+        if (Ogre::StringUtil::match(mFileName, pattern))
         {
-            results->push_back(Ogre::FileInfo{this, "dummyArchiveTest", "/", "dummyArchiveTest", 0, 1});
+            results->push_back(Ogre::FileInfo{this, mFileName, "/", mFileName, 0, 1});
         }
         return results;
     }
 
     time_t getModifiedTime(const Ogre::String& filename) const override { return 0; }
 
-    bool isCaseSensitive() const override { return true; }
+    bool isCaseSensitive() const override { return mCaseSensitive; }
 
     Ogre::StringVectorPtr list(bool recursive = true, bool dirs = false) const override
     {
         Ogre::StringVectorPtr results = std::make_shared<Ogre::StringVector>();
         if (dirs) return results;
-        results->push_back("dummyArchiveTest");
+        results->push_back(mFileName);
         return results;
     }
 
@@ -85,7 +89,7 @@ public:
     {
         Ogre::FileInfoListPtr results = std::make_shared<Ogre::FileInfoList>();
         if (dirs) return results;
-        results->push_back(Ogre::FileInfo{this, "dummyArchiveTest", "/", "dummyArchiveTest", 0, 1});
+        results->push_back(Ogre::FileInfo{this, mFileName, "/", mFileName, 0, 1});
         return results;
     }
 
@@ -95,7 +99,7 @@ public:
 
     Ogre::DataStreamPtr open(const Ogre::String& filename, bool readOnly = true) const override
     {
-        if (filename == "dummyArchiveTest")
+        if (filename == mFileName)
         {
             unsigned char* ptr = OGRE_ALLOC_T(unsigned char, 1, Ogre::MEMCATEGORY_GENERAL);
             *ptr = mContents;
@@ -112,26 +116,34 @@ private:
         return counter++;
     }
 
+    Ogre::String mFileName;
+    bool mCaseSensitive;
     unsigned char mContents;
 };
 
 class DummyArchiveFactory : public Ogre::ArchiveFactory
 {
 public:
+    DummyArchiveFactory(const Ogre::String& type = "DummyArchive", const Ogre::String& fileName = "dummyArchiveTest",
+                        bool caseSensitive = true)
+        : mType(type), mFileName(fileName), mCaseSensitive(caseSensitive)
+    {
+    }
     virtual ~DummyArchiveFactory() {}
 
     Ogre::Archive* createInstance(const Ogre::String& name, bool) override
     {
-        return OGRE_NEW DummyArchive(name, "DummyArchive");
+        return OGRE_NEW DummyArchive(name, mType, mFileName, mCaseSensitive);
     }
 
     void destroyInstance(Ogre::Archive* ptr) override { OGRE_DELETE ptr; }
 
-    const Ogre::String& getType() const override
-    {
-        static Ogre::String type = "DummyArchive";
-        return type;
-    }
+    const Ogre::String& getType() const override { return mType; }
+
+private:
+    Ogre::String mType;
+    Ogre::String mFileName;
+    bool mCaseSensitive;
 };
 
 #endif
@@ -312,3 +312,31 @@ TEST_F(FileSystemArchiveTests,CreateAndRemoveFile)
     EXPECT_TRUE(!mArch->exists(fileName));
 }
 //--------------------------------------------------------------------------
+TEST_F(FileSystemArchiveTests,MmapRead)
+{
+    FileSystemArchiveFactory::setUseMmap(true);
+    DataStreamPtr stream = mArch->open("rootfile.txt");
+    DataStreamPtr rwStream = mArch->open("rootfile.txt", false);
+    FileSystemArchiveFactory::setUseMmap(false);
+
+    // only read-only streams are mapped
+    EXPECT_FALSE(dynamic_cast<MmapDataStream*>(rwStream.get()));
+    rwStream.reset();
+
+    auto mmapStream = dynamic_cast<MmapDataStream*>(stream.get());
+    ASSERT_TRUE(mmapStream);
+    EXPECT_EQ(mFileSizeRoot1, stream->size());
+    EXPECT_TRUE(stream->isReadable());
+    EXPECT_FALSE(stream->isWriteable());
+    EXPECT_EQ(String("this is line 1"), String((const char*)mmapStream->getPtr(), 14));
+
+    EXPECT_EQ(String("this is line 1 in file 1"), stream->getLine());
+    EXPECT_EQ(String("this is line 2 in file 1"), stream->getLine());
+    stream->seek(0);
+    EXPECT_EQ(String("this is line 1 in file 1"), stream->getLine());
+    EXPECT_EQ(String("this is line 2 in file 1"), String((const char*)mmapStream->getCurrentPtr(), 24));
+
+    stream->close();
+    EXPECT_THROW(MmapDataStream("missing", mTestPath + "/missing.txt"), FileNotFoundException);
+}
+//--------------------------------------------------------------------------
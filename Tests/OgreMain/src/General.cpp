@@ -28,8 +28,11 @@ THE SOFTWARE.
 #include <gtest/gtest.h>
 
 #include "OgreRoot.h"
+#include "OgreWorkQueue.h"
+#include "OgreDefaultWorkQueue.h"
 #include "OgreSceneNode.h"
 #include "OgreEntity.h"
+#include "OgreSubEntity.h"
 #include "OgreCamera.h"
 #include "RootWithoutRenderSystemFixture.h"
 #include "OgreStaticPluginLoader.h"
@@ -43,8 +46,11 @@ THE SOFTWARE.
 #include "OgreHighLevelGpuProgramManager.h"
 #include "OgreMeshManager.h"
 #include "OgreMesh.h"
+#include "OgreSubMesh.h"
 #include "OgreSkeletonManager.h"
 #include "OgreSkeletonInstance.h"
+#include "OgreSkeletonSerializer.h"
+#include "OgreBone.h"
 #include "OgreCompositorManager.h"
 #include "OgreTextureManager.h"
 #include "OgreFileSystem.h"
@@ -57,6 +63,26 @@ THE SOFTWARE.
 #include "OgreBillboardSet.h"
 #include "OgreBillboard.h"
 
+#include "OgreRenderQueue.h"
+#include "OgreRenderQueueSortingGrouping.h"
+#include "OgreTransformStore.h"
+#include "OgreInstanceManager.h"
+#include "OgreInstanceBatch.h"
+#include "OgreInstancedEntity.h"
+#include "OgreOptimisedUtil.h"
+#include "OgreParticle.h"
+#include "OgreParticleStreams.h"
+#include "OgreParticleSystem.h"
+#include "OgreParticleSystemManager.h"
+#include "OgreParticleEmitter.h"
+#include "OgreParticleEmitterFactory.h"
+#include "OgreParticleAffector.h"
+#include "OgreParticleAffectorFactory.h"
+#include "OgreControllerManager.h"
+#include "OgreProfiler.h"
+#include "OgreFrameCounters.h"
+#include "OgreTimer.h"
+
 #include <random>
 using std::minstd_rand;
 
@@ -188,6 +214,1091 @@ TEST_F(SceneNodeTest, destroyChildAndObjects)
     EXPECT_TRUE(mSceneMgr->hasEntity("sinbad"));
 }
 
+TEST_F(SceneNodeTest, parallelUpdate)
+{
+    mRoot->getWorkQueue()->startup();
+
+    SceneManager* parallelMgr = mRoot->createSceneManager();
+    parallelMgr->setParallelUpdateDepth(2);
+
+    std::vector<SceneNode*> serialNodes, parallelNodes;
+    for (auto sm : {mSceneMgr, parallelMgr})
+    {
+        auto& nodes = sm == mSceneMgr ? serialNodes : parallelNodes;
+        nodes.push_back(sm->getRootSceneNode());
+        // 4 levels with 4 children each, every node carrying an entity
+        for (size_t i = 0; nodes.size() < 1 + 4 + 16 + 64 + 256; i++)
+        {
+            for (int c = 0; c < 4; c++)
+            {
+                auto node = nodes[i]->createChildSceneNode(Vector3(c * 10.0f, Real(i), -c * 5.0f));
+                node->roll(Degree(15.0f * c));
+                node->setScale(Vector3(0.9f));
+                node->attachObject(sm->createEntity("sphere.mesh"));
+                nodes.push_back(node);
+            }
+        }
+    }
+
+    auto compare = [&]() {
+        // the parallel update adds the updated nodes once per chunk of subtrees
+        std::vector<uint64> nodesUpdated;
+        for (auto sm : {mSceneMgr, parallelMgr})
+        {
+            uint64 before = FrameCounters::getCurrentValue(FrameCounters::NODES_UPDATED);
+            sm->_updateSceneGraph(NULL);
+            nodesUpdated.push_back(FrameCounters::getCurrentValue(FrameCounters::NODES_UPDATED) - before);
+        }
+        EXPECT_EQ(nodesUpdated[0], nodesUpdated[1]);
+
+        for (size_t i = 0; i < serialNodes.size(); i++)
+        {
+            EXPECT_EQ(serialNodes[i]->_getDerivedPosition(), parallelNodes[i]->_getDerivedPosition());
+            EXPECT_EQ(serialNodes[i]->_getWorldAABB(), parallelNodes[i]->_getWorldAABB());
+        }
+    };
+
+    compare();
+
+    // only some branches need an update
+    for (size_t i : {3, 17, 90, 300})
+    {
+        serialNodes[i]->translate(Vector3(0, 50, 0));
+        parallelNodes[i]->translate(Vector3(0, 50, 0));
+    }
+    compare();
+}
+
+TEST_F(SceneNodeTest, parallelUpdateOptIn)
+{
+    // like the octree scene manager, subclasses keep the serial traversal unless they opt in
+    struct SerialSceneManager : public SceneManager
+    {
+        SerialSceneManager() : SceneManager("serial") {}
+        const String& getTypeName(void) const override { return BLANKSTRING; }
+    } serialMgr;
+    serialMgr.setParallelUpdateDepth(2);
+    serialMgr.setParallelCullingDepth(2);
+    EXPECT_EQ(serialMgr.getParallelUpdateDepth(), 0);
+    EXPECT_EQ(serialMgr.getParallelCullingDepth(), 0);
+
+    SceneManager* defaultMgr = mRoot->createSceneManager();
+    defaultMgr->setParallelUpdateDepth(2);
+    EXPECT_EQ(defaultMgr->getParallelUpdateDepth(), 2);
+    EXPECT_EQ(defaultMgr->getParallelCullingDepth(), 0);
+}
+
+TEST_F(SceneNodeTest, parallelUpdateInstancedEntities)
+{
+    mRoot->getWorkQueue()->setWorkerThreadCount(3);
+    mRoot->getWorkQueue()->startup();
+
+    SceneManager* parallelMgr = mRoot->createSceneManager();
+    parallelMgr->setParallelUpdateDepth(1);
+
+    MeshPtr mesh = MeshManager::getSingleton().createManual("instanced", RGN_DEFAULT);
+    InstanceManager* instanceMgr = parallelMgr->createInstanceManager("instances", "instanced", RGN_DEFAULT,
+                                                                      InstanceManager::ShaderBased, 64);
+
+    // records which threads mark it dirty, the real batches need a render system
+    struct TestBatch : public InstanceBatch
+    {
+        std::vector<std::thread::id> dirtyThreads;
+        TestBatch(InstanceManager* creator, MeshPtr& mesh, const String& name)
+            : InstanceBatch(creator, mesh, MaterialPtr(), 64, NULL, name)
+        {
+        }
+        size_t calculateMaxNumInstances(const SubMesh*, uint16) const override { return 64; }
+        void setupVertices(const SubMesh*) override {}
+        void setupIndices(const SubMesh*) override {}
+        void getWorldTransforms(Matrix4*) const override {}
+        void _boundsDirty(void) override
+        {
+            dirtyThreads.push_back(std::this_thread::get_id());
+            InstanceBatch::_boundsDirty();
+        }
+    } batches[2] = {{instanceMgr, mesh, "batch0"}, {instanceMgr, mesh, "batch1"}};
+
+    // slows down each subtree, so the workers get some of them on a single core as well
+    struct SlowEntity : public InstancedEntity
+    {
+        using InstancedEntity::InstancedEntity;
+        void _notifyMoved(void) override
+        {
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+            InstancedEntity::_notifyMoved();
+        }
+    };
+
+    // listeners need not be thread safe, so they are called on the updating thread
+    struct ThreadListener : public Node::Listener, public MovableObject::Listener
+    {
+        std::vector<std::thread::id> threads;
+        void nodeUpdated(const Node*) override { threads.push_back(std::this_thread::get_id()); }
+        void objectMoved(MovableObject*) override { threads.push_back(std::this_thread::get_id()); }
+    } listener;
+
+    // the entities of both batches are spread over all subtrees
+    std::vector<std::unique_ptr<InstancedEntity> > entities;
+    std::vector<SceneNode*> nodes;
+    for (uint32 i = 0; i < 64; i++)
+    {
+        nodes.push_back(parallelMgr->getRootSceneNode()->createChildSceneNode());
+        nodes.back()->setListener(&listener);
+        for (uint32 j = 0; j < 4; j++)
+        {
+            entities.emplace_back(new SlowEntity(&batches[j % 2], i * 4 + j));
+            entities.back()->setListener(&listener);
+            nodes.back()->createChildSceneNode()->attachObject(entities.back().get());
+        }
+    }
+    parallelMgr->_updateSceneGraph(NULL);
+    instanceMgr->_updateDirtyBatches();
+
+    for (int frame = 0; frame < 5; frame++)
+    {
+        for (auto& b : batches)
+            b.dirtyThreads.clear();
+        listener.threads.clear();
+        for (auto n : nodes)
+            n->translate(Vector3(1, 0, 0));
+        parallelMgr->_updateSceneGraph(NULL);
+
+        for (auto& b : batches)
+        {
+            ASSERT_FALSE(b.dirtyThreads.empty());
+            for (auto id : b.dirtyThreads)
+                EXPECT_EQ(id, std::this_thread::get_id());
+        }
+        instanceMgr->_updateDirtyBatches();
+
+        // each subtree root and its entities
+        EXPECT_EQ(listener.threads.size(), 64u * 5);
+        for (auto id : listener.threads)
+            EXPECT_EQ(id, std::this_thread::get_id());
+    }
+
+    for (auto& e : entities)
+        EXPECT_EQ(e->getParentSceneNode()->_getDerivedPosition(), Vector3(5, 0, 0));
+    for (auto n : nodes)
+        n->setListener(NULL);
+    for (auto& e : entities)
+        e->setListener(NULL);
+    entities.clear();
+    parallelMgr->destroyInstanceManager(instanceMgr);
+}
+
+TEST_F(SceneNodeTest, transformStore)
+{
+    SceneManager* storeMgr = mRoot->createSceneManager();
+    storeMgr->setUseTransformStore(true);
+    EXPECT_TRUE(storeMgr->getUseTransformStore());
+
+    minstd_rand rng;
+    std::uniform_real_distribution<float> dist(-10, 10);
+    std::vector<SceneNode*> nodes, storeNodes;
+    for (int i = 0; i < 39; i++)
+    {
+        // the first few below the root, then below random earlier nodes
+        Vector3 pos(dist(rng), dist(rng), dist(rng));
+        Quaternion q(Degree(dist(rng) * 18), Vector3(dist(rng), dist(rng), 1).normalisedCopy());
+        Vector3 scale(1 + dist(rng) / 20, 1, 1 - dist(rng) / 20);
+        size_t parent = i < 3 ? 0 : rng() % i;
+        for (auto sm : {mSceneMgr, storeMgr})
+        {
+            auto& list = sm == mSceneMgr ? nodes : storeNodes;
+            auto node = i < 3 ? sm->getRootSceneNode()->createChildSceneNode() : list[parent]->createChildSceneNode();
+            node->setPosition(pos);
+            node->setOrientation(q);
+            node->setScale(scale);
+            node->setInheritOrientation(i % 7 != 0);
+            node->setInheritScale(i % 5 != 0);
+            list.push_back(node);
+        }
+    }
+
+    // the traversal reads the derived transforms from the store
+    struct StoreListener : public Node::Listener
+    {
+        SceneManager* sm;
+        bool usedStore = false;
+        void nodeUpdated(const Node*) override { usedStore = sm->_getUpdatedTransformStore() != NULL; }
+    } listener;
+    listener.sm = storeMgr;
+    storeNodes.back()->setListener(&listener);
+
+    auto compare = [&]() {
+        for (auto sm : {mSceneMgr, storeMgr})
+            sm->_updateSceneGraph(NULL);
+
+        for (size_t i = 0; i < nodes.size(); i++)
+        {
+            EXPECT_TRUE(nodes[i]->_getDerivedPosition().positionEquals(storeNodes[i]->_getDerivedPosition(), 1e-4));
+            EXPECT_TRUE(
+                nodes[i]->_getDerivedOrientation().orientationEquals(storeNodes[i]->_getDerivedOrientation(), 1e-5));
+            EXPECT_TRUE(nodes[i]->_getDerivedScale().positionEquals(storeNodes[i]->_getDerivedScale(), 1e-5));
+        }
+    };
+
+    compare();
+    EXPECT_TRUE(listener.usedStore);
+
+    // local changes are written to the store
+    for (auto list : {&nodes, &storeNodes})
+    {
+        (*list)[5]->translate(Vector3(0, 50, 0));
+        (*list)[20]->yaw(Degree(30));
+        (*list)[21]->setInheritScale(false);
+        (*list)[38]->scale(2, 2, 2);
+    }
+    listener.usedStore = false;
+    compare();
+    EXPECT_TRUE(listener.usedStore);
+
+    // as is the new layout after the hierarchy changed
+    for (auto list : {&nodes, &storeNodes})
+    {
+        auto moved = (*list)[30];
+        moved->getParent()->removeChild(moved);
+        (*list)[1]->addChild(moved);
+        auto detached = (*list)[10];
+        detached->getParent()->removeChild(detached);
+        detached->translate(Vector3(5, 0, 0));
+    }
+    compare();
+
+    // changes of destroyed nodes are dropped
+    for (auto sm : {mSceneMgr, storeMgr})
+    {
+        auto& list = sm == mSceneMgr ? nodes : storeNodes;
+        list[33]->translate(Vector3(1, 0, 0));
+        sm->destroySceneNode(list[33]);
+        list.erase(list.begin() + 33);
+    }
+    compare();
+
+    // nodes outside the scene graph and queried between updates compute their own transforms
+    for (auto list : {&nodes, &storeNodes})
+        (*list)[12]->setPosition(Vector3(1, 2, 3));
+    EXPECT_TRUE(nodes[12]->_getDerivedPosition().positionEquals(storeNodes[12]->_getDerivedPosition(), 1e-4));
+
+    storeMgr->setUseTransformStore(false);
+    compare();
+
+    // the listener does not outlive the test, unlike the node
+    storeNodes.back()->setListener(NULL);
+}
+
+TEST_F(SceneNodeTest, parallelCulling)
+{
+    mRoot->getWorkQueue()->startup();
+
+    SceneManager* parallelMgr = mRoot->createSceneManager();
+    parallelMgr->setParallelCullingDepth(2);
+
+    struct NameRecorder : public QueuedRenderableVisitor
+    {
+        std::vector<String> names;
+        void visit(RenderablePass* rp) override {}
+        void visit(const Pass* p, RenderableList& rs) override
+        {
+            for (auto r : rs)
+                names.push_back(static_cast<SubEntity*>(r)->getParent()->getName());
+        }
+    };
+
+    // the objects notified of the camera, which updates their LOD
+    struct CameraRecorder : public MovableObject::Listener
+    {
+        std::vector<String> names;
+        bool objectRendering(const MovableObject* o, const Camera*) override
+        {
+            names.push_back(o->getName());
+            return true;
+        }
+    };
+
+    std::vector<String> serialNames, parallelNames;
+    std::vector<VisibleObjectsBoundsInfo> bounds;
+    CameraRecorder cameraRecorders[2];
+    for (auto sm : {mSceneMgr, parallelMgr})
+    {
+        CameraRecorder* cameraRecorder = &cameraRecorders[sm == parallelMgr];
+        auto attach = [cameraRecorder](SceneNode* node, MovableObject* o) {
+            o->setListener(cameraRecorder);
+            node->attachObject(o);
+        };
+
+        // a grid of groups, only part of which is in view
+        for (int i = 0; i < 64; i++)
+        {
+            auto group = sm->getRootSceneNode()->createChildSceneNode(Vector3((i % 8) * 300.0f, (i / 8) * 300.0f, 0));
+            for (int j = 0; j < 4; j++)
+            {
+                auto node = group->createChildSceneNode(Vector3(j * 60.0f, 0, 0));
+                attach(node, sm->createEntity(StringConverter::toString(i * 4 + j), "sphere.mesh"));
+            }
+        }
+
+        // objects that are queued along with the other objects of their visible node
+        auto group = sm->getRootSceneNode()->createChildSceneNode();
+        auto node = group->createChildSceneNode(Vector3(500, 500, 0));
+        attach(node, sm->createEntity("mixed", "sphere.mesh"));
+        attach(node, sm->createManualObject("null"));
+        auto infinite = sm->createManualObject("infinite");
+        infinite->setBoundingBox(AxisAlignedBox::BOX_INFINITE);
+        attach(group->createChildSceneNode(Vector3(500, 500, 5000)), infinite);
+        // behind the camera, but the bounds of its node include the child in front of it
+        node = group->createChildSceneNode(Vector3(500, 500, 5000));
+        attach(node, sm->createEntity("behind", "sphere.mesh"));
+        attach(node->createChildSceneNode(Vector3(0, 0, -5000)), sm->createEntity("inFront", "sphere.mesh"));
+
+        Camera* cam = sm->createCamera("Camera");
+        auto camNode = sm->getRootSceneNode()->createChildSceneNode(Vector3(500, 500, 1000));
+        camNode->attachObject(cam);
+
+        sm->_updateSceneGraph(cam);
+
+        VisibleObjectsBoundsInfo info;
+        info.reset();
+        sm->getRenderQueue()->clear();
+        sm->_findVisibleObjects(cam, &info, false);
+        bounds.push_back(info);
+
+        NameRecorder recorder;
+        for (auto& pg : sm->getRenderQueue()->getQueueGroup(RENDER_QUEUE_MAIN)->getPriorityGroups())
+            pg.second->getSolidsBasic().acceptVisitor(&recorder, QueuedRenderableCollection::OM_PASS_GROUP);
+        (sm == mSceneMgr ? serialNames : parallelNames) = recorder.names;
+    }
+
+    EXPECT_FALSE(serialNames.empty());
+    EXPECT_LT(serialNames.size(), 64 * 4);
+    EXPECT_EQ(serialNames, parallelNames);
+    EXPECT_EQ(std::count(parallelNames.begin(), parallelNames.end(), "behind"), 1);
+    EXPECT_EQ(std::count(parallelNames.begin(), parallelNames.end(), "inFront"), 1);
+    EXPECT_EQ(cameraRecorders[0].names, cameraRecorders[1].names);
+    for (const char* name : {"null", "infinite"})
+        EXPECT_EQ(std::count(cameraRecorders[1].names.begin(), cameraRecorders[1].names.end(), name), 1);
+    EXPECT_EQ(bounds[0].aabb, bounds[1].aabb);
+    EXPECT_EQ(bounds[0].receiverAabb, bounds[1].receiverAabb);
+    EXPECT_EQ(bounds[0].minDistance, bounds[1].minDistance);
+    EXPECT_EQ(bounds[0].maxDistance, bounds[1].maxDistance);
+
+    // the recorders go out of scope before the scene managers
+    for (auto sm : {mSceneMgr, parallelMgr})
+        sm->clearScene();
+}
+
+typedef RootWithoutRenderSystemFixture WorkQueueTests;
+TEST_F(WorkQueueTests, TaskGroups)
+{
+    DefaultWorkQueue queue("test");
+    queue.setWorkerThreadCount(3);
+    queue.startup();
+
+    // sums [begin, end) by splitting it up, the child tasks wait for their own children
+    std::function<uint64(uint64, uint64)> sum = [&](uint64 begin, uint64 end) {
+        if (end - begin <= 16)
+        {
+            uint64 s = 0;
+            for (uint64 i = begin; i < end; i++)
+                s += i;
+            return s;
+        }
+        uint64 mid = (begin + end) / 2, left = 0;
+        WorkQueue::TaskGroup children;
+        queue.addTask([&]() { left = sum(begin, mid); }, children);
+        uint64 right = sum(mid, end);
+        queue.waitForTasks(children);
+        return left + right;
+    };
+
+    for (int run = 0; run < 2; run++)
+    {
+        EXPECT_EQ(sum(0, 100000), uint64(100000) * 99999 / 2);
+
+        // tasks added by this thread go through the shared queue
+        std::atomic<int> count(0);
+        WorkQueue::TaskGroup group;
+        for (int i = 0; i < 10000; i++)
+            queue.addTask([&]() { count++; }, group);
+        queue.waitForTasks(group);
+        EXPECT_EQ(count, 10000);
+
+        queue.startup(true);
+    }
+
+    // waiting only helps with the group, not with an unrelated task queued before it
+    std::atomic<int> blocked(0);
+    std::atomic<bool> release(false), unrelatedDone(false);
+    for (int i = 0; i < 3; i++)
+        queue.addTask([&]() {
+            blocked++;
+            while (!release)
+                std::this_thread::yield();
+        });
+    while (blocked < 3)
+        std::this_thread::yield();
+
+    auto waitingThread = std::this_thread::get_id();
+    std::thread::id unrelatedThread;
+    queue.addTask([&]() {
+        unrelatedThread = std::this_thread::get_id();
+        unrelatedDone = true;
+    });
+    std::atomic<int> count(0);
+    WorkQueue::TaskGroup group;
+    for (int i = 0; i < 100; i++)
+        queue.addTask([&]() { count++; }, group);
+    queue.waitForTasks(group);
+    EXPECT_EQ(count, 100);
+    EXPECT_FALSE(unrelatedDone);
+
+    release = true;
+    while (!unrelatedDone)
+        std::this_thread::yield();
+    EXPECT_NE(unrelatedThread, waitingThread);
+    queue.shutdown();
+}
+
+TEST_F(WorkQueueTests, WaitForGroupsOfOneDeque)
+{
+    DefaultWorkQueue queue("test");
+    queue.setWorkerThreadCount(4);
+    queue.startup();
+
+    // a worker fills its deque with the tasks of several groups, which are then stolen by threads
+    // waiting on different groups, while the finished tasks are recycled for new ones
+    for (int run = 0; run < 200; run++)
+    {
+        WorkQueue::TaskGroup groups[4];
+        std::atomic<int> counts[4];
+        std::atomic<bool> produced(false);
+        std::atomic<int> waitersDone(0);
+        for (auto& c : counts)
+            c = 0;
+
+        queue.addTask([&]() {
+            for (int i = 0; i < 800; i++)
+                queue.addTask([&counts, i]() { counts[i % 4]++; }, groups[i % 4]);
+            produced = true;
+            queue.waitForTasks(groups[0]);
+            waitersDone++;
+        });
+        for (int g = 1; g < 3; g++)
+            queue.addTask([&, g]() {
+                while (!produced)
+                    std::this_thread::yield();
+                queue.waitForTasks(groups[g]);
+                waitersDone++;
+            });
+
+        while (!produced)
+            std::this_thread::yield();
+        queue.waitForTasks(groups[3]);
+        while (waitersDone < 3)
+            std::this_thread::yield();
+
+        for (auto& c : counts)
+            ASSERT_EQ(c, 200) << run;
+    }
+    queue.shutdown();
+}
+
+TEST_F(WorkQueueTests, ParallelForAndTaskGraph)
+{
+    DefaultWorkQueue queue("test");
+    queue.setWorkerThreadCount(3);
+    queue.startup();
+
+    std::vector<int> visits(10000);
+    queue.parallelFor(visits.size(), 16, [&](size_t begin, size_t end) {
+        EXPECT_LE(begin, end);
+        for (size_t i = begin; i < end; i++)
+            visits[i]++;
+    });
+    EXPECT_EQ(std::count(visits.begin(), visits.end(), 1), int(visits.size()));
+
+    // a diamond, with the order of finishing recorded
+    std::atomic<int> counter(0);
+    int order[4];
+    TaskGraph graph;
+    auto a = graph.addTask([&]() { order[0] = counter++; });
+    auto b = graph.addTask([&]() { order[1] = counter++; }, {a});
+    auto c = graph.addTask([&]() { order[2] = counter++; }, {a});
+    graph.addTask([&]() { order[3] = counter++; }, {b, c});
+
+    for (WorkQueue* q : {(WorkQueue*)&queue, (WorkQueue*)NULL})
+    {
+        counter = 0;
+        graph.run(q);
+        EXPECT_EQ(counter, 4);
+        EXPECT_EQ(order[0], 0);
+        EXPECT_EQ(order[3], 3);
+    }
+    queue.shutdown();
+}
+
+struct RecordingProfileListener : public ProfileSessionListener
+{
+    std::map<String, uint> calls;
+    void initializeSession() override {}
+    void finializeSession() override {}
+    void displayResults(const ProfileInstance& instance, ulong maxTotalFrameTime) override
+    {
+        for (auto& c : instance.children)
+        {
+            calls[c.first] = c.second->frame.calls;
+            displayResults(*c.second, maxTotalFrameTime);
+        }
+    }
+};
+
+TEST(Profiler, ThreadsAndChromeTrace)
+{
+    Timer timer;
+    Profiler profiler;
+    profiler.setTimer(&timer);
+    RecordingProfileListener listener;
+    profiler.addListener(&listener);
+
+    // the request to enable applies at the end of a profile
+    profiler.setEnabled(true);
+    profiler.endProfile("Frame");
+    ASSERT_TRUE(profiler.getEnabled());
+
+    profiler.startCapture();
+    profiler.beginProfile("Frame");
+    {
+        Profile update("Update");
+    }
+    std::thread worker([]() {
+        // more than fit into the events of a thread, the whole profiles that do not are dropped
+        for (int i = 0; i < 10000; i++)
+        {
+            Profile task("Task");
+            Profile inner("Inner");
+        }
+    });
+    worker.join();
+    profiler.endProfile("Frame");
+    profiler.stopCapture();
+
+    EXPECT_EQ(listener.calls["Frame"], 1u);
+    EXPECT_EQ(listener.calls["Update"], 1u);
+    EXPECT_GT(listener.calls["Task"], 0u);
+    EXPECT_LT(listener.calls["Task"], 10000u);
+    EXPECT_EQ(listener.calls["Inner"], listener.calls["Task"]);
+
+    std::stringstream trace;
+    profiler.exportChromeTrace(trace);
+    String json = trace.str();
+    EXPECT_EQ(json.find("{\"displayTimeUnit\":\"ms\",\"traceEvents\":["), 0u);
+    EXPECT_NE(json.find("\"args\":{\"name\":\"Main\"}"), String::npos);
+    EXPECT_NE(json.find("\"args\":{\"name\":\"Thread 1\"}"), String::npos);
+    EXPECT_NE(json.find("{\"name\":\"Update\",\"cat\":\"User\",\"ph\":\"B\",\"pid\":0,\"tid\":0,\"ts\":"), String::npos);
+
+    auto count = [&](const String& str) {
+        int n = 0;
+        for (size_t pos = json.find(str); pos != String::npos; pos = json.find(str, pos + 1))
+            n++;
+        return n;
+    };
+    EXPECT_EQ(count("\"ph\":\"B\""), count("\"ph\":\"E\""));
+    EXPECT_EQ(count("\"name\":\"Task\""), 2 * int(listener.calls["Task"]));
+
+    // as used by OgreProfile, the call site only caches the id of a string literal
+    listener.calls.clear();
+    profiler.setUpdateDisplayFrequency(1);
+    profiler.beginProfile("Frame");
+    for (int i = 0; i < 2; i++)
+    {
+        static ProfileName literal, buffer, str;
+        char name[16];
+        snprintf(name, sizeof(name), "Buffer%d", i);
+        Profile a(literal, "Literal", OGREPROF_USER_DEFAULT);
+        Profile b(buffer, name, OGREPROF_USER_DEFAULT);
+        Profile c(str, String(name).append("String").c_str(), OGREPROF_USER_DEFAULT);
+    }
+    profiler.endProfile("Frame");
+    EXPECT_EQ(listener.calls["Literal"], 2u);
+    EXPECT_EQ(listener.calls["Buffer0"], 1u);
+    EXPECT_EQ(listener.calls["Buffer1"], 1u);
+    EXPECT_EQ(listener.calls["Buffer0String"], 1u);
+    EXPECT_EQ(listener.calls["Buffer1String"], 1u);
+
+    profiler.removeListener(&listener);
+}
+
+typedef RootWithoutRenderSystemFixture FrameCountersTests;
+TEST_F(FrameCountersTests, CountsAndCsv)
+{
+    FrameCounters::reset();
+
+    SceneManager* sceneMgr = mRoot->createSceneManager();
+    SceneNode* parent = sceneMgr->getRootSceneNode()->createChildSceneNode();
+    parent->createChildSceneNode();
+    parent->createChildSceneNode();
+    sceneMgr->getRootSceneNode()->_update(true, false);
+    EXPECT_EQ(FrameCounters::getCurrentValue(FrameCounters::NODES_UPDATED), 4u);
+
+    // locking the shadow buffer through the delegate counts once
+    auto vbuf = HardwareBufferManager::getSingleton().createVertexBuffer(12, 4, HBU_CPU_TO_GPU, true);
+    vbuf->lock(HardwareBuffer::HBL_DISCARD);
+    vbuf->unlock();
+    EXPECT_EQ(FrameCounters::getCurrentValue(FrameCounters::BUFFER_LOCKS), 1u);
+    EXPECT_EQ(FrameCounters::getCurrentValue(FrameCounters::BUFFER_BYTES_LOCKED), 48u);
+
+    sceneMgr->createEntity("Sinbad.mesh");
+    EXPECT_GT(FrameCounters::getCurrentValue(FrameCounters::RESOURCES_LOADED), 0u);
+
+    uint32 custom = FrameCounters::registerCounter("Custom");
+    EXPECT_EQ(FrameCounters::registerCounter("Custom"), custom);
+    EXPECT_EQ(FrameCounters::registerCounter("NodesUpdated"), uint32(FrameCounters::NODES_UPDATED));
+    FrameCounters::add(custom, 5);
+
+    FrameCounters::_frameStarted();
+    EXPECT_EQ(FrameCounters::getFrameCount(), 1u);
+    EXPECT_EQ(FrameCounters::getValue(custom), 5u);
+    EXPECT_EQ(FrameCounters::getCurrentValue(custom), 0u);
+    EXPECT_EQ(FrameCounters::getValue(FrameCounters::NODES_UPDATED), 4u);
+
+    String header = FrameCounters::getCsvHeader();
+    String row = FrameCounters::getCsvRow();
+    EXPECT_EQ(header.find("Frame,NodesUpdated,NodesCulled,"), 0u);
+    EXPECT_TRUE(StringUtil::endsWith(header, ",Custom", false));
+    EXPECT_EQ(row.find("1,4,0,"), 0u);
+    EXPECT_TRUE(StringUtil::endsWith(row, ",5", false));
+    EXPECT_EQ(std::count(header.begin(), header.end(), ','), std::count(row.begin(), row.end(), ','));
+}
+
+TEST(TransformStore, MatchesNode)
+{
+    Root root("");
+    SceneManager* sm = root.createSceneManager();
+
+    TransformStore store;
+    std::vector<SceneNode*> nodes;
+    minstd_rand rng;
+    std::uniform_real_distribution<float> dist(-10, 10);
+    for (uint32 i = 0; i < 39; i++)
+    {
+        // a few roots, then children of random earlier entries. Some groups depend on themselves.
+        uint32 parent = i < 3 ? TransformStore::NO_PARENT : rng() % i;
+        Vector3 pos(dist(rng), dist(rng), dist(rng));
+        Quaternion q(Degree(dist(rng) * 18), Vector3(dist(rng), dist(rng), 1).normalisedCopy());
+        Vector3 scale(1 + dist(rng) / 20, 1, 1 - dist(rng) / 20);
+        bool inheritOrientation = i % 7 != 0;
+        bool inheritScale = i % 5 != 0;
+
+        EXPECT_EQ(store.add(parent, pos, q, scale, inheritOrientation, inheritScale), i);
+
+        SceneNode* node = parent == TransformStore::NO_PARENT ? sm->getRootSceneNode()->createChildSceneNode()
+                                                              : nodes[parent]->createChildSceneNode();
+        node->setPosition(pos);
+        node->setOrientation(q);
+        node->setScale(scale);
+        node->setInheritOrientation(inheritOrientation);
+        node->setInheritScale(inheritScale);
+        nodes.push_back(node);
+    }
+
+    store.update();
+    sm->getRootSceneNode()->_update(true, false);
+
+    for (uint32 i = 0; i < nodes.size(); i++)
+    {
+        EXPECT_TRUE(store.getDerivedPosition(i).positionEquals(nodes[i]->_getDerivedPosition(), 1e-4));
+        EXPECT_TRUE(store.getDerivedOrientation(i).orientationEquals(nodes[i]->_getDerivedOrientation(), 1e-5));
+        EXPECT_TRUE(store.getDerivedScale(i).positionEquals(nodes[i]->_getDerivedScale(), 1e-5));
+    }
+}
+
+typedef RootWithoutRenderSystemFixture OptimisedUtilTests;
+TEST_F(OptimisedUtilTests, BatchedCulling)
+{
+    minstd_rand rng;
+    std::uniform_real_distribution<float> dist(-100, 100);
+
+    Frustum frustum;
+    frustum.setFOVy(Degree(60));
+    frustum.setNearClipDistance(1);
+    frustum.setFarClipDistance(150);
+    frustum.setCustomViewMatrix(true, Affine3::getTrans(0, 0, -100));
+
+    Vector4 planes[6];
+    for (int p = 0; p < 6; p++)
+    {
+        const Plane& plane = frustum.getFrustumPlane(p);
+        planes[p] = Vector4(plane.normal.x, plane.normal.y, plane.normal.z, plane.d);
+    }
+
+    // not a multiple of four or eight, to cover the partial groups
+    const size_t count = 203;
+    std::vector<AxisAlignedBox> boxes;
+    std::vector<float> centres, halfSizes, mins, maxs;
+    std::vector<Vector4> spheres;
+    for (size_t i = 0; i < count; i++)
+    {
+        Vector3 centre(dist(rng), dist(rng), dist(rng));
+        Vector3 halfSize(std::abs(dist(rng)) / 10, std::abs(dist(rng)) / 10, std::abs(dist(rng)) / 10);
+        boxes.push_back(AxisAlignedBox(centre - halfSize, centre + halfSize));
+        centres.insert(centres.end(), centre.ptr(), centre.ptr() + 3);
+        halfSizes.insert(halfSizes.end(), halfSize.ptr(), halfSize.ptr() + 3);
+        mins.insert(mins.end(), boxes.back().getMinimum().ptr(), boxes.back().getMinimum().ptr() + 3);
+        maxs.insert(maxs.end(), boxes.back().getMaximum().ptr(), boxes.back().getMaximum().ptr() + 3);
+        spheres.push_back(Vector4(centre.x, centre.y, centre.z, halfSize.x));
+    }
+
+    auto isSet = [](const std::vector<uint32>& mask, size_t i) { return (mask[i / 32] & (1u << (i % 32))) != 0; };
+
+    OptimisedUtil* util = OptimisedUtil::getImplementation();
+    std::vector<uint32> mask((count + 31) / 32, 0xFFFFFFFF);
+
+    util->cullBoxes(planes, 6, centres.data(), halfSizes.data(), count, mask.data());
+    size_t numVisible = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        EXPECT_EQ(isSet(mask, i), frustum.isVisible(boxes[i])) << i;
+        numVisible += isSet(mask, i);
+    }
+    // the padding bits are cleared
+    EXPECT_EQ(mask.back() >> (count % 32), 0u);
+    EXPECT_GT(numVisible, 0u);
+    EXPECT_LT(numVisible, count);
+
+    util->cullSpheres(planes, 6, spheres.data(), count, mask.data());
+    for (size_t i = 0; i < count; i++)
+        EXPECT_EQ(isSet(mask, i), frustum.isVisible(Sphere(spheres[i].xyz(), spheres[i].w))) << i;
+
+    std::vector<float> distances(count);
+    for (const Ray& ray : {Ray(Vector3(-100, -20, 10), Vector3(1, 0.2, 0)), Ray(Vector3(5, 0, -100), Vector3::UNIT_Z)})
+    {
+        util->intersectRayBoxes(ray.getOrigin(), ray.getDirection(), mins.data(), maxs.data(), count, mask.data(),
+                                distances.data());
+        for (size_t i = 0; i < count; i++)
+        {
+            auto ref = Math::intersects(ray, boxes[i]);
+            EXPECT_EQ(isSet(mask, i), ref.first) << i;
+            if (ref.first)
+            {
+                EXPECT_NEAR(distances[i], ref.second, 1e-3) << i;
+            }
+        }
+    }
+}
+
+TEST_F(OptimisedUtilTests, SoftwareSkinning)
+{
+    minstd_rand rng;
+    std::uniform_real_distribution<float> dist(-10, 10);
+
+    alignas(16) Affine3 bones[5];
+    const Affine3* blendMatrices[5];
+    for (int i = 0; i < 5; i++)
+    {
+        Quaternion q(Radian(dist(rng)), Vector3(dist(rng), dist(rng), dist(rng)).normalisedCopy());
+        bones[i] = Affine3(Vector3(dist(rng), dist(rng), dist(rng)), q, Vector3(2));
+        blendMatrices[i] = &bones[i];
+    }
+
+    // not a multiple of eight, to cover the partial group
+    const size_t count = 37;
+    const size_t numWeights = 3;
+    // position and normal interleaved in a shared buffer
+    std::vector<float> src(count * 6), dst(count * 6);
+    std::vector<float> weights(count * numWeights);
+    std::vector<uchar> indices(count * numWeights);
+    for (size_t i = 0; i < count; i++)
+    {
+        Vector3 normal = Vector3(dist(rng), dist(rng), dist(rng)).normalisedCopy();
+        float* v = &src[i * 6];
+        v[0] = dist(rng), v[1] = dist(rng), v[2] = dist(rng);
+        v[3] = normal.x, v[4] = normal.y, v[5] = normal.z;
+
+        float sum = 0;
+        for (size_t j = 0; j < numWeights; j++)
+        {
+            weights[i * numWeights + j] = std::abs(dist(rng));
+            indices[i * numWeights + j] = uchar(rng() % 5);
+            sum += weights[i * numWeights + j];
+        }
+        for (size_t j = 0; j < numWeights; j++)
+            weights[i * numWeights + j] /= sum;
+    }
+
+    OptimisedUtil* util = OptimisedUtil::getImplementation();
+    util->softwareVertexSkinning(src.data(), dst.data(), src.data() + 3, dst.data() + 3, weights.data(),
+                                 indices.data(), blendMatrices, 6 * sizeof(float), 6 * sizeof(float),
+                                 6 * sizeof(float), 6 * sizeof(float), numWeights * sizeof(float), numWeights,
+                                 numWeights, count);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        Vector3 pos(&src[i * 6]), normal(&src[i * 6 + 3]);
+        Vector3 refPos = Vector3::ZERO, refNormal = Vector3::ZERO;
+        for (size_t j = 0; j < numWeights; j++)
+        {
+            const Affine3& mat = bones[indices[i * numWeights + j]];
+            refPos += mat * pos * weights[i * numWeights + j];
+            refNormal += mat.linear() * normal * weights[i * numWeights + j];
+        }
+        refNormal.normalise();
+
+        EXPECT_TRUE(Vector3(&dst[i * 6]).positionEquals(refPos, 1e-3)) << i;
+        EXPECT_TRUE(Vector3(&dst[i * 6 + 3]).positionEquals(refNormal, 1e-3)) << i;
+    }
+
+    // positions only, packed
+    std::vector<float> srcPos(count * 3), dstPos(count * 3);
+    for (size_t i = 0; i < count; i++)
+        std::copy(&src[i * 6], &src[i * 6 + 3], &srcPos[i * 3]);
+
+    util->softwareVertexSkinning(srcPos.data(), dstPos.data(), NULL, NULL, weights.data(), indices.data(),
+                                 blendMatrices, 3 * sizeof(float), 3 * sizeof(float), 0, 0,
+                                 numWeights * sizeof(float), numWeights, numWeights, count);
+    for (size_t i = 0; i < count; i++)
+        EXPECT_TRUE(Vector3(&dstPos[i * 3]).positionEquals(Vector3(&dst[i * 6]), 1e-3)) << i;
+
+    alignas(16) Affine3 concatenated[5];
+    util->concatenateAffineMatrices(bones[0], bones, concatenated, 5);
+    for (int i = 0; i < 5; i++)
+    {
+        Affine3 ref = bones[0] * bones[i];
+        for (int r = 0; r < 3; r++)
+            for (int c = 0; c < 4; c++)
+                EXPECT_NEAR(concatenated[i][r][c], ref[r][c], 1e-3) << i;
+    }
+}
+
+/// skins the same random vertices with the given implementation, positions followed by normals
+static std::vector<float> skinRandomVertices(OptimisedUtil* util, size_t numWeights, bool shared)
+{
+    minstd_rand rng;
+    std::uniform_real_distribution<float> dist(-10, 10);
+
+    alignas(16) Affine3 bones[5];
+    const Affine3* blendMatrices[5];
+    for (int i = 0; i < 5; i++)
+    {
+        Quaternion q(Radian(dist(rng)), Vector3(dist(rng), dist(rng), dist(rng)).normalisedCopy());
+        bones[i] = Affine3(Vector3(dist(rng), dist(rng), dist(rng)), q, Vector3(2));
+        blendMatrices[i] = &bones[i];
+    }
+
+    // not a multiple of four or eight, to cover the partial groups
+    const size_t count = 45;
+    std::vector<float> src(count * 6), dst(count * 6);
+    std::vector<float> weights(count * numWeights);
+    std::vector<uchar> indices(count * numWeights);
+    for (auto& f : src)
+        f = dist(rng);
+    // the SSE version relies on the weights of a vertex adding up to one
+    for (size_t v = 0; v < count; v++)
+    {
+        float sum = 0;
+        for (size_t w = 0; w < numWeights; w++)
+        {
+            weights[v * numWeights + w] = std::abs(dist(rng)) + 0.1f;
+            indices[v * numWeights + w] = uchar(rng() % 5);
+            sum += weights[v * numWeights + w];
+        }
+        for (size_t w = 0; w < numWeights; w++)
+            weights[v * numWeights + w] /= sum;
+    }
+
+    // either position and normal interleaved, or two separate packed buffers
+    size_t stride = (shared ? 6 : 3) * sizeof(float);
+    float* srcNorm = shared ? src.data() + 3 : src.data() + count * 3;
+    float* dstNorm = shared ? dst.data() + 3 : dst.data() + count * 3;
+    util->softwareVertexSkinning(src.data(), dst.data(), srcNorm, dstNorm, weights.data(), indices.data(),
+                                 blendMatrices, stride, stride, stride, stride, numWeights * sizeof(float),
+                                 numWeights, numWeights, count);
+    return dst;
+}
+
+static void compareSkinningImplementations(OptimisedUtil* util)
+{
+    OptimisedUtil* general = OptimisedUtil::getImplementation(OptimisedUtil::IMPL_GENERAL);
+    ASSERT_TRUE(general);
+
+    for (size_t numWeights = 1; numWeights <= OGRE_MAX_BLEND_WEIGHTS; numWeights++)
+    {
+        for (bool shared : {true, false})
+        {
+            auto ref = skinRandomVertices(general, numWeights, shared);
+            auto res = skinRandomVertices(util, numWeights, shared);
+            for (size_t i = 0; i < ref.size(); i++)
+                EXPECT_NEAR(res[i], ref[i], 1e-3) << numWeights << " weights, shared " << shared << ", " << i;
+        }
+    }
+
+    alignas(16) Affine3 matrices[7], ref[7], res[7];
+    for (int i = 0; i < 7; i++)
+        matrices[i] = Affine3(Vector3(i, 2.0f * i, 1), Quaternion(Degree(20.0f * i), Vector3::UNIT_X), Vector3(1.5));
+    general->concatenateAffineMatrices(matrices[3], matrices, ref, 7);
+    util->concatenateAffineMatrices(matrices[3], matrices, res, 7);
+    for (int i = 0; i < 7; i++)
+        for (int r = 0; r < 3; r++)
+            for (int c = 0; c < 4; c++)
+                EXPECT_NEAR(res[i][r][c], ref[i][r][c], 1e-4) << i;
+}
+
+TEST_F(OptimisedUtilTests, SkinningSSE)
+{
+    OptimisedUtil* sse = OptimisedUtil::getImplementation(OptimisedUtil::IMPL_SSE);
+    if (!sse)
+        GTEST_SKIP() << "SSE not supported";
+    compareSkinningImplementations(sse);
+}
+
+TEST_F(OptimisedUtilTests, SkinningAVX2)
+{
+    OptimisedUtil* avx2 = OptimisedUtil::getImplementation(OptimisedUtil::IMPL_AVX2);
+    if (!avx2)
+        GTEST_SKIP() << "AVX2 not supported";
+    compareSkinningImplementations(avx2);
+}
+
+TEST_F(OptimisedUtilTests, SoftwareVertexBlend)
+{
+    mRoot->getWorkQueue()->startup();
+
+    minstd_rand rng;
+    std::uniform_real_distribution<float> dist(-10, 10);
+
+    alignas(16) Affine3 bones[4];
+    const Affine3* blendMatrices[4];
+    for (int i = 0; i < 4; i++)
+    {
+        bones[i] = Affine3(Vector3(dist(rng), dist(rng), dist(rng)), Quaternion(Radian(dist(rng)), Vector3::UNIT_Y));
+        blendMatrices[i] = &bones[i];
+    }
+
+    // enough vertices to be split into several tasks
+    const size_t count = 5000;
+    VertexData src, dst;
+    src.vertexCount = dst.vertexCount = count;
+    for (auto vd : {&src, &dst})
+    {
+        vd->vertexDeclaration->addElement(0, 0, VET_FLOAT3, VES_POSITION);
+        vd->vertexDeclaration->addElement(0, 12, VET_FLOAT3, VES_NORMAL);
+        vd->vertexBufferBinding->setBinding(0, mHBM->createVertexBuffer(24, count, HBU_CPU_ONLY));
+    }
+    src.vertexDeclaration->addElement(1, 0, VET_UBYTE4, VES_BLEND_INDICES);
+    src.vertexDeclaration->addElement(1, 4, VET_FLOAT2, VES_BLEND_WEIGHTS);
+    src.vertexBufferBinding->setBinding(1, mHBM->createVertexBuffer(12, count, HBU_CPU_ONLY));
+
+    std::vector<float> srcData(count * 6);
+    for (auto& f : srcData)
+        f = dist(rng);
+    src.vertexBufferBinding->getBuffer(0)->writeData(0, srcData.size() * sizeof(float), srcData.data());
+
+    std::vector<uchar> blendData(count * 12);
+    for (size_t i = 0; i < count; i++)
+    {
+        uchar indices[4] = {uchar(i % 4), uchar((i / 4) % 4), 0, 0};
+        float weights[2] = {0.25f, 0.75f};
+        memcpy(&blendData[i * 12], indices, 4);
+        memcpy(&blendData[i * 12 + 4], weights, 8);
+    }
+    src.vertexBufferBinding->getBuffer(1)->writeData(0, blendData.size(), blendData.data());
+
+    Mesh::softwareVertexBlend(&src, &dst, blendMatrices, 4, true);
+
+    std::vector<float> dstData(count * 6);
+    dst.vertexBufferBinding->getBuffer(0)->readData(0, dstData.size() * sizeof(float), dstData.data());
+    for (size_t i = 0; i < count; i++)
+    {
+        const Affine3& m0 = bones[i % 4];
+        const Affine3& m1 = bones[(i / 4) % 4];
+        Vector3 pos(&srcData[i * 6]), normal(&srcData[i * 6 + 3]);
+        Vector3 refPos = m0 * pos * 0.25f + m1 * pos * 0.75f;
+        Vector3 refNormal = (m0.linear() * normal * 0.25f + m1.linear() * normal * 0.75f).normalisedCopy();
+
+        EXPECT_TRUE(Vector3(&dstData[i * 6]).positionEquals(refPos, 1e-3)) << i;
+        EXPECT_TRUE(Vector3(&dstData[i * 6 + 3]).positionEquals(refNormal, 1e-3)) << i;
+    }
+}
+
+struct LockProbe : public MovableObject
+{
+    HardwareVertexBufferSharedPtr buffer;
+    bool wasLocked;
+    AxisAlignedBox box;
+
+    LockProbe(const HardwareVertexBufferSharedPtr& buf) : MovableObject("LockProbe"), buffer(buf), wasLocked(false) {}
+    const String& getMovableType() const override { return BLANKSTRING; }
+    const AxisAlignedBox& getBoundingBox() const override { return box; }
+    Real getBoundingRadius() const override { return 0; }
+    void _updateRenderQueue(RenderQueue*) override { wasLocked = wasLocked || buffer->isLocked(); }
+    void visitRenderables(Renderable::Visitor*, bool) override {}
+};
+
+TEST_F(OptimisedUtilTests, SoftwareVertexBlendSharedMesh)
+{
+    mRoot->getWorkQueue()->startup();
+
+    // the pose animation of one entity reads the mesh data, while the skinning of the other is queued
+    MeshPtr mesh = MeshManager::getSingleton().load("jaiqua.mesh", RGN_DEFAULT)->clone("PosedJaiqua");
+    ushort target = mesh->sharedVertexData ? 0 : 1;
+    VertexData* meshData = target ? mesh->getSubMesh(0)->vertexData : mesh->sharedVertexData;
+    Pose* pose = mesh->createPose(target, "Lift");
+    for (uint32 i = 0; i < std::min<size_t>(100, meshData->vertexCount); i++)
+        pose->addVertex(i, Vector3f(0, 10, 0));
+    VertexAnimationTrack* track = mesh->createAnimation("Lift", 1)->createVertexTrack(target, VAT_POSE);
+    track->createVertexPoseKeyFrame(0)->addPoseReference(0, 1);
+    track->createVertexPoseKeyFrame(1)->addPoseReference(0, 1);
+
+    auto posBuf = meshData->vertexBufferBinding->getBuffer(
+        meshData->vertexDeclaration->findElementBySemantic(VES_POSITION)->getSource());
+
+    std::vector<float> results[2];
+    for (bool parallel : {false, true})
+    {
+        SceneManager* sm = mRoot->createSceneManager();
+        sm->setParallelSoftwareAnimation(parallel);
+        Camera* cam = sm->createCamera("Camera");
+        sm->getRootSceneNode()->attachObject(cam);
+
+        SceneNode* node = sm->getRootSceneNode()->createChildSceneNode(Vector3(0, 0, -100));
+        Entity* skinned = sm->createEntity(mesh);
+        Entity* posed = sm->createEntity(mesh);
+        posed->getAnimationState("Lift")->setEnabled(true);
+        LockProbe probe(posBuf);
+        node->attachObject(skinned);
+        node->attachObject(&probe);
+        node->attachObject(posed);
+
+        sm->_updateSceneGraph(cam);
+        VisibleObjectsBoundsInfo info;
+        sm->_findVisibleObjectsAndBlend(cam, &info, false);
+        EXPECT_FALSE(probe.wasLocked);
+        EXPECT_FALSE(posBuf->isLocked());
+
+        VertexData* skinnedData = posed->getSubEntity(0)->_getSkelAnimVertexData();
+        if (!target)
+            skinnedData = posed->_getSkelAnimVertexData();
+        ASSERT_TRUE(skinnedData);
+        auto elem = skinnedData->vertexDeclaration->findElementBySemantic(VES_POSITION);
+        auto buf = skinnedData->vertexBufferBinding->getBuffer(elem->getSource());
+        HardwareBufferLockGuard lock(buf, HardwareBuffer::HBL_READ_ONLY);
+        for (size_t i = 0; i < skinnedData->vertexCount; i++)
+        {
+            float* pos;
+            elem->baseVertexPointerToElement(static_cast<uchar*>(lock.pData) + i * buf->getVertexSize(), &pos);
+            results[parallel].insert(results[parallel].end(), pos, pos + 3);
+        }
+
+        node->detachObject(&probe);
+        mRoot->destroySceneManager(sm);
+    }
+
+    ASSERT_EQ(results[0].size(), results[1].size());
+    for (size_t i = 0; i < results[0].size(); i++)
+        EXPECT_NEAR(results[0][i], results[1][i], 1e-3) << i;
+}
+
 static void createRandomEntityClones(Entity* ent, size_t cloneCount, const Vector3& min,
                                      const Vector3& max, SceneManager* mgr)
 {
@@ -212,6 +1323,378 @@ static void createRandomEntityClones(Entity* ent, size_t cloneCount, const Vecto
     }
 }
 
+TEST(ParticleStreams, MatchesParticles)
+{
+    minstd_rand rng;
+    std::uniform_real_distribution<float> dist(-10, 10);
+
+    // 39 particles, so the scalar tails are covered as well
+    ParticleStreams streams;
+    std::vector<Particle> particles(39);
+    for (auto& p : particles)
+    {
+        p.mPosition = Vector3(dist(rng), dist(rng), dist(rng));
+        p.mDirection = Vector3(dist(rng), dist(rng), dist(rng));
+        p.mColour = rng();
+        p.mWidth = dist(rng) / 2 + 5;
+        p.mHeight = dist(rng) / 2 + 5;
+        p.mRotation = Radian(dist(rng));
+        p.mRotationSpeed = Radian(dist(rng));
+        streams.push_back(p);
+    }
+
+    Real t = 0.1f;
+    Vector3 force(0, -9.81, 0.5);
+    ColourValue dc(0.7, -0.3, 0.1, -0.6);
+    Vector3 normal(0.2, 1, 0.1);
+    Real planeDistance = 1;
+    for (int i = 0; i < 10; i++)
+    {
+        streams.addDirection(force * t);
+        streams.averageDirection(force);
+        streams.adjustColour(dc * t);
+        streams.adjustDimensions(-t);
+        streams.applyRotationSpeed(t);
+        streams.deflect(normal, planeDistance, 0.5, t);
+        streams.applyMotion(t);
+
+        // same as the ParticleFX affectors and ParticleSystem::_applyMotion
+        for (auto& p : particles)
+        {
+            p.mDirection += force * t;
+            p.mDirection = (p.mDirection + force) / 2;
+            p.mColour = (ColourValue((uchar*)&p.mColour) + dc * t).saturateCopy().getAsBYTE();
+            p.setDimensions(std::max(0.0f, p.mWidth - t), std::max(0.0f, p.mHeight - t));
+            p.mRotation = p.mRotation + t * p.mRotationSpeed;
+
+            Vector3 direction(p.mDirection * t);
+            if (normal.dotProduct(p.mPosition + direction) + planeDistance <= 0.0)
+            {
+                Real a = normal.dotProduct(p.mPosition) + planeDistance;
+                if (a > 0.0)
+                {
+                    Vector3 directionPart = direction * (-a / direction.dotProduct(normal));
+                    p.mPosition = (p.mPosition + directionPart) + ((directionPart - direction) * 0.5);
+                    p.mDirection = (p.mDirection - (2.0f * p.mDirection.dotProduct(normal) * normal)) * 0.5;
+                }
+            }
+
+            p.mPosition += p.mDirection * t;
+        }
+    }
+
+    ASSERT_EQ(streams.size(), particles.size());
+    Particle p;
+    for (size_t i = 0; i < particles.size(); i++)
+    {
+        streams.get(i, p);
+        EXPECT_EQ(p.mPosition, particles[i].mPosition);
+        EXPECT_EQ(p.mDirection, particles[i].mDirection);
+        EXPECT_EQ(p.mColour, particles[i].mColour);
+        EXPECT_EQ(p.mWidth, particles[i].mWidth);
+        EXPECT_EQ(p.mHeight, particles[i].mHeight);
+        EXPECT_EQ(p.mRotation, particles[i].mRotation);
+    }
+
+    streams.removeSwapLast(3);
+    streams.get(3, p);
+    EXPECT_EQ(streams.size(), particles.size() - 1);
+    EXPECT_EQ(p.mPosition, particles.back().mPosition);
+}
+
+namespace
+{
+// deterministic emitter, so systems can be compared
+struct CountingEmitter : public ParticleEmitter
+{
+    int mCount = 0;
+    CountingEmitter(ParticleSystem* psys) : ParticleEmitter(psys) { mType = "Counting"; }
+    void _initParticle(Particle* p) override
+    {
+        ParticleEmitter::_initParticle(p);
+        mCount++;
+        p->mPosition = Vector3(mCount % 7, 0, mCount % 5);
+        p->mDirection = Vector3(1, mCount % 3, 0);
+        p->mTimeToLive = p->mTotalTimeToLive = 0.5f + (mCount % 4) * 0.25f;
+    }
+};
+struct CountingEmitterFactory : public ParticleEmitterFactory
+{
+    String getName() const override { return "Counting"; }
+    ParticleEmitter* createEmitter(ParticleSystem* psys) override { return new CountingEmitter(psys); }
+};
+
+// uses the random numbers of the system
+struct RandomEmitter : public ParticleEmitter
+{
+    RandomEmitter(ParticleSystem* psys) : ParticleEmitter(psys) { mType = "Random"; }
+    void _initParticle(Particle* p) override
+    {
+        ParticleEmitter::_initParticle(p);
+        genEmissionDirection(p->mPosition, p->mDirection);
+        genEmissionVelocity(p->mDirection);
+        p->mTimeToLive = p->mTotalTimeToLive = genEmissionTTL();
+    }
+};
+struct RandomEmitterFactory : public ParticleEmitterFactory
+{
+    String getName() const override { return "Random"; }
+    ParticleEmitter* createEmitter(ParticleSystem* psys) override { return new RandomEmitter(psys); }
+};
+
+// affectors with and without stream support
+struct GravityAffector : public ParticleAffector
+{
+    GravityAffector(ParticleSystem* psys) : ParticleAffector(psys) { mType = "Gravity"; }
+    void _affectParticles(ParticleSystem* pSystem, Real timeElapsed) override
+    {
+        for (auto p : pSystem->_getActiveParticles())
+            p->mDirection += Vector3(0, -10, 0) * timeElapsed;
+    }
+    bool _supportsParticleStreams(void) const override { return true; }
+    void _affectParticleStreams(ParticleStreams& streams, Real timeElapsed) override
+    {
+        streams.addDirection(Vector3(0, -10, 0) * timeElapsed);
+    }
+};
+struct DragAffector : public ParticleAffector
+{
+    DragAffector(ParticleSystem* psys) : ParticleAffector(psys) { mType = "Drag"; }
+    void _affectParticles(ParticleSystem* pSystem, Real timeElapsed) override
+    {
+        for (auto p : pSystem->_getActiveParticles())
+            p->mDirection *= 0.9;
+    }
+};
+template <typename T> struct TestAffectorFactory : public ParticleAffectorFactory
+{
+    String mName;
+    TestAffectorFactory(const String& name) : mName(name) {}
+    String getName() const override { return mName; }
+    ParticleAffector* createAffector(ParticleSystem* psys) override { return new T(psys); }
+};
+}
+
+typedef RootWithoutRenderSystemFixture ParticleSystemTests;
+TEST_F(ParticleSystemTests, StreamStorage)
+{
+    // these are otherwise created along with the render system
+    ControllerManager controllerManager;
+    ParticleSystemManager::getSingleton()._initialise();
+
+    CountingEmitterFactory emitterFactory;
+    TestAffectorFactory<GravityAffector> gravityFactory("Gravity");
+    TestAffectorFactory<DragAffector> dragFactory("Drag");
+    ParticleSystemManager::getSingleton().addEmitterFactory(&emitterFactory);
+    ParticleSystemManager::getSingleton().addAffectorFactory(&gravityFactory);
+    ParticleSystemManager::getSingleton().addAffectorFactory(&dragFactory);
+
+    SceneManager* sm = mRoot->createSceneManager();
+    ParticleSystem* systems[2];
+    for (int i = 0; i < 2; i++)
+    {
+        systems[i] = sm->createParticleSystem(100);
+        systems[i]->addEmitter("Counting")->setEmissionRate(60);
+        systems[i]->addAffector("Gravity");
+        systems[i]->addAffector("Drag");
+        systems[i]->addAffector("Gravity");
+        sm->getRootSceneNode()->attachObject(systems[i]);
+    }
+    systems[1]->setParameter("stream_storage", "true");
+    EXPECT_TRUE(systems[1]->getStreamStorage());
+    EXPECT_TRUE(systems[1]->_getParticleStreams());
+
+    for (int i = 0; i < 50; i++)
+    {
+        systems[0]->_update(0.05);
+        systems[1]->_update(0.05);
+    }
+
+    ASSERT_EQ(systems[0]->getNumParticles(), systems[1]->getNumParticles());
+    EXPECT_GT(systems[1]->getNumParticles(), 0u);
+    EXPECT_EQ(systems[0]->getBoundingBox(), systems[1]->getBoundingBox());
+
+    Particle p;
+    for (size_t i = 0; i < systems[0]->getNumParticles(); i++)
+    {
+        systems[1]->_getParticleStreams()->get(i, p);
+        EXPECT_EQ(systems[0]->getParticle(i)->mPosition, p.mPosition);
+        EXPECT_EQ(systems[0]->getParticle(i)->mTimeToLive, p.mTimeToLive);
+    }
+
+    // the factories are not owned by the manager, but the systems must go before them
+    sm->destroyAllParticleSystems();
+}
+
+TEST_F(ParticleSystemTests, DefaultSeed)
+{
+    ControllerManager controllerManager;
+    ParticleSystemManager::getSingleton()._initialise();
+
+    // FNV-1a of the name, which must not change between platforms
+    std::minstd_rand expected(1647883453u);
+    ParticleSystem sys("Seeded", RGN_DEFAULT);
+    for (int i = 0; i < 4; i++)
+    {
+        float value = float(expected() - expected.min()) / float(expected.max() - expected.min());
+        EXPECT_EQ(sys._unitRandom(), value);
+    }
+}
+
+TEST_F(ParticleSystemTests, ParallelUpdate)
+{
+    ControllerManager controllerManager;
+    ParticleSystemManager& psm = ParticleSystemManager::getSingleton();
+    psm._initialise();
+    mRoot->getWorkQueue()->startup();
+
+    RandomEmitterFactory emitterFactory;
+    TestAffectorFactory<GravityAffector> gravityFactory("Gravity");
+    psm.addEmitterFactory(&emitterFactory);
+    psm.addAffectorFactory(&gravityFactory);
+
+    // the first half is updated serially, the second half in parallel
+    SceneManager* sm = mRoot->createSceneManager();
+    std::vector<ParticleSystem*> systems;
+    for (int i = 0; i < 16; i++)
+    {
+        ParticleSystem* sys = sm->createParticleSystem(200);
+        ParticleEmitter* emitter = sys->addEmitter("Random");
+        emitter->setEmissionRate(100 + (i % 8) * 10);
+        emitter->setAngle(Degree(30));
+        emitter->setTimeToLive(0.5, 1.5);
+        emitter->setParticleVelocity(1, 5);
+        sys->addAffector("Gravity");
+        sys->setRandomSeed(i % 8);
+        sm->getRootSceneNode()->createChildSceneNode(Vector3(i % 8, 0, 0))->attachObject(sys);
+        systems.push_back(sys);
+    }
+
+    psm.setParallelUpdate(true);
+    for (int i = 0; i < 40; i++)
+    {
+        for (int j = 0; j < 8; j++)
+        {
+            systems[j]->_update(0.05);
+            psm._queueUpdate(systems[j + 8], 0.05);
+        }
+        psm._updateQueuedSystems();
+    }
+
+    // updates queued outside of SceneManager::_renderScene are done when the next frame starts
+    for (int j = 0; j < 8; j++)
+    {
+        systems[j]->_update(0.05);
+        psm._queueUpdate(systems[j + 8], 0.05);
+    }
+    mRoot->_fireFrameStarted();
+    mRoot->_fireFrameEnded();
+    psm.setParallelUpdate(false);
+
+    for (int j = 0; j < 8; j++)
+    {
+        ParticleSystem* serial = systems[j];
+        ParticleSystem* parallel = systems[j + 8];
+        ASSERT_EQ(serial->getNumParticles(), parallel->getNumParticles());
+        EXPECT_GT(serial->getNumParticles(), 0u);
+        EXPECT_EQ(serial->getBoundingBox(), parallel->getBoundingBox());
+        for (size_t i = 0; i < serial->getNumParticles(); i++)
+        {
+            EXPECT_EQ(serial->getParticle(i)->mPosition, parallel->getParticle(i)->mPosition);
+            EXPECT_EQ(serial->getParticle(i)->mTimeToLive, parallel->getParticle(i)->mTimeToLive);
+        }
+    }
+
+    // a destroyed system must not stay queued
+    psm._queueUpdate(systems[0], 0.05);
+    sm->destroyAllParticleSystems();
+    psm._updateQueuedSystems();
+}
+
+typedef RootWithoutRenderSystemFixture BillboardSetTests;
+TEST_F(BillboardSetTests, InjectBillboards)
+{
+    mRoot->getWorkQueue()->startup();
+
+    SceneManager* sm = mRoot->createSceneManager();
+    Camera* cam = sm->createCamera("Camera");
+    SceneNode* camNode = sm->getRootSceneNode()->createChildSceneNode(Vector3(10, 20, 500));
+    camNode->attachObject(cam);
+    camNode->lookAt(Vector3(0, 0, 0), Node::TS_PARENT);
+
+    minstd_rand rng;
+    std::uniform_real_distribution<float> dist(-100, 100);
+    std::vector<Billboard> billboards(1000);
+    for (size_t i = 0; i < billboards.size(); i++)
+    {
+        Billboard& bb = billboards[i];
+        bb.mPosition = Vector3(dist(rng), dist(rng), dist(rng));
+        bb.mDirection = Vector3(dist(rng), dist(rng), dist(rng)).normalisedCopy();
+        bb.mColour = rng();
+        bb.mRotation = Radian(i % 2 ? dist(rng) : 0);
+        if (i % 3 == 0)
+            bb.setDimensions(dist(rng) + 101, dist(rng) + 101);
+        bb.setTexcoordIndex(i % 4);
+    }
+
+    BillboardSet* sets[2];
+    for (auto& set : sets)
+    {
+        set = sm->createBillboardSet(billboards.size());
+        set->setTextureStacksAndSlices(2, 2);
+        set->setCommonDirection(Vector3(0, 1, 1).normalisedCopy());
+        set->setCommonUpVector(Vector3(1, 0, 0));
+        sm->getRootSceneNode()->createChildSceneNode(Vector3(1, 2, 3))->attachObject(set);
+    }
+
+    for (auto type : {BBT_POINT, BBT_ORIENTED_COMMON, BBT_ORIENTED_SELF, BBT_PERPENDICULAR_COMMON,
+                      BBT_PERPENDICULAR_SELF})
+    {
+        for (auto rotationType : {BBR_VERTEX, BBR_TEXCOORD})
+        {
+            for (bool accurateFacing : {false, true})
+            {
+                for (auto set : sets)
+                {
+                    set->setBillboardType(type);
+                    set->setBillboardRotationType(rotationType);
+                    set->setUseAccurateFacing(accurateFacing);
+                    set->_notifyCurrentCamera(cam);
+                    set->beginBillboards(billboards.size());
+                }
+
+                for (auto& bb : billboards)
+                    sets[0]->injectBillboard(bb);
+                sets[1]->injectBillboards(billboards.data(), billboards.size());
+
+                for (auto set : sets)
+                    set->endBillboards();
+
+                RenderOperation ops[2];
+                sets[0]->getRenderOperation(ops[0]);
+                sets[1]->getRenderOperation(ops[1]);
+                ASSERT_EQ(ops[0].vertexData->vertexCount, billboards.size() * 4);
+                ASSERT_EQ(ops[1].vertexData->vertexCount, billboards.size() * 4);
+
+                HardwareBufferLockGuard ref(ops[0].vertexData->vertexBufferBinding->getBuffer(0),
+                                            HardwareBuffer::HBL_READ_ONLY);
+                HardwareBufferLockGuard bulk(ops[1].vertexData->vertexBufferBinding->getBuffer(0),
+                                             HardwareBuffer::HBL_READ_ONLY);
+                const float* pRef = static_cast<const float*>(ref.pData);
+                const float* pBulk = static_cast<const float*>(bulk.pData);
+                // position, colour, texcoords
+                for (size_t i = 0; i < billboards.size() * 4 * 6; i++)
+                {
+                    if (i % 6 == 3)
+                        EXPECT_EQ(memcmp(&pRef[i], &pBulk[i], sizeof(float)), 0);
+                    else
+                        ASSERT_NEAR(pRef[i], pBulk[i], 1e-3) << type << rotationType << accurateFacing << i;
+                }
+            }
+        }
+    }
+}
+
 struct SceneQueryTest : public RootWithoutRenderSystemFixture {
     SceneManager* mSceneMgr;
     Camera* mCamera;
@@ -573,6 +2056,283 @@ TEST_F(SkeletonTests, linkedSkeletonAnimationSource)
     EXPECT_TRUE(entity->getAnimationState("Stealth")); // animation from ninja.sekeleton
 }
 
+TEST_F(SkeletonTests, AnimationCache)
+{
+    auto sceneMgr = mRoot->createSceneManager();
+    Entity* entities[3];
+    for (auto& e : entities)
+        e = sceneMgr->createEntity("jaiqua.mesh");
+
+    // the animations are shared, the states are per entity
+    const String& animName = entities[0]->getSkeleton()->getAnimation(0)->getName();
+    auto animate = [&animName](Entity* e, Real time) {
+        AnimationState* state = e->getAnimationState(animName);
+        state->setEnabled(true);
+        state->setTimePosition(time);
+        state->setWeight(0.7);
+        e->getSkeleton()->setAnimationState(*e->getAllAnimationStates());
+    };
+
+    // reference without the cache
+    animate(entities[0], 0.5);
+
+    SkeletonPtr master = entities[1]->getMesh()->getSkeleton();
+    entities[1]->getSkeleton()->setAnimationCache(true);
+    EXPECT_TRUE(master->getAnimationCacheEnabled());
+    animate(entities[1], 0.5);
+
+    // snapped to 0.5
+    entities[2]->getSkeleton()->setAnimationCache(true, 0.1);
+    EXPECT_EQ(master->getAnimationCacheQuantum(), Real(0.1));
+    animate(entities[2], 0.52);
+
+    Skeleton* ref = entities[0]->getSkeleton();
+    for (int i = 1; i < 3; i++)
+    {
+        Skeleton* skel = entities[i]->getSkeleton();
+        ASSERT_EQ(ref->getNumBones(), skel->getNumBones());
+        for (unsigned short b = 0; b < ref->getNumBones(); b++)
+        {
+            EXPECT_EQ(ref->getBone(b)->getPosition(), skel->getBone(b)->getPosition());
+            EXPECT_EQ(ref->getBone(b)->getOrientation(), skel->getBone(b)->getOrientation());
+            EXPECT_EQ(ref->getBone(b)->getScale(), skel->getBone(b)->getScale());
+        }
+    }
+
+    master->setAnimationCache(false);
+    EXPECT_FALSE(entities[2]->getSkeleton()->getAnimationCacheEnabled());
+}
+
+TEST_F(SkeletonTests, EvaluateBoneMatrices)
+{
+    auto sceneMgr = mRoot->createSceneManager();
+    Entity* entities[2];
+    for (auto& e : entities)
+    {
+        e = sceneMgr->createEntity("jaiqua.mesh");
+        e->getSkeleton()->addLinkedSkeletonAnimationSource("ninja.skeleton", 0.5);
+        e->refreshAvailableAnimationState();
+
+        AnimationState* state = e->getAnimationState(e->getSkeleton()->getAnimation(0)->getName());
+        state->setEnabled(true);
+        state->setTimePosition(0.4);
+        state->setWeight(0.7);
+        state = e->getAnimationState("Stealth");
+        state->setEnabled(true);
+        state->setTimePosition(1.3);
+        state->setWeight(0.6);
+
+        Bone* manual = e->getSkeleton()->getBone(5);
+        manual->setManuallyControlled(true);
+        manual->setPosition(1, 2, 3);
+    }
+
+    SkeletonInstance* ref = entities[0]->getSkeleton();
+    std::vector<Affine3> refMatrices(ref->getNumBones());
+    ref->setAnimationState(*entities[0]->getAllAnimationStates());
+    ref->_getBoneMatrices(refMatrices.data());
+
+    SkeletonInstance* skel = entities[1]->getSkeleton();
+    EXPECT_TRUE(skel->getManualBonesDirty());
+    EXPECT_TRUE(entities[1]->_prepareSkeletonEvaluation());
+    // marked as updated for this frame
+    EXPECT_FALSE(entities[1]->_prepareSkeletonEvaluation());
+    entities[1]->_evaluateSkeleton();
+    EXPECT_FALSE(skel->getManualBonesDirty());
+
+    const Affine3* matrices = entities[1]->_getBoneMatrices();
+    for (unsigned short b = 0; b < ref->getNumBones(); b++)
+    {
+        EXPECT_EQ(ref->getBone(b)->getPosition(), skel->getBone(b)->getPosition());
+        EXPECT_EQ(ref->getBone(b)->getOrientation(), skel->getBone(b)->getOrientation());
+        EXPECT_TRUE(ref->getBone(b)->_getDerivedPosition().positionEquals(skel->getBone(b)->_getDerivedPosition()));
+        for (int i = 0; i < 3; i++)
+            for (int j = 0; j < 4; j++)
+                EXPECT_NEAR(refMatrices[b][i][j], matrices[b][i][j], 1e-4);
+    }
+
+    // skeletons with a node listener are left to the serial update, which calls it
+    Node::Listener listener;
+    ref->getBone(3)->setListener(&listener);
+    EXPECT_FALSE(entities[0]->_prepareSkeletonEvaluation());
+    ref->getBone(3)->setListener(NULL);
+    EXPECT_TRUE(entities[0]->_prepareSkeletonEvaluation());
+}
+
+TEST_F(SkeletonTests, CompressedTracks)
+{
+    auto skel = static_pointer_cast<Skeleton>(SkeletonManager::getSingleton().load("jaiqua.skeleton", RGN_DEFAULT));
+    Animation* anim = skel->getAnimation(0);
+    anim->setInterpolationMode(Animation::IM_LINEAR);
+
+    std::vector<TransformKeyFrame> ref;
+    std::vector<Real> times;
+    for (Real t = 0; t <= anim->getLength(); t += anim->getLength() / 50)
+        times.push_back(t);
+    for (const auto& it : anim->_getNodeTrackList())
+    {
+        for (Real t : times)
+        {
+            ref.emplace_back(nullptr, t);
+            it.second->getInterpolatedKeyFrame(anim->_getTimeIndex(t), &ref.back());
+        }
+    }
+
+    Real tolerance = 1e-3f;
+    skel->compressAllAnimations(tolerance, Radian(tolerance), tolerance);
+
+    auto check = [&](Animation* compressed) {
+        size_t i = 0;
+        for (const auto& it : compressed->_getNodeTrackList())
+        {
+            EXPECT_TRUE(it.second->isCompressed());
+            EXPECT_EQ(it.second->getNumKeyFrames(), 0u);
+            for (Real t : times)
+            {
+                TransformKeyFrame kf(nullptr, t);
+                it.second->getInterpolatedKeyFrame(compressed->_getTimeIndex(t), &kf);
+                // the key reduction and quantisation errors add up
+                EXPECT_TRUE(kf.getTranslate().positionEquals(ref[i].getTranslate(), 4 * tolerance));
+                EXPECT_TRUE(kf.getRotation().equals(ref[i].getRotation(), Radian(4 * tolerance)));
+                EXPECT_TRUE(kf.getScale().positionEquals(ref[i].getScale(), 4 * tolerance));
+                i++;
+            }
+        }
+        EXPECT_EQ(i, ref.size());
+    };
+    check(anim);
+
+    // round trip through the compressed chunk
+    auto stream = std::make_shared<MemoryDataStream>(1 << 20);
+    SkeletonSerializer().exportSkeleton(skel.get(), stream);
+    DataStreamPtr data = std::make_shared<MemoryDataStream>(stream->getPtr(), stream->tell());
+    auto loaded =
+        static_pointer_cast<Skeleton>(SkeletonManager::getSingleton().create("compressed.skeleton", RGN_DEFAULT));
+    SkeletonSerializer().importSkeleton(data, loaded.get());
+    loaded->getAnimation(0)->setInterpolationMode(Animation::IM_LINEAR);
+    EXPECT_TRUE(loaded->getAnimation(0)->_getNodeTrackList().begin()->second->isCompressed());
+    check(loaded->getAnimation(0));
+
+    // the 1.8 format keeps plain keyframes
+    stream = std::make_shared<MemoryDataStream>(1 << 20);
+    SkeletonSerializer().exportSkeleton(skel.get(), stream, SKELETON_VERSION_1_8);
+    data = std::make_shared<MemoryDataStream>(stream->getPtr(), stream->tell());
+    data->skip(sizeof(uint16));
+    EXPECT_EQ(data->getLine(), "[Serializer_v1.80]");
+    data->seek(0);
+    auto loaded18 =
+        static_pointer_cast<Skeleton>(SkeletonManager::getSingleton().create("keyframes.skeleton", RGN_DEFAULT));
+    SkeletonSerializer().importSkeleton(data, loaded18.get());
+    EXPECT_FALSE(loaded18->getAnimation(0)->_getNodeTrackList().begin()->second->isCompressed());
+
+    // back to keyframes
+    NodeAnimationTrack* track = anim->_getNodeTrackList().begin()->second;
+    track->decompress();
+    EXPECT_FALSE(track->isCompressed());
+    EXPECT_GT(track->getNumKeyFrames(), 0u);
+}
+
+TEST_F(SkeletonTests, MergeCompressedAnimation)
+{
+    auto src = static_pointer_cast<Skeleton>(SkeletonManager::getSingleton().create("src.skeleton", RGN_DEFAULT));
+    auto dst = static_pointer_cast<Skeleton>(SkeletonManager::getSingleton().create("dst.skeleton", RGN_DEFAULT));
+    for (auto& skel : {src, dst})
+    {
+        skel->createBone("root", 0);
+        skel->createBone("child", 1)->setPosition(skel == src ? Vector3(0, 1, 0) : Vector3(0, 2, 0));
+        skel->getBone(0)->addChild(skel->getBone(1));
+        skel->setBindingPose();
+    }
+
+    Animation* anim = src->createAnimation("walk", 10);
+    anim->setInterpolationMode(Animation::IM_LINEAR);
+    for (unsigned short b = 0; b < 2; b++)
+    {
+        NodeAnimationTrack* track = anim->createNodeTrack(b, src->getBone(b));
+        for (int i = 0; i <= 10; i++)
+            track->createNodeKeyFrame(i)->setTranslate(Vector3(i * 0.5f, i % 2, 0));
+        EXPECT_TRUE(track->compress());
+    }
+
+    Skeleton::BoneHandleMap boneHandleMap;
+    dst->_buildMapBoneByName(src.get(), boneHandleMap);
+    dst->_mergeSkeletonAnimations(src.get(), boneHandleMap);
+
+    // the keys of the compressed tracks are copied, moved to the binding pose of the target
+    Animation* merged = dst->getAnimation("walk");
+    for (unsigned short b = 0; b < 2; b++)
+    {
+        NodeAnimationTrack* track = anim->getNodeTrack(b);
+        NodeAnimationTrack* mergedTrack = merged->getNodeTrack(b);
+        ASSERT_EQ(mergedTrack->getNumKeyFrames(), 11u);
+        Vector3 delta = b == 0 ? Vector3::ZERO : Vector3(0, -1, 0);
+        for (int i = 0; i <= 10; i++)
+        {
+            TransformKeyFrame kf(nullptr, i);
+            track->getInterpolatedKeyFrame(anim->_getTimeIndex(i), &kf);
+            EXPECT_NEAR(mergedTrack->getNodeKeyFrame(i)->getTime(), i, 1e-3);
+            EXPECT_TRUE(mergedTrack->getNodeKeyFrame(i)->getTranslate().positionEquals(kf.getTranslate() + delta));
+        }
+    }
+
+    StringStream dump;
+    dump << *src;
+    EXPECT_NE(dump.str().find("Number of keyframes: 11"), String::npos);
+
+    SkeletonManager::getSingleton().remove(src);
+    SkeletonManager::getSingleton().remove(dst);
+}
+
+TEST(CompressedTracks, Tolerance)
+{
+    Animation anim("anim", 100);
+    anim.setInterpolationMode(Animation::IM_LINEAR);
+    Real tolerance = 1e-3f;
+
+    // the tolerance holds at each key, including the quantisation error of a large range
+    NodeAnimationTrack* track = anim.createNodeTrack(0);
+    for (int i = 0; i <= 1000; i++)
+    {
+        Real t = i / 10.0f;
+        track->createNodeKeyFrame(t)->setTranslate(Vector3(t * 0.5f, std::sin(t) * 10, 0));
+    }
+    std::vector<TransformKeyFrame> ref;
+    for (int i = 0; i <= 1000; i++)
+    {
+        ref.emplace_back(nullptr, i / 10.0f);
+        track->getInterpolatedKeyFrame(anim._getTimeIndex(i / 10.0f), &ref.back());
+    }
+    EXPECT_TRUE(track->compress(tolerance, Radian(tolerance), tolerance));
+    EXPECT_TRUE(track->isCompressed());
+    for (const auto& r : ref)
+    {
+        TransformKeyFrame kf(nullptr, r.getTime());
+        track->getInterpolatedKeyFrame(anim._getTimeIndex(r.getTime()), &kf);
+        // half a time unit away from the key, with a slope of up to 10 per second
+        EXPECT_TRUE(kf.getTranslate().positionEquals(r.getTranslate(), tolerance + 10 / 65535.0f * 100))
+            << r.getTime();
+    }
+
+    // the quantisation step of the range exceeds the tolerance
+    track = anim.createNodeTrack(1);
+    track->createNodeKeyFrame(0)->setTranslate(Vector3::ZERO);
+    track->createNodeKeyFrame(50)->setTranslate(Vector3(1e5, 0, 0));
+    track->createNodeKeyFrame(100)->setTranslate(Vector3(0.5, 0, 0));
+    EXPECT_FALSE(track->compress(tolerance, Radian(tolerance), tolerance));
+    EXPECT_FALSE(track->isCompressed());
+    EXPECT_EQ(track->getNumKeyFrames(), 3u);
+
+    // keys closer than a time unit, which cannot be dropped
+    track = anim.createNodeTrack(2);
+    track->createNodeKeyFrame(0)->setTranslate(Vector3::ZERO);
+    track->createNodeKeyFrame(40)->setTranslate(Vector3::ZERO);
+    track->createNodeKeyFrame(40.0001f)->setTranslate(Vector3(1, 0, 0));
+    track->createNodeKeyFrame(100)->setTranslate(Vector3(1, 0, 0));
+    EXPECT_FALSE(track->compress(tolerance, Radian(tolerance), tolerance));
+    EXPECT_FALSE(track->isCompressed());
+    EXPECT_EQ(track->getNumKeyFrames(), 4u);
+}
+
 TEST(MaterialLoading, LateShadowCaster)
 {
     Root root("");
@@ -695,4 +2455,65 @@ TEST(Billboard, TextureCoords)
             bb->setTexcoordIndex((ysegs - y - 1)*xsegs + x);
         }
     }
-}
\ No newline at end of file
+}
+
+namespace
+{
+struct DepthRenderable : public Renderable
+{
+    MaterialPtr mMaterial;
+    Real mDepth;
+    DepthRenderable(const MaterialPtr& mat, Real depth) : mMaterial(mat), mDepth(depth) {}
+    const MaterialPtr& getMaterial(void) const override { return mMaterial; }
+    void getRenderOperation(RenderOperation& op) override {}
+    void getWorldTransforms(Matrix4* xform) const override { *xform = Matrix4::IDENTITY; }
+    Real getSquaredViewDepth(const Camera* cam) const override { return mDepth; }
+    const LightList& getLights(void) const override
+    {
+        static LightList lights;
+        return lights;
+    }
+};
+
+struct DepthRecorder : public QueuedRenderableVisitor
+{
+    std::vector<Real> depths;
+    void visit(RenderablePass* rp) override { depths.push_back(rp->renderable->getSquaredViewDepth(NULL)); }
+    void visit(const Pass* p, RenderableList& rs) override
+    {
+        for (auto r : rs)
+            depths.push_back(r->getSquaredViewDepth(NULL));
+    }
+};
+}
+
+typedef RootWithoutRenderSystemFixture RenderQueueTests;
+TEST_F(RenderQueueTests, SortSolidsFrontToBack)
+{
+    auto mat = MaterialManager::getSingleton().getDefaultMaterial(false);
+    mat->load();
+    DepthRenderable back(mat, 300), front(mat, 100), middle(mat, 200);
+
+    RenderQueue queue;
+    queue.setSortSolidsFrontToBack(true);
+    for (auto rend : {&back, &front, &middle})
+    {
+        queue.addRenderable(rend, RENDER_QUEUE_MAIN);
+        queue.addRenderable(rend, RENDER_QUEUE_OVERLAY);
+    }
+
+    Camera cam("cam", NULL);
+    auto render = [&](uint8 qid) {
+        DepthRecorder recorder;
+        for (auto& pg : queue.getQueueGroup(qid)->getPriorityGroups())
+        {
+            pg.second->sort(&cam);
+            pg.second->getSolidsBasic().acceptVisitor(&recorder, QueuedRenderableCollection::OM_PASS_GROUP);
+        }
+        return recorder.depths;
+    };
+
+    EXPECT_EQ(render(RENDER_QUEUE_MAIN), std::vector<Real>({100, 200, 300}));
+    // overlays keep the submission order
+    EXPECT_EQ(render(RENDER_QUEUE_OVERLAY), std::vector<Real>({300, 100, 200}));
+}
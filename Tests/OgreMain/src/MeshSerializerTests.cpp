@@ -198,11 +198,16 @@ TEST_F(MeshSerializerTests,Skeleton_Version_1_0)
     }
 }
 //--------------------------------------------------------------------------
-TEST_F(MeshSerializerTests,Mesh_Version_1_10)
+TEST_F(MeshSerializerTests,Mesh_Version_14_4)
 {
     testMesh(MESH_VERSION_LATEST);
 }
 //--------------------------------------------------------------------------
+TEST_F(MeshSerializerTests,Mesh_Version_1_10)
+{
+    testMesh(MESH_VERSION_1_10);
+}
+//--------------------------------------------------------------------------
 TEST_F(MeshSerializerTests,Mesh_Version_1_8)
 {
     testMesh(MESH_VERSION_1_8);
@@ -223,6 +228,93 @@ TEST_F(MeshSerializerTests,Mesh_Version_1_3)
     testMesh(MESH_VERSION_1_0);
 }
 //--------------------------------------------------------------------------
+TEST_F(MeshSerializerTests,Mesh_SwappedEndian)
+{
+    // the buffers and edge lists are decoded after parsing the chunks, when the stream is in memory
+    if (!mOrigMesh->isEdgeListBuilt())
+        mOrigMesh->buildEdgeList();
+
+    MeshSerializer serializer;
+    auto stream = std::make_shared<MemoryDataStream>(16 << 20);
+    serializer.exportMesh(mOrigMesh.get(), stream, MESH_VERSION_LATEST,
+                          OGRE_ENDIAN == OGRE_ENDIAN_BIG ? MeshSerializer::ENDIAN_LITTLE : MeshSerializer::ENDIAN_BIG);
+    stream->seek(0);
+
+    MeshPtr loaded = MeshManager::getSingleton().createManual("SwappedEndian.mesh", "General");
+    serializer.importMesh(stream, loaded.get());
+    assertMeshClone(mOrigMesh.get(), loaded.get());
+    MeshManager::getSingleton().remove(loaded);
+}
+//--------------------------------------------------------------------------
+static std::vector<uchar> readBlendBuffer(VertexData* vertexData)
+{
+    auto elem = vertexData->vertexDeclaration->findElementBySemantic(VES_BLEND_INDICES);
+    if (!elem)
+        return {};
+    auto vbuf = vertexData->vertexBufferBinding->getBuffer(elem->getSource());
+    std::vector<uchar> ret(vbuf->getSizeInBytes());
+    vbuf->readData(0, ret.size(), ret.data());
+    return ret;
+}
+//--------------------------------------------------------------------------
+static void assertBoneAssignmentsEqual(const Mesh::VertexBoneAssignmentList& a,
+                                       const Mesh::VertexBoneAssignmentList& b)
+{
+    ASSERT_EQ(a.size(), b.size());
+    for (auto ia = a.begin(), ib = b.begin(); ia != a.end(); ++ia, ++ib)
+    {
+        EXPECT_EQ(ia->first, ib->first);
+        EXPECT_EQ(ia->second.vertexIndex, ib->second.vertexIndex);
+        EXPECT_EQ(ia->second.boneIndex, ib->second.boneIndex);
+        EXPECT_EQ(ia->second.weight, ib->second.weight);
+    }
+}
+//--------------------------------------------------------------------------
+TEST_F(MeshSerializerTests,Mesh_BoneWeights)
+{
+    MeshPtr mesh = MeshManager::getSingleton().load("jaiqua.mesh", "General");
+    // rationalises the assignments, as the packed bone weights are
+    mesh->_updateCompiledBoneAssignments();
+
+    MeshSerializer serializer;
+    size_t fileSize[3];
+    MeshVersion versions[] = {MESH_VERSION_LATEST, MESH_VERSION_1_10, MESH_VERSION_LATEST};
+    MeshSerializer::Endian endians[] = {MeshSerializer::ENDIAN_NATIVE, MeshSerializer::ENDIAN_NATIVE,
+                                        OGRE_ENDIAN == OGRE_ENDIAN_BIG ? MeshSerializer::ENDIAN_LITTLE
+                                                                       : MeshSerializer::ENDIAN_BIG};
+    for (int i = 0; i < 3; i++)
+    {
+        auto stream = std::make_shared<MemoryDataStream>(16 << 20);
+        serializer.exportMesh(mesh.get(), stream, versions[i], endians[i]);
+        fileSize[i] = stream->tell();
+        stream->seek(0);
+
+        MeshPtr loaded = MeshManager::getSingleton().createManual("BoneWeights.mesh", "General");
+        serializer.importMesh(stream, loaded.get());
+        loaded->_updateCompiledBoneAssignments();
+
+        ASSERT_EQ(mesh->getNumSubMeshes(), loaded->getNumSubMeshes());
+        assertBoneAssignmentsEqual(mesh->getBoneAssignments(), loaded->getBoneAssignments());
+        for (size_t j = 0; j < mesh->getNumSubMeshes(); j++)
+        {
+            SubMesh* a = mesh->getSubMesh(j);
+            SubMesh* b = loaded->getSubMesh(j);
+            assertBoneAssignmentsEqual(a->getBoneAssignments(), b->getBoneAssignments());
+            EXPECT_EQ(a->blendIndexToBoneIndexMap, b->blendIndexToBoneIndexMap);
+            if (!a->useSharedVertices)
+            {
+                EXPECT_EQ(readBlendBuffer(a->vertexData), readBlendBuffer(b->vertexData));
+            }
+        }
+
+        MeshManager::getSingleton().remove(loaded);
+    }
+
+    EXPECT_FALSE(mesh->getSubMesh(0)->getBoneAssignments().empty());
+    EXPECT_LT(fileSize[0], fileSize[1]);
+    EXPECT_EQ(fileSize[0], fileSize[2]);
+}
+//--------------------------------------------------------------------------
 #ifdef I_HAVE_LOT_OF_FREE_TIME
 TEST_F(MeshSerializerTests,Mesh_Version_1_2)
 {
@@ -596,9 +688,36 @@ void MeshSerializerTests::assertEdgeDataClone(EdgeData* a, EdgeData* b, MeshVers
         EXPECT_TRUE(a->isClosed == b->isClosed);
         EXPECT_TRUE(isContainerClone(a->triangleFaceNormals, b->triangleFaceNormals));
         EXPECT_TRUE(isContainerClone(a->triangleLightFacings, b->triangleLightFacings));
-        // TODO: Compare triangles and edgeGroups in more detail.
-        EXPECT_TRUE(a->triangles.size() == b->triangles.size());
-        EXPECT_TRUE(a->edgeGroups.size() == b->edgeGroups.size());
+        ASSERT_EQ(a->triangles.size(), b->triangles.size());
+        for (size_t i = 0; i < a->triangles.size(); i++) {
+            const EdgeData::Triangle& ta = a->triangles[i];
+            const EdgeData::Triangle& tb = b->triangles[i];
+            EXPECT_EQ(ta.indexSet, tb.indexSet);
+            EXPECT_EQ(ta.vertexSet, tb.vertexSet);
+            for (int j = 0; j < 3; j++) {
+                EXPECT_EQ(ta.vertIndex[j], tb.vertIndex[j]);
+                EXPECT_EQ(ta.sharedVertIndex[j], tb.sharedVertIndex[j]);
+            }
+        }
+        ASSERT_EQ(a->edgeGroups.size(), b->edgeGroups.size());
+        for (size_t i = 0; i < a->edgeGroups.size(); i++) {
+            const EdgeData::EdgeGroup& ga = a->edgeGroups[i];
+            const EdgeData::EdgeGroup& gb = b->edgeGroups[i];
+            EXPECT_EQ(ga.vertexSet, gb.vertexSet);
+            EXPECT_EQ(ga.triStart, gb.triStart);
+            EXPECT_EQ(ga.triCount, gb.triCount);
+            ASSERT_EQ(ga.edges.size(), gb.edges.size());
+            for (size_t j = 0; j < ga.edges.size(); j++) {
+                const EdgeData::Edge& ea = ga.edges[j];
+                const EdgeData::Edge& eb = gb.edges[j];
+                for (int k = 0; k < 2; k++) {
+                    EXPECT_EQ(ea.triIndex[k], eb.triIndex[k]);
+                    EXPECT_EQ(ea.vertIndex[k], eb.vertIndex[k]);
+                    EXPECT_EQ(ea.sharedVertIndex[k], eb.sharedVertIndex[k]);
+                }
+                EXPECT_EQ(ea.degenerate, eb.degenerate);
+            }
+        }
     }
 }
 //--------------------------------------------------------------------------
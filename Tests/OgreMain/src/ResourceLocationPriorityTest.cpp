@@ -56,4 +56,57 @@ TEST(ResourceGroupLocationTest, ResourceLocationPriority)
 
     resGrpMgr.removeResourceLocation("ResourceLocationPriority0");
     resGrpMgr.removeResourceLocation("ResourceLocationPriority1");
-}
\ No newline at end of file
+}
+TEST(ResourceGroupLocationTest, FindGroupContainingResource)
+{
+    std::unique_ptr<DummyArchiveFactory> fact = std::unique_ptr<DummyArchiveFactory>(new DummyArchiveFactory);
+    Ogre::Root root("");
+    Ogre::ArchiveManager::getSingleton().addArchiveFactory(fact.get());
+
+    Ogre::ResourceGroupManager& resGrpMgr = Ogre::ResourceGroupManager::getSingleton();
+    EXPECT_FALSE(resGrpMgr.resourceExistsInAnyGroup("dummyArchiveTest"));
+
+    resGrpMgr.addResourceLocation("ResourceLocationIndexB", "DummyArchive", "GroupB");
+    EXPECT_EQ(resGrpMgr.findGroupContainingResource("dummyArchiveTest"), "GroupB");
+    unsigned char contentsB;
+    resGrpMgr.openResource("dummyArchiveTest", Ogre::RGN_AUTODETECT)->read(&contentsB, 1);
+
+    // groups are searched in name order, the index must pick up the new location
+    resGrpMgr.addResourceLocation("ResourceLocationIndexA", "DummyArchive", "GroupA");
+    EXPECT_EQ(resGrpMgr.findGroupContainingResource("dummyArchiveTest"), "GroupA");
+    unsigned char contentsA;
+    resGrpMgr.openResource("dummyArchiveTest", Ogre::RGN_AUTODETECT)->read(&contentsA, 1);
+    EXPECT_NE(contentsA, contentsB);
+
+    resGrpMgr.removeResourceLocation("ResourceLocationIndexA", "GroupA");
+    EXPECT_EQ(resGrpMgr.findGroupContainingResource("dummyArchiveTest"), "GroupB");
+
+    resGrpMgr.destroyResourceGroup("GroupB");
+    EXPECT_FALSE(resGrpMgr.resourceExistsInAnyGroup("dummyArchiveTest"));
+    EXPECT_THROW(resGrpMgr.findGroupContainingResource("dummyArchiveTest"), Ogre::ItemIdentityException);
+}
+#if !OGRE_RESOURCEMANAGER_STRICT
+TEST(ResourceGroupLocationTest, CaseInsensitiveGroupOrder)
+{
+    // only case insensitive archives are in the case insensitive index
+    std::unique_ptr<DummyArchiveFactory> fact(new DummyArchiveFactory("LowerDummyArchive", "dummyArchiveTest", false));
+    std::unique_ptr<DummyArchiveFactory> upperFact(
+        new DummyArchiveFactory("UpperDummyArchive", "DUMMYARCHIVETEST", false));
+    Ogre::Root root("");
+    Ogre::ArchiveManager::getSingleton().addArchiveFactory(fact.get());
+    Ogre::ArchiveManager::getSingleton().addArchiveFactory(upperFact.get());
+
+    // each group tries the exact case before ignoring it, but groups are still searched in name order
+    Ogre::ResourceGroupManager& resGrpMgr = Ogre::ResourceGroupManager::getSingleton();
+    resGrpMgr.addResourceLocation("ResourceLocationCaseB", "LowerDummyArchive", "GroupB");
+    resGrpMgr.addResourceLocation("ResourceLocationCaseA", "UpperDummyArchive", "GroupA");
+    EXPECT_EQ(resGrpMgr.findGroupContainingResource("dummyArchiveTest"), "GroupA");
+    EXPECT_EQ(resGrpMgr.findGroupContainingResource("DUMMYARCHIVETEST"), "GroupA");
+
+    // either way round
+    resGrpMgr.removeResourceLocation("ResourceLocationCaseA", "GroupA");
+    resGrpMgr.addResourceLocation("ResourceLocationCaseC", "UpperDummyArchive", "GroupC");
+    EXPECT_EQ(resGrpMgr.findGroupContainingResource("dummyArchiveTest"), "GroupB");
+    EXPECT_EQ(resGrpMgr.findGroupContainingResource("DUMMYARCHIVETEST"), "GroupB");
+}
+#endif
@@ -30,6 +30,10 @@ THE SOFTWARE.
 #include "OgreCommon.h"
 #include "OgreConfigFile.h"
 #include "OgreFileSystemLayer.h"
+#include "OgreDeflate.h"
+#include "OgreFileSystem.h"
+
+#include <thread>
 
 using namespace Ogre;
 
@@ -250,3 +254,56 @@ TEST_F(ZipArchiveTests,ReadInterleave)
     EXPECT_TRUE(stream2->eof());
 }
 //--------------------------------------------------------------------------
+TEST_F(ZipArchiveTests,ConcurrentRead)
+{
+    // every thread inflates its own entries, without a shared zip handle
+    std::vector<std::thread> threads;
+    std::vector<int> failures(4);
+    for (int t = 0; t < 4; t++)
+    {
+        threads.emplace_back([this, t, &failures]() {
+            for (int i = 0; i < 50; i++)
+            {
+                DataStreamPtr stream = arch->open(i % 2 ? "rootfile.txt" : "rootfile2.txt");
+                String expected = StringUtil::format("this is line 1 in file %d", i % 2 ? 1 : 2);
+                failures[t] += stream->getLine() != expected;
+            }
+        });
+    }
+    for (auto& t : threads)
+        t.join();
+    for (int f : failures)
+        EXPECT_EQ(0, f);
+}
+//--------------------------------------------------------------------------
+TEST_F(ZipArchiveTests,LazyInflate)
+{
+    ZipArchiveFactory::setLazyInflateThreshold(1);
+    DataStreamPtr stream = arch->open("rootfile.txt");
+    ZipArchiveFactory::setLazyInflateThreshold(0);
+
+    EXPECT_TRUE(dynamic_cast<DeflateStream*>(stream.get()));
+    EXPECT_EQ(arch->open("rootfile.txt")->size(), stream->size());
+    EXPECT_EQ(String("this is line 1 in file 1"), stream->getLine());
+    stream->seek(0);
+    EXPECT_EQ(String("this is line 1 in file 1"), stream->getLine());
+    EXPECT_EQ(String("this is line 2 in file 1"), stream->getLine());
+    EXPECT_EQ(String("this is line 3 in file 1"), stream->getLine());
+    EXPECT_EQ(String("this is line 4 in file 1"), stream->getLine());
+    EXPECT_EQ(String("this is line 5 in file 1"), stream->getLine());
+    EXPECT_TRUE(stream->eof());
+}
+//--------------------------------------------------------------------------
+TEST_F(ZipArchiveTests,MmapRead)
+{
+    FileSystemArchiveFactory::setUseMmap(true);
+    Archive* mapped = ZipArchiveFactory().createInstance(arch->getName(), true);
+    mapped->load();
+    FileSystemArchiveFactory::setUseMmap(false);
+
+    DataStreamPtr stream = mapped->open("rootfile2.txt");
+    EXPECT_EQ(String("this is line 1 in file 2"), stream->getLine());
+    EXPECT_EQ(arch->list()->size(), mapped->list()->size());
+    OGRE_DELETE mapped;
+}
+//--------------------------------------------------------------------------
@@ -0,0 +1,113 @@
+// This file is part of the OGRE project.
+// It is subject to the license terms in the LICENSE file found in the top-level directory
+// of this distribution and at https://www.ogre3d.org/licensing.
+// SPDX-License-Identifier: MIT
+
+#include <gtest/gtest.h>
+
+#include "OgreRoot.h"
+#include "OgreTinyRasterizer.h"
+
+using namespace Ogre;
+
+namespace
+{
+struct FlatShader : public IShader
+{
+    ColourValue colour;
+    explicit FlatShader(const ColourValue& c) : colour(c) {}
+    bool fragment(const Varying var[3], const vec3& bar, ColourValue& gl_FragColor) const override
+    {
+        gl_FragColor = colour;
+        return false;
+    }
+};
+
+/// draw a quad covering the whole target at the given NDC depth
+void drawQuad(TinyRasterizer& rasterizer, const Image& target, float z, const FlatShader& shader)
+{
+    float w = target.getWidth() / 2.f, h = target.getHeight() / 2.f;
+    Matrix4 viewport;
+    viewport.makeTransform({w, h, 0.5}, {w, h, 0.5}, Quaternion::IDENTITY);
+
+    rasterizer.beginDraw({&shader, true, true, false});
+    IShader::Varying var[3] = {};
+    IShader::vec4 lower[3] = {{-1, -1, z, 1}, {1, -1, z, 1}, {1, 1, z, 1}};
+    IShader::vec4 upper[3] = {{-1, -1, z, 1}, {1, 1, z, 1}, {-1, 1, z, 1}};
+    rasterizer.addTriangle(viewport, lower, var, false);
+    rasterizer.addTriangle(viewport, upper, var, false);
+}
+
+bool allPixels(const Image& img, const ColourValue& c)
+{
+    for (uint32 y = 0; y < img.getHeight(); y++)
+        for (uint32 x = 0; x < img.getWidth(); x++)
+            if (img.getColourAt(x, y, 0) != c)
+                return false;
+    return true;
+}
+} // namespace
+
+TEST(TinyRasterizer, HiZRejection)
+{
+    Root root("");
+    FlatShader red(ColourValue::Red), green(ColourValue::Green);
+
+    Image colour(PF_BYTE_RGBA, 200, 150), depth(PF_FLOAT32_R, 200, 150);
+    colour.setTo(ColourValue::Black);
+
+    TinyRasterizer rasterizer;
+    rasterizer.setTarget(&colour, &depth);
+    rasterizer.clearDepth(1);
+
+    drawQuad(rasterizer, colour, 0, red);
+    rasterizer.flush();
+    EXPECT_TRUE(allPixels(colour, ColourValue::Red));
+
+    // behind the depth range of every tile and block
+    drawQuad(rasterizer, colour, 0.5, green);
+    rasterizer.flush();
+    EXPECT_TRUE(allPixels(colour, ColourValue::Red));
+
+    // in front, so the per pixel depth test is skipped as well
+    drawQuad(rasterizer, colour, -0.5, green);
+    rasterizer.flush();
+    EXPECT_TRUE(allPixels(colour, ColourValue::Green));
+}
+
+TEST(TinyRasterizer, HiZAfterResize)
+{
+    Root root("");
+    FlatShader red(ColourValue::Red), green(ColourValue::Green);
+
+    Image colour(PF_BYTE_RGBA, 100, 100), depth(PF_FLOAT32_R, 100, 100);
+
+    TinyRasterizer rasterizer;
+    rasterizer.setTarget(&colour, &depth);
+    rasterizer.clearDepth(1);
+    drawQuad(rasterizer, colour, 0, red);
+    rasterizer.flush();
+
+    // grow in place, keeping the same number of tiles. The blocks that were outside of the buffer must be
+    // picked up by the depth ranges.
+    colour.create(PF_BYTE_RGBA, 120, 120);
+    depth.create(PF_FLOAT32_R, 120, 120);
+    colour.setTo(ColourValue::Black);
+    rasterizer.setTarget(&colour, &depth);
+    rasterizer.clearDepth(1);
+
+    drawQuad(rasterizer, colour, 0, green);
+    rasterizer.flush();
+    EXPECT_TRUE(allPixels(colour, ColourValue::Green));
+
+    // shrink in place, the ranges must follow the new contents
+    colour.create(PF_BYTE_RGBA, 90, 90);
+    depth.create(PF_FLOAT32_R, 90, 90);
+    colour.setTo(ColourValue::Black);
+    depth.setTo(ColourValue(1));
+    rasterizer.setTarget(&colour, &depth);
+
+    drawQuad(rasterizer, colour, 0.5, red);
+    rasterizer.flush();
+    EXPECT_TRUE(allPixels(colour, ColourValue::Red));
+}
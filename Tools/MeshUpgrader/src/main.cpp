@@ -74,7 +74,7 @@ R"HELP(Usage: OgreMeshUpgrader [opts] sourcefile [destfile]
 -E endian      = Set endian mode 'big' 'little' or 'native' (default)
 -b             = Recalculate bounding box (static meshes only)
 -V version     = Specify OGRE version format to write instead of latest
-                 Options are: 1.10, 1.8, 1.7, 1.4, 1.0
+                 Options are: 14.4, 1.10, 1.8, 1.7, 1.4, 1.0
 -log filename  = name of the log file (default: 'OgreMeshUpgrader.log')
 sourcefile     = name of file to convert
 destfile       = optional name of file to write to. If you don't
@@ -189,7 +189,9 @@ UpgradeOptions parseOpts(UnaryOptionList& unOpts, BinaryOptionList& binOpts)
 
     bi = binOpts.find("-V");
     if (!bi->second.empty()) {
-        if (bi->second == "1.10") {
+        if (bi->second == "14.4") {
+            opts.targetVersion = MESH_VERSION_14_4;
+        } else if (bi->second == "1.10") {
             opts.targetVersion = MESH_VERSION_1_10;
         } else if (bi->second == "1.8") {
             opts.targetVersion = MESH_VERSION_1_8;
@@ -569,6 +569,13 @@ namespace Ogre {
         // Write all keyframes
         pugi::xml_node keysNode =
             trackNode.append_child("keyframes");
+        // The XML format only knows keyframes, write the decoded keys of compressed tracks
+        std::vector<TransformKeyFrame> decodedKeys;
+        track->_decodeCompressedKeys(decodedKeys);
+        for (const auto& key : decodedKeys)
+        {
+            writeKeyFrame(keysNode, &key);
+        }
         for (unsigned short i = 0; i < track->getNumKeyFrames(); ++i)
         {
             writeKeyFrame(keysNode, track->getNodeKeyFrame(i));